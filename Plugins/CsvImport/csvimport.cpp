@@ -2,9 +2,11 @@
 #include "services/importmanager.h"
 #include "sqlitestudio.h"
 #include "services/notifymanager.h"
+#include "csvreader.h"
 #include <QVariant>
 #include <QFile>
 #include <QTextStream>
+#include <QTextCodec>
 
 CsvImport::CsvImport()
 {
@@ -32,11 +34,24 @@ bool CsvImport::beforeImport(const ImportManager::StandardImportConfig& config)
         return false;
     }
 
-    stream = new QTextStream(file);
-    stream->setCodec(config.codec.toLatin1().data());
+    QTextCodec* codec = QTextCodec::codecForName(config.codec.toLatin1());
+    if (codec && CsvReader::isSupported(csvFormat, codec))
+    {
+        reader = new CsvReader(file, csvFormat, codec);
+        if (!reader->isValid())
+            safe_delete(reader);
+    }
+
+    if (!reader)
+    {
+        file->seek(0);
+        stream = new QTextStream(file);
+        stream->setCodec(config.codec.toLatin1().data());
+    }
 
     if (!extractColumns())
     {
+        safe_delete(reader);
         safe_delete(stream);
         safe_delete(file);
         return false;
@@ -47,15 +62,16 @@ bool CsvImport::beforeImport(const ImportManager::StandardImportConfig& config)
 
 void CsvImport::afterImport()
 {
+    safe_delete(reader);
     safe_delete(stream);
     safe_delete(file);
 }
 
 bool CsvImport::extractColumns()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
-    while (deserializedEntry.isEmpty() && !stream->atEnd())
-        deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+    QStringList deserializedEntry = readEntry();
+    while (deserializedEntry.isEmpty() && !(reader ? reader->atEnd() : stream->atEnd()))
+        deserializedEntry = readEntry();
 
     if (deserializedEntry.isEmpty())
     {
@@ -74,7 +90,10 @@ bool CsvImport::extractColumns()
         for (int i = 1, total = deserializedEntry.size(); i <= total; ++i)
             columnNames << colTmp.arg(i);
 
-        stream->seek(0);
+        if (reader)
+            reader->reset();
+        else
+            stream->seek(0);
     }
 
     return true;
@@ -118,9 +137,17 @@ QList<ImportPlugin::ColumnDefinition> CsvImport::getColumns() const
     return columnList;
 }
 
+QStringList CsvImport::readEntry()
+{
+    if (reader)
+        return reader->readEntry();
+
+    return CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+}
+
 QList<QVariant> CsvImport::next()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+    QStringList deserializedEntry = readEntry();
 
     QList<QVariant> values;
     if (deserializedEntry.isEmpty())
@@ -19,6 +19,7 @@ CFG_CATEGORIES(CsvImportConfig,
 
 class QFile;
 class QTextStream;
+class CsvReader;
 
 class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlugin
 {
@@ -44,9 +45,11 @@ class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlug
     private:
         bool extractColumns();
         void defineCsvFormat();
+        QStringList readEntry();
 
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
+        CsvReader* reader = nullptr;
         QStringList columnNames;
         CsvFormat csvFormat;
         CFG_LOCAL_PERSISTABLE(CsvImportConfig, cfg)
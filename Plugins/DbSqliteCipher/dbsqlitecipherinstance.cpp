@@ -39,3 +39,8 @@ QString DbSqliteCipherInstance::getAttachSql(Db* otherDb, const QString& generat
 
     return QString("ATTACH '%1' AS %2 KEY '%3';").arg(otherDb->getPath(), generatedAttachName, pass);
 }
+
+AbstractDb3<SqlCipher>* DbSqliteCipherInstance::createReadConnection(const QHash<QString, QVariant>& options)
+{
+    return new DbSqliteCipherInstance(name, path, options);
+}
@@ -24,6 +24,7 @@ class DbSqliteCipherInstance : public AbstractDb3<SqlCipher>
 
     protected:
         void initAfterOpen();
+        AbstractDb3<SqlCipher>* createReadConnection(const QHash<QString, QVariant>& options);
         QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
 };
 
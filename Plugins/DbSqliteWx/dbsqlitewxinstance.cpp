@@ -46,3 +46,8 @@ QString DbSqliteWxInstance::getAttachSql(Db *otherDb, const QString &generatedAt
 
     return QString("ATTACH '%1' AS %2 KEY '%3';").arg(otherDb->getPath(), generatedAttachName, pass);
 }
+
+AbstractDb3<WxSQLite>* DbSqliteWxInstance::createReadConnection(const QHash<QString, QVariant>& options)
+{
+    return new DbSqliteWxInstance(name, path, options);
+}
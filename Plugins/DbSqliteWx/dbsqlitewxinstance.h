@@ -24,6 +24,7 @@ class DbSqliteWxInstance : public AbstractDb3<WxSQLite>
 
     protected:
         void initAfterOpen();
+        AbstractDb3<WxSQLite>* createReadConnection(const QHash<QString, QVariant>& options);
         QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
 };
 
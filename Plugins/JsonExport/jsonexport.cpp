@@ -265,6 +265,27 @@ bool JsonExport::beforeExport()
     return true;
 }
 
+ExportPlugin* JsonExport::createTableExporter()
+{
+    return new JsonExport();
+}
+
+bool JsonExport::initTableExporter(ExportPlugin* exporter, QIODevice* output)
+{
+    JsonExport* jsonExporter = dynamic_cast<JsonExport*>(exporter);
+    if (!jsonExporter)
+        return false;
+
+    initTableExporterBase(jsonExporter, output);
+    jsonExporter->elementCounter = elementCounter;
+    jsonExporter->indent = indent;
+    jsonExporter->indentDepth = indentDepth;
+    jsonExporter->indentStr = indentStr;
+    jsonExporter->newLineStr = newLineStr;
+    jsonExporter->codecName = codecName;
+    return true;
+}
+
 bool JsonExport::init()
 {
     SQLS_INIT_RESOURCE(jsonexport);
@@ -323,17 +344,45 @@ void JsonExport::write(const QString& str)
 
 QString JsonExport::escapeString(const QString& str)
 {
-    QString copy = str;
-    return "\"" +
-            copy.replace("\\", "\\\\")
-                .replace("\"", "\\\"")
-                .replace("/", "\\/")
-                .replace("\b", "\\b")
-                .replace("\f", "\\f")
-                .replace("\n", "\\n")
-                .replace("\r", "\\r")
-                .replace("\t", "\\t")
-            + "\"";
+    // Single pass over the string, instead of replacing each special character in a separate pass
+    QString result;
+    result.reserve(str.size() + 2);
+    result += QLatin1Char('"');
+    for (const QChar& c : str)
+    {
+        switch (c.unicode())
+        {
+            case '\\':
+                result += QLatin1String("\\\\");
+                break;
+            case '"':
+                result += QLatin1String("\\\"");
+                break;
+            case '/':
+                result += QLatin1String("\\/");
+                break;
+            case '\b':
+                result += QLatin1String("\\b");
+                break;
+            case '\f':
+                result += QLatin1String("\\f");
+                break;
+            case '\n':
+                result += QLatin1String("\\n");
+                break;
+            case '\r':
+                result += QLatin1String("\\r");
+                break;
+            case '\t':
+                result += QLatin1String("\\t");
+                break;
+            default:
+                result += c;
+                break;
+        }
+    }
+    result += QLatin1Char('"');
+    return result;
 }
 
 QString JsonExport::formatValue(const QVariant& val)
@@ -420,7 +469,10 @@ void JsonExport::endArray()
 void JsonExport::writeValue(const QVariant& value)
 {
     writePrefixBeforeNextElement();
-    write(formatValue(value));
+    GenericExportPlugin::write(indentStr);
+    if (!writeInteger(value))
+        GenericExportPlugin::write(formatValue(value));
+
     incrElementCount();
 }
 
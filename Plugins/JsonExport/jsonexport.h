@@ -43,6 +43,8 @@ class JSONEXPORTSHARED_EXPORT JsonExport : public GenericExportPlugin
         bool exportView(const QString& database, const QString& name, const QString& ddl, SqliteCreateViewPtr createView);
         bool afterExportDatabase();
         bool beforeExport();
+        ExportPlugin* createTableExporter();
+        bool initTableExporter(ExportPlugin* exporter, QIODevice* output);
         bool init();
         void deinit();
 
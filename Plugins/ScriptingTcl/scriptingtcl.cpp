@@ -5,31 +5,33 @@
 #include "parser/lexer.h"
 #include "parser/token.h"
 #include "common/utils_sql.h"
+#include "plugins/scriptingthreadcontexts.h"
 #include <QDebug>
-#include <QMutexLocker>
+#include <QThread>
 
 ScriptingTcl::ScriptingTcl()
 {
-    mainInterpMutex = new QMutex();
 }
 
 ScriptingTcl::~ScriptingTcl()
 {
-    safe_delete(mainInterpMutex);
+    safe_delete(threadContexts);
 }
 
 bool ScriptingTcl::init()
 {
     SQLS_INIT_RESOURCE(scriptingtcl);
-    QMutexLocker locker(mainInterpMutex);
-    mainContext = new ContextTcl();
+    safe_delete(threadContexts);
+    threadContexts = new ScriptingThreadContexts([]() -> Context*
+    {
+        return new ContextTcl();
+    });
     return true;
 }
 
 void ScriptingTcl::deinit()
 {
-    QMutexLocker locker(mainInterpMutex);
-    safe_delete(mainContext);
+    safe_delete(threadContexts);
     Tcl_Finalize();
     SQLS_CLEANUP_RESOURCE(scriptingtcl);
 }
@@ -119,11 +121,20 @@ QVariant ScriptingTcl::evaluate(ScriptingPlugin::Context* context, const QString
 QVariant ScriptingTcl::evaluate(const QString& code, const FunctionInfo& funcInfo, const QList<QVariant>& args,
                                 Db* db, bool locking, QString* errorMessage)
 {
-    QMutexLocker locker(mainInterpMutex);
-    QVariant results = compileAndEval(mainContext, code, funcInfo, args, db, locking);
+    ScriptingThreadContexts::Usage usage(threadContexts);
+    ContextTcl* ctx = static_cast<ContextTcl*>(usage.getContext());
+    if (!ctx)
+    {
+        if (errorMessage)
+            *errorMessage = tr("Tcl interpreter is not initialized.");
+
+        return QVariant();
+    }
 
-    if (errorMessage && !mainContext->error.isEmpty())
-        *errorMessage = mainContext->error;
+    QVariant results = compileAndEval(ctx, code, funcInfo, args, db, locking);
+
+    if (errorMessage && !ctx->error.isEmpty())
+        *errorMessage = ctx->error;
 
     return results;
 }
@@ -670,7 +681,8 @@ Tcl_Obj* ScriptingTcl::ScriptObject::getTclObj()
     return obj;
 }
 
-ScriptingTcl::ContextTcl::ContextTcl()
+ScriptingTcl::ContextTcl::ContextTcl() :
+    thread(QThread::currentThread())
 {
     scriptCache.setMaxCost(cacheSize);
     interp = Tcl_CreateInterp();
@@ -679,6 +691,16 @@ ScriptingTcl::ContextTcl::ContextTcl()
 
 ScriptingTcl::ContextTcl::~ContextTcl()
 {
+    if (thread != QThread::currentThread())
+    {
+        // Interpreter of another thread is left for Tcl_Finalize() in deinit(), including cached scripts
+        // referring to it, because Tcl doesn't allow to release them from here.
+        for (const QString& key : scriptCache.keys())
+            scriptCache.take(key);
+
+        return;
+    }
+
     Tcl_DeleteInterp(interp);
 }
 
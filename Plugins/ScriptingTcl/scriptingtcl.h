@@ -8,7 +8,8 @@
 #include <QCache>
 #include <tcl.h>
 
-class QMutex;
+class ScriptingThreadContexts;
+class QThread;
 struct Tcl_Interp;
 struct Tcl_Obj;
 
@@ -66,6 +67,11 @@ class SCRIPTINGTCLSHARED_EXPORT ScriptingTcl : public GenericPlugin, public DbAw
 
             private:
                 void init();
+
+                /**
+                 * @brief Thread that created the interpreter. Only this thread can delete it.
+                 */
+                QThread* thread = nullptr;
         };
 
         enum class TclDataType
@@ -107,9 +113,14 @@ class SCRIPTINGTCLSHARED_EXPORT ScriptingTcl : public GenericPlugin, public DbAw
 
         static const constexpr int cacheSize = 5;
 
-        ContextTcl* mainContext = nullptr;
+        /**
+         * @brief Interpreters used by evaluations without explicit context, one per thread.
+         *
+         * Tcl interpreter can be used only by the thread that created it, so each thread gets its own one,
+         * which also lets the threads evaluate at the same time.
+         */
+        ScriptingThreadContexts* threadContexts = nullptr;
         QList<Context*> contexts;
-        QMutex* mainInterpMutex = nullptr;
 };
 
 #endif // SCRIPTINGTCL_H
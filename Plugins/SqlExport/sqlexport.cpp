@@ -67,7 +67,7 @@ bool SqlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
     QString ddl = "CREATE TABLE " + theTable + " (" + this->columns + ");";
     writeln("");
 
-    if (cfg.SqlExport.GenerateDrop.get())
+    if (generateDrop)
         writeln(formatQuery(dropDdl.arg(theTable)));
 
     writeln(formatQuery(ddl));
@@ -76,10 +76,7 @@ bool SqlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
 
 bool SqlExport::exportQueryResultsRow(SqlResultsRowPtr row)
 {
-    QStringList argList = rowToArgList(row);
-    QString argStr = argList.join(", ");
-    QString sql = "INSERT INTO " + theTable + " (" + this->columns + ") VALUES (" + argStr + ");";
-    writeln(sql);
+    writeInsert(rowToValues(row));
     return true;
 }
 
@@ -139,7 +136,7 @@ bool SqlExport::exportTable(const QString& database, const QString& table, const
 
     theTable = getNameForObject(database, table, true);
 
-    if (cfg.SqlExport.GenerateDrop.get())
+    if (generateDrop)
         writeln(formatQuery(dropDdl.arg(theTable)));
 
     writeln(formatQuery(ddl));
@@ -148,13 +145,16 @@ bool SqlExport::exportTable(const QString& database, const QString& table, const
 
 bool SqlExport::exportTableRow(SqlResultsRowPtr data)
 {
-    QStringList argList = rowToArgList(data, true);
-    QString argStr = argList.join(", ");
-    QString sql = "INSERT INTO " + theTable + " (" + columns + ") VALUES (" + argStr + ");";
-    if (!cfg.SqlExport.FormatDdlsOnly.get())
-        sql = formatQuery(sql);
+    QList<QVariant> values = rowToValues(data, true);
+    if (formatDdlsOnly || !useFormatter)
+    {
+        writeInsert(values);
+        return true;
+    }
 
-    writeln(sql);
+    QString argStr = valueListToSqlList(values).join(", ");
+    QString sql = "INSERT INTO " + theTable + " (" + columns + ") VALUES (" + argStr + ");";
+    writeln(formatQuery(sql));
     return true;
 }
 
@@ -165,6 +165,36 @@ bool SqlExport::afterExport()
     return true;
 }
 
+bool SqlExport::beforeExport()
+{
+    generateDrop = cfg.SqlExport.GenerateDrop.get();
+    formatDdlsOnly = cfg.SqlExport.FormatDdlsOnly.get();
+    useFormatter = cfg.SqlExport.UseFormatter.get();
+    return true;
+}
+
+ExportPlugin* SqlExport::createTableExporter()
+{
+    // Code formatter is not meant to be used from many threads at once
+    if (cfg.SqlExport.UseFormatter.get())
+        return nullptr;
+
+    return new SqlExport();
+}
+
+bool SqlExport::initTableExporter(ExportPlugin* exporter, QIODevice* output)
+{
+    SqlExport* sqlExporter = dynamic_cast<SqlExport*>(exporter);
+    if (!sqlExporter)
+        return false;
+
+    initTableExporterBase(sqlExporter, output);
+    sqlExporter->generateDrop = generateDrop;
+    sqlExporter->formatDdlsOnly = formatDdlsOnly;
+    sqlExporter->useFormatter = useFormatter;
+    return true;
+}
+
 bool SqlExport::beforeExportDatabase(const QString& database)
 {
     UNUSED(database);
@@ -184,7 +214,7 @@ bool SqlExport::exportIndex(const QString& database, const QString& name, const
     writeln(tr("-- Index: %1").arg(index));
 
     QString fullName = getNameForObject(database, name, true);
-    if (cfg.SqlExport.GenerateDrop.get())
+    if (generateDrop)
         writeln(formatQuery(dropDdl.arg(fullName)));
 
     writeln(formatQuery(ddl));
@@ -201,7 +231,7 @@ bool SqlExport::exportTrigger(const QString& database, const QString& name, cons
     writeln(tr("-- Trigger: %1").arg(trig));
 
     QString fullName = getNameForObject(database, name, true);
-    if (cfg.SqlExport.GenerateDrop.get())
+    if (generateDrop)
         writeln(dropDdl.arg(fullName));
 
     writeln(formatQuery(formatQuery(ddl)));
@@ -218,7 +248,7 @@ bool SqlExport::exportView(const QString& database, const QString& name, const Q
     writeln(tr("-- View: %1").arg(view));
 
     QString fullName = getNameForObject(database, name, true);
-    if (cfg.SqlExport.GenerateDrop.get())
+    if (generateDrop)
         writeln(dropDdl.arg(fullName));
 
     writeln(formatQuery(formatQuery(ddl)));
@@ -261,7 +291,7 @@ void SqlExport::writeFkEnable()
 
 QString SqlExport::formatQuery(const QString& sql)
 {
-    if (cfg.SqlExport.UseFormatter.get())
+    if (useFormatter)
         return FORMATTER->format("sql", sql, db);
 
     if (sql.trimmed().endsWith(";"))
@@ -279,7 +309,7 @@ QString SqlExport::getNameForObject(const QString& database, const QString& name
     return obj;
 }
 
-QStringList SqlExport::rowToArgList(SqlResultsRowPtr row, bool honorGeneratedColumns)
+QList<QVariant> SqlExport::rowToValues(SqlResultsRowPtr row, bool honorGeneratedColumns)
 {
     if (honorGeneratedColumns)
     {
@@ -292,10 +322,27 @@ QStringList SqlExport::rowToArgList(SqlResultsRowPtr row, bool honorGeneratedCol
 
             filteredValues << value;
         }
-        return valueListToSqlList(filteredValues);
+        return filteredValues;
     }
 
-    return valueListToSqlList(row->valueList());
+    return row->valueList();
+}
+
+void SqlExport::writeInsert(const QList<QVariant>& values)
+{
+    // Statement is written piece by piece, so integers are formatted directly into the output
+    write("INSERT INTO " + theTable + " (" + columns + ") VALUES (");
+    bool first = true;
+    for (const QVariant& value : values)
+    {
+        if (!first)
+            write(", ");
+
+        first = false;
+        if (!writeInteger(value))
+            write(valueListToSqlList({value}).first());
+    }
+    writeln(");");
 }
 
 void SqlExport::validateOptions()
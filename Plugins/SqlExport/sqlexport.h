@@ -39,6 +39,9 @@ class SQLEXPORTSHARED_EXPORT SqlExport : public GenericExportPlugin
                                 const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportTableRow(SqlResultsRowPtr data);
         bool afterExport();
+        bool beforeExport();
+        ExportPlugin* createTableExporter();
+        bool initTableExporter(ExportPlugin* exporter, QIODevice* output);
         bool beforeExportDatabase(const QString& database);
         bool exportIndex(const QString& database, const QString& name, const QString& ddl, SqliteCreateIndexPtr createIndex);
         bool exportTrigger(const QString& database, const QString& name, const QString& ddl, SqliteCreateTriggerPtr createTrigger);
@@ -56,12 +59,18 @@ class SQLEXPORTSHARED_EXPORT SqlExport : public GenericExportPlugin
         void writeFkEnable();
         QString formatQuery(const QString& sql);
         QString getNameForObject(const QString& database, const QString& name, bool wrapped);
-        QStringList rowToArgList(SqlResultsRowPtr row, bool honorGeneratedColumns = false);
+        QList<QVariant> rowToValues(SqlResultsRowPtr row, bool honorGeneratedColumns = false);
+        void writeInsert(const QList<QVariant>& values);
 
         QString theTable;
         QString columns;
         QStringList tableGeneratedColumns;
         QList<int> generatedColumnIndexes;
+
+        // Settings are read once per export, so instances created with createTableExporter() can get them from the main one
+        bool generateDrop = false;
+        bool formatDdlsOnly = false;
+        bool useFormatter = false;
         CFG_LOCAL_PERSISTABLE(SqlExportConfig, cfg)
 };
 
@@ -92,6 +92,8 @@ bool XmlExport::exportQueryResultsRow(SqlResultsRowPtr row)
 {
     static const QString rowTpl = QStringLiteral("<value column=\"%1\">%2</value>");
     static const QString nullTpl = QStringLiteral("<value column=\"%1\" null=\"true\"/>");
+    static const QString intStartTpl = QStringLiteral("<value column=\"%1\">");
+    static const QString intEnd = QStringLiteral("</value>");
 
     writeln("<row>");
     incrIndent();
@@ -100,9 +102,20 @@ bool XmlExport::exportQueryResultsRow(SqlResultsRowPtr row)
     for (const QVariant& value : row->valueList())
     {
         if (value.isNull())
+        {
             writeln(nullTpl.arg(i));
+        }
+        else if (isInteger(value))
+        {
+            // Integers need no escaping, so they are formatted directly into the output
+            GenericExportPlugin::write(indentStr + intStartTpl.arg(i));
+            writeInteger(value);
+            GenericExportPlugin::write(intEnd + newLineStr);
+        }
         else
+        {
             writeln(rowTpl.arg(i).arg(escape(value.toString())));
+        }
 
         i++;
     }
@@ -479,6 +492,29 @@ QString XmlExport::toString(bool value)
     return value ? "true" : "false";
 }
 
+ExportPlugin* XmlExport::createTableExporter()
+{
+    return new XmlExport();
+}
+
+bool XmlExport::initTableExporter(ExportPlugin* exporter, QIODevice* output)
+{
+    XmlExport* xmlExporter = dynamic_cast<XmlExport*>(exporter);
+    if (!xmlExporter)
+        return false;
+
+    initTableExporterBase(xmlExporter, output);
+    xmlExporter->indent = indent;
+    xmlExporter->indentDepth = indentDepth;
+    xmlExporter->indentStr = indentStr;
+    xmlExporter->newLineStr = newLineStr;
+    xmlExporter->nsStr = nsStr;
+    xmlExporter->codecName = codecName;
+    xmlExporter->useAmpersand = useAmpersand;
+    xmlExporter->useCdata = useCdata;
+    return true;
+}
+
 bool XmlExport::init()
 {
     SQLS_INIT_RESOURCE(xmlexport);
@@ -43,6 +43,8 @@ class XMLEXPORTSHARED_EXPORT XmlExport : public GenericExportPlugin
         bool exportTrigger(const QString& database, const QString& name, const QString& ddl, SqliteCreateTriggerPtr createTrigger);
         bool exportView(const QString& database, const QString& name, const QString& ddl, SqliteCreateViewPtr createView);
         bool afterExportDatabase();
+        ExportPlugin* createTableExporter();
+        bool initTableExporter(ExportPlugin* exporter, QIODevice* output);
         bool init();
         void deinit();
 
@@ -0,0 +1,15 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_collationstest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_collationstest.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,154 @@
+#include "services/impl/collationmanagerimpl.h"
+#include "common/utils_sql.h"
+#include "db/sqlquery.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QCollator>
+#include <QtTest>
+
+class CollationsTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        CollationsTest();
+
+    private:
+        int compare(const QString& collation, const QString& value1, const QString& value2);
+
+    private Q_SLOTS:
+        void init();
+        void testNaturalNumbers();
+        void testNaturalLongNumbers();
+        void testNaturalCase();
+        void testNaturalUnicode();
+        void testUnicodeNoCase();
+        void testUnicodeNoCaseNonAscii();
+        void testLocale();
+        void testUnknownLocale();
+        void testNamesCaseInsensitive();
+        void testInDatabase();
+};
+
+CollationsTest::CollationsTest()
+{
+}
+
+int CollationsTest::compare(const QString& collation, const QString& value1, const QString& value2)
+{
+    CollationManager::ComparatorPtr comparator = CollationManagerImpl::resolveNativeCollation(collation);
+    Q_ASSERT(comparator);
+
+    QByteArray utf1 = value1.toUtf8();
+    QByteArray utf2 = value2.toUtf8();
+    int result = comparator->compare(utf1.constData(), utf1.size(), utf2.constData(), utf2.size());
+    return (result > 0) - (result < 0);
+}
+
+void CollationsTest::init()
+{
+    initMocks();
+    initUtilsSql();
+}
+
+void CollationsTest::testNaturalNumbers()
+{
+    QCOMPARE(compare("NATURAL", "file2", "file10"), -1);
+    QCOMPARE(compare("NATURAL", "file10", "file2"), 1);
+    QCOMPARE(compare("NATURAL", "file02", "file2"), 0);
+    QCOMPARE(compare("NATURAL", "file2a", "file2b"), -1);
+    QCOMPARE(compare("NATURAL", "10", "9"), 1);
+    QCOMPARE(compare("NATURAL", "a", "a1"), -1);
+    QCOMPARE(compare("NATURAL", "", ""), 0);
+}
+
+void CollationsTest::testNaturalLongNumbers()
+{
+    // Numbers longer than any integer type must not overflow
+    QCOMPARE(compare("NATURAL", "x123456789012345678901234567890", "x99"), 1);
+    QCOMPARE(compare("NATURAL", "x123456789012345678901234567890", "x123456789012345678901234567891"), -1);
+    QCOMPARE(compare("NATURAL", "x000123456789012345678901234567890", "x123456789012345678901234567890"), 0);
+}
+
+void CollationsTest::testNaturalCase()
+{
+    QCOMPARE(compare("NATURAL", "File2", "file02"), 0);
+    QCOMPARE(compare("NATURAL", "ABC", "abd"), -1);
+}
+
+void CollationsTest::testNaturalUnicode()
+{
+    QCOMPARE(compare("NATURAL", QString::fromUtf8("żółw2"), QString::fromUtf8("żółw10")), -1);
+    QCOMPARE(compare("NATURAL", QString::fromUtf8("ŻÓŁW7"), QString::fromUtf8("żółw007")), 0);
+}
+
+void CollationsTest::testUnicodeNoCase()
+{
+    QCOMPARE(compare("UNICODE_NOCASE", "abc", "ABC"), 0);
+    QCOMPARE(compare("UNICODE_NOCASE", "abc", "ABD"), -1);
+    QCOMPARE(compare("UNICODE_NOCASE", "ab", "abc"), -1);
+    QCOMPARE(compare("UNICODE_NOCASE", "b", "A"), 1);
+    QCOMPARE(compare("UNICODE_NOCASE", "file10", "file2"), -1);
+}
+
+void CollationsTest::testUnicodeNoCaseNonAscii()
+{
+    QCOMPARE(compare("UNICODE_NOCASE", QString::fromUtf8("ŻÓŁW"), QString::fromUtf8("żółw")), 0);
+    QCOMPARE(compare("UNICODE_NOCASE", QString::fromUtf8("ÄBC"), QString::fromUtf8("äbd")), -1);
+    QCOMPARE(compare("UNICODE_NOCASE", QString::fromUtf8("żółw"), "abc"), 1);
+}
+
+void CollationsTest::testLocale()
+{
+    QCOMPARE(compare("LOCALE", "a", "b"), -1);
+    QCOMPARE(compare("LOCALE", "b", "a"), 1);
+    QCOMPARE(compare("LOCALE", "abc", "abc"), 0);
+
+    // Results depend on the collation support Qt was built with, so they are compared with QCollator itself
+    QString value1 = QString::fromUtf8("äpfel");
+    QString value2 = QString::fromUtf8("birne");
+    QCollator collator(QLocale("de_DE"));
+    int expected = collator.compare(value1, value2);
+    QCOMPARE(compare("LOCALE_de_DE", value1, value2), (expected > 0) - (expected < 0));
+
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    collator.setLocale(QLocale());
+    expected = collator.compare("Abc", "abc");
+    QCOMPARE(compare("LOCALE_NOCASE", "Abc", "abc"), (expected > 0) - (expected < 0));
+}
+
+void CollationsTest::testUnknownLocale()
+{
+    QVERIFY(!CollationManagerImpl::resolveNativeCollation("LOCALE_zz"));
+    QVERIFY(!CollationManagerImpl::resolveNativeCollation("NO_SUCH_COLLATION"));
+}
+
+void CollationsTest::testNamesCaseInsensitive()
+{
+    QVERIFY(CollationManagerImpl::resolveNativeCollation("natural"));
+    QVERIFY(CollationManagerImpl::resolveNativeCollation("Unicode_NoCase"));
+    QVERIFY(CollationManagerImpl::resolveNativeCollation("locale_pl"));
+}
+
+void CollationsTest::testInDatabase()
+{
+    Db* db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE files (name text);");
+    db->exec("INSERT INTO files VALUES ('file10'), ('File2'), ('file1');");
+
+    SqlQueryPtr results = db->exec("SELECT name FROM files ORDER BY name COLLATE NATURAL;");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->columnAsList<QString>(0), QList<QString>({"file1", "File2", "file10"}));
+
+    results = db->exec("SELECT count(*) FROM files WHERE name = 'FILE1' COLLATE UNICODE_NOCASE;");
+    QCOMPARE(results->getSingleCell().toInt(), 1);
+
+    db->close();
+    delete db;
+}
+
+QTEST_APPLESS_MAIN(CollationsTest)
+
+#include "tst_collationstest.moc"
@@ -0,0 +1,189 @@
+#include "db/columnarresults.h"
+#include <QString>
+#include <QtTest>
+
+class ColumnarResultsTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ColumnarResultsTest();
+
+    private:
+        void appendText(ColumnarResults& block, int col, const QString& value);
+
+    private Q_SLOTS:
+        void testTypedValues();
+        void testRowView();
+        void testRollbackRow();
+        void testLargeValues();
+        void testRollbackLargeValues();
+        void testFullByRows();
+        void testFullByBytes();
+};
+
+ColumnarResultsTest::ColumnarResultsTest()
+{
+}
+
+void ColumnarResultsTest::appendText(ColumnarResults& block, int col, const QString& value)
+{
+    block.appendText(col, value.constData(), value.size());
+}
+
+void ColumnarResultsTest::testTypedValues()
+{
+    ColumnarResults block({"i", "r", "t", "b", "n"});
+    QByteArray blob("\x00\x01\x02", 3);
+
+    block.appendInteger(0, 1234567890123LL);
+    block.appendReal(1, 2.5);
+    appendText(block, 2, "abc");
+    block.appendBlob(3, blob.constData(), blob.size());
+    block.appendNull(4);
+    block.finishRow();
+
+    block.appendInteger(0, -1);
+    block.appendReal(1, -0.25);
+    appendText(block, 2, "");
+    block.appendBlob(3, blob.constData(), 1);
+    block.appendNull(4);
+    block.finishRow();
+
+    QCOMPARE(block.rowCount(), 2);
+    QCOMPARE(block.columnCount(), 5);
+
+    QVERIFY(block.type(0, 0) == ColumnarResults::Type::INTEGER);
+    QVERIFY(block.type(0, 1) == ColumnarResults::Type::REAL);
+    QVERIFY(block.type(0, 2) == ColumnarResults::Type::TEXT);
+    QVERIFY(block.type(0, 3) == ColumnarResults::Type::BLOB);
+    QVERIFY(block.isNull(0, 4));
+
+    QCOMPARE(block.integer(0, 0), 1234567890123LL);
+    QCOMPARE(block.real(0, 1), 2.5);
+    QCOMPARE(block.value(0, 2).toString(), QString("abc"));
+    QCOMPARE(block.value(0, 3).toByteArray(), blob);
+    QVERIFY(block.value(0, 4).isNull());
+
+    QCOMPARE(block.integer(1, 0), -1LL);
+    QCOMPARE(block.real(1, 1), -0.25);
+    QCOMPARE(block.value(1, 2).toString(), QString());
+    QCOMPARE(block.value(1, 3).toByteArray(), blob.left(1));
+}
+
+void ColumnarResultsTest::testRowView()
+{
+    ColumnarResultsPtr block = ColumnarResultsPtr::create(QStringList({"a", "b"}));
+    block->appendInteger(0, 5);
+    appendText(*block, 1, "x");
+    block->finishRow();
+
+    ColumnarResultsRow row(block, 0);
+    QCOMPARE(row.value(0).toLongLong(), 5LL);
+    QCOMPARE(row.value("b").toString(), QString("x"));
+    QCOMPARE(row.valueList().size(), 2);
+    QCOMPARE(row.getRowIndex(), 0);
+}
+
+void ColumnarResultsTest::testRollbackRow()
+{
+    ColumnarResults block({"a", "b"});
+    appendText(block, 0, "first");
+    block.appendBlob(1, "12", 2);
+    block.finishRow();
+    qint64 bytes = block.byteCount();
+
+    appendText(block, 0, "second");
+    block.appendBlob(1, "345", 3);
+    block.rollbackRow();
+
+    QCOMPARE(block.rowCount(), 1);
+    QCOMPARE(block.byteCount(), bytes);
+
+    appendText(block, 0, "third");
+    block.appendBlob(1, "6", 1);
+    block.finishRow();
+
+    QCOMPARE(block.value(0, 0).toString(), QString("first"));
+    QCOMPARE(block.value(0, 1).toByteArray(), QByteArray("12"));
+    QCOMPARE(block.value(1, 0).toString(), QString("third"));
+    QCOMPARE(block.value(1, 1).toByteArray(), QByteArray("6"));
+}
+
+void ColumnarResultsTest::testLargeValues()
+{
+    ColumnarResults block({"t", "b"});
+    QString largeText(ColumnarResults::LARGE_VALUE_BYTES, 'x');
+    QByteArray largeBlob(ColumnarResults::LARGE_VALUE_BYTES, 'y');
+
+    appendText(block, 0, "small");
+    block.appendBlob(1, "s", 1);
+    block.finishRow();
+
+    appendText(block, 0, largeText);
+    block.appendBlob(1, largeBlob.constData(), largeBlob.size());
+    block.finishRow();
+
+    appendText(block, 0, "after");
+    block.appendBlob(1, "a", 1);
+    block.finishRow();
+
+    QCOMPARE(block.value(0, 0).toString(), QString("small"));
+    QCOMPARE(block.value(1, 0).toString(), largeText);
+    QCOMPARE(block.value(1, 1).toByteArray(), largeBlob);
+    QCOMPARE(block.value(2, 0).toString(), QString("after"));
+    QCOMPARE(block.value(2, 1).toByteArray(), QByteArray("a"));
+}
+
+void ColumnarResultsTest::testRollbackLargeValues()
+{
+    ColumnarResults block({"t"});
+    QString largeText(ColumnarResults::LARGE_VALUE_BYTES, 'x');
+
+    appendText(block, 0, largeText);
+    block.finishRow();
+
+    appendText(block, 0, largeText + "z");
+    block.rollbackRow();
+
+    appendText(block, 0, "short");
+    block.finishRow();
+
+    QCOMPARE(block.rowCount(), 2);
+    QCOMPARE(block.value(0, 0).toString(), largeText);
+    QCOMPARE(block.value(1, 0).toString(), QString("short"));
+}
+
+void ColumnarResultsTest::testFullByRows()
+{
+    ColumnarResults block({"a"}, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        QVERIFY(!block.isFull());
+        block.appendInteger(0, i);
+        block.finishRow();
+    }
+    QVERIFY(block.isFull());
+}
+
+void ColumnarResultsTest::testFullByBytes()
+{
+    ColumnarResults block({"b"});
+    QByteArray value(ColumnarResults::LARGE_VALUE_BYTES - 1, 'v');
+    int rows = 0;
+    while (!block.isFull())
+    {
+        block.appendBlob(0, value.constData(), value.size());
+        block.finishRow();
+        rows++;
+    }
+
+    QVERIFY(rows < ColumnarResults::DEFAULT_BLOCK_ROWS);
+    QVERIFY(block.byteCount() >= ColumnarResults::MAX_BLOCK_BYTES);
+    QVERIFY(block.byteCount() < ColumnarResults::MAX_BLOCK_BYTES + ColumnarResults::LARGE_VALUE_BYTES * 2);
+    QCOMPARE(block.value(rows - 1, 0).toByteArray(), value);
+}
+
+QTEST_APPLESS_MAIN(ColumnarResultsTest)
+
+#include "tst_columnarresultstest.moc"
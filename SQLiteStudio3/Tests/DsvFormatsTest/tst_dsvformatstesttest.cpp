@@ -5,6 +5,9 @@
 #include <QTextStream>
 #include "tsvserializer.h"
 #include "csvserializer.h"
+#include "csvreader.h"
+#include <QBuffer>
+#include <QTextCodec>
 
 // TODO Add tests for CsvSerializer
 
@@ -17,10 +20,13 @@ class DsvFormatsTestTest : public QObject
 
 private:
         QString toString(const QList<QStringList>& input);
+        QList<QStringList> readWithSerializer(const QByteArray& input, const CsvFormat& format);
+        QList<QStringList> readWithReader(const QByteArray& input, const CsvFormat& format, int blockSize);
 
         QList<QStringList> sampleData;
         QList<QStringList> sampleDeserializedData;
         QString sampleTsv;
+        QList<QByteArray> csvCorpus;
 
     private Q_SLOTS:
         void initTestCase();
@@ -35,6 +41,9 @@ private:
         void testCsv3Win();
         void testCsv3Mac();
         void testCsvPerformance();
+        void testCsvReaderSameAsSerializer();
+        void testCsvReaderByteArray();
+        void testCsvReaderPerformance();
 };
 
 DsvFormatsTestTest::DsvFormatsTestTest()
@@ -76,6 +85,28 @@ void DsvFormatsTestTest::initTestCase()
     sampleDeserializedData << QStringList{"a\"a\"", "\"b\"c\"", "d\"\"e"};
     sampleDeserializedData << QStringList{"a\na", "\"b", "c\"", "\"d", "\"\"e\""};
     sampleDeserializedData << QStringList{"a", "", "b", ""};
+
+    csvCorpus << "v1,v2\nv3,v4\n";
+    csvCorpus << "v1,v2\r\nv3,v4\r\n";
+    csvCorpus << "v1,v2\rv3,v4\r";
+    csvCorpus << "v1,v2\r\n\r\n\nv3,v4";
+    csvCorpus << "a,\"\"";
+    csvCorpus << "a,\"b\"";
+    csvCorpus << "\"\"";
+    csvCorpus << ",,\n,";
+    csvCorpus << "a,b,";
+    csvCorpus << "\"a\"\"b\",\"c\nd\",\"e,f\"\r\ng";
+    csvCorpus << "ab\"c,d\"e,f\"\"g\"";
+    csvCorpus << "\"unterminated,quote\nstill inside";
+    csvCorpus << "x\r";
+    csvCorpus << "\xEF\xBB\xBFbom,first\nrow,two";
+    csvCorpus << "za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87,\"g\xC4\x99\xC5\x9Bl\xC4\x85\"\n\xE2\x82\xAC,\xF0\x9F\x98\x80";
+
+    QByteArray longFields;
+    for (int i = 0; i < 200; i++)
+        longFields += "abcdefghijklmnopqrstuvwxyz0123456789,\"quoted \"\" value with, comma and\r\nnewline\",," + QByteArray::number(i) + "\r\n";
+
+    csvCorpus << longFields;
 }
 
 void DsvFormatsTestTest::cleanupTestCase()
@@ -227,6 +258,105 @@ void DsvFormatsTestTest::testCsvPerformance()
     qDebug() << "Deserialization time:" << time;
 }
 
+QList<QStringList> DsvFormatsTestTest::readWithSerializer(const QByteArray& input, const CsvFormat& format)
+{
+    QByteArray data = input;
+    QTextStream stream(&data);
+    stream.setCodec("UTF-8");
+
+    QList<QStringList> result;
+    QStringList entry;
+    while (!stream.atEnd())
+    {
+        entry = CsvSerializer::deserializeOneEntry(stream, format);
+        if (!entry.isEmpty())
+            result << entry;
+    }
+    return result;
+}
+
+QList<QStringList> DsvFormatsTestTest::readWithReader(const QByteArray& input, const CsvFormat& format, int blockSize)
+{
+    QBuffer buffer;
+    buffer.setData(input);
+    buffer.open(QIODevice::ReadOnly);
+    CsvReader reader(&buffer, format, QTextCodec::codecForName("UTF-8"), blockSize);
+
+    QList<QStringList> result;
+    QStringList entry;
+    while (!reader.atEnd())
+    {
+        entry = reader.readEntry();
+        if (!entry.isEmpty())
+            result << entry;
+    }
+    return result;
+}
+
+void DsvFormatsTestTest::testCsvReaderSameAsSerializer()
+{
+    CsvFormat importFormat(QStringList({";"}), QStringList({"\r\n", "\n", "\r"}));
+    importFormat.columnSeparator = ",";
+    importFormat.calculateSeparatorMaxLengths();
+
+    QList<CsvFormat> formats = {CsvFormat::DEFAULT, importFormat, CsvFormat(",;", "\n")};
+    for (const CsvFormat& format : formats)
+    {
+        QVERIFY(CsvReader::isSupported(format, QTextCodec::codecForName("UTF-8")));
+        for (const QByteArray& input : csvCorpus)
+        {
+            QList<QStringList> expected = readWithSerializer(input, format);
+            for (int blockSize : {16, CsvReader::DEFAULT_BLOCK_SIZE})
+            {
+                QList<QStringList> result = readWithReader(input, format, blockSize);
+                QVERIFY2(result == expected, QString("Input: %1\nSample: %2\nGot: %3").arg(QString::fromUtf8(input), toString(expected), toString(result))
+                         .toLocal8Bit().data());
+            }
+        }
+    }
+}
+
+void DsvFormatsTestTest::testCsvReaderByteArray()
+{
+    QByteArray data = "v1,\"v\"\"2\"\r\nv3,v4,\n";
+    QList<QList<QByteArray>> result = CsvSerializer::deserialize(data, CsvFormat::DEFAULT);
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result[0].size(), 2);
+    QCOMPARE(result[0][0], QByteArray("v1"));
+    QCOMPARE(result[0][1], QByteArray("v\"2"));
+    QCOMPARE(result[1].size(), 3);
+    QCOMPARE(result[1][0], QByteArray("v3"));
+    QCOMPARE(result[1][1], QByteArray("v4"));
+    QCOMPARE(result[1][2], QByteArray());
+}
+
+void DsvFormatsTestTest::testCsvReaderPerformance()
+{
+    QByteArray input;
+    for (int i = 0; i < 10000; i++)
+        input += "abc,d,g,\"jkl\nh\",mno\r\n";
+
+    QTemporaryFile theFile;
+    theFile.open();
+    theFile.write(input);
+    theFile.seek(0);
+
+    QElapsedTimer timer;
+    timer.start();
+    CsvReader reader(&theFile, CsvFormat::DEFAULT, QTextCodec::codecForName("UTF-8"));
+    QList<QStringList> result;
+    while (!reader.atEnd())
+        result << reader.readEntry();
+
+    int time = timer.elapsed();
+
+    QVERIFY(result.size() == 10000);
+    QVERIFY(result.first().size() == 5);
+    QVERIFY(result.last().size() == 5);
+
+    qDebug() << "Deserialization time:" << time;
+}
+
 QTEST_APPLESS_MAIN(DsvFormatsTestTest)
 
 #include "tst_dsvformatstesttest.moc"
@@ -0,0 +1,15 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_expiringcachetest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_expiringcachetest.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,206 @@
+#include "common/expiringcache.h"
+#include "common/utils_sql.h"
+#include "schemaresolver.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QThread>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class ExpiringCacheTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ExpiringCacheTest();
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void testInsertAndLookup();
+        void testReplace();
+        void testExpiration();
+        void testCostEviction();
+        void testTooExpensive();
+        void testTakeAndRemove();
+        void testClear();
+        void testSchemaCacheClearedForDb();
+        void testSchemaCacheForReattachedAlias();
+};
+
+ExpiringCacheTest::ExpiringCacheTest()
+{
+}
+
+void ExpiringCacheTest::testInsertAndLookup()
+{
+    ExpiringCache<QString, int> cache(10, 60000);
+    QVERIFY(cache.insert("a", new int(1)));
+    QVERIFY(cache.insert("b", new int(2)));
+
+    QVERIFY(cache.contains("a"));
+    QCOMPARE(*cache.object("a"), 1);
+    QCOMPARE(*cache["b"], 2);
+    QVERIFY(!cache.object("c"));
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(cache.totalCost(), 2);
+}
+
+void ExpiringCacheTest::testReplace()
+{
+    ExpiringCache<QString, int> cache(10, 60000);
+    cache.insert("a", new int(1), 3);
+    cache.insert("a", new int(2), 4);
+
+    QCOMPARE(*cache.object("a"), 2);
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.totalCost(), 4);
+}
+
+void ExpiringCacheTest::testExpiration()
+{
+    ExpiringCache<QString, int> cache(10, 50);
+    cache.insert("a", new int(1));
+    QVERIFY(cache.contains("a"));
+
+    QThread::msleep(100);
+    cache.insert("b", new int(2));
+
+    QVERIFY(!cache.contains("a"));
+    QVERIFY(cache.contains("b"));
+    QCOMPARE(cache.keys(), QList<QString>({"b"}));
+    QCOMPARE(cache.totalCost(), 1);
+}
+
+void ExpiringCacheTest::testCostEviction()
+{
+    ExpiringCache<QString, int> cache(3, 60000);
+    cache.insert("a", new int(1));
+    cache.insert("b", new int(2));
+    cache.insert("c", new int(3));
+
+    // Using "a" makes "b" the least recently used one.
+    QVERIFY(cache.object("a"));
+    cache.insert("d", new int(4));
+
+    QVERIFY(cache.contains("a"));
+    QVERIFY(!cache.contains("b"));
+    QVERIFY(cache.contains("c"));
+    QVERIFY(cache.contains("d"));
+
+    cache.insert("e", new int(5), 2);
+    QCOMPARE(cache.keys(), QList<QString>({"d", "e"}));
+    QCOMPARE(cache.totalCost(), 3);
+}
+
+void ExpiringCacheTest::testTooExpensive()
+{
+    ExpiringCache<QString, int> cache(3, 60000);
+    cache.insert("a", new int(1));
+
+    QVERIFY(!cache.insert("b", new int(2), 4));
+    QVERIFY(!cache.contains("b"));
+    QVERIFY(cache.contains("a"));
+}
+
+void ExpiringCacheTest::testTakeAndRemove()
+{
+    ExpiringCache<QString, int> cache(10, 60000);
+    cache.insert("a", new int(1));
+    cache.insert("b", new int(2));
+
+    int* taken = cache.take("a");
+    QVERIFY(taken);
+    QCOMPARE(*taken, 1);
+    delete taken;
+    QVERIFY(!cache.contains("a"));
+
+    QVERIFY(cache.remove("b"));
+    QVERIFY(!cache.remove("b"));
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+}
+
+void ExpiringCacheTest::testClear()
+{
+    ExpiringCache<QString, int> cache(10, 60000);
+    cache.insert("a", new int(1));
+    cache.insert("b", new int(2));
+    cache.clear();
+
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+
+    cache.insert("c", new int(3));
+    QCOMPARE(cache.keys(), QList<QString>({"c"}));
+}
+
+void ExpiringCacheTest::testSchemaCacheClearedForDb()
+{
+    // Both in-memory databases have the same name and the same schema version,
+    // so the first one's schema must not be served for the second one.
+    Db* db = new DbSqlite3Mock("cachetestdb");
+    db->open();
+    db->exec("CREATE TABLE first (id int);");
+    QVERIFY(SchemaResolver(db).getTables().contains("first"));
+    db->close();
+    delete db;
+
+    SchemaResolver::clearCache("cachetestdb");
+
+    db = new DbSqlite3Mock("cachetestdb");
+    db->open();
+    db->exec("CREATE TABLE second (id int);");
+    QStringList tables = SchemaResolver(db).getTables();
+    QVERIFY(tables.contains("second"));
+    QVERIFY(!tables.contains("first"));
+    db->close();
+    delete db;
+}
+
+void ExpiringCacheTest::testSchemaCacheForReattachedAlias()
+{
+    // Both files have the same schema version, so only the file tells their cached schemas apart.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    for (const QString& table : {QString("first"), QString("second")})
+    {
+        Db* fileDb = new DbSqlite3Mock(table, dir.filePath(table + ".db"));
+        fileDb->open();
+        fileDb->exec(QString("CREATE TABLE %1 (id int);").arg(table));
+        fileDb->close();
+        delete fileDb;
+    }
+
+    Db* db = new DbSqlite3Mock("attachtestdb");
+    db->open();
+    db->exec("ATTACH ? AS att;", {dir.filePath("first.db")});
+    QVERIFY(SchemaResolver(db).getTables("att").contains("first"));
+    db->exec("DETACH att;");
+
+    db->exec("ATTACH ? AS att;", {dir.filePath("second.db")});
+    QStringList tables = SchemaResolver(db).getTables("att");
+    QVERIFY(tables.contains("second"));
+    QVERIFY(!tables.contains("first"));
+    db->close();
+    delete db;
+}
+
+void ExpiringCacheTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void ExpiringCacheTest::init()
+{
+    initMocks();
+    initUtilsSql();
+}
+
+QTEST_APPLESS_MAIN(ExpiringCacheTest)
+
+#include "tst_expiringcachetest.moc"
@@ -0,0 +1,313 @@
+#include "importworker.h"
+#include "common/boundedqueue.h"
+#include "plugins/genericplugin.h"
+#include "plugins/importplugin.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/sqlquery.h"
+#include "common/utils_sql.h"
+#include "common/unused.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QThread>
+#include <QSignalSpy>
+#include <QtTest>
+
+class TestImportPlugin : public GenericPlugin, public ImportPlugin
+{
+        Q_OBJECT
+
+    public:
+        QString getDataSourceTypeName() const {return "test";}
+        ImportManager::StandardConfigFlags standardOptionsToEnable() const {return ImportManager::StandardConfigFlags();}
+        QString getFileFilter() const {return QString();}
+        CfgMain* getConfig() {return nullptr;}
+        QString getImportConfigFormName() const {return QString();}
+        bool validateOptions() {return true;}
+
+        bool beforeImport(const ImportManager::StandardImportConfig& config)
+        {
+            UNUSED(config);
+            threads << QThread::currentThread();
+            beforeCalls++;
+            nextRow = 0;
+            return startResult;
+        }
+
+        void afterImport()
+        {
+            threads << QThread::currentThread();
+            afterCalls++;
+        }
+
+        QList<ColumnDefinition> getColumns() const
+        {
+            return {{"id", "INTEGER"}, {"val", "TEXT"}};
+        }
+
+        QList<QVariant> next()
+        {
+            threads << QThread::currentThread();
+            if (nextRow >= rowsToProvide)
+                return QList<QVariant>();
+
+            int id = nextRow++;
+            return {id, QString("value %1").arg(id)};
+        }
+
+        int rowsToProvide = 0;
+        bool startResult = true;
+        int beforeCalls = 0;
+        int afterCalls = 0;
+        QSet<QThread*> threads;
+
+    private:
+        int nextRow = 0;
+};
+
+class QueueProducer : public QThread
+{
+    public:
+        QueueProducer(BoundedQueue<int>* queue, int count) :
+            queue(queue), count(count)
+        {
+        }
+
+        int pushed = 0;
+
+    protected:
+        void run()
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if (!queue->push(i))
+                    return;
+
+                pushed++;
+            }
+            queue->close();
+        }
+
+    private:
+        BoundedQueue<int>* queue = nullptr;
+        int count = 0;
+};
+
+class ImportWorkerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ImportWorkerTest();
+
+    private:
+        bool runImport(int rows, int rowsPerInsert, int bufferedBatches, int& rowCount);
+        int countRows();
+
+        Db* db = nullptr;
+        TestImportPlugin* plugin = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testQueueOrder();
+        void testQueueClose();
+        void testQueueAbort();
+        void testQueueProducerThread();
+        void testQueueAbortUnblocksProducer();
+        void testUnbufferedImport();
+        void testBufferedImport();
+        void testBufferedImportEmptyInput();
+        void testBufferedImportPluginFails();
+        void testUnbufferedImportPluginFails();
+};
+
+ImportWorkerTest::ImportWorkerTest()
+{
+}
+
+bool ImportWorkerTest::runImport(int rows, int rowsPerInsert, int bufferedBatches, int& rowCount)
+{
+    plugin->rowsToProvide = rows;
+
+    ImportManager::StandardImportConfig config;
+    config.rowsPerInsert = rowsPerInsert;
+    config.bufferedBatches = bufferedBatches;
+
+    ImportWorker worker(plugin, &config, db, "imported");
+    QSignalSpy spy(&worker, SIGNAL(finished(bool,int)));
+    worker.run();
+
+    Q_ASSERT(spy.size() == 1);
+    rowCount = spy.first()[1].toInt();
+    return spy.first()[0].toBool();
+}
+
+int ImportWorkerTest::countRows()
+{
+    return db->exec("SELECT count(*) FROM imported")->getSingleCell().toInt();
+}
+
+void ImportWorkerTest::testQueueOrder()
+{
+    BoundedQueue<int> queue(3);
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    QVERIFY(queue.push(3));
+
+    int value = 0;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(queue.push(4));
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 2);
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 3);
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 4);
+}
+
+void ImportWorkerTest::testQueueClose()
+{
+    BoundedQueue<int> queue(3);
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    queue.close();
+    QVERIFY(!queue.push(3));
+
+    int value = 0;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 2);
+    QVERIFY(!queue.pop(value));
+}
+
+void ImportWorkerTest::testQueueAbort()
+{
+    BoundedQueue<int> queue(3);
+    QVERIFY(queue.push(1));
+    queue.abort();
+
+    int value = 0;
+    QVERIFY(!queue.pop(value));
+    QVERIFY(!queue.push(2));
+}
+
+void ImportWorkerTest::testQueueProducerThread()
+{
+    BoundedQueue<int> queue(2);
+    QueueProducer producer(&queue, 1000);
+    producer.start();
+
+    int value = 0;
+    int expected = 0;
+    while (queue.pop(value))
+        QCOMPARE(value, expected++);
+
+    QVERIFY(producer.wait(5000));
+    QCOMPARE(expected, 1000);
+    QCOMPARE(producer.pushed, 1000);
+}
+
+void ImportWorkerTest::testQueueAbortUnblocksProducer()
+{
+    BoundedQueue<int> queue(2);
+    QueueProducer producer(&queue, 1000);
+    producer.start();
+
+    int value = 0;
+    QVERIFY(queue.pop(value));
+    queue.abort();
+
+    QVERIFY(producer.wait(5000));
+    QVERIFY(producer.pushed < 1000);
+}
+
+void ImportWorkerTest::testUnbufferedImport()
+{
+    int rowCount = 0;
+    QVERIFY(runImport(10, 3, 0, rowCount));
+    QCOMPARE(rowCount, 10);
+    QCOMPARE(countRows(), 10);
+    QCOMPARE(plugin->beforeCalls, 1);
+    QCOMPARE(plugin->afterCalls, 1);
+    QCOMPARE(plugin->threads, QSet<QThread*>({QThread::currentThread()}));
+}
+
+void ImportWorkerTest::testBufferedImport()
+{
+    int rowCount = 0;
+    QVERIFY(runImport(1000, 7, 2, rowCount));
+    QCOMPARE(rowCount, 1000);
+    QCOMPARE(countRows(), 1000);
+    QCOMPARE(db->exec("SELECT val FROM imported WHERE id = 999")->getSingleCell().toString(), QString("value 999"));
+    QCOMPARE(plugin->beforeCalls, 1);
+    QCOMPARE(plugin->afterCalls, 1);
+
+    // All plugin calls are made from the single reader thread.
+    QCOMPARE(plugin->threads.size(), 1);
+    QVERIFY(!plugin->threads.contains(QThread::currentThread()));
+}
+
+void ImportWorkerTest::testBufferedImportEmptyInput()
+{
+    int rowCount = 0;
+    QVERIFY(runImport(0, 7, 2, rowCount));
+    QCOMPARE(rowCount, 0);
+    QCOMPARE(countRows(), 0);
+    QCOMPARE(plugin->afterCalls, 1);
+}
+
+void ImportWorkerTest::testBufferedImportPluginFails()
+{
+    plugin->startResult = false;
+
+    int rowCount = 0;
+    QVERIFY(!runImport(10, 3, 2, rowCount));
+    QCOMPARE(rowCount, 0);
+    QCOMPARE(plugin->beforeCalls, 1);
+    QCOMPARE(plugin->afterCalls, 0);
+}
+
+void ImportWorkerTest::testUnbufferedImportPluginFails()
+{
+    plugin->startResult = false;
+
+    int rowCount = 0;
+    QVERIFY(!runImport(10, 3, 0, rowCount));
+    QCOMPARE(rowCount, 0);
+    QCOMPARE(plugin->beforeCalls, 1);
+    QCOMPARE(plugin->afterCalls, 0);
+}
+
+void ImportWorkerTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void ImportWorkerTest::init()
+{
+    initMocks();
+    initUtilsSql();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    plugin = new TestImportPlugin();
+}
+
+void ImportWorkerTest::cleanup()
+{
+    delete plugin;
+    plugin = nullptr;
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+QTEST_APPLESS_MAIN(ImportWorkerTest)
+
+#include "tst_importworkertest.moc"
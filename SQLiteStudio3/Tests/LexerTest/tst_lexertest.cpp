@@ -1,4 +1,6 @@
 #include "parser/lexer.h"
+#include "parser/keywords.h"
+#include "parser/sqlite3_parse.h"
 #include <QString>
 #include <QtTest>
 
@@ -16,6 +18,8 @@ class LexerTest : public QObject
         void testHex1();
         void testHex2();
         void testBindParam1();
+        void testRawTokens();
+        void testKeywordLookup();
 };
 
 LexerTest::LexerTest()
@@ -89,6 +93,51 @@ void LexerTest::testBindParam1()
     QVERIFY(bindTokens[4]->value == "@id");
 }
 
+void LexerTest::testRawTokens()
+{
+    QString sql = "SELECT a, 'x''y', [b c], X'1F' FROM test -- comment\n"
+                  "WHERE id = :id AND val >= 1.5e3 /* unfinished";
+
+    for (bool tolerant : {false, true})
+    {
+        Lexer lex;
+        lex.setTolerantMode(tolerant);
+        TokenList tokens = lex.process(sql);
+        RawTokenList rawTokens = Lexer::tokenizeRaw(sql, tolerant);
+        QCOMPARE(rawTokens.size(), tokens.size());
+        for (int i = 0; i < tokens.size(); i++)
+        {
+            QCOMPARE(rawTokens[i].type, tokens[i]->type);
+            QCOMPARE(rawTokens[i].lemonType, tokens[i]->lemonType);
+            QCOMPARE(static_cast<qint64>(rawTokens[i].start), tokens[i]->start);
+            QCOMPARE(sql.mid(rawTokens[i].start, rawTokens[i].length), tokens[i]->value);
+        }
+        QCOMPARE(rawTokens.last().invalid, tolerant);
+    }
+}
+
+void LexerTest::testKeywordLookup()
+{
+    initKeywords();
+    QHashIterator<QString,int> it(getKeywords3());
+    while (it.hasNext())
+    {
+        it.next();
+        QCOMPARE(getKeywordId3(it.key()), it.value());
+        QCOMPARE(getKeywordId3(it.key().toLower()), it.value());
+    }
+
+    QCOMPARE(getKeywordId3("SELECTX"), static_cast<int>(TK3_ID));
+    QCOMPARE(getKeywordId3("column1"), static_cast<int>(TK3_ID));
+    QCOMPARE(getKeywordId3(QString::fromUtf8("s\u00e9lect")), static_cast<int>(TK3_ID));
+    QCOMPARE(getKeywordId3(QString()), static_cast<int>(TK3_ID));
+
+    TokenList tokens = Lexer::tokenize("select Abc FROM");
+    QCOMPARE(tokens[0]->type, Token::KEYWORD);
+    QCOMPARE(tokens[2]->type, Token::OTHER);
+    QCOMPARE(tokens[4]->type, Token::KEYWORD);
+}
+
 QTEST_APPLESS_MAIN(LexerTest)
 
 #include "tst_lexertest.moc"
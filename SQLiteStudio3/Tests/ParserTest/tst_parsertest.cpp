@@ -7,6 +7,8 @@
 #include "parser/keywords.h"
 #include "parser/lexer.h"
 #include "parser/parsererror.h"
+#include "parser/incrementalparser.h"
+#include "parser/sqlstatementsplitter.h"
 #include "common/utils_sql.h"
 #include "parser/ast/sqlitewindowdefinition.h"
 #include "parser/ast/sqlitefilterover.h"
@@ -62,6 +64,8 @@ class ParserTest : public QObject
         void testUpdateFrom();
         void testStringAsTableId();
         void testJsonPtrOp();
+        void testIncrementalParser();
+        void testStatementSplitter();
 };
 
 ParserTest::ParserTest()
@@ -684,6 +688,87 @@ void ParserTest::testJsonPtrOp()
     QVERIFY(parser3->getErrors().isEmpty());
 }
 
+void ParserTest::testIncrementalParser()
+{
+    QString sql = "SELECT 1;\n"
+                  "CREATE TRIGGER tr AFTER INSERT ON t BEGIN SELECT 2; SELECT 3; END;\n"
+                  "SELECT 'a;b' FROM t;\n"
+                  "SELECT 4;";
+
+    IncrementalParser incrParser;
+    QVERIFY(incrParser.parse(sql));
+    QCOMPARE(incrParser.getStatements().size(), 4);
+
+    IncrementalParser::ResultsPtr firstResults = incrParser.getStatements()[0].results;
+
+    // Each edit is applied to the result of the previous one
+    QList<QPair<QString, QString>> edits = {
+        {"'a;b'", "'a;b', 5"},
+        {"'a;b'", "'a;b"},      // unterminated string swallows the rest
+        {"'a;b", "'a;b'"},
+        {"SELECT 4;", "SELECT 4 FROM;"},
+        {"END;", ""}            // trigger body swallows following statements
+    };
+
+    for (const QPair<QString, QString>& edit : edits)
+    {
+        sql.replace(edit.first, edit.second);
+        IncrementalParser freshParser;
+        QCOMPARE(incrParser.parse(sql), freshParser.parse(sql));
+
+        QStringList expected = splitQueries(sql);
+        QCOMPARE(incrParser.getStatements().size(), expected.size());
+        QCOMPARE(freshParser.getStatements().size(), expected.size());
+        for (int i = 0; i < expected.size(); i++)
+        {
+            QCOMPARE(incrParser.getStatementSql(i), expected[i]);
+            QCOMPARE(incrParser.getStatements()[i].start, freshParser.getStatements()[i].start);
+            QCOMPARE(incrParser.getStatements()[i].results->successful, freshParser.getStatements()[i].results->successful);
+        }
+        QCOMPARE(incrParser.getErrors().size(), freshParser.getErrors().size());
+
+        // First statement was never touched, so it was not parsed again
+        QVERIFY(incrParser.getStatements()[0].results == firstResults);
+    }
+}
+
+void ParserTest::testStatementSplitter()
+{
+    QStringList expected = {
+        "SELECT 'a;b';",
+        "\n-- c;\nSELECT [x;y] /* ; */ FROM t;",
+        " CREATE TEMP TRIGGER tr AFTER INSERT ON t BEGIN SELECT 1; UPDATE t SET a = \"b;c\"; END;"
+    };
+    QString remainder = " SELECT 2";
+    QString sql = expected.join("") + remainder;
+
+    // Statements must not depend on how the script is divided into parts
+    for (int partSize = 1; partSize <= 8; partSize++)
+    {
+        SqlStatementSplitter splitter;
+        QList<SqlStatementSplitter::Statement> statements;
+        for (int i = 0; i < sql.size(); i += partSize)
+        {
+            splitter.append(sql.mid(i, partSize));
+            while (splitter.hasStatement())
+                statements << splitter.takeStatement();
+        }
+
+        QCOMPARE(statements.size(), expected.size());
+        qint64 end = 0;
+        for (int i = 0; i < expected.size(); i++)
+        {
+            end += expected[i].size();
+            QCOMPARE(statements[i].sql, expected[i]);
+            QCOMPARE(statements[i].end, end);
+        }
+
+        SqlStatementSplitter::Statement last = splitter.takeRemainder();
+        QCOMPARE(last.sql, remainder);
+        QCOMPARE(last.end, static_cast<qint64>(sql.size()));
+    }
+}
+
 void ParserTest::initTestCase()
 {
     initKeywords();
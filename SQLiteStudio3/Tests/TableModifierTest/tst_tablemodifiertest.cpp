@@ -3,6 +3,7 @@
 #include "tablemodifier.h"
 #include "parser/parser.h"
 #include "db/db.h"
+#include "db/sqlquery.h"
 #include "dbsqlite3mock.h"
 #include "mocks.h"
 #include <QString>
@@ -34,6 +35,8 @@ class TableModifierTest : public QObject
         void testCase5();
         void testCase6();
         void testCase7();
+        void testChunkedCopy();
+        void testChunkedCopyWithFkAndTrigger();
 };
 
 TableModifierTest::TableModifierTest()
@@ -300,6 +303,92 @@ void TableModifierTest::testCase7()
     verifyRe("PRAGMA foreign_keys = 1;", sqls[i++]);
 }
 
+void TableModifierTest::testChunkedCopy()
+{
+    for (int i = 1; i <= 25; i++)
+        db->exec("INSERT INTO test VALUES (?, ?, ?);", {i, QString("v%1").arg(i), QVariant()});
+
+    TableModifier mod(db, "test");
+    createTable->columns[1]->name = "newCol";
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+    QHash<int,ChainExecutor::ChunkedQuery> chunked = mod.getChunkedQueries();
+
+    // Copy to temp table and copy back to the new table
+    QVERIFY(chunked.size() == 2);
+    QVERIFY(chunked.contains(1));
+    QVERIFY(chunked.contains(4));
+    verifyRe("CREATE TABLE sqlitestudio_temp_table.*AS SELECT \\* FROM test WHERE 0;", chunked[1].initQuery);
+    verifyRe("INSERT INTO sqlitestudio_temp_table.* SELECT \\* FROM test WHERE rowid BETWEEN :chunkFrom AND :chunkTo;", chunked[1].chunkQuery);
+    verifyRe("INSERT INTO test \\(id, newCol, val2\\) SELECT id, val, val2 FROM sqlitestudio_temp_table.* WHERE rowid BETWEEN :chunkFrom AND :chunkTo;",
+             chunked[4].chunkQuery);
+
+    ChainExecutor executor;
+    executor.setDb(db);
+    executor.setAsync(false);
+    executor.setChunkSize(10);
+    executor.setQueries(sqls);
+    executor.setChunkedQueries(chunked);
+    executor.exec();
+    QVERIFY(executor.getSuccessfulExecution());
+
+    SqlQueryPtr results = db->exec("SELECT count(*), sum(id), group_concat(newCol, '') FROM test;");
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toInt(), 25);
+    QCOMPARE(row->value(1).toInt(), 325);
+    QVERIFY(row->value(2).toString().startsWith("v1v2v3"));
+}
+
+void TableModifierTest::testChunkedCopyWithFkAndTrigger()
+{
+    db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
+    db->exec("CREATE TRIGGER t1 AFTER INSERT ON abc BEGIN UPDATE test SET val2 = new.xyz WHERE val = new.xyz; END;");
+    db->exec("CREATE TRIGGER t2 AFTER UPDATE OF val ON test BEGIN SELECT val FROM test; END;");
+    for (int i = 1; i <= 25; i++)
+    {
+        db->exec("INSERT INTO test VALUES (?, ?, ?);", {i, QString("v%1").arg(i), QVariant()});
+        db->exec("INSERT INTO abc VALUES (?, ?);", {i, QString("v%1").arg(i)});
+    }
+
+    TableModifier mod(db, "test");
+    createTable->columns[1]->name = "newCol";
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+    QHash<int,ChainExecutor::ChunkedQuery> chunked = mod.getChunkedQueries();
+
+    // Each chunked query must replace the statement copying the same data
+    QVERIFY(chunked.size() == 4);
+    for (auto it = chunked.cbegin(); it != chunked.cend(); ++it)
+    {
+        QVERIFY(it.key() < sqls.size());
+        QString sql = sqls[it.key()];
+        if (it->initQuery.isNull())
+        {
+            QString copySql = it->chunkQuery.left(it->chunkQuery.indexOf(" WHERE "));
+            QCOMPARE(sql, copySql + ";");
+        }
+        else
+        {
+            verifyRe("CREATE TABLE .* AS SELECT \\* FROM .*;", sql);
+            QCOMPARE(sql, QString(it->initQuery).replace(" WHERE 0;", ";"));
+        }
+    }
+
+    ChainExecutor executor;
+    executor.setDb(db);
+    executor.setAsync(false);
+    executor.setChunkSize(10);
+    executor.setQueries(sqls);
+    executor.setChunkedQueries(chunked);
+    executor.exec();
+    QVERIFY(executor.getSuccessfulExecution());
+
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt(), 25);
+    QCOMPARE(db->exec("SELECT count(*) FROM abc;")->getSingleCell().toInt(), 25);
+    QCOMPARE(db->exec("SELECT count(*) FROM test JOIN abc ON abc.xyz = test.newCol;")->getSingleCell().toInt(), 25);
+    QCOMPARE(db->exec("SELECT count(*) FROM sqlite_master WHERE type = 'trigger';")->getSingleCell().toInt(), 2);
+}
+
 void TableModifierTest::initTestCase()
 {
     initKeywords();
@@ -1,4 +1,5 @@
 #include "collationmanagermock.h"
+#include "services/impl/collationmanagerimpl.h"
 
 CollationManagerMock::CollationManagerMock()
 {
@@ -27,3 +28,13 @@ int CollationManagerMock::evaluateDefault(const QString&, const QString&)
 {
     return 0;
 }
+
+CollationManager::ComparatorPtr CollationManagerMock::resolveCollation(const QString& name)
+{
+    return CollationManagerImpl::resolveNativeCollation(name);
+}
+
+QStringList CollationManagerMock::getNativeCollationNames() const
+{
+    return {"LOCALE", "LOCALE_NOCASE", "NATURAL", "UNICODE_NOCASE"};
+}
@@ -13,6 +13,8 @@ class CollationManagerMock : public CollationManager
         QList<CollationPtr> getCollationsForDatabase(const QString&) const;
         int evaluate(const QString&, const QString&, const QString&);
         int evaluateDefault(const QString&, const QString&);
+        ComparatorPtr resolveCollation(const QString&);
+        QStringList getNativeCollationNames() const;
 };
 
 #endif // COLLATIONMANAGERMOCK_H
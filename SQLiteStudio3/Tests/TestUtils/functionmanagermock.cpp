@@ -24,6 +24,16 @@ QVariant FunctionManagerMock::evaluateScalar(const QString&, int, const QList<QV
     return QVariant();
 }
 
+FunctionManager::ResolvedFunctionPtr FunctionManagerMock::resolveScalar(const QString&, int)
+{
+    return ResolvedFunctionPtr();
+}
+
+FunctionManager::ResolvedAggregateFunctionPtr FunctionManagerMock::resolveAggregate(const QString&, int)
+{
+    return ResolvedAggregateFunctionPtr();
+}
+
 void FunctionManagerMock::evaluateAggregateInitial(const QString&, int, Db*, QHash<QString, QVariant>&)
 {
 }
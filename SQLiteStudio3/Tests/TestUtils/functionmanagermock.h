@@ -13,6 +13,8 @@ class FunctionManagerMock : public FunctionManager
         QList<ScriptFunction*> getScriptFunctionsForDatabase(const QString&) const;
         QList<NativeFunction*> getAllNativeFunctions() const;
         QVariant evaluateScalar(const QString&, int, const QList<QVariant>&, Db*, bool&);
+        ResolvedFunctionPtr resolveScalar(const QString&, int);
+        ResolvedAggregateFunctionPtr resolveAggregate(const QString&, int);
         void evaluateAggregateInitial(const QString&, int, Db*, QHash<QString, QVariant>&);
         void evaluateAggregateStep(const QString&, int, const QList<QVariant>&, Db*, QHash<QString, QVariant>&);
         QVariant evaluateAggregateFinal(const QString&, int, Db*, bool&, QHash<QString, QVariant>&);
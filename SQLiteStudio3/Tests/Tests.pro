@@ -29,6 +29,18 @@ lexer_test.depends = test_utils
 formatter.subdir = FormatterTest
 formatter.depends = test_utils
 
+columnar_results.subdir = ColumnarResultsTest
+columnar_results.depends = test_utils
+
+import_worker.subdir = ImportWorkerTest
+import_worker.depends = test_utils
+
+expiring_cache.subdir = ExpiringCacheTest
+expiring_cache.depends = test_utils
+
+collations.subdir = CollationsTest
+collations.depends = test_utils
+
 SUBDIRS += \
     test_utils \
     completion_helper \
@@ -39,4 +51,8 @@ SUBDIRS += \
     dsv \
     utils_test \
     lexer_test \
-    formatter
+    formatter \
+    columnar_results \
+    import_worker \
+    expiring_cache \
+    collations
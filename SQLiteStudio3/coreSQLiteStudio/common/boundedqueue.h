@@ -0,0 +1,95 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+
+/**
+ * @brief Fixed capacity queue for passing data between producer and consumer threads.
+ *
+ * The push() blocks while the queue is full and the pop() blocks while the queue is empty,
+ * so a fast producer cannot get too far ahead of the consumer (and the other way around).
+ *
+ * The producer calls close() once it has no more items. Consumer still receives all items
+ * that were already queued, then the pop() returns false. The consumer calls abort() when it stops
+ * consuming (for example because of an error), so the producer's next push() returns false
+ * and the producer can quit.
+ */
+template <class T>
+class BoundedQueue
+{
+    public:
+        explicit BoundedQueue(int capacity);
+
+        bool push(const T& item);
+        bool pop(T& item);
+        void close();
+        void abort();
+
+    private:
+        QQueue<T> queue;
+        QMutex mutex;
+        QWaitCondition notEmpty;
+        QWaitCondition notFull;
+        int capacity;
+        bool closed = false;
+        bool aborted = false;
+};
+
+template <class T>
+BoundedQueue<T>::BoundedQueue(int capacity)
+    : capacity(capacity)
+{
+    Q_ASSERT(capacity > 0);
+}
+
+template <class T>
+bool BoundedQueue<T>::push(const T& item)
+{
+    QMutexLocker locker(&mutex);
+    while (queue.size() >= capacity && !aborted)
+        notFull.wait(&mutex);
+
+    if (aborted || closed)
+        return false;
+
+    queue.enqueue(item);
+    notEmpty.wakeOne();
+    return true;
+}
+
+template <class T>
+bool BoundedQueue<T>::pop(T& item)
+{
+    QMutexLocker locker(&mutex);
+    while (queue.isEmpty() && !closed && !aborted)
+        notEmpty.wait(&mutex);
+
+    if (aborted || queue.isEmpty())
+        return false;
+
+    item = queue.dequeue();
+    notFull.wakeOne();
+    return true;
+}
+
+template <class T>
+void BoundedQueue<T>::close()
+{
+    QMutexLocker locker(&mutex);
+    closed = true;
+    notEmpty.wakeAll();
+}
+
+template <class T>
+void BoundedQueue<T>::abort()
+{
+    QMutexLocker locker(&mutex);
+    aborted = true;
+    queue.clear();
+    notEmpty.wakeAll();
+    notFull.wakeAll();
+}
+
+#endif // BOUNDEDQUEUE_H
@@ -1,13 +1,24 @@
 #ifndef EXPIRINGCACHE_H
 #define EXPIRINGCACHE_H
 
-#include <QCache>
+#include <QHash>
+#include <QList>
 #include <QDateTime>
 #include <QTimer>
 #include <QDebug>
 
+/**
+ * @brief Cache with cost limit (like QCache) and expiring entries.
+ *
+ * Every entry expires after the expire time since it was inserted. When the total cost of entries
+ * exceeds maximum cost, least recently used entries are removed.
+ *
+ * Entries are kept in a hash and are linked in two lists. One is in order of use (for cost limit eviction),
+ * the other one in order of insertion, which is also the order of expiration. Because of that, insertion,
+ * lookup and removal of expired entries are all O(1) (amortized), regardless of number of entries in cache.
+ */
 template <class K, class V>
-class ExpiringCache : public QCache<K, V>
+class ExpiringCache
 {
     public:
         ExpiringCache(int maxCost = 100, int expireMs = 1000);
@@ -24,90 +35,137 @@ class ExpiringCache : public QCache<K, V>
         void clear();
         bool isEmpty() const;
         void setExpireTime(int ms);
+        int maxCost() const;
+        void setMaxCost(int cost);
+        int totalCost() const;
 
     private:
-        bool expired(const K& key) const;
+        struct Node
+        {
+            K key;
+            V* object = nullptr;
+            int cost = 0;
+            qint64 expireAt = 0;
+            Node* usePrev = nullptr;
+            Node* useNext = nullptr;
+            Node* insertPrev = nullptr;
+            Node* insertNext = nullptr;
+        };
 
-        mutable QHash<K, qint64> expires;
+        ExpiringCache(const ExpiringCache&) = delete;
+        ExpiringCache& operator=(const ExpiringCache&) = delete;
+
+        Node* findValid(const K& key, bool noExpireCheck) const;
+        void touch(Node* node) const;
+        V* unlink(Node* node) const;
+        void removeExpired() const;
+        void trim(int cost);
+
+        mutable QHash<K, Node*> nodes;
+        mutable Node* mostRecentlyUsed = nullptr;
+        mutable Node* leastRecentlyUsed = nullptr;
+        mutable Node* oldest = nullptr;
+        mutable Node* newest = nullptr;
+        mutable int total = 0;
+        int maxCostValue;
         int expireMs;
 };
 
 template <class K, class V>
 ExpiringCache<K, V>::ExpiringCache(int maxCost, int expireMs) :
-    QCache<K, V>(maxCost), expireMs(expireMs)
+    maxCostValue(maxCost), expireMs(expireMs)
 {
 }
 
 template <class K, class V>
 ExpiringCache<K, V>::~ExpiringCache()
 {
+    clear();
 }
 
 template <class K, class V>
 bool ExpiringCache<K, V>::insert(const K& key, V* object, int cost)
 {
-    QList<K> keysBefore = QCache<K, V>::keys();
-    bool result = QCache<K, V>::insert(key, object, cost);
-    if (!result)
+    remove(key);
+    if (cost > maxCostValue)
+    {
+        delete object;
         return false;
+    }
 
-    QList<K> keysAfter = QCache<K, V>::keys();
+    removeExpired();
+    trim(maxCostValue - cost);
 
-    for (const K& keyBefore : keysBefore)
-    {
-        if (!keysAfter.contains(keyBefore))
-            expires.remove(keyBefore);
-    }
+    Node* node = new Node();
+    node->key = key;
+    node->object = object;
+    node->cost = cost;
+    node->expireAt = QDateTime::currentMSecsSinceEpoch() + expireMs;
+
+    node->insertPrev = newest;
+    if (newest)
+        newest->insertNext = node;
+    else
+        oldest = node;
+
+    newest = node;
 
-    expires[key] = QDateTime::currentMSecsSinceEpoch() + expireMs;
+    node->useNext = mostRecentlyUsed;
+    if (mostRecentlyUsed)
+        mostRecentlyUsed->usePrev = node;
+    else
+        leastRecentlyUsed = node;
+
+    mostRecentlyUsed = node;
+
+    nodes[key] = node;
+    total += cost;
     return true;
 }
 
 template <class K, class V>
 bool ExpiringCache<K, V>::contains(const K& key) const
 {
-    if (expired(key))
-        return false;
-
-    return QCache<K, V>::contains(key);
+    return findValid(key, false) != nullptr;
 }
 
 template <class K, class V>
 V* ExpiringCache<K, V>::object(const K& key, bool noExpireCheck) const
 {
-    if (!noExpireCheck && expired(key))
+    Node* node = findValid(key, noExpireCheck);
+    if (!node)
         return nullptr;
 
-    return QCache<K, V>::object(key);
+    touch(node);
+    return node->object;
 }
 
 template <class K, class V>
 V* ExpiringCache<K, V>::operator[](const K& key) const
 {
-    if (expired(key))
-        return nullptr;
-
-    return QCache<K, V>::operator[](key);
+    return object(key);
 }
 
 template <class K, class V>
 V* ExpiringCache<K, V>::take(const K& key)
 {
-    if (expired(key))
+    Node* node = findValid(key, false);
+    if (!node)
         return nullptr;
 
-    expires.remove(key);
-    return QCache<K, V>::take(key);
+    return unlink(node);
 }
 
 template <class K, class V>
 QList<K> ExpiringCache<K, V>::keys() const
 {
+    removeExpired();
+
     QList<K> keyList;
-    for (const K& key : QCache<K, V>::keys())
+    for (Node* node = oldest; node; node = node->insertNext)
     {
-        if (!expired(key))
-            keyList << key;
+        if (QDateTime::currentMSecsSinceEpoch() <= node->expireAt)
+            keyList << node->key;
     }
     return keyList;
 }
@@ -115,8 +173,12 @@ QList<K> ExpiringCache<K, V>::keys() const
 template <class K, class V>
 bool ExpiringCache<K, V>::remove(const K& key)
 {
-    expires.remove(key);
-    return QCache<K, V>::remove(key);
+    Node* node = nodes.value(key);
+    if (!node)
+        return false;
+
+    delete unlink(node);
+    return true;
 }
 
 template <class K, class V>
@@ -128,8 +190,18 @@ int ExpiringCache<K, V>::count() const
 template <class K, class V>
 void ExpiringCache<K, V>::clear()
 {
-    expires.clear();
-    QCache<K, V>::clear();
+    for (Node* node : nodes)
+    {
+        delete node->object;
+        delete node;
+    }
+
+    nodes.clear();
+    mostRecentlyUsed = nullptr;
+    leastRecentlyUsed = nullptr;
+    oldest = nullptr;
+    newest = nullptr;
+    total = 0;
 }
 
 template <class K, class V>
@@ -145,14 +217,104 @@ void ExpiringCache<K, V>::setExpireTime(int ms)
 }
 
 template <class K, class V>
-bool ExpiringCache<K, V>::expired(const K& key) const
+int ExpiringCache<K, V>::maxCost() const
+{
+    return maxCostValue;
+}
+
+template <class K, class V>
+void ExpiringCache<K, V>::setMaxCost(int cost)
+{
+    maxCostValue = cost;
+    trim(maxCostValue);
+}
+
+template <class K, class V>
+int ExpiringCache<K, V>::totalCost() const
 {
-    if (expires.contains(key) && QDateTime::currentMSecsSinceEpoch() > expires[key])
+    return total;
+}
+
+template <class K, class V>
+typename ExpiringCache<K, V>::Node* ExpiringCache<K, V>::findValid(const K& key, bool noExpireCheck) const
+{
+    Node* node = nodes.value(key);
+    if (!node)
+        return nullptr;
+
+    if (!noExpireCheck && QDateTime::currentMSecsSinceEpoch() > node->expireAt)
     {
-        expires.remove(key);
-        return true;
+        delete unlink(node);
+        return nullptr;
     }
-    return false;
+    return node;
+}
+
+template <class K, class V>
+void ExpiringCache<K, V>::touch(Node* node) const
+{
+    if (node == mostRecentlyUsed)
+        return;
+
+    // Detach from current position
+    node->usePrev->useNext = node->useNext;
+    if (node->useNext)
+        node->useNext->usePrev = node->usePrev;
+    else
+        leastRecentlyUsed = node->usePrev;
+
+    // Put in front
+    node->usePrev = nullptr;
+    node->useNext = mostRecentlyUsed;
+    mostRecentlyUsed->usePrev = node;
+    mostRecentlyUsed = node;
+}
+
+template <class K, class V>
+V* ExpiringCache<K, V>::unlink(Node* node) const
+{
+    if (node->usePrev)
+        node->usePrev->useNext = node->useNext;
+    else
+        mostRecentlyUsed = node->useNext;
+
+    if (node->useNext)
+        node->useNext->usePrev = node->usePrev;
+    else
+        leastRecentlyUsed = node->usePrev;
+
+    if (node->insertPrev)
+        node->insertPrev->insertNext = node->insertNext;
+    else
+        oldest = node->insertNext;
+
+    if (node->insertNext)
+        node->insertNext->insertPrev = node->insertPrev;
+    else
+        newest = node->insertPrev;
+
+    V* object = node->object;
+    total -= node->cost;
+    nodes.remove(node->key);
+    delete node;
+    return object;
+}
+
+template <class K, class V>
+void ExpiringCache<K, V>::removeExpired() const
+{
+    // Entries are in order of expiration (unless expire time was changed in meantime,
+    // but then remaining expired entries are still caught when they are looked up).
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (oldest && now > oldest->expireAt)
+        delete unlink(oldest);
+}
+
+template <class K, class V>
+void ExpiringCache<K, V>::trim(int cost)
+{
+    while (leastRecentlyUsed && total > cost)
+        delete unlink(leastRecentlyUsed);
 }
 
 #endif // EXPIRINGCACHE_H
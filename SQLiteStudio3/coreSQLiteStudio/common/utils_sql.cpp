@@ -703,13 +703,17 @@ QString getBindTokenName(const TokenPtr& token)
 }
 
 QueryAccessMode getQueryAccessMode(const QString& query, bool* isSelect)
+{
+    return getQueryAccessMode(Lexer::tokenize(query), isSelect);
+}
+
+QueryAccessMode getQueryAccessMode(const TokenList& tokens, bool* isSelect)
 {
     static QStringList readOnlyCommands = {"ANALYZE", "EXPLAIN", "PRAGMA", "SELECT"};
 
     if (isSelect)
         *isSelect = false;
 
-    TokenList tokens = Lexer::tokenize(query);
     int keywordIdx = tokens.indexOf(Token::KEYWORD);
     if (keywordIdx < 0)
         return QueryAccessMode::WRITE;
@@ -829,6 +833,42 @@ QString trimQueryEnd(const QString &query)
     return q;
 }
 
+QString getLeadingWord(const QString& query)
+{
+    // Skipping whitespaces and comments, without tokenizing whole query
+    const QChar* data = query.constData();
+    int size = query.size();
+    int i = 0;
+    while (i < size)
+    {
+        if (data[i].isSpace())
+        {
+            i++;
+        }
+        else if (data[i] == '-' && i + 1 < size && data[i+1] == '-')
+        {
+            while (i < size && data[i] != '\n')
+                i++;
+        }
+        else if (data[i] == '/' && i + 1 < size && data[i+1] == '*')
+        {
+            i += 2;
+            while (i < size && !(data[i] == '*' && i + 1 < size && data[i+1] == '/'))
+                i++;
+
+            i += 2;
+        }
+        else
+            break;
+    }
+
+    int start = i;
+    while (i < size && (data[i].isLetterOrNumber() || data[i] == '_'))
+        i++;
+
+    return query.mid(start, i - start);
+}
+
 SqliteDataType toSqliteDataType(const QString& typeStr)
 {
     QString upperType = typeStr.trimmed().toUpper();
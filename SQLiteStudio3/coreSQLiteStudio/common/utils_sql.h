@@ -87,8 +87,10 @@ API_EXPORT QString trimBindParamPrefix(const QString& param);
 API_EXPORT QString commentAllSqlLines(const QString& sql);
 API_EXPORT QString getBindTokenName(const TokenPtr& token);
 API_EXPORT QueryAccessMode getQueryAccessMode(const QString& query, bool* isSelect = nullptr);
+API_EXPORT QueryAccessMode getQueryAccessMode(const TokenList& tokens, bool* isSelect = nullptr);
 API_EXPORT QStringList valueListToSqlList(const QList<QVariant>& values);
 API_EXPORT QString trimQueryEnd(const QString& query);
+API_EXPORT QString getLeadingWord(const QString& query);
 
 
 #endif // UTILS_SQL_H
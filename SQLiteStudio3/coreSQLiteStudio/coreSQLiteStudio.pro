@@ -81,6 +81,8 @@ SOURCES += sqlitestudio.cpp \
     parser/sqlite3_parse.cpp \
     parser/parsercontext.cpp \
     parser/parser.cpp \
+    parser/incrementalparser.cpp \
+    parser/sqlstatementsplitter.cpp \
     parser/ast/sqlitestatement.cpp \
     parser/ast/sqlitequery.cpp \
     parser/ast/sqlitealtertable.cpp \
@@ -126,6 +128,10 @@ SOURCES += sqlitestudio.cpp \
     db/db.cpp \
     services/dbmanager.cpp \
     db/sqlresultsrow.cpp \
+    db/columnarresults.cpp \
+    db/sqlvaluebuffer.cpp \
+    db/sqlscriptexecutor.cpp \
+    db/sqlfunctionvalue.cpp \
     db/asyncqueryrunner.cpp \
     completionhelper.cpp \
     completioncomparer.cpp \
@@ -147,6 +153,7 @@ SOURCES += sqlitestudio.cpp \
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.cpp \
     csvformat.cpp \
     csvserializer.cpp \
+    csvreader.cpp \
     db/queryexecutorsteps/queryexecutordatasources.cpp \
     expectedtoken.cpp \
     sqlhistorymodel.cpp \
@@ -205,6 +212,7 @@ SOURCES += sqlitestudio.cpp \
     plugins/populatescript.cpp \
     plugins/builtinplugin.cpp \
     plugins/scriptingqtdbproxy.cpp \
+    plugins/scriptingthreadcontexts.cpp \
     plugins/sqlformatterplugin.cpp \
     services/updatemanager.cpp \
     config_builder/cfgmain.cpp \
@@ -259,6 +267,8 @@ HEADERS += sqlitestudio.h\
     parser/sqlite3_parse.h \
     parser/parsercontext.h \
     parser/parser.h \
+    parser/incrementalparser.h \
+    parser/sqlstatementsplitter.h \
     parser/ast/sqlitestatement.h \
     parser/ast/sqlitequery.h \
     parser/ast/sqlitealtertable.h \
@@ -301,11 +311,16 @@ HEADERS += sqlitestudio.h\
     parser/ast/sqliteattach.h \
     parser/parsererror.h \
     common/objectpool.h \
+    common/boundedqueue.h \
     selectresolver.h \
     schemaresolver.h \
     db/db.h \
     services/dbmanager.h \
     db/sqlresultsrow.h \
+    db/columnarresults.h \
+    db/sqlvaluebuffer.h \
+    db/sqlscriptexecutor.h \
+    db/sqlfunctionvalue.h \
     db/asyncqueryrunner.h \
     completionhelper.h \
     expectedtoken.h \
@@ -334,6 +349,7 @@ HEADERS += sqlitestudio.h\
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.h \
     csvformat.h \
     csvserializer.h \
+    csvreader.h \
     db/queryexecutorsteps/queryexecutordatasources.h \
     sqlhistorymodel.h \
     db/queryexecutorsteps/queryexecutorexplainmode.h \
@@ -406,6 +422,7 @@ HEADERS += sqlitestudio.h\
     plugins/populatescript.h \
     plugins/builtinplugin.h \
     plugins/scriptingqtdbproxy.h \
+    plugins/scriptingthreadcontexts.h \
     plugins/codeformatterplugin.h \
     services/updatemanager.h \
     config_builder/cfgmain.h \
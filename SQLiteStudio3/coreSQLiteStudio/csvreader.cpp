@@ -0,0 +1,363 @@
+#include "csvreader.h"
+#include <QIODevice>
+#include <QFile>
+#include <QTextCodec>
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_READER_SSE2
+#endif
+
+CsvReader::CsvReader(QIODevice* device, const CsvFormat& format, QTextCodec* codec, int blockSize) :
+    device(device), blockSize(qMax(blockSize, 16))
+{
+    init(format, codec);
+
+    QFile* file = qobject_cast<QFile*>(device);
+    if (file && file->size() > 0 && file->size() < INT_MAX)
+        mappedData = file->map(0, file->size());
+
+    reset();
+}
+
+CsvReader::CsvReader(const QByteArray& data, const CsvFormat& format, QTextCodec* codec) :
+    buffer(data)
+{
+    init(format, codec);
+    reset();
+}
+
+CsvReader::~CsvReader()
+{
+    if (mappedData)
+        static_cast<QFile*>(device)->unmap(mappedData);
+}
+
+bool CsvReader::isSupported(const CsvFormat& format, QTextCodec* codec)
+{
+    if (!codec)
+        codec = QTextCodec::codecForLocale();
+
+    // Encodings where bytes of ASCII range are never a part of any other character.
+    static const QList<QByteArray> prefixes = {"UTF-8", "ISO-8859-", "windows-125", "KOI8-", "US-ASCII"};
+    QByteArray name = codec->name();
+    bool asciiCompatible = false;
+    for (const QByteArray& prefix : prefixes)
+    {
+        if (name.startsWith(prefix))
+        {
+            asciiCompatible = true;
+            break;
+        }
+    }
+
+    if (!asciiCompatible)
+        return false;
+
+    // Lookahead of CsvSerializer is limited to the longest separator, which in some corner cases
+    // (quotes right after separators) makes it behave differently for separators longer than 2 characters.
+    int maxLength = qMax(format.maxColumnSeparatorLength, format.maxRowSeparatorLength);
+    if (maxLength > 2)
+        return false;
+
+    QStringList separators = format.columnSeparators + format.rowSeparators;
+    separators << format.columnSeparator << format.rowSeparator;
+    for (const QString& sep : separators)
+    {
+        if (sep.length() > maxLength)
+            return false;
+
+        for (const QChar& c : sep)
+        {
+            if (c.unicode() >= 0x80 || c == '"')
+                return false;
+        }
+    }
+    return true;
+}
+
+bool CsvReader::isValid() const
+{
+    return valid;
+}
+
+bool CsvReader::atEnd()
+{
+    return !fill(1);
+}
+
+bool CsvReader::readEntry(QList<QByteArray>& cells)
+{
+    cells.clear();
+
+    bool quotes = false;
+    bool sepAsLast = false;
+    int sepLength;
+    const char* quote;
+    QByteArray field;
+    while (fill(1))
+    {
+        sepAsLast = false;
+        if (quotes)
+        {
+            quote = static_cast<const char*>(memchr(data + pos, '"', dataSize - pos));
+            if (!quote)
+            {
+                field.append(data + pos, dataSize - pos);
+                pos = dataSize;
+                continue;
+            }
+
+            field.append(data + pos, quote - data - pos);
+            pos = quote - data + 1;
+            if (!fill(1))
+            {
+                // Closing quote at the very end of data
+                if (field.isEmpty())
+                    cells << field;
+
+                quotes = false;
+            }
+            else if (data[pos] == '"')
+            {
+                field.append('"');
+                pos++;
+            }
+            else
+            {
+                quotes = false;
+            }
+            continue;
+        }
+
+        int runLength = findSpecial();
+        if (runLength > 0)
+        {
+            field.append(data + pos, runLength);
+            pos += runLength;
+            continue;
+        }
+
+        if (data[pos] == '"')
+        {
+            quotes = true;
+            pos++;
+        }
+        else if ((sepLength = matchSeparator(columnSeparators)) > 0)
+        {
+            cells << field;
+            field.clear();
+            sepAsLast = true;
+            pos += sepLength;
+        }
+        else if ((sepLength = matchSeparator(rowSeparators)) > 0)
+        {
+            cells << field;
+            field.clear();
+            pos += sepLength;
+            break;
+        }
+        else
+        {
+            // First character of a separator, but not followed by the rest of it
+            field.append(data[pos++]);
+        }
+    }
+
+    if (field.size() > 0 || sepAsLast)
+        cells << field;
+
+    return !cells.isEmpty();
+}
+
+QStringList CsvReader::readEntry()
+{
+    QStringList values;
+    QList<QByteArray> cells;
+    if (!readEntry(cells))
+        return values;
+
+    for (const QByteArray& cell : cells)
+        values << decode(cell);
+
+    return values;
+}
+
+void CsvReader::reset()
+{
+    if (mappedData)
+    {
+        data = reinterpret_cast<const char*>(mappedData);
+        dataSize = static_cast<int>(static_cast<QFile*>(device)->size());
+    }
+    else if (device)
+    {
+        device->seek(0);
+        buffer.clear();
+        data = buffer.constData();
+        dataSize = 0;
+    }
+    else
+    {
+        data = buffer.constData();
+        dataSize = buffer.size();
+    }
+    pos = 0;
+    skipByteOrderMark();
+}
+
+QString CsvReader::decode(const QByteArray& value) const
+{
+    if (utf8)
+        return QString::fromUtf8(value);
+
+    return codec->toUnicode(value);
+}
+
+void CsvReader::init(const CsvFormat& format, QTextCodec* codec)
+{
+    this->codec = codec ? codec : QTextCodec::codecForLocale();
+    utf8 = (this->codec->mibEnum() == 106);
+
+    initSeparators(columnSeparators, format.strictColumnSeparator, format.multipleColumnSeparators,
+                   format.columnSeparator, format.columnSeparators);
+    initSeparators(rowSeparators, format.strictRowSeparator, format.multipleRowSeparators,
+                   format.rowSeparator, format.rowSeparators);
+
+    specialChars = "\"";
+    for (const Separators* seps : {&columnSeparators, &rowSeparators})
+    {
+        for (char c : seps->chars)
+        {
+            if (!specialChars.contains(c))
+                specialChars.append(c);
+        }
+    }
+
+    memset(specialTable, 0, sizeof(specialTable));
+    for (char c : specialChars)
+        specialTable[static_cast<uchar>(c)] = true;
+}
+
+void CsvReader::initSeparators(CsvReader::Separators& separators, bool strict, bool multiple, const QString& single, const QStringList& list)
+{
+    separators.strict = strict;
+    if (!strict)
+    {
+        // Any of characters is a separator
+        separators.chars = single.toLatin1();
+        return;
+    }
+
+    QStringList strings = multiple ? list : QStringList({single});
+    for (const QString& str : strings)
+    {
+        if (str.isEmpty())
+            continue;
+
+        separators.strings << str.toLatin1();
+        if (!separators.chars.contains(separators.strings.last()[0]))
+            separators.chars.append(separators.strings.last()[0]);
+    }
+}
+
+void CsvReader::skipByteOrderMark()
+{
+    if (!fill(4) && !fill(1))
+        return;
+
+    const uchar* bytes = reinterpret_cast<const uchar*>(data + pos);
+    int available = dataSize - pos;
+    if (available >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+    {
+        // QTextStream switches to UTF-8 when it finds its byte order mark
+        pos += 3;
+        codec = QTextCodec::codecForMib(106);
+        utf8 = true;
+        return;
+    }
+
+    if (available >= 2 && ((bytes[0] == 0xFF && bytes[1] == 0xFE) || (bytes[0] == 0xFE && bytes[1] == 0xFF)))
+        valid = false;
+    else if (available >= 4 && bytes[0] == 0 && bytes[1] == 0 && bytes[2] == 0xFE && bytes[3] == 0xFF)
+        valid = false;
+}
+
+bool CsvReader::fill(int bytes)
+{
+    if (dataSize - pos >= bytes)
+        return true;
+
+    if (!device || mappedData)
+        return false;
+
+    // Keep unread bytes and append next block after them
+    buffer.remove(0, pos);
+    pos = 0;
+    while (buffer.size() < bytes && !device->atEnd())
+    {
+        QByteArray block = device->read(blockSize);
+        if (block.isEmpty())
+            break;
+
+        buffer.append(block);
+    }
+
+    data = buffer.constData();
+    dataSize = buffer.size();
+    return dataSize >= bytes;
+}
+
+int CsvReader::findSpecial() const
+{
+    const char* start = data + pos;
+    int size = dataSize - pos;
+    int i = 0;
+
+#ifdef CSV_READER_SSE2
+    if (specialChars.size() <= 8)
+    {
+        __m128i needles[8];
+        int needleCount = specialChars.size();
+        for (int n = 0; n < needleCount; n++)
+            needles[n] = _mm_set1_epi8(specialChars[n]);
+
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(start + i));
+            __m128i matches = _mm_cmpeq_epi8(chunk, needles[0]);
+            for (int n = 1; n < needleCount; n++)
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, needles[n]));
+
+            int mask = _mm_movemask_epi8(matches);
+            if (mask != 0)
+                return i + qCountTrailingZeroBits(static_cast<quint32>(mask));
+        }
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+        if (specialTable[static_cast<uchar>(start[i])])
+            return i;
+    }
+    return size;
+}
+
+int CsvReader::matchSeparator(const CsvReader::Separators& separators)
+{
+    if (!separators.strict)
+        return separators.chars.contains(data[pos]) ? 1 : 0;
+
+    for (const QByteArray& sep : separators.strings)
+    {
+        if (sep[0] != data[pos] || !fill(sep.size()))
+            continue;
+
+        if (memcmp(data + pos, sep.constData(), sep.size()) == 0)
+            return sep.size();
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "csvformat.h"
+#include <QByteArray>
+#include <QStringList>
+
+class QIODevice;
+class QTextCodec;
+
+/**
+ * @brief Fast CSV reader working on raw bytes.
+ *
+ * It's an alternative to CsvSerializer::deserializeOneEntry() for inputs in ASCII-compatible encodings.
+ * Instead of reading the input character by character through QTextStream, it reads the input in big blocks
+ * (or maps the whole file into memory, if the device is a QFile), looks for quotes and separators
+ * with SSE2 instructions (16 bytes at once, with a scalar fallback on other platforms) and copies
+ * whole runs of bytes between them into fields. Fields are decoded into QString only once they are complete.
+ *
+ * Results are the same as from CsvSerializer, including handling of quotes in the middle of a field,
+ * escaped quotes and empty quoted field at the end of data. Since structural characters (quote and separators)
+ * are looked for as single bytes, the reader can be used only if all of them are ASCII characters
+ * and the encoding never uses ASCII bytes as a part of other characters. Use isSupported() to check it.
+ */
+class API_EXPORT CsvReader
+{
+    public:
+        /**
+         * @brief Number of bytes read from the device at once.
+         */
+        static const int DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+        /**
+         * @brief Creates reader for the device.
+         * @param device Opened device to read from. The reader doesn't take ownership of it.
+         * @param format CSV format to use.
+         * @param codec Text encoding of the input. If null, the locale encoding is used.
+         * @param blockSize Number of bytes to read from the device at once.
+         *
+         * If the device is a QFile, the file is mapped into memory, unless mapping fails,
+         * in which case it's read in blocks as any other device.
+         */
+        CsvReader(QIODevice* device, const CsvFormat& format, QTextCodec* codec = nullptr, int blockSize = DEFAULT_BLOCK_SIZE);
+
+        /**
+         * @brief Creates reader for data already in memory.
+         * @param data Data to read.
+         * @param format CSV format to use.
+         * @param codec Text encoding of the input. If null, the locale encoding is used.
+         */
+        CsvReader(const QByteArray& data, const CsvFormat& format, QTextCodec* codec = nullptr);
+
+        ~CsvReader();
+
+        /**
+         * @brief Tells if the reader can handle given format and encoding.
+         * @param format CSV format.
+         * @param codec Text encoding. If null, the locale encoding is checked.
+         * @return true if results of the reader will be identical to the results of CsvSerializer.
+         */
+        static bool isSupported(const CsvFormat& format, QTextCodec* codec = nullptr);
+
+        /**
+         * @brief Tells if the input can be read by this reader.
+         * @return false if the input starts with UTF-16 or UTF-32 byte order mark.
+         *
+         * QTextStream would switch to the encoding from the byte order mark, but this reader works only
+         * with ASCII-compatible encodings, so in that case the caller should fall back to CsvSerializer.
+         */
+        bool isValid() const;
+
+        bool atEnd();
+
+        /**
+         * @brief Reads next CSV entry (row) as raw bytes.
+         * @param cells List to fill with values of the entry. It's cleared first.
+         * @return true if there were any values, or false if there is no more data.
+         */
+        bool readEntry(QList<QByteArray>& cells);
+
+        /**
+         * @brief Reads next CSV entry (row) and decodes its values.
+         * @return Values of the entry, or empty list if there is no more data.
+         */
+        QStringList readEntry();
+
+        /**
+         * @brief Moves the reader to the beginning of the input.
+         */
+        void reset();
+
+        QString decode(const QByteArray& value) const;
+
+    private:
+        struct Separators
+        {
+            bool strict = false;
+            QByteArray chars;
+            QList<QByteArray> strings;
+        };
+
+        void init(const CsvFormat& format, QTextCodec* codec);
+        void initSeparators(Separators& separators, bool strict, bool multiple, const QString& single, const QStringList& list);
+        void skipByteOrderMark();
+        bool fill(int bytes);
+        int findSpecial() const;
+        int matchSeparator(const Separators& separators);
+
+        QIODevice* device = nullptr;
+        int blockSize = DEFAULT_BLOCK_SIZE;
+        uchar* mappedData = nullptr;
+        QByteArray buffer;
+        const char* data = nullptr;
+        int dataSize = 0;
+        int pos = 0;
+        bool valid = true;
+        QTextCodec* codec = nullptr;
+        bool utf8 = false;
+        Separators columnSeparators;
+        Separators rowSeparators;
+        QByteArray specialChars;
+        bool specialTable[256];
+};
+
+#endif // CSVREADER_H
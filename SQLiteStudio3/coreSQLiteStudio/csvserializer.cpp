@@ -1,4 +1,5 @@
 #include "csvserializer.h"
+#include "csvreader.h"
 #include <QStringList>
 #include <QList>
 #include <QDebug>
@@ -230,6 +231,13 @@ QStringList CsvSerializer::deserializeOneEntry(QTextStream& data, const CsvForma
 
 QList<QList<QByteArray>> CsvSerializer::deserialize(const QByteArray& data, const CsvFormat& format)
 {
+    if (CsvReader::isSupported(format))
+    {
+        CsvReader reader(data, format);
+        if (reader.isValid())
+            return deserializeWithReader(reader);
+    }
+
     QTextStream stream(data, QIODevice::ReadWrite);
     return typedDeserialize<QByteArray,char>(stream, format);
 }
@@ -252,3 +260,27 @@ QList<QStringList> CsvSerializer::deserialize(const QString& data, const CsvForm
     return deserialize(stream, format);
 }
 
+
+QList<QList<QByteArray>> CsvSerializer::deserializeWithReader(CsvReader& reader)
+{
+    QList<QList<QByteArray>> rows;
+    QList<QByteArray> cells;
+    while (reader.readEntry(cells))
+    {
+        // Legacy byte array results are characters decoded from the locale encoding, truncated to Latin-1,
+        // which only matters for non-ASCII values.
+        for (QByteArray& cell : cells)
+        {
+            for (char c : cell)
+            {
+                if (static_cast<uchar>(c) >= 0x80)
+                {
+                    cell = reader.decode(cell).toLatin1();
+                    break;
+                }
+            }
+        }
+        rows << cells;
+    }
+    return rows;
+}
@@ -6,6 +6,8 @@
 
 #include <QTextStream>
 
+class CsvReader;
+
 class API_EXPORT CsvSerializer
 {
     public:
@@ -15,6 +17,9 @@ class API_EXPORT CsvSerializer
         static QList<QList<QByteArray>> deserialize(const QByteArray& data, const CsvFormat& format);
         static QList<QStringList> deserialize(QTextStream& data, const CsvFormat& format);
         static QStringList deserializeOneEntry(QTextStream& data, const CsvFormat& format);
+
+    private:
+        static QList<QList<QByteArray>> deserializeWithReader(CsvReader& reader);
 };
 
 #endif // CSVSERIALIZER_H
@@ -10,6 +10,7 @@
 #include "services/sqliteextensionmanager.h"
 #include "parser/lexer.h"
 #include "common/compatibility.h"
+#include "common/unused.h"
 #include <QDebug>
 #include <QTime>
 #include <QWriteLocker>
@@ -38,6 +39,12 @@ bool AbstractDb::open()
     return res;
 }
 
+bool AbstractDb::isTransactionActive()
+{
+    // Drivers that can ask the connection for autocommit mode override this.
+    return true;
+}
+
 bool AbstractDb::close()
 {
     bool deny = false;
@@ -335,6 +342,16 @@ SqlQueryPtr AbstractDb::execHashArg(const QString& query, const QHash<QString,QV
     if (!isOpenInternal())
         return SqlQueryPtr(new SqlErrorResults(SqlErrorCode::DB_NOT_OPEN, tr("Cannot execute query on closed database.")));
 
+    Db* readDb = getReadConnection(query, flags);
+    if (readDb)
+    {
+        // Read connections are shared by many threads, so they always use their own lock
+        int interruptsBefore = interruptCounter.loadAcquire();
+        SqlQueryPtr results = readDb->exec(query, args, flags & ~Flags(Flag::NO_LOCK));
+        if (!isReadConnectionRetryNeeded(results, interruptsBefore))
+            return results;
+    }
+
     QString newQuery = query;
     SqlQueryPtr queryStmt = prepare(newQuery);
     queryStmt->setArgs(args);
@@ -352,6 +369,16 @@ SqlQueryPtr AbstractDb::execListArg(const QString& query, const QList<QVariant>&
     if (!isOpenInternal())
         return SqlQueryPtr(new SqlErrorResults(SqlErrorCode::DB_NOT_OPEN, tr("Cannot execute query on closed database.")));
 
+    Db* readDb = getReadConnection(query, flags);
+    if (readDb)
+    {
+        // Read connections are shared by many threads, so they always use their own lock
+        int interruptsBefore = interruptCounter.loadAcquire();
+        SqlQueryPtr results = readDb->exec(query, args, flags & ~Flags(Flag::NO_LOCK));
+        if (!isReadConnectionRetryNeeded(results, interruptsBefore))
+            return results;
+    }
+
     QString newQuery = query;
     SqlQueryPtr queryStmt = prepare(newQuery);
     queryStmt->setArgs(args);
@@ -386,6 +413,9 @@ bool AbstractDb::openAndSetup()
     // Custom collations
     registerAllCollations();
 
+    // Connections for parallel reading
+    openReadConnections();
+
     return result;
 }
 
@@ -393,6 +423,45 @@ void AbstractDb::initAfterOpen()
 {
 }
 
+void AbstractDb::openReadConnections()
+{
+}
+
+Db* AbstractDb::getReadConnection(const QString& query, Flags flags)
+{
+    UNUSED(query);
+    UNUSED(flags);
+    return nullptr;
+}
+
+bool AbstractDb::isReadConnectionRetryNeeded(SqlQueryPtr results, int interruptsBefore) const
+{
+    static const QStringList missingObjectErrors = {
+        QStringLiteral("no such table"),
+        QStringLiteral("no such function"),
+        QStringLiteral("no such collation sequence"),
+        QStringLiteral("no such module"),
+        QStringLiteral("unknown database")
+    };
+
+    if (!results->isError())
+        return false;
+
+    // Interrupted query should not be started again, where nothing interrupts it
+    if (results->isInterrupted() || interruptCounter.loadAcquire() != interruptsBefore)
+        return false;
+
+    // The query may refer to something that exists only in this connection (like a temporary table),
+    // so it has to be executed here again. Any other error would be just repeated.
+    QString errorText = results->getErrorText();
+    for (const QString& error : missingObjectErrors)
+    {
+        if (errorText.startsWith(error, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
+
 void AbstractDb::checkForDroppedObject(const QString& query)
 {
     TokenList tokens = Lexer::tokenize(query);
@@ -739,6 +808,62 @@ bool AbstractDb::initAfterCreated()
     return true;
 }
 
+bool AbstractDb::copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                  QString& errorMessage)
+{
+    // Generic implementation, going through regular queries. Drivers can do it much faster with their native API.
+    SqlQueryPtr results = prepare(selectQuery);
+    if (!results->execute())
+    {
+        errorMessage = results->getErrorText();
+        return false;
+    }
+
+    SqlQueryPtr insert = dstDb->prepare(insertQuery);
+    SqlResultsRowPtr row;
+    int i = 0;
+    while (results->hasNext())
+    {
+        row = results->next();
+        if (!row)
+        {
+            errorMessage = results->getErrorText();
+            return false;
+        }
+
+        insert->setArgs(row->valueList());
+        if (!insert->execute())
+        {
+            errorMessage = insert->getErrorText();
+            return false;
+        }
+
+        if ((++i % COPY_BATCH_ROWS) == 0 && interrupted())
+            return false;
+    }
+    return !interrupted();
+}
+
+bool AbstractDb::insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage)
+{
+    SqlQueryPtr insert = prepare(insertQuery);
+    QList<QVariant> args;
+    for (int row = 0, rowCount = rows.getRowCount(); row < rowCount; row++)
+    {
+        args.clear();
+        for (int col = 0, colCount = rows.getColumnCount(); col < colCount; col++)
+            args << rows.toVariant(row, col);
+
+        insert->setArgs(args);
+        if (!insert->execute())
+        {
+            errorMessage = insert->getErrorText();
+            return false;
+        }
+    }
+    return true;
+}
+
 void AbstractDb::setTimeout(int secs)
 {
     timeout = secs;
@@ -823,6 +948,7 @@ void AbstractDb::interrupt()
     // Lock connection state to forbid closing db before interrupt() returns.
     // This is required by SQLite.
     QWriteLocker locker(&connectionStateLock);
+    interruptCounter.ref();
     interruptExecution();
 }
 
@@ -7,6 +7,7 @@
 #include "common/bihash.h"
 #include "services/functionmanager.h"
 #include "common/readwritelocker.h"
+#include "db/sqlvaluebuffer.h"
 #include "coreSQLiteStudio_global.h"
 #include <QObject>
 #include <QVariant>
@@ -15,6 +16,7 @@
 #include <QSet>
 #include <QReadWriteLock>
 #include <QRunnable>
+#include <QAtomicInt>
 #include <QStringList>
 
 class AsyncQueryRunner;
@@ -44,6 +46,7 @@ class API_EXPORT AbstractDb : public Db
         virtual ~AbstractDb();
 
         bool isOpen();
+        bool isTransactionActive();
         QString getName() const;
         QString getPath() const;
         quint8 getVersion() const;
@@ -85,13 +88,42 @@ class API_EXPORT AbstractDb : public Db
         int getTimeout() const;
         bool isValid() const;
         void loadExtensions();
+        bool copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                              QString& errorMessage);
+        bool insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage);
 
     protected:
+        /**
+         * @brief Number of rows copied by copyQueryResults() between checks for interruption.
+         *
+         * It's also the number of rows passed at once to insertRows() of other database.
+         */
+        static const int COPY_BATCH_ROWS = 1000;
+
+        /**
+         * @brief Size of text and blob data, above which a batch of copied rows is passed to insertRows() earlier.
+         */
+        static const int COPY_BATCH_BYTES = 16 * 1024 * 1024;
+
         struct FunctionUserData
         {
             QString name;
             int argCount = 0;
             Db* db = nullptr;
+
+            /**
+             * @brief Function resolved at registration, used for scalar functions.
+             *
+             * If it's null, the function is evaluated by name, with QVariant arguments.
+             */
+            FunctionManager::ResolvedFunctionPtr resolvedFunction;
+
+            /**
+             * @brief Function resolved at registration, used for aggregate functions.
+             *
+             * If it's null, the function is evaluated by name, with the QHash based aggregate context.
+             */
+            FunctionManager::ResolvedAggregateFunctionPtr resolvedAggregate;
         };
 
         virtual QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
@@ -203,6 +235,25 @@ class API_EXPORT AbstractDb : public Db
 
         virtual void initAfterOpen();
 
+        /**
+         * @brief Opens additional connections used for reading.
+         *
+         * Called by openAndSetup() when the database is fully initialized. Default implementation does nothing.
+         * See DB_READ_POOL_SIZE for details.
+         */
+        virtual void openReadConnections();
+
+        /**
+         * @brief Provides additional connection to execute the query in.
+         * @param query Query to be executed.
+         * @param flags Execution flags.
+         * @return Connection to execute query in, or null if the query should be executed in this connection.
+         *
+         * Default implementation always returns null. If the query fails in the returned connection, because it refers
+         * to an object missing in that connection, the query is executed again in this connection.
+         */
+        virtual Db* getReadConnection(const QString& query, Flags flags);
+
         void checkForDroppedObject(const QString& query);
         bool registerCollation(const QString& name);
         bool deregisterCollation(const QString& name);
@@ -419,6 +470,14 @@ class API_EXPORT AbstractDb : public Db
          */
         void registerFunction(const RegisteredFunction& function);
 
+        /**
+         * @brief Tells if query that failed in a read connection should be executed again in this connection.
+         * @param results Results of the query from the read connection.
+         * @param interruptsBefore Value of interruptCounter from before the query was executed.
+         * @return true if the query failed only because the read connection doesn't know some object, false otherwise.
+         */
+        bool isReadConnectionRetryNeeded(SqlQueryPtr results, int interruptsBefore) const;
+
         /**
          * @brief Connection state lock.
          *
@@ -427,6 +486,13 @@ class API_EXPORT AbstractDb : public Db
          */
         QReadWriteLock connectionStateLock;
 
+        /**
+         * @brief Number of interrupt() calls made so far.
+         *
+         * Used to tell whether a query failed in the read connection because it was interrupted.
+         */
+        QAtomicInt interruptCounter;
+
         /**
          * @brief Sequence container for generating unique asynchronous IDs.
          */
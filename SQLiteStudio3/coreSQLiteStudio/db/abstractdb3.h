@@ -8,9 +8,13 @@
 #include "services/collationmanager.h"
 #include "sqlitestudio.h"
 #include "db/sqlerrorcodes.h"
+#include "db/columnarresults.h"
 #include "log.h"
 #include <QThread>
 #include <QPointer>
+#include <QVarLengthArray>
+#include <QReadWriteLock>
+#include <QAtomicInt>
 #include <QDebug>
 
 /**
@@ -46,7 +50,11 @@ class AbstractDb3 : public AbstractDb
 
         bool loadExtension(const QString& filePath, const QString& initFunc = QString());
         bool isComplete(const QString& sql) const;
+        bool isTransactionActive();
         QList<AliasedColumn> columnsForQuery(const QString& query);
+        bool copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                              QString& errorMessage);
+        bool insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage);
 
     protected:
         bool isOpenInternal();
@@ -64,6 +72,17 @@ class AbstractDb3 : public AbstractDb
         bool registerAggregateFunction(const QString& name, int argCount, bool deterministic);
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
+        void openReadConnections();
+        Db* getReadConnection(const QString& query, Flags flags);
+
+        /**
+         * @brief Creates new instance of the same database type, to be used as an additional connection for reading.
+         * @param options Connection options for the new instance.
+         * @return New, not yet open instance, or null if the database type doesn't support additional connections.
+         *
+         * Default implementation returns null. See DB_READ_POOL_SIZE for details.
+         */
+        virtual AbstractDb3<T>* createReadConnection(const QHash<QString, QVariant>& options);
 
     private:
         class Query : public SqlQuery
@@ -74,6 +93,14 @@ class AbstractDb3 : public AbstractDb
                     public:
                         int init(const QStringList& columns, typename T::stmt* stmt, Db::Flags flags);
 
+                        /**
+                         * @brief Appends current row of the statement to the columnar block.
+                         * @param block Block to append to. It must not be full.
+                         * @param stmt Statement to read values from.
+                         * @return T::OK on success.
+                         */
+                        static int appendTo(ColumnarResults& block, typename T::stmt* stmt);
+
                     private:
                         int getValue(typename T::stmt* stmt, int col, QVariant& value, Db::Flags flags);
                 };
@@ -86,6 +113,7 @@ class AbstractDb3 : public AbstractDb
                 QStringList getColumnNames();
                 int columnCount();
                 qint64 rowsAffected();
+                StatementStats getStatementStats();
                 void finalize();
 
             protected:
@@ -95,6 +123,35 @@ class AbstractDb3 : public AbstractDb
                 bool execInternal(const QHash<QString, QVariant>& args);
 
             private:
+                /**
+                 * @brief Details of the query, which don't change between its executions.
+                 *
+                 * The same query is often executed many times in a row (importing, populating, copying data),
+                 * so details that require tokenizing of the query are determined only at the first execution.
+                 * Parameters are read from the prepared statement.
+                 */
+                struct Metadata
+                {
+                    bool initialized = false;
+                    ReadWriteLocker::Mode lockMode = ReadWriteLocker::WRITE;
+
+                    /**
+                     * @brief True if the query may be a DROP statement, so dropped objects need to be checked after execution.
+                     */
+                    bool mayDropObject = false;
+
+                    int paramCount = 0;
+
+                    /**
+                     * @brief Parameter names, in order of indexes, with prefix characters (like ":").
+                     *
+                     * Parameters without name have "?" here.
+                     */
+                    QStringList paramNames;
+                };
+
+                SqlResultsRowPtr nextColumnarInternal();
+                void initMetadata();
                 int prepareStmt();
                 int resetStmt();
                 int bindParam(int paramIdx, const QVariant& value);
@@ -112,17 +169,59 @@ class AbstractDb3 : public AbstractDb
                 int colCount = 0;
                 QStringList colNames;
                 bool rowAvailable = false;
+                Metadata metadata;
+
+                /**
+                 * @brief Block that rows are appended to in Db::Flag::COLUMNAR_RESULTS mode.
+                 *
+                 * Rows returned earlier keep their own reference to the block, so once the block is full
+                 * it's simply replaced by a new one.
+                 */
+                ColumnarResultsPtr columnarBlock;
         };
 
         struct CollationUserData
         {
             QString name;
             AbstractDb3<T>* db = nullptr;
+
+            /**
+             * @brief Collation implementation resolved at registration.
+             *
+             * If it's null, the collation is evaluated by its name with CollationManager::evaluate().
+             */
+            CollationManager::ComparatorPtr comparator;
         };
 
         QString extractLastError();
         void cleanUp();
         void resetError();
+        void closeReadConnections();
+
+        /**
+         * @brief Prepares statement directly with SQLite API, without creating Query object.
+         * @param query Query to prepare.
+         * @param errorMessage Filled with the error details if preparing failed.
+         * @return Prepared statement, or null on failure. It has to be finalized by the caller.
+         */
+        typename T::stmt* prepareStmt(const QString& query, QString& errorMessage);
+
+        /**
+         * @brief Copies rows into database using the same SQLite library, binding values directly.
+         */
+        bool copyQueryResultsDirectly(typename T::stmt* selectStmt, AbstractDb3<T>* dstDb, const QString& insertQuery,
+                                      InterruptedCheck interrupted, QString& errorMessage);
+
+        /**
+         * @brief Copies rows into any other database, passing them in batches with SqlValueBuffer.
+         */
+        bool copyQueryResultsBuffered(typename T::stmt* selectStmt, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                      QString& errorMessage);
+
+        /**
+         * @brief Appends current row of the statement to the buffer.
+         */
+        static void appendRow(SqlValueBuffer& buffer, typename T::stmt* stmt, int colCount);
 
         /**
          * @brief Registers function to call when unknown collation was encountered by the SQLite.
@@ -145,6 +244,16 @@ class AbstractDb3 : public AbstractDb
          */
         static void storeResult(typename T::context* context, const QVariant& result, bool ok);
 
+        /**
+         * @brief Stores given result in function's context.
+         * @param context Custom SQL function call context.
+         * @param result Value returned from function execution.
+         * @param ok true if the result is from a successful execution, or false if the result contains error message (as text).
+         *
+         * This is the variant used for functions evaluated with FunctionManager::ResolvedFunction.
+         */
+        static void storeResult(typename T::context* context, const SqlFunctionValue& result, bool ok);
+
         /**
          * @brief Converts SQLite arguments into the list of argument values.
          * @param argCount Number of arguments.
@@ -156,6 +265,13 @@ class AbstractDb3 : public AbstractDb
          */
         static QList<QVariant> getArgs(int argCount, typename T::value** args);
 
+        /**
+         * @brief Converts SQLite argument into the value for the resolved function.
+         * @param arg SQLite argument value.
+         * @param value Value to fill.
+         */
+        static void getArg(typename T::value* arg, SqlFunctionValue& value);
+
         /**
          * @brief Evaluates requested function using defined implementation code and provides result.
          * @param context SQL function call context.
@@ -201,7 +317,7 @@ class AbstractDb3 : public AbstractDb
 
         /**
          * @brief Evaluates code of the collation.
-         * @param userData Collation user data (name of the collation inside).
+         * @param userData Collation user data (name of the collation and its comparator inside).
          * @param length1 Number of characters in value1 (excluding \0).
          * @param value1 First value to compare.
          * @param length2 Number of characters in value2 (excluding \0).
@@ -263,6 +379,15 @@ class AbstractDb3 : public AbstractDb
          */
         static void releaseAggregateContext(typename T::context* context);
 
+        /**
+         * @brief Provides state of the resolved aggregate function.
+         * @param context SQL function call context.
+         * @return Pointer to the place in SQLite aggregate context where the state is stored, or null if it couldn't be allocated.
+         *
+         * The state lives in SQLite's aggregate context memory until the final step, which deletes it.
+         */
+        static FunctionManager::AggregateState** getAggregateState(typename T::context* context);
+
         /**
          * @brief Registers default collation for requested collation.
          * @param fnUserData User data passed when registering collation request handling function.
@@ -270,8 +395,9 @@ class AbstractDb3 : public AbstractDb
          * @param eTextRep Text encoding (for now always T::UTF8).
          * @param collationName Name of requested collation.
          *
-         * This function is called by SQLite to order registering collation with given name. We register default collation,
-         * cause all known collations should already be registered.
+         * This function is called by SQLite to order registering collation with given name. User defined collations
+         * should already be registered, so here we register one of built-in collations (see CollationManager::getNativeCollationNames()),
+         * or the default collation if there is no built-in collation with that name.
          *
          * Default collation is implemented by evaluateDefaultCollation().
          */
@@ -300,6 +426,31 @@ class AbstractDb3 : public AbstractDb
          * and delete it when database is closed.
          */
         CollationUserData* defaultCollationUserData = nullptr;
+
+        /**
+         * @brief Additional connections for reading.
+         *
+         * They are created when the database is opened for the first time and deleted together with this instance.
+         * When this database is closed, they are only closed, so no other thread is left with a deleted connection.
+         */
+        QList<AbstractDb3<T>*> readConnections;
+
+        /**
+         * @brief Whether queries are executed in read connections.
+         *
+         * It's true only when all read connections are open and the database is in WAL journal mode.
+         */
+        bool readConnectionsActive = false;
+
+        /**
+         * @brief Protects read connections list and their state.
+         */
+        QReadWriteLock readConnectionsLock;
+
+        /**
+         * @brief Counter used to pick read connections in turns.
+         */
+        QAtomicInt nextReadConnection;
 };
 
 //------------------------------------------------------------------------------------
@@ -317,6 +468,8 @@ AbstractDb3<T>::~AbstractDb3()
 {
     if (isOpenInternal())
         closeInternal();
+
+    qDeleteAll(readConnections);
 }
 
 template<class T>
@@ -379,12 +532,112 @@ QList<AliasedColumn> AbstractDb3<T>::columnsForQuery(const QString& query)
     return result;
 }
 
+template<class T>
+bool AbstractDb3<T>::copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                      QString& errorMessage)
+{
+    if (!isOpenInternal())
+    {
+        errorMessage = QObject::tr("Cannot execute query on closed database.");
+        return false;
+    }
+
+    // Another instance of the same template reads values of this database's library directly
+    AbstractDb3<T>* sameLibraryDb = dynamic_cast<AbstractDb3<T>*>(dstDb);
+    if (sameLibraryDb && !sameLibraryDb->isOpenInternal())
+        sameLibraryDb = nullptr;
+
+    bool sameDb = (sameLibraryDb == this);
+    ReadWriteLocker locker(&dbOperLock, sameDb ? ReadWriteLocker::WRITE : ReadWriteLocker::READ);
+    logSql(this, selectQuery, QList<QVariant>(), Db::Flag::NONE);
+
+    typename T::stmt* selectStmt = prepareStmt(selectQuery, errorMessage);
+    if (!selectStmt)
+        return false;
+
+    bool result;
+    if (sameDb)
+        result = copyQueryResultsDirectly(selectStmt, this, insertQuery, interrupted, errorMessage);
+    else if (sameLibraryDb)
+    {
+        ReadWriteLocker dstLocker(&(sameLibraryDb->dbOperLock), ReadWriteLocker::WRITE);
+        result = copyQueryResultsDirectly(selectStmt, sameLibraryDb, insertQuery, interrupted, errorMessage);
+    }
+    else
+        result = copyQueryResultsBuffered(selectStmt, dstDb, insertQuery, interrupted, errorMessage);
+
+    T::finalize(selectStmt);
+    return result;
+}
+
+template<class T>
+bool AbstractDb3<T>::insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage)
+{
+    if (!isOpenInternal())
+    {
+        errorMessage = QObject::tr("Cannot execute query on closed database.");
+        return false;
+    }
+
+    ReadWriteLocker locker(&dbOperLock, ReadWriteLocker::WRITE);
+    typename T::stmt* stmt = prepareStmt(insertQuery, errorMessage);
+    if (!stmt)
+        return false;
+
+    int colCount = rows.getColumnCount();
+    int res = T::DONE;
+    for (int row = 0, rowCount = rows.getRowCount(); row < rowCount && res == T::DONE; row++)
+    {
+        for (int col = 0; col < colCount; col++)
+        {
+            // Buffer outlives the statement execution, so values don't need to be copied by SQLite
+            const SqlValueBuffer::Value& value = rows.value(row, col);
+            switch (value.type)
+            {
+                case SqlValueBuffer::Type::INTEGER:
+                    T::bind_int64(stmt, col + 1, value.integer);
+                    break;
+                case SqlValueBuffer::Type::REAL:
+                    T::bind_double(stmt, col + 1, value.real);
+                    break;
+                case SqlValueBuffer::Type::TEXT:
+                    T::bind_text(stmt, col + 1, rows.data(value), value.size, T::STATIC());
+                    break;
+                case SqlValueBuffer::Type::BLOB:
+                    T::bind_blob(stmt, col + 1, rows.data(value), value.size, T::STATIC());
+                    break;
+                case SqlValueBuffer::Type::NULL_TYPE:
+                    T::bind_null(stmt, col + 1);
+                    break;
+            }
+        }
+
+        res = T::step(stmt);
+        T::reset(stmt);
+    }
+
+    if (res != T::DONE)
+        errorMessage = extractLastError();
+
+    T::finalize(stmt);
+    return res == T::DONE;
+}
+
 template <class T>
 bool AbstractDb3<T>::isOpenInternal()
 {
     return dbHandle != nullptr;
 }
 
+template <class T>
+bool AbstractDb3<T>::isTransactionActive()
+{
+    if (!isOpenInternal())
+        return false;
+
+    return T::get_autocommit(dbHandle) == 0;
+}
+
 template <class T>
 void AbstractDb3<T>::interruptExecution()
 {
@@ -392,6 +645,10 @@ void AbstractDb3<T>::interruptExecution()
         return;
 
     T::interrupt(dbHandle);
+
+    QReadLocker locker(&readConnectionsLock);
+    for (AbstractDb3<T>* readDb : readConnections)
+        readDb->interrupt();
 }
 
 template <class T>
@@ -433,6 +690,7 @@ bool AbstractDb3<T>::closeInternal()
     if (!dbHandle)
         return false;
 
+    closeReadConnections();
     cleanUp();
 
     int res = T::close(dbHandle);
@@ -468,6 +726,81 @@ SqlQueryPtr AbstractDb3<T>::prepare(const QString& query)
     return SqlQueryPtr(new Query(this, query));
 }
 
+template <class T>
+void AbstractDb3<T>::openReadConnections()
+{
+    int poolSize = connOptions.value(DB_READ_POOL_SIZE).toInt();
+    if (poolSize <= 0)
+        return;
+
+    // Readers and the writer don't block each other only in WAL mode
+    SqlQueryPtr results = exec("PRAGMA journal_mode;", Flag::NO_LOCK);
+    if (results->isError() || results->getSingleCell().toString().toLower() != "wal")
+        return;
+
+    QWriteLocker locker(&readConnectionsLock);
+    QHash<QString, QVariant> options = connOptions;
+    options.remove(DB_READ_POOL_SIZE);
+    while (readConnections.size() < poolSize)
+    {
+        AbstractDb3<T>* readDb = createReadConnection(options);
+        if (!readDb)
+            return;
+
+        readConnections << readDb;
+    }
+
+    for (AbstractDb3<T>* readDb : readConnections)
+    {
+        if (!readDb->isOpen() && !readDb->openQuiet())
+        {
+            qWarning() << "Could not open read connection for database" << name << ":" << readDb->getErrorText();
+            return;
+        }
+    }
+    readConnectionsActive = true;
+}
+
+template <class T>
+void AbstractDb3<T>::closeReadConnections()
+{
+    QWriteLocker locker(&readConnectionsLock);
+    readConnectionsActive = false;
+    for (AbstractDb3<T>* readDb : readConnections)
+    {
+        if (readDb->isOpen())
+            readDb->closeQuiet();
+    }
+}
+
+template <class T>
+Db* AbstractDb3<T>::getReadConnection(const QString& query, Flags flags)
+{
+    // Only the caller knows if the query doesn't depend on temporary objects, attached databases, PRAGMA settings,
+    // or on another operation running on this connection without lock.
+    if (!flags.testFlag(Flag::READ_POOL))
+        return nullptr;
+
+    QReadLocker locker(&readConnectionsLock);
+    if (!readConnectionsActive || isTransactionActive())
+        return nullptr;
+
+    bool isSelect = false;
+    getQueryAccessMode(query, &isSelect);
+    if (!isSelect)
+        return nullptr;
+
+    uint idx = static_cast<uint>(nextReadConnection.fetchAndAddRelaxed(1));
+    return readConnections[static_cast<int>(idx % static_cast<uint>(readConnections.size()))];
+}
+
+template <class T>
+AbstractDb3<T>* AbstractDb3<T>::createReadConnection(const QHash<QString, QVariant>& options)
+{
+    UNUSED(options);
+    return nullptr;
+}
+
 template <class T>
 QString AbstractDb3<T>::getTypeLabel()
 {
@@ -494,6 +827,8 @@ bool AbstractDb3<T>::registerScalarFunction(const QString& name, int argCount, b
     userData->db = this;
     userData->name = name;
     userData->argCount = argCount;
+    if (FUNCTIONS)
+        userData->resolvedFunction = FUNCTIONS->resolveScalar(name, argCount);
 
     int opts = T::UTF8;
     if (deterministic)
@@ -518,6 +853,8 @@ bool AbstractDb3<T>::registerAggregateFunction(const QString& name, int argCount
     userData->db = this;
     userData->name = name;
     userData->argCount = argCount;
+    if (FUNCTIONS)
+        userData->resolvedAggregate = FUNCTIONS->resolveAggregate(name, argCount);
 
     int opts = T::UTF8;
     if (deterministic)
@@ -540,6 +877,8 @@ bool AbstractDb3<T>::registerCollationInternal(const QString& name)
 
     CollationUserData* userData = new CollationUserData;
     userData->name = name;
+    if (COLLATIONS)
+        userData->comparator = COLLATIONS->resolveCollation(name);
 
     int res = T::create_collation_v2(dbHandle, name.toUtf8().constData(), T::UTF8, userData,
                                           &AbstractDb3<T>::evaluateCollation,
@@ -565,6 +904,119 @@ QString AbstractDb3<T>::extractLastError()
     return dbErrorMessage;
 }
 
+template <class T>
+typename T::stmt* AbstractDb3<T>::prepareStmt(const QString& query, QString& errorMessage)
+{
+    QByteArray queryBytes = query.toUtf8();
+    typename T::stmt* stmt = nullptr;
+    if (T::prepare_v2(dbHandle, queryBytes.constData(), queryBytes.size(), &stmt, nullptr) != T::OK)
+    {
+        errorMessage = extractLastError();
+        T::finalize(stmt);
+        return nullptr;
+    }
+    return stmt;
+}
+
+template <class T>
+bool AbstractDb3<T>::copyQueryResultsDirectly(typename T::stmt* selectStmt, AbstractDb3<T>* dstDb, const QString& insertQuery,
+                                              InterruptedCheck interrupted, QString& errorMessage)
+{
+    typename T::stmt* insertStmt = dstDb->prepareStmt(insertQuery, errorMessage);
+    if (!insertStmt)
+        return false;
+
+    int colCount = T::column_count(selectStmt);
+    int rowCount = 0;
+    int res = T::DONE;
+    bool ok = true;
+    while (ok && (res = T::step(selectStmt)) == T::ROW)
+    {
+        for (int col = 0; col < colCount; col++)
+            T::bind_value(insertStmt, col + 1, T::column_value(selectStmt, col));
+
+        if (T::step(insertStmt) != T::DONE)
+        {
+            T::reset(insertStmt);
+            errorMessage = dstDb->extractLastError();
+            ok = false;
+            break;
+        }
+        T::reset(insertStmt);
+
+        if ((++rowCount % COPY_BATCH_ROWS) == 0 && interrupted())
+            ok = false;
+    }
+
+    if (ok && res != T::DONE)
+    {
+        errorMessage = extractLastError();
+        ok = false;
+    }
+
+    T::finalize(insertStmt);
+    return ok && !interrupted();
+}
+
+template <class T>
+bool AbstractDb3<T>::copyQueryResultsBuffered(typename T::stmt* selectStmt, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                              QString& errorMessage)
+{
+    int colCount = T::column_count(selectStmt);
+    SqlValueBuffer buffer(colCount);
+    int res;
+    while ((res = T::step(selectStmt)) == T::ROW)
+    {
+        appendRow(buffer, selectStmt, colCount);
+        if (buffer.getRowCount() < COPY_BATCH_ROWS && buffer.getDataSize() < COPY_BATCH_BYTES)
+            continue;
+
+        if (!dstDb->insertRows(insertQuery, buffer, errorMessage))
+            return false;
+
+        buffer.clear();
+        if (interrupted())
+            return false;
+    }
+
+    if (res != T::DONE)
+    {
+        errorMessage = extractLastError();
+        return false;
+    }
+
+    if (buffer.getRowCount() > 0 && !dstDb->insertRows(insertQuery, buffer, errorMessage))
+        return false;
+
+    return !interrupted();
+}
+
+template <class T>
+void AbstractDb3<T>::appendRow(SqlValueBuffer& buffer, typename T::stmt* stmt, int colCount)
+{
+    for (int col = 0; col < colCount; col++)
+    {
+        switch (T::column_type(stmt, col))
+        {
+            case T::INTEGER:
+                buffer.appendInteger(T::column_int64(stmt, col));
+                break;
+            case T::FLOAT:
+                buffer.appendReal(T::column_double(stmt, col));
+                break;
+            case T::BLOB:
+                buffer.appendBlob(T::column_blob(stmt, col), T::column_bytes(stmt, col));
+                break;
+            case T::NULL_TYPE:
+                buffer.appendNull();
+                break;
+            default:
+                buffer.appendText(reinterpret_cast<const char*>(T::column_text(stmt, col)), T::column_bytes(stmt, col));
+                break;
+        }
+    }
+}
+
 template <class T>
 void AbstractDb3<T>::cleanUp()
 {
@@ -650,6 +1102,58 @@ void AbstractDb3<T>::storeResult(typename T::context* context, const QVariant& r
     }
 }
 
+template <class T>
+void AbstractDb3<T>::storeResult(typename T::context* context, const SqlFunctionValue& result, bool ok)
+{
+    if (!ok)
+    {
+        T::result_error16(context, result.text.utf16(), result.text.size() * sizeof(QChar));
+        return;
+    }
+
+    switch (result.type)
+    {
+        case SqlFunctionValue::Type::NULL_TYPE:
+            T::result_null(context);
+            break;
+        case SqlFunctionValue::Type::INTEGER:
+            T::result_int64(context, result.integer);
+            break;
+        case SqlFunctionValue::Type::REAL:
+            T::result_double(context, result.real);
+            break;
+        case SqlFunctionValue::Type::TEXT:
+            T::result_text16(context, result.text.utf16(), result.text.size() * sizeof(QChar), T::TRANSIENT());
+            break;
+        case SqlFunctionValue::Type::BLOB:
+            T::result_blob(context, result.blob.constData(), result.blob.size(), T::TRANSIENT());
+            break;
+    }
+}
+
+template <class T>
+void AbstractDb3<T>::getArg(typename T::value* arg, SqlFunctionValue& value)
+{
+    switch (T::value_type(arg))
+    {
+        case T::INTEGER:
+            value.setInteger(T::value_int64(arg));
+            break;
+        case T::BLOB:
+            value.setBlob(QByteArray(static_cast<const char*>(T::value_blob(arg)), T::value_bytes(arg)));
+            break;
+        case T::FLOAT:
+            value.setReal(T::value_double(arg));
+            break;
+        case T::NULL_TYPE:
+            value.setNull();
+            break;
+        default:
+            value.setText(QString(reinterpret_cast<const QChar*>(T::value_text16(arg)), T::value_bytes16(arg) / sizeof(QChar)));
+            break;
+    }
+}
+
 template <class T>
 QList<QVariant> AbstractDb3<T>::getArgs(int argCount, typename T::value** args)
 {
@@ -693,6 +1197,21 @@ QList<QVariant> AbstractDb3<T>::getArgs(int argCount, typename T::value** args)
 template <class T>
 void AbstractDb3<T>::evaluateScalar(typename T::context* context, int argCount, typename T::value** args)
 {
+    FunctionUserData* userData = reinterpret_cast<FunctionUserData*>(T::user_data(context));
+    if (userData && userData->resolvedFunction)
+    {
+        // Values are passed directly to the resolved function, no lookups, nor QVariant on the way
+        QVarLengthArray<SqlFunctionValue, 8> argValues(argCount);
+        for (int i = 0; i < argCount; i++)
+            getArg(args[i], argValues[i]);
+
+        SqlFunctionValue result;
+        bool ok = true;
+        userData->resolvedFunction->evaluate(argValues.constData(), argCount, userData->db, result, ok);
+        storeResult(context, result, ok);
+        return;
+    }
+
     QList<QVariant> argList = getArgs(argCount, args);
     bool ok = true;
     QVariant result = AbstractDb::evaluateScalar(T::user_data(context), argList, ok);
@@ -703,6 +1222,27 @@ template <class T>
 void AbstractDb3<T>::evaluateAggregateStep(typename T::context* context, int argCount, typename T::value** args)
 {
     void* dataPtr = T::user_data(context);
+    FunctionUserData* userData = reinterpret_cast<FunctionUserData*>(dataPtr);
+    if (userData && userData->resolvedAggregate)
+    {
+        FunctionManager::AggregateState** state = getAggregateState(context);
+        if (!state)
+        {
+            qCritical() << "Could not allocate aggregate context.";
+            return;
+        }
+
+        if (!*state)
+            *state = userData->resolvedAggregate->createState(userData->db);
+
+        QVarLengthArray<SqlFunctionValue, 8> argValues(argCount);
+        for (int i = 0; i < argCount; i++)
+            getArg(args[i], argValues[i]);
+
+        userData->resolvedAggregate->step(*state, argValues.constData(), argCount, userData->db);
+        return;
+    }
+
     QList<QVariant> argList = getArgs(argCount, args);
     QHash<QString,QVariant> aggregateContext = getAggregateContext(context);
 
@@ -715,6 +1255,31 @@ template <class T>
 void AbstractDb3<T>::evaluateAggregateFinal(typename T::context* context)
 {
     void* dataPtr = T::user_data(context);
+    FunctionUserData* userData = reinterpret_cast<FunctionUserData*>(dataPtr);
+    if (userData && userData->resolvedAggregate)
+    {
+        FunctionManager::AggregateState** state = getAggregateState(context);
+        SqlFunctionValue result;
+        bool ok = true;
+        if (state)
+        {
+            // There was no step at all if the group was empty
+            if (!*state)
+                *state = userData->resolvedAggregate->createState(userData->db);
+
+            userData->resolvedAggregate->finish(*state, userData->db, result, ok);
+            safe_delete(*state);
+        }
+        else
+        {
+            ok = false;
+            result.setText(QObject::tr("Could not allocate aggregate context."));
+        }
+
+        storeResult(context, result, ok);
+        return;
+    }
+
     QHash<QString,QVariant> aggregateContext = getAggregateContext(context);
 
     bool ok = true;
@@ -727,10 +1292,11 @@ void AbstractDb3<T>::evaluateAggregateFinal(typename T::context* context)
 template <class T>
 int AbstractDb3<T>::evaluateCollation(void* userData, int length1, const void* value1, int length2, const void* value2)
 {
-    UNUSED(length1);
-    UNUSED(length2);
     CollationUserData* collUserData = reinterpret_cast<CollationUserData*>(userData);
-    return COLLATIONS->evaluate(collUserData->name, QString::fromUtf8((const char*)value1), QString::fromUtf8((const char*)value2));
+    if (collUserData->comparator)
+        return collUserData->comparator->compare(reinterpret_cast<const char*>(value1), length1, reinterpret_cast<const char*>(value2), length2);
+
+    return COLLATIONS->evaluate(collUserData->name, QString::fromUtf8((const char*)value1, length1), QString::fromUtf8((const char*)value2, length2));
 }
 
 template <class T>
@@ -771,6 +1337,12 @@ void AbstractDb3<T>::setAggregateContext(typename T::context* context, const QHa
     AbstractDb::setAggregateContext(getContextMemPtr(context), aggregateContext);
 }
 
+template <class T>
+FunctionManager::AggregateState** AbstractDb3<T>::getAggregateState(typename T::context* context)
+{
+    return reinterpret_cast<FunctionManager::AggregateState**>(T::aggregate_context(context, sizeof(FunctionManager::AggregateState*)));
+}
+
 template <class T>
 void AbstractDb3<T>::releaseAggregateContext(typename T::context* context)
 {
@@ -807,8 +1379,23 @@ void AbstractDb3<T>::registerDefaultCollation(void* fnUserData, typename T::hand
         return;
     }
 
-    int res = T::create_collation_v2(fnDbHandle, collationName, T::UTF8, nullptr,
-                                          &AbstractDb3<T>::evaluateDefaultCollation, nullptr);
+    // Built-in collations are registered only when they are needed
+    CollationManager::ComparatorPtr comparator = COLLATIONS->resolveCollation(QString::fromUtf8(collationName));
+    int res;
+    if (comparator)
+    {
+        CollationUserData* userData = new CollationUserData;
+        userData->name = QString::fromUtf8(collationName);
+        userData->comparator = comparator;
+        res = T::create_collation_v2(fnDbHandle, collationName, T::UTF8, userData,
+                                     &AbstractDb3<T>::evaluateCollation,
+                                     &AbstractDb3<T>::deleteCollationUserData);
+    }
+    else
+    {
+        res = T::create_collation_v2(fnDbHandle, collationName, T::UTF8, nullptr,
+                                     &AbstractDb3<T>::evaluateDefaultCollation, nullptr);
+    }
 
     if (res != T::OK)
         qWarning() << "Could not register default collation in AbstractDb3<T>::registerDefaultCollation().";
@@ -905,9 +1492,45 @@ int AbstractDb3<T>::Query::prepareStmt()
     if (tail && !QString::fromUtf8(tail).trimmed().isEmpty())
         qWarning() << "Executed query left with tailing contents:" << tail << ", while executing query:" << query;
 
+    const char* paramName = nullptr;
+    metadata.paramCount = T::bind_parameter_count(stmt);
+    metadata.paramNames.clear();
+    for (int paramIdx = 1; paramIdx <= metadata.paramCount; paramIdx++)
+    {
+        paramName = T::bind_parameter_name(stmt, paramIdx);
+        metadata.paramNames << (paramName ? QString::fromUtf8(paramName) : QStringLiteral("?"));
+    }
+
     return T::OK;
 }
 
+template <class T>
+void AbstractDb3<T>::Query::initMetadata()
+{
+    // Statements modifying data can be recognized by the first word, without tokenizing whole query,
+    // which matters for long INSERT statements, like the ones in SQL dumps.
+    static const QStringList plainWriteCommands = {"INSERT", "REPLACE", "UPDATE", "DELETE", "CREATE"};
+    QString command = getLeadingWord(query);
+    for (const QString& writeCommand : plainWriteCommands)
+    {
+        if (command.compare(writeCommand, Qt::CaseInsensitive) == 0)
+        {
+            metadata.lockMode = ReadWriteLocker::WRITE;
+            metadata.mayDropObject = false;
+            metadata.initialized = true;
+            return;
+        }
+    }
+
+    TokenList tokens = Lexer::tokenize(query);
+    metadata.lockMode = (getQueryAccessMode(tokens) == QueryAccessMode::READ) ? ReadWriteLocker::READ : ReadWriteLocker::WRITE;
+
+    // Only a quick check, the detailed one is done by checkForDroppedObject()
+    int keywordIdx = tokens.indexOf(Token::KEYWORD);
+    metadata.mayDropObject = (keywordIdx > -1 && tokens[keywordIdx]->value.compare("DROP", Qt::CaseInsensitive) == 0);
+    metadata.initialized = true;
+}
+
 template <class T>
 int AbstractDb3<T>::Query::resetStmt()
 {
@@ -916,6 +1539,7 @@ int AbstractDb3<T>::Query::resetStmt()
     affected = 0;
     colCount = -1;
     rowAvailable = false;
+    columnarBlock.clear();
 
     int res = T::reset(stmt);
     if (res != T::OK)
@@ -933,7 +1557,10 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, flags.testFlag(Db::Flag::NO_LOCK));
+    if (!metadata.initialized)
+        initMetadata();
+
+    ReadWriteLocker locker(&(db->dbOperLock), flags.testFlag(Db::Flag::NO_LOCK) ? ReadWriteLocker::NONE : metadata.lockMode);
     logSql(db.data(), query, args, flags);
 
     int res;
@@ -947,10 +1574,7 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
 
     int maxParamIdx = args.size();
     if (!flags.testFlag(Db::Flag::SKIP_PARAM_COUNTING))
-    {
-        QueryWithParamCount queryWithParams = getQueryWithParamCount(query);
-        maxParamIdx = qMin(maxParamIdx, queryWithParams.second);
-    }
+        maxParamIdx = qMin(maxParamIdx, metadata.paramCount);
 
     for (int paramIdx = 1; paramIdx <= maxParamIdx; paramIdx++)
     {
@@ -964,7 +1588,7 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     }
 
     bool ok = (fetchFirst() == T::OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && metadata.mayDropObject && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
     return ok;
@@ -976,10 +1600,11 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, flags.testFlag(Db::Flag::NO_LOCK));
-    logSql(db.data(), query, args, flags);
+    if (!metadata.initialized)
+        initMetadata();
 
-    QueryWithParamNames queryWithParams = getQueryWithParamNames(query);
+    ReadWriteLocker locker(&(db->dbOperLock), flags.testFlag(Db::Flag::NO_LOCK) ? ReadWriteLocker::NONE : metadata.lockMode);
+    logSql(db.data(), query, args, flags);
 
     int res;
     if (stmt)
@@ -990,9 +1615,10 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (res != T::OK)
         return false;
 
-    int paramIdx = -1;
-    for (const QString& paramName : queryWithParams.second)
+    QString paramName;
+    for (int paramIdx = 1; paramIdx <= metadata.paramCount; paramIdx++)
     {
+        paramName = metadata.paramNames[paramIdx - 1];
         if (!args.contains(paramName))
         {
             qWarning() << "Could not bind parameter" << paramName << "because it was not found in passed arguments.";
@@ -1000,14 +1626,6 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
             return false;
         }
 
-        paramIdx = T::bind_parameter_index(stmt, paramName.toUtf8().constData());
-        if (paramIdx <= 0)
-        {
-            qWarning() << "Could not bind parameter" << paramName << "because it was not found in prepared statement.";
-            setError(SqlErrorCode::OTHER_EXECUTION_ERROR, "Error while preparing statement: could not bind parameter " + paramName);
-            return false;
-        }
-
         res = bindParam(paramIdx, args[paramName]);
         if (res != T::OK)
         {
@@ -1018,7 +1636,7 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     }
 
     bool ok = (fetchFirst() == T::OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && metadata.mayDropObject && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
     return ok;
@@ -1116,9 +1734,26 @@ qint64 AbstractDb3<T>::Query::rowsAffected()
     return affected;
 }
 
+template <class T>
+SqlQuery::StatementStats AbstractDb3<T>::Query::getStatementStats()
+{
+    StatementStats stats;
+    if (!stmt || !checkDbState())
+        return stats;
+
+    stats.fullScanSteps = T::stmt_status(stmt, T::STMTSTATUS_FULLSCAN_STEP, 0);
+    stats.sorts = T::stmt_status(stmt, T::STMTSTATUS_SORT, 0);
+    stats.autoIndexRows = T::stmt_status(stmt, T::STMTSTATUS_AUTOINDEX, 0);
+    stats.vmSteps = T::stmt_status(stmt, T::STMTSTATUS_VM_STEP, 0);
+    return stats;
+}
+
 template <class T>
 SqlResultsRowPtr AbstractDb3<T>::Query::nextInternal()
 {
+    if (flags.testFlag(Db::Flag::COLUMNAR_RESULTS))
+        return nextColumnarInternal();
+
     Row* row = new Row;
     int res = row->init(colNames, stmt, flags);
     if (res != T::OK)
@@ -1138,6 +1773,28 @@ SqlResultsRowPtr AbstractDb3<T>::Query::nextInternal()
     return SqlResultsRowPtr(row);
 }
 
+template <class T>
+SqlResultsRowPtr AbstractDb3<T>::Query::nextColumnarInternal()
+{
+    if (!columnarBlock || columnarBlock->isFull())
+        columnarBlock = ColumnarResultsPtr::create(colNames);
+
+    int res = Row::appendTo(*columnarBlock, stmt);
+    if (res != T::OK)
+    {
+        columnarBlock->rollbackRow();
+        setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
+        return SqlResultsRowPtr();
+    }
+
+    int rowIdx = columnarBlock->rowCount() - 1;
+    res = fetchNext();
+    if (res != T::OK)
+        return SqlResultsRowPtr();
+
+    return SqlResultsRowPtr(new ColumnarResultsRow(columnarBlock, rowIdx));
+}
+
 template <class T>
 bool AbstractDb3<T>::Query::hasNextInternal()
 {
@@ -1148,6 +1805,7 @@ template <class T>
 int AbstractDb3<T>::Query::fetchFirst()
 {
     colCount = T::column_count(stmt);
+    colNames.clear();
     for (int i = 0; i < colCount; i++)
         colNames << QString::fromUtf8(T::column_name(stmt, i));
 
@@ -1211,6 +1869,7 @@ int AbstractDb3<T>::Query::Row::init(const QStringList& columns, typename T::stm
 {
     int res = T::OK;
     QVariant value;
+    values.reserve(columns.size());
     for (int i = 0; i < columns.size(); i++)
     {
         res = getValue(stmt, i, value, flags);
@@ -1218,11 +1877,43 @@ int AbstractDb3<T>::Query::Row::init(const QStringList& columns, typename T::stm
             return res;
 
         values << value;
-        valuesMap[columns[i]] = value;
     }
+
+    // Name->value hash is built by SqlResultsRow upon first request.
+    this->columns = columns;
+    valuesMapLoaded = false;
     return res;
 }
 
+template <class T>
+int AbstractDb3<T>::Query::Row::appendTo(ColumnarResults& block, typename T::stmt* stmt)
+{
+    int colCount = block.columnCount();
+    for (int col = 0; col < colCount; col++)
+    {
+        switch (T::column_type(stmt, col))
+        {
+            case T::INTEGER:
+                block.appendInteger(col, T::column_int64(stmt, col));
+                break;
+            case T::BLOB:
+                block.appendBlob(col, static_cast<const char*>(T::column_blob(stmt, col)), T::column_bytes(stmt, col));
+                break;
+            case T::NULL_TYPE:
+                block.appendNull(col);
+                break;
+            case T::FLOAT:
+                block.appendReal(col, T::column_double(stmt, col));
+                break;
+            default:
+                block.appendText(col, reinterpret_cast<const QChar*>(T::column_text16(stmt, col)), T::column_bytes16(stmt, col) / sizeof(QChar));
+                break;
+        }
+    }
+    block.finishRow();
+    return T::OK;
+}
+
 template <class T>
 int AbstractDb3<T>::Query::Row::getValue(typename T::stmt* stmt, int col, QVariant& value, Db::Flags flags)
 {
@@ -27,6 +27,22 @@ void ChainExecutor::setQueries(const QStringList& value)
 {
     sqls = value;
     queryParams.clear();
+    chunkedQueries.clear();
+}
+
+void ChainExecutor::setChunkedQueries(const QHash<int, ChainExecutor::ChunkedQuery>& value)
+{
+    chunkedQueries = value;
+}
+
+int ChainExecutor::getChunkSize() const
+{
+    return chunkSize;
+}
+
+void ChainExecutor::setChunkSize(int value)
+{
+    chunkSize = qMax(value, 1);
 }
 
 void ChainExecutor::exec()
@@ -64,6 +80,8 @@ void ChainExecutor::exec()
     }
 
     currentSqlIndex = 0;
+    chunkStep = ChunkStep::NONE;
+    chunkedQueriesDone = 0;
     if (async)
         executeCurrentSql();
     else
@@ -90,6 +108,14 @@ void ChainExecutor::executeCurrentSql()
         return;
     }
 
+    if (chunkedQueries.contains(currentSqlIndex))
+    {
+        QHash<QString,QVariant> params = queryParams;
+        QString sql = getChunkStepSql(params);
+        asyncId = db->asyncExec(sql, params, getExecFlags());
+        return;
+    }
+
     asyncId = db->asyncExec(sqls[currentSqlIndex], queryParams, getExecFlags());
 }
 
@@ -128,6 +154,13 @@ void ChainExecutor::handleAsyncResults(quint32 asyncId, SqlQueryPtr results)
     if (!handleResults(results))
         return;
 
+    // Next step of the same chunked query
+    if (chunkedQueries.contains(currentSqlIndex) && !handleChunkStepResults(results))
+    {
+        executeCurrentSql();
+        return;
+    }
+
     currentSqlIndex++;
     executeCurrentSql();
 }
@@ -162,8 +195,31 @@ void ChainExecutor::executeSync()
 {
     Db::Flags flags = getExecFlags();
     SqlQueryPtr results;
+    QHash<QString,QVariant> params;
     for (const QString& sql : sqls)
     {
+        if (chunkedQueries.contains(currentSqlIndex))
+        {
+            do
+            {
+                if (interrupted)
+                {
+                    executionFailure(SqlErrorCode::INTERRUPTED, tr("Interrupted", "chain executor"));
+                    return;
+                }
+
+                params = queryParams;
+                QString stepSql = getChunkStepSql(params);
+                results = db->exec(stepSql, params, flags);
+                if (!handleResults(results))
+                    return;
+            }
+            while (!handleChunkStepResults(results));
+
+            currentSqlIndex++;
+            continue;
+        }
+
         results = db->exec(sql, queryParams, flags);
         if (!handleResults(results))
             return;
@@ -196,6 +252,83 @@ Db::Flags ChainExecutor::getExecFlags() const
     return flags;
 }
 
+QString ChainExecutor::getChunkStepSql(QHash<QString, QVariant>& params)
+{
+    const ChunkedQuery& chunked = chunkedQueries[currentSqlIndex];
+    if (chunkStep == ChunkStep::NONE)
+        chunkStep = chunked.initQuery.isEmpty() ? ChunkStep::RANGE : ChunkStep::INIT;
+
+    switch (chunkStep)
+    {
+        case ChunkStep::INIT:
+            return chunked.initQuery;
+        case ChunkStep::RANGE:
+            return QString("SELECT min(%1), max(%1) FROM %2").arg(chunked.rowId, chunked.table);
+        case ChunkStep::BOUNDARY:
+            // Last rowid of the chunk. Walking the table b-tree is cheap compared to copying the rows.
+            params[":chunkFrom"] = chunkFrom;
+            return QString("SELECT %1 FROM %2 WHERE %1 >= :chunkFrom ORDER BY %1 LIMIT 1 OFFSET %3")
+                    .arg(chunked.rowId, chunked.table, QString::number(chunkSize - 1));
+        case ChunkStep::CHUNK:
+            params[":chunkFrom"] = chunkFrom;
+            params[":chunkTo"] = chunkTo;
+            return chunked.chunkQuery;
+        case ChunkStep::NONE:
+            break;
+    }
+    return QString();
+}
+
+bool ChainExecutor::handleChunkStepResults(SqlQueryPtr results)
+{
+    SqlResultsRowPtr row;
+    QVariant value;
+    switch (chunkStep)
+    {
+        case ChunkStep::INIT:
+            chunkStep = ChunkStep::RANGE;
+            return false;
+        case ChunkStep::RANGE:
+        {
+            row = results->hasNext() ? results->next() : SqlResultsRowPtr();
+            if (!row || row->value(0).isNull())
+                break; // empty table, nothing to do
+
+            chunkMin = row->value(0).toLongLong();
+            chunkMax = row->value(1).toLongLong();
+            chunkFrom = chunkMin;
+            chunkStep = ChunkStep::BOUNDARY;
+            return false;
+        }
+        case ChunkStep::BOUNDARY:
+        {
+            value = results->hasNext() ? results->getSingleCell() : QVariant();
+            chunkTo = value.isNull() ? chunkMax : value.toLongLong();
+            chunkStep = ChunkStep::CHUNK;
+            return false;
+        }
+        case ChunkStep::CHUNK:
+        {
+            if (chunkTo >= chunkMax)
+                break;
+
+            double queryProgress = static_cast<double>(chunkTo - chunkMin) / static_cast<double>(chunkMax - chunkMin);
+            emit progress(static_cast<int>((chunkedQueriesDone + queryProgress) * 100 / chunkedQueries.size()));
+
+            chunkFrom = chunkTo + 1;
+            chunkStep = ChunkStep::BOUNDARY;
+            return false;
+        }
+        case ChunkStep::NONE:
+            break;
+    }
+
+    chunkStep = ChunkStep::NONE;
+    chunkedQueriesDone++;
+    emit progress(chunkedQueriesDone * 100 / chunkedQueries.size());
+    return true;
+}
+
 void ChainExecutor::restoreFk()
 {
     if (disableForeignKeys)
@@ -3,6 +3,7 @@
 
 #include "db/db.h"
 #include <QObject>
+#include <QHash>
 
 // TODO add parameters support for ChainExecutor.
 // it requires clever api, cause there can be multiple queries and each can use differend parameters,
@@ -28,6 +29,46 @@ class API_EXPORT ChainExecutor : public QObject
     public:
         typedef QPair<int,QString> ExecutionError;
 
+        /**
+         * @brief Query executed in chunks, for consecutive ranges of rowids of a table.
+         *
+         * Instead of executing the query from setQueries() at once, the executor finds
+         * range of rowids in the table and executes the chunk query for each range of (at most)
+         * the chunk size rows. Ranges are bound to the <tt>:chunkFrom</tt> and <tt>:chunkTo</tt>
+         * parameters (both inclusive).
+         *
+         * Executing it this way lets the executor report progress and react to interruption
+         * between chunks, which makes a difference for queries copying huge tables.
+         * The result is the same as if the query from setQueries() was executed.
+         */
+        struct API_EXPORT ChunkedQuery
+        {
+            /**
+             * @brief Table which rows are processed, wrapped if needed.
+             */
+            QString table;
+
+            /**
+             * @brief Name to refer to rowid of the table with (rowid, _rowid_ or oid), not shadowed by any column.
+             */
+            QString rowId;
+
+            /**
+             * @brief Optional query executed once, before the first chunk.
+             */
+            QString initQuery;
+
+            /**
+             * @brief Query executed for each chunk.
+             */
+            QString chunkQuery;
+        };
+
+        /**
+         * @brief Default number of rows in a single chunk of ChunkedQuery.
+         */
+        static const int DEFAULT_CHUNK_SIZE = 10000;
+
         /**
          * @brief Creates executor.
          * @param parent Parent object for QObject.
@@ -62,10 +103,22 @@ class API_EXPORT ChainExecutor : public QObject
          * This is the main mathod you're interested in when using ChainExecutor.
          * This is how you define what SQL queries will be executed.
          *
-         * Calling this method will clear any parameters defined previously with setParam().
+         * Calling this method will clear any parameters defined previously with setParam()
+         * and any chunked queries defined with setChunkedQueries().
          */
         void setQueries(const QStringList& value);
 
+        /**
+         * @brief Defines which queries are executed in chunks.
+         * @param value Chunked queries by index of the query (as passed to setQueries()) they are executed instead of.
+         *
+         * See ChunkedQuery for details. Progress of chunked queries is reported with progress() signal.
+         */
+        void setChunkedQueries(const QHash<int,ChunkedQuery>& value);
+
+        int getChunkSize() const;
+        void setChunkSize(int value);
+
         /**
          * @brief Provides currently configured database.
          * @return Database that the queries are executed on in this executor.
@@ -251,6 +304,29 @@ class API_EXPORT ChainExecutor : public QObject
 
         void restoreFk();
 
+        /**
+         * @brief Provides query for the next step of the current chunked query.
+         * @param params Query parameters, to be extended with parameters of the step.
+         * @return Query to execute.
+         */
+        QString getChunkStepSql(QHash<QString,QVariant>& params);
+
+        /**
+         * @brief Processes results of the step of the current chunked query.
+         * @param results Results of the query returned from getChunkStepSql().
+         * @return true if all chunks were executed, false if there are further steps.
+         */
+        bool handleChunkStepResults(SqlQueryPtr results);
+
+        enum class ChunkStep
+        {
+            NONE,
+            INIT,
+            RANGE,
+            BOUNDARY,
+            CHUNK
+        };
+
         /**
          * @brief Database for execution.
          */
@@ -328,6 +404,28 @@ class API_EXPORT ChainExecutor : public QObject
         bool disableForeignKeys = false;
         bool disableObjectDropsDetection = false;
 
+        /**
+         * @brief Chunked queries by index of the query they replace.
+         */
+        QHash<int,ChunkedQuery> chunkedQueries;
+
+        int chunkSize = DEFAULT_CHUNK_SIZE;
+
+        /**
+         * @brief Next step to execute for the current chunked query.
+         */
+        ChunkStep chunkStep = ChunkStep::NONE;
+
+        qint64 chunkMin = 0;
+        qint64 chunkMax = 0;
+        qint64 chunkFrom = 0;
+        qint64 chunkTo = 0;
+
+        /**
+         * @brief Number of chunked queries completed in current execution, used to calculate the overall progress.
+         */
+        int chunkedQueriesDone = 0;
+
         SqlQueryPtr lastExecutionResults;
 
     public slots:
@@ -382,6 +480,12 @@ class API_EXPORT ChainExecutor : public QObject
          * See setMandatoryQueries() for details on mandatory queries.
          */
         void failure(int errorCode, const QString& errorText);
+
+        /**
+         * @brief Emitted after each chunk of chunked queries was executed.
+         * @param value Progress of all chunked queries, from 0 to 100.
+         */
+        void progress(int value);
 };
 
 #endif // CHAINEXECUTOR_H
@@ -0,0 +1,236 @@
+#include "columnarresults.h"
+#include <cstring>
+
+ColumnarResults::ColumnarResults(const QStringList& columns, int capacity) :
+    columns(columns), capacity(capacity)
+{
+    data.resize(columns.size());
+    for (Column& column : data)
+    {
+        column.types.reserve(capacity);
+        column.cells.reserve(capacity);
+    }
+}
+
+void ColumnarResults::appendNull(int col)
+{
+    Column& column = data[col];
+    column.types << Type::NULL_VALUE;
+    column.cells << 0;
+    bytes += sizeof(qint64) + sizeof(Type);
+}
+
+void ColumnarResults::appendInteger(int col, qint64 value)
+{
+    Column& column = data[col];
+    column.types << Type::INTEGER;
+    column.cells << value;
+    bytes += sizeof(qint64) + sizeof(Type);
+}
+
+void ColumnarResults::appendReal(int col, double value)
+{
+    qint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    Column& column = data[col];
+    column.types << Type::REAL;
+    column.cells << bits;
+    bytes += sizeof(qint64) + sizeof(Type);
+}
+
+void ColumnarResults::appendText(int col, const QChar* data, int length)
+{
+    Column& column = this->data[col];
+    column.types << Type::TEXT;
+    qint64 valueBytes = static_cast<qint64>(length) * sizeof(QChar);
+    if (valueBytes >= LARGE_VALUE_BYTES)
+    {
+        column.cells << packSpan(LARGE_VALUE_OFFSET, column.largeTexts.size());
+        column.largeTexts << QString(data, length);
+    }
+    else
+    {
+        column.cells << packSpan(column.textArena.size(), length);
+        column.textArena.append(data, length);
+    }
+    bytes += sizeof(qint64) + sizeof(Type) + valueBytes;
+}
+
+void ColumnarResults::appendBlob(int col, const char* data, int length)
+{
+    Column& column = this->data[col];
+    column.types << Type::BLOB;
+    if (length >= LARGE_VALUE_BYTES)
+    {
+        column.cells << packSpan(LARGE_VALUE_OFFSET, column.largeBlobs.size());
+        column.largeBlobs << QByteArray(data, length);
+    }
+    else
+    {
+        column.cells << packSpan(column.blobArena.size(), length);
+        column.blobArena.append(data, length);
+    }
+    bytes += sizeof(qint64) + sizeof(Type) + length;
+}
+
+void ColumnarResults::finishRow()
+{
+    rows++;
+    finishedBytes = bytes;
+}
+
+void ColumnarResults::rollbackRow()
+{
+    for (Column& column : data)
+    {
+        if (column.types.size() <= rows)
+            continue;
+
+        qint64 slot = column.cells[rows];
+        if (column.types[rows] == Type::TEXT)
+        {
+            if (isLargeValue(slot))
+                column.largeTexts.resize(spanLength(slot));
+            else
+                column.textArena.truncate(spanOffset(slot));
+        }
+        else if (column.types[rows] == Type::BLOB)
+        {
+            if (isLargeValue(slot))
+                column.largeBlobs.resize(spanLength(slot));
+            else
+                column.blobArena.truncate(spanOffset(slot));
+        }
+
+        column.types.resize(rows);
+        column.cells.resize(rows);
+    }
+    bytes = finishedBytes;
+}
+
+bool ColumnarResults::isFull() const
+{
+    return rows >= capacity || bytes >= MAX_BLOCK_BYTES;
+}
+
+int ColumnarResults::rowCount() const
+{
+    return rows;
+}
+
+int ColumnarResults::columnCount() const
+{
+    return columns.size();
+}
+
+const QStringList& ColumnarResults::getColumns() const
+{
+    return columns;
+}
+
+qint64 ColumnarResults::byteCount() const
+{
+    return bytes;
+}
+
+ColumnarResults::Type ColumnarResults::type(int row, int col) const
+{
+    return data[col].types[row];
+}
+
+bool ColumnarResults::isNull(int row, int col) const
+{
+    return data[col].types[row] == Type::NULL_VALUE;
+}
+
+qint64 ColumnarResults::integer(int row, int col) const
+{
+    return data[col].cells[row];
+}
+
+double ColumnarResults::real(int row, int col) const
+{
+    double value;
+    qint64 bits = data[col].cells[row];
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+QVariant ColumnarResults::value(int row, int col) const
+{
+    const Column& column = data[col];
+    qint64 slot = column.cells[row];
+    switch (column.types[row])
+    {
+        case Type::INTEGER:
+            return slot;
+        case Type::REAL:
+            return real(row, col);
+        case Type::TEXT:
+        {
+            if (isLargeValue(slot))
+                return column.largeTexts[spanLength(slot)];
+
+            return QString(column.textArena.constData() + spanOffset(slot), spanLength(slot));
+        }
+        case Type::BLOB:
+        {
+            if (isLargeValue(slot))
+                return column.largeBlobs[spanLength(slot)];
+
+            return QByteArray(column.blobArena.constData() + spanOffset(slot), spanLength(slot));
+        }
+        case Type::NULL_VALUE:
+            break;
+    }
+    return QVariant(QVariant::String);
+}
+
+qint64 ColumnarResults::packSpan(int offset, int length)
+{
+    return static_cast<qint64>((static_cast<quint64>(static_cast<quint32>(offset)) << 32) | static_cast<quint32>(length));
+}
+
+int ColumnarResults::spanOffset(qint64 slot)
+{
+    return static_cast<qint32>(static_cast<quint64>(slot) >> 32);
+}
+
+int ColumnarResults::spanLength(qint64 slot)
+{
+    return static_cast<int>(slot & 0xFFFFFFFF);
+}
+
+bool ColumnarResults::isLargeValue(qint64 slot)
+{
+    return spanOffset(slot) == LARGE_VALUE_OFFSET;
+}
+
+ColumnarResultsRow::ColumnarResultsRow(const ColumnarResultsPtr& block, int row) :
+    block(block), row(row)
+{
+    columns = block->getColumns();
+    valuesLoaded = false;
+    valuesMapLoaded = false;
+}
+
+ColumnarResultsPtr ColumnarResultsRow::getBlock() const
+{
+    return block;
+}
+
+int ColumnarResultsRow::getRowIndex() const
+{
+    return row;
+}
+
+int ColumnarResultsRow::valueCount() const
+{
+    return block->columnCount();
+}
+
+QVariant ColumnarResultsRow::valueAt(int idx) const
+{
+    return block->value(row, idx);
+}
@@ -0,0 +1,183 @@
+#ifndef COLUMNARRESULTS_H
+#define COLUMNARRESULTS_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/sqlresultsrow.h"
+#include <QVector>
+#include <QStringList>
+#include <QSharedPointer>
+
+/**
+ * @brief Block of query results stored in per-column typed buffers.
+ *
+ * This is a storage used by Db::Flag::COLUMNAR_RESULTS mode. Instead of creating QVariant for every cell
+ * and QHash for every row, values are appended to typed buffers of each column. Integers and floating point
+ * values are kept in a single 64-bit slot, while text and blob values are kept in per-column arenas
+ * and the slot holds only offset and length of the value in the arena.
+ *
+ * The block has a fixed capacity of rows and a limit of bytes (see MAX_BLOCK_BYTES). Once any of them is reached,
+ * the query starts a new block, so the memory of older blocks is released as soon as nobody refers to rows
+ * from them anymore. Values of at least LARGE_VALUE_BYTES are not copied into arenas, they're kept as separate
+ * strings or byte arrays, so arenas stay small and a few huge values don't make the arena grow (and reallocate)
+ * beyond the limits of Qt containers.
+ * This keeps streaming consumers (like export) at a constant memory usage, while the preloaded results
+ * (like data grid pages) are kept as a couple of big allocations instead of millions of small ones.
+ *
+ * Values are read with ColumnarResultsRow, which is a lightweight view of a single row in the block.
+ */
+class API_EXPORT ColumnarResults
+{
+    public:
+        /**
+         * @brief Storage class of a single cell.
+         */
+        enum class Type : quint8
+        {
+            NULL_VALUE,
+            INTEGER,
+            REAL,
+            TEXT,
+            BLOB
+        };
+
+        /**
+         * @brief Default number of rows kept in a single block.
+         */
+        static const int DEFAULT_BLOCK_ROWS = 1024;
+
+        /**
+         * @brief Number of bytes of values, after which the block is considered full.
+         *
+         * A single row is never split between blocks, so the block may exceed it by the size of the last row.
+         */
+        static const int MAX_BLOCK_BYTES = 16 * 1024 * 1024;
+
+        /**
+         * @brief Size in bytes, from which a text or blob value is kept outside of the column arena.
+         */
+        static const int LARGE_VALUE_BYTES = 64 * 1024;
+
+        /**
+         * @brief Creates empty block.
+         * @param columns Column names of the results.
+         * @param capacity Number of rows that fit into this block.
+         */
+        ColumnarResults(const QStringList& columns, int capacity = DEFAULT_BLOCK_ROWS);
+
+        void appendNull(int col);
+        void appendInteger(int col, qint64 value);
+        void appendReal(int col, double value);
+        void appendText(int col, const QChar* data, int length);
+        void appendBlob(int col, const char* data, int length);
+
+        /**
+         * @brief Marks currently appended row as complete.
+         *
+         * Call it after value for each column was appended with one of append*() methods.
+         */
+        void finishRow();
+
+        /**
+         * @brief Discards values appended for the row that was not finished with finishRow().
+         */
+        void rollbackRow();
+
+        bool isFull() const;
+        int rowCount() const;
+        int columnCount() const;
+        const QStringList& getColumns() const;
+
+        /**
+         * @brief Provides approximate memory used by values in the block.
+         * @return Number of bytes.
+         */
+        qint64 byteCount() const;
+
+        Type type(int row, int col) const;
+        bool isNull(int row, int col) const;
+        qint64 integer(int row, int col) const;
+        double real(int row, int col) const;
+
+        /**
+         * @brief Provides value of the cell as QVariant.
+         * @param row 0-based row index in this block.
+         * @param col 0-based column index.
+         * @return Value converted in the same way as regular (non-columnar) results do it.
+         */
+        QVariant value(int row, int col) const;
+
+    private:
+        struct Column
+        {
+            QVector<Type> types;
+            QVector<qint64> cells;
+            QString textArena;
+            QByteArray blobArena;
+            QVector<QString> largeTexts;
+            QVector<QByteArray> largeBlobs;
+        };
+
+        /**
+         * @brief Offset stored in the slot of a value kept outside of the arena.
+         *
+         * Length part of such slot is the index of the value in Column::largeTexts or Column::largeBlobs.
+         */
+        static const int LARGE_VALUE_OFFSET = -1;
+
+        static qint64 packSpan(int offset, int length);
+        static int spanOffset(qint64 slot);
+        static int spanLength(qint64 slot);
+        static bool isLargeValue(qint64 slot);
+
+        QStringList columns;
+        QVector<Column> data;
+        int capacity = 0;
+        int rows = 0;
+        qint64 bytes = 0;
+
+        /**
+         * @brief Value of #bytes after the last finished row, used by rollbackRow().
+         */
+        qint64 finishedBytes = 0;
+};
+
+/**
+ * @brief Shared pointer to the columnar results block.
+ */
+typedef QSharedPointer<ColumnarResults> ColumnarResultsPtr;
+
+/**
+ * @brief View of a single row in the ColumnarResults block.
+ *
+ * It holds only reference to the block and index of the row. List of values and column->value hash
+ * are created only if somebody asks for valueList() or valueMap(). Calls to value() read directly from the block.
+ */
+class API_EXPORT ColumnarResultsRow : public SqlResultsRow
+{
+    public:
+        ColumnarResultsRow(const ColumnarResultsPtr& block, int row);
+
+        /**
+         * @brief Provides the block that this row belongs to.
+         * @return Columnar block.
+         *
+         * It can be used by consumers willing to read typed values (see ColumnarResults::type()) directly.
+         */
+        ColumnarResultsPtr getBlock() const;
+
+        /**
+         * @brief Provides index of this row in the block.
+         * @return 0-based row index.
+         */
+        int getRowIndex() const;
+
+    protected:
+        int valueCount() const;
+        QVariant valueAt(int idx) const;
+
+    private:
+        ColumnarResultsPtr block;
+        int row = 0;
+};
+
+#endif // COLUMNARRESULTS_H
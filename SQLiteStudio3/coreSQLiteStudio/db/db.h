@@ -23,6 +23,7 @@ class AsyncQueryRunner;
 class Db;
 class DbManager;
 class SqlQuery;
+class SqlValueBuffer;
 
 typedef QSharedPointer<SqlQuery> SqlQueryPtr;
 
@@ -35,6 +36,18 @@ typedef QSharedPointer<SqlQuery> SqlQueryPtr;
  */
 static_char* DB_PURE_INIT = "sqlitestudio_pure_db_initalization";
 
+/**
+ * @brief Option to open additional connections for reading.
+ *
+ * The value is the number of additional connections to open. They are used only when the database
+ * is in the WAL journal mode, where readers don't block the writer (and the other way around).
+ * SELECT queries executed with Db::exec() and Db::Flag::READ_POOL outside of a transaction are then executed
+ * in one of these connections, so they can run in parallel with other queries.
+ *
+ * For SQLite 3 databases it's one of connection options the user can set in the database dialog.
+ */
+static_char* DB_READ_POOL_SIZE = "sqlitestudio_read_pool_size";
+
 /**
  * @brief Option name for plugin handling the database.
  *
@@ -151,6 +164,14 @@ class API_EXPORT Db : public QObject, public Interruptable
                                         *   Benefit is that it speeds up execution. */
             SKIP_PARAM_COUNTING = 0x8, /**< During execution with arguments as list the number of bind parameters will not be verified.
                                         *   This speeds up execution at cost of possible error if bind params in query don't match number of args. */
+            COLUMNAR_RESULTS    = 0x10, /**< Results rows are stored in per-column typed buffers (see ColumnarResults) instead of
+                                         *   a list of QVariant per row. Each returned row is a lightweight view into those buffers.
+                                         *   This greatly reduces number of memory allocations for big result sets. */
+            READ_POOL           = 0x20, /**< SELECT query may be executed in one of additional read connections (see DB_READ_POOL_SIZE).
+                                         *   These connections don't see temporary objects, attached databases, nor any PRAGMA
+                                         *   settings of this connection, so use it only for queries that don't depend on them.
+                                         *   Combined with NO_LOCK it means that the query is not a part of any other operation
+                                         *   on this connection. The read connection is locked anyway. */
         };
         Q_DECLARE_FLAGS(Flags, Flag)
 
@@ -162,6 +183,11 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         typedef std::function<void(SqlQueryPtr)> QueryResultsHandler;
 
+        /**
+         * @brief Function telling if a long lasting operation should stop.
+         */
+        typedef std::function<bool()> InterruptedCheck;
+
         /**
          * @brief Default, empty constructor.
          */
@@ -194,6 +220,14 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual bool isOpen() = 0;
 
+        /**
+         * @brief Checks if there is a transaction in progress on the database connection.
+         * @return true if the connection is not in autocommit mode, or if the implementation cannot tell it.
+         *
+         * It covers transactions started both with begin() and with a BEGIN statement executed by the user.
+         */
+        virtual bool isTransactionActive() = 0;
+
         /**
          * @brief Gets database symbolic name.
          * @return Database symbolic name (as it was defined in call to DbManager#addDb() or DbManager#updateDb()).
@@ -292,6 +326,39 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual QList<AliasedColumn> columnsForQuery(const QString& query) = 0;
 
+        /**
+         * @brief Copies results of a query from this database into another database.
+         * @param selectQuery Query returning rows to copy. It's executed in this database.
+         * @param dstDb Database to insert rows into.
+         * @param insertQuery Query inserting single row into the destination database, with one positional parameter
+         * per each result column of the select query.
+         * @param interrupted Function checked between batches of rows. If it returns true, copying stops.
+         * @param errorMessage Filled with details of the error, if there was one.
+         * @return true if all rows were copied, or false on error or interruption.
+         *
+         * This is much faster than executing the select query and then the insert query for each row with exec(),
+         * because values are not converted to QVariant and back. If both databases use the same SQLite library,
+         * values are passed directly from one statement to the other. Otherwise rows are read in batches into
+         * SqlValueBuffer and inserted with insertRows() of the destination database.
+         *
+         * The method doesn't start any transaction, so the caller should do it for both databases
+         * (otherwise every inserted row is committed separately).
+         */
+        virtual bool copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                      QString& errorMessage) = 0;
+
+        /**
+         * @brief Inserts rows from the buffer into this database.
+         * @param insertQuery Query inserting single row, with one positional parameter per each column of the buffer.
+         * @param rows Rows to insert.
+         * @param errorMessage Filled with details of the error, if there was one.
+         * @return true if all rows were inserted, or false on error.
+         *
+         * The insert query is prepared once and executed for each row.
+         * It's used by copyQueryResults() when source database uses different SQLite library.
+         */
+        virtual bool insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage) = 0;
+
         /**
          * @brief Executes SQL query.
          * @param query Query to be executed. Parameter placeholders can be either of: ?, :param, \@param, just don't mix different types in single query.
@@ -14,3 +14,8 @@ bool DbSqlite3::complete(const QString& sql)
 {
     return Sqlite3::complete(sql.toUtf8().constData());
 }
+
+AbstractDb3<Sqlite3>* DbSqlite3::createReadConnection(const QHash<QString, QVariant>& options)
+{
+    return new DbSqlite3(name, path, options);
+}
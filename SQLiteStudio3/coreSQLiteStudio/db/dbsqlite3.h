@@ -30,6 +30,9 @@ class API_EXPORT DbSqlite3 : public AbstractDb3<Sqlite3>
         DbSqlite3(const QString& name, const QString& path);
 
         static bool complete(const QString& sql);
+
+    protected:
+        AbstractDb3<Sqlite3>* createReadConnection(const QHash<QString, QVariant>& options);
 };
 
 #endif // DBSQLITE3_H
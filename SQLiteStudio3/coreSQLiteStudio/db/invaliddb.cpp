@@ -12,6 +12,11 @@ bool InvalidDb::isOpen()
     return false;
 }
 
+bool InvalidDb::isTransactionActive()
+{
+    return false;
+}
+
 QString InvalidDb::getName() const
 {
     return name;
@@ -68,6 +73,25 @@ QList<AliasedColumn> InvalidDb::columnsForQuery(const QString& query)
     return QList<AliasedColumn>();
 }
 
+bool InvalidDb::copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                                 QString& errorMessage)
+{
+    UNUSED(selectQuery);
+    UNUSED(dstDb);
+    UNUSED(insertQuery);
+    UNUSED(interrupted);
+    errorMessage = error;
+    return false;
+}
+
+bool InvalidDb::insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage)
+{
+    UNUSED(insertQuery);
+    UNUSED(rows);
+    errorMessage = error;
+    return false;
+}
+
 SqlQueryPtr InvalidDb::exec(const QString& query, const QList<QVariant>& args, Db::Flags flags)
 {
     UNUSED(query);
@@ -9,6 +9,7 @@ class API_EXPORT InvalidDb : public Db
         InvalidDb(const QString& name, const QString& path, const QHash<QString, QVariant>& connOptions);
 
         bool isOpen();
+        bool isTransactionActive();
         QString getName() const;
         QString getPath() const;
         quint8 getVersion() const;
@@ -20,6 +21,9 @@ class API_EXPORT InvalidDb : public Db
         void setTimeout(int secs);
         int getTimeout() const;
         QList<AliasedColumn> columnsForQuery(const QString& query);
+        bool copyQueryResults(const QString& selectQuery, Db* dstDb, const QString& insertQuery, InterruptedCheck interrupted,
+                              QString& errorMessage);
+        bool insertRows(const QString& insertQuery, const SqlValueBuffer& rows, QString& errorMessage);
         SqlQueryPtr exec(const QString& query, const QList<QVariant>& args, Flags flags);
         SqlQueryPtr exec(const QString& query, const QHash<QString, QVariant>& args, Flags flags);
         SqlQueryPtr exec(const QString& query, Db::Flags flags);
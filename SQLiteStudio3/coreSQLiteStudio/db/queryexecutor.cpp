@@ -24,6 +24,7 @@
 #include "schemaresolver.h"
 #include "parser/lexer.h"
 #include "common/table.h"
+#include "common/utils_sql.h"
 #include <QMutexLocker>
 #include <QDateTime>
 #include <QThreadPool>
@@ -141,6 +142,7 @@ void QueryExecutor::executeChain()
 {
     // Go through all remaining steps
     bool result;
+    QElapsedTimer stepTimer;
     for (QueryExecutorStep* currentStep : executionChain)
     {
         if (isInterrupted())
@@ -150,7 +152,13 @@ void QueryExecutor::executeChain()
         }
 
         logExecutorStep(currentStep);
+        if (context->profilingMode)
+            stepTimer.start();
+
         result = currentStep->exec();
+        if (context->profilingMode)
+            addProfileStep(getProfileStepName(currentStep), stepTimer.nsecsElapsed());
+
         logExecutorAfterStep(context->processedQuery);
 
         if (!result)
@@ -210,6 +218,9 @@ void QueryExecutor::cleanupBeforeDbDestroy(Db* dbToBeUnloaded)
 
 void QueryExecutor::setQuery(const QString& query)
 {
+    if (originalQuery != query)
+        clearKeysetBoundaries();
+
     originalQuery = query;
 }
 
@@ -256,6 +267,7 @@ void QueryExecutor::execInternal()
     queriesForSimpleExecution.clear();
     if (forceSimpleMode)
     {
+        resetProfile();
         executeSimpleMethod();
         return;
     }
@@ -268,6 +280,7 @@ void QueryExecutor::execInternal()
         {
             qDebug() << "Number of queries" << queryCount << "exceeds maximum number allowed for smart execution method" <<
                         queryCountLimitForSmartMode << ". Simple method will be used to retain efficiency.";
+            resetProfile();
             executeSimpleMethod();
             return;
         }
@@ -289,6 +302,7 @@ void QueryExecutor::execInternal()
     context->processedQuery = originalQuery;
     context->explainMode = explainMode;
     context->skipRowCounting = skipRowCounting;
+    context->profilingMode = profilingMode;
     context->noMetaColumns = noMetaColumns;
     context->resultsHandler = resultsHandler;
     context->preloadResults = preloadResults;
@@ -320,14 +334,26 @@ bool QueryExecutor::countResults()
     if (context->countingQuery.isEmpty()) // simple method doesn't provide that
         return false;
 
+    // Counting can run in a read connection, in parallel with fetching data of the page.
+    // If it refers to objects existing only in this connection, it's executed here again.
+    Db::Flags countingFlags = Db::Flag::NO_LOCK|Db::Flag::READ_POOL;
+
     if (asyncMode)
     {
         // Start asynchronous results counting query
-        resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        if (context->profilingMode)
+            profileTimer.start();
+
+        resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, countingFlags);
     }
     else
     {
-        SqlQueryPtr results = db->exec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        QElapsedTimer countingTimer;
+        countingTimer.start();
+        SqlQueryPtr results = db->exec(context->countingQuery, context->queryParameters, countingFlags);
+        if (context->profilingMode)
+            context->profile.countingTime = countingTimer.nsecsElapsed();
+
         context->totalRowsReturned = results->getSingleCell().toLongLong();
         context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
 
@@ -421,11 +447,17 @@ QSet<QueryExecutor::EditionForbiddenReason> QueryExecutor::getEditionForbiddenGl
 
 void QueryExecutor::setParam(const QString& name, const QVariant& value)
 {
+    if (queryParameters.value(name) != value)
+        clearKeysetBoundaries();
+
     queryParameters[name] = value;
 }
 
 void QueryExecutor::setParams(const QHash<QString, QVariant>& params)
 {
+    if (queryParameters != params)
+        clearKeysetBoundaries();
+
     queryParameters = params;
 }
 
@@ -439,6 +471,7 @@ void QueryExecutor::executeSimpleMethod()
 {
     simpleExecution = true;
     context->editionForbiddenReasons << EditionForbiddenReason::SMART_EXECUTION_FAILED;
+    context->profile.simpleMethod = true;
     if (queriesForSimpleExecution.isEmpty())
         queriesForSimpleExecution = quickSplitQueries(originalQuery, false, true);
 
@@ -449,6 +482,9 @@ void QueryExecutor::executeSimpleMethod()
     simpleExecutor->setAsync(false); // this is already in a thread
 
     simpleExecutionStartTime = QDateTime::currentMSecsSinceEpoch();
+    if (context->profilingMode)
+        profileTimer.start();
+
     simpleExecutor->exec();
 }
 
@@ -463,6 +499,13 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
         return;
     }
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - simpleExecutionStartTime;
+    if (context->profilingMode)
+    {
+        QString lastQuery = simpleExecutor->getQueries().last();
+        addProfileStep("SimpleExecution", profileTimer.nsecsElapsed());
+        collectResultsProfile(results, lastQuery);
+        collectQueryPlanProfile(lastQuery, queryParameters);
+    }
 
     if (simpleExecIsSelect())
         context->countingQuery = "SELECT count(*) AS cnt FROM ("+trimQueryEnd(queriesForSimpleExecution.last())+");";
@@ -574,6 +617,8 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         return false;
 
     resultsCountingAsyncId = 0;
+    if (context->profilingMode)
+        context->profile.countingTime = profileTimer.nsecsElapsed();
 
     context->totalRowsReturned = results->getSingleCell().toLongLong();
     context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
@@ -589,6 +634,74 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
     return true;
 }
 
+void QueryExecutor::collectResultsProfile(SqlQueryPtr results, const QString& query)
+{
+    Profile& profile = context->profile;
+    profile.profiledQuery = query;
+
+    QElapsedTimer fetchTimer;
+    fetchTimer.start();
+    results->preload();
+    profile.fetchTime = fetchTimer.nsecsElapsed();
+    profile.statementStats = results->getStatementStats();
+}
+
+void QueryExecutor::collectQueryPlanProfile(const QString& query, const QHash<QString, QVariant>& params)
+{
+    static_qstring(planTpl, "EXPLAIN QUERY PLAN %1");
+
+    Profile& profile = context->profile;
+    profile.queryPlan.clear();
+    if (getLeadingWord(query).compare("EXPLAIN", Qt::CaseInsensitive) == 0)
+        return;
+
+    SqlQueryPtr planResults = db->exec(planTpl.arg(query), params);
+    if (planResults->isError())
+    {
+        qDebug() << "Could not determine query plan for the execution profile:" << planResults->getErrorText();
+        return;
+    }
+
+    QueryPlanRow planRow;
+    SqlResultsRowPtr row;
+    while (planResults->hasNext())
+    {
+        row = planResults->next();
+        planRow.id = row->value("id").toInt();
+        planRow.parentId = row->value("parent").toInt();
+        planRow.detail = row->value("detail").toString();
+        profile.queryPlan << planRow;
+    }
+}
+
+void QueryExecutor::resetProfile()
+{
+    context->profilingMode = profilingMode;
+    context->profile = Profile();
+}
+
+void QueryExecutor::addProfileStep(const QString& name, qint64 time)
+{
+    ProfileStep step;
+    step.name = name;
+    step.time = time;
+    context->profile.steps << step;
+}
+
+QString QueryExecutor::getProfileStepName(QueryExecutorStep* step)
+{
+    static_qstring(classPrefix, "QueryExecutor");
+
+    QString name = QString::fromLatin1(step->metaObject()->className());
+    if (name.startsWith(classPrefix) && name.size() > classPrefix.size())
+        name = name.mid(classPrefix.size());
+
+    if (!step->objectName().isEmpty())
+        name += " (" + step->objectName() + ")";
+
+    return name;
+}
+
 QStringList QueryExecutor::applyLimitForSimpleMethod(const QStringList &queries)
 {
     static_qstring(tpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
@@ -812,6 +925,21 @@ void QueryExecutor::setExplainMode(bool value)
     explainMode = value;
 }
 
+bool QueryExecutor::getProfilingMode() const
+{
+    return profilingMode;
+}
+
+void QueryExecutor::setProfilingMode(bool value)
+{
+    profilingMode = value;
+}
+
+QueryExecutor::Profile QueryExecutor::getProfile() const
+{
+    return context->profile;
+}
+
 
 void QueryExecutor::error(int code, const QString& text)
 {
@@ -886,6 +1014,9 @@ int QueryExecutor::getResultsPerPage() const
 
 void QueryExecutor::setResultsPerPage(int value)
 {
+    if (resultsPerPage != value)
+        clearKeysetBoundaries();
+
     resultsPerPage = value;
 }
 
@@ -899,6 +1030,47 @@ void QueryExecutor::setPage(int value)
     page = value;
 }
 
+bool QueryExecutor::getKeysetPaging() const
+{
+    return keysetPaging;
+}
+
+void QueryExecutor::setKeysetPaging(bool value)
+{
+    keysetPaging = value;
+    clearKeysetBoundaries();
+}
+
+bool QueryExecutor::hasKeysetBoundary(int page, const QStringList& columns) const
+{
+    QMutexLocker lock(&keysetMutex);
+    return keysetBoundaryColumns == columns && keysetBoundaries.contains(page);
+}
+
+QList<QVariant> QueryExecutor::getKeysetBoundary(int page) const
+{
+    QMutexLocker lock(&keysetMutex);
+    return keysetBoundaries.value(page);
+}
+
+void QueryExecutor::setKeysetBoundary(int page, const QStringList& columns, const QList<QVariant>& values)
+{
+    QMutexLocker lock(&keysetMutex);
+    if (keysetBoundaryColumns != columns)
+    {
+        keysetBoundaries.clear();
+        keysetBoundaryColumns = columns;
+    }
+    keysetBoundaries[page] = values;
+}
+
+void QueryExecutor::clearKeysetBoundaries()
+{
+    QMutexLocker lock(&keysetMutex);
+    keysetBoundaries.clear();
+    keysetBoundaryColumns.clear();
+}
+
 bool QueryExecutor::isExecutionInProgress()
 {
     QMutexLocker executionLock(&executionMutex);
@@ -948,6 +1120,13 @@ QueryExecutor::SortList QueryExecutor::getSortOrder() const
 
 void QueryExecutor::setSortOrder(const SortList& value)
 {
+    bool changed = (sortOrder.size() != value.size());
+    for (int i = 0; !changed && i < value.size(); i++)
+        changed = (sortOrder[i].column != value[i].column || sortOrder[i].order != value[i].order);
+
+    if (changed)
+        clearKeysetBoundaries();
+
     sortOrder = value;
 }
 
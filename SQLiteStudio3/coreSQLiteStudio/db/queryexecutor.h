@@ -2,6 +2,7 @@
 #define QUERYEXECUTOR_H
 
 #include "db/db.h"
+#include "db/sqlquery.h"
 #include "parser/token.h"
 #include "selectresolver.h"
 #include "coreSQLiteStudio_global.h"
@@ -11,6 +12,7 @@
 #include <QHash>
 #include <QMutex>
 #include <QRunnable>
+#include <QElapsedTimer>
 
 /** @file */
 
@@ -105,6 +107,8 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
 {
     Q_OBJECT
 
+    friend class QueryExecutorExecute;
+
     public:
         /**
          * @brief General reasons for which results data cannot be edited.
@@ -413,6 +417,100 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         typedef QSharedPointer<SourceTable> SourceTablePtr;
 
+        /**
+         * @brief Wall time of a single phase of the query execution.
+         */
+        struct ProfileStep
+        {
+            /**
+             * @brief Name of the phase.
+             *
+             * For executor steps it's the class name of the step (without the QueryExecutor prefix),
+             * followed by the name of the step instance, if it has one (like "ParseQuery (after Attaches)").
+             */
+            QString name;
+
+            /**
+             * @brief Time spent in the phase, in nanoseconds.
+             */
+            qint64 time = 0;
+        };
+
+        /**
+         * @brief Single row of the EXPLAIN QUERY PLAN results.
+         */
+        struct QueryPlanRow
+        {
+            int id = 0;
+
+            /**
+             * @brief ID of the parent row, or 0 for top level rows.
+             */
+            int parentId = 0;
+
+            QString detail;
+        };
+
+        /**
+         * @brief Profile of the query execution.
+         *
+         * It's collected only in profiling mode (see setProfilingMode()) and it tells how much time was spent
+         * in query preprocessing done by the executor (steps of the smart execution method) and how much
+         * in SQLite itself, and how SQLite executed the final query.
+         *
+         * Counters and the query plan are collected only for the last query, because its results
+         * are the ones presented to the user.
+         */
+        struct Profile
+        {
+            /**
+             * @brief Phases of the execution, in order of execution.
+             *
+             * For the smart execution method these are the executor steps, up to the step that failed, if any.
+             * The simple execution method (including fallback from failed smart method) adds a single
+             * "SimpleExecution" phase.
+             */
+            QList<ProfileStep> steps;
+
+            /**
+             * @brief Tells if the simple execution method was used.
+             */
+            bool simpleMethod = false;
+
+            /**
+             * @brief The last query, in its final form, as it was executed.
+             */
+            QString profiledQuery;
+
+            /**
+             * @brief Time of reading results of the last query, in nanoseconds.
+             *
+             * In profiling mode the page of results is read entirely right after the execution,
+             * so this is the time SQLite spent on producing the rows. For the smart execution method
+             * it's part of the "Execute" phase. It's -1 if results were not read.
+             */
+            qint64 fetchTime = -1;
+
+            /**
+             * @brief Time of the row counting query execution, in nanoseconds.
+             *
+             * It's -1 until the counting is done (see countResults()).
+             */
+            qint64 countingTime = -1;
+
+            /**
+             * @brief Counters of the last query statement.
+             */
+            SqlQuery::StatementStats statementStats;
+
+            /**
+             * @brief EXPLAIN QUERY PLAN results for the last query.
+             *
+             * It's empty if the plan could not be determined (for example for EXPLAIN or PRAGMA queries).
+             */
+            QList<QueryPlanRow> queryPlan;
+        };
+
         /**
          * @brief Query execution context.
          *
@@ -508,6 +606,22 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             bool skipRowCounting = false;
 
+            /**
+             * @brief Collecting execution profile.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setProfilingMode().
+             */
+            bool profilingMode = false;
+
+            /**
+             * @brief Execution profile.
+             *
+             * Filled only if profilingMode is enabled. Steps are timed by QueryExecutor,
+             * while results related data is provided by QueryExecutorExecute step.
+             */
+            Profile profile;
+
             /**
              * @brief Parameters for query execution.
              *
@@ -613,6 +727,18 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             bool preloadResults = false;
 
+            /**
+             * @brief Result columns used as the paging key.
+             *
+             * Defined by QueryExecutorLimit step if the page was selected with keyset (seek) method
+             * (see QueryExecutor::setKeysetPaging()). These are query executor aliases of columns, in the order
+             * used by ORDER BY of the final query. It's empty if the OFFSET method was used.
+             *
+             * QueryExecutorExecute uses it to remember key of the last row on the page,
+             * so the next page can be selected with WHERE clause instead of the OFFSET.
+             */
+            QStringList keysetColumns;
+
             /**
              * @brief Tells if executed queries did modify database schema.
              *
@@ -991,6 +1117,60 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setPage(int value);
 
+        /**
+         * @brief Tests if keyset (seek) paging is enabled.
+         * @return true if enabled, false otherwise.
+         *
+         * See setKeysetPaging() for details.
+         */
+        bool getKeysetPaging() const;
+
+        /**
+         * @brief Enables or disables keyset (seek) paging.
+         * @param value true to enable the keyset paging.
+         *
+         * By default pages are selected with "LIMIT n OFFSET m", which makes SQLite to step through all skipped rows,
+         * so the cost of reading a page grows with its index.
+         *
+         * When keyset paging is enabled and the query reads from a single table (so it has ROWID columns provided by
+         * QueryExecutorAddRowIds), results are ordered by the ROWID (or by the single sort column defined with setSortOrder(),
+         * followed by the ROWID) and the executor remembers the key of the last row of each loaded page.
+         * The page directly following an already loaded page is then selected with "WHERE key > last_key LIMIT n",
+         * which costs the same regardless of the page index. Jumps to pages that don't follow any loaded page fall back
+         * to the OFFSET method.
+         *
+         * Remembered keys are dropped whenever the query, its parameters, the sort order or the page size change.
+         */
+        void setKeysetPaging(bool value);
+
+        /**
+         * @brief Tells if the key of the last row of given page is known.
+         * @param page 0-based page index.
+         * @param columns Key columns that the caller is going to use.
+         * @return true if the key was remembered for the same key columns.
+         */
+        bool hasKeysetBoundary(int page, const QStringList& columns) const;
+
+        /**
+         * @brief Provides key of the last row of given page.
+         * @param page 0-based page index.
+         * @return Values of key columns, in order of Context::keysetColumns. Empty list if not known.
+         */
+        QList<QVariant> getKeysetBoundary(int page) const;
+
+        /**
+         * @brief Remembers key of the last row of given page.
+         * @param page 0-based page index.
+         * @param columns Key columns (query executor aliases).
+         * @param values Values of key columns in the last row of the page.
+         */
+        void setKeysetBoundary(int page, const QStringList& columns, const QList<QVariant>& values);
+
+        /**
+         * @brief Forgets all keys remembered for the keyset paging.
+         */
+        void clearKeysetBoundaries();
+
         /**
          * @brief Tests if there's any execution in progress at the moment.
          * @return true if the execution is in progress, or false otherwise.
@@ -1056,6 +1236,34 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setExplainMode(bool value);
 
+        /**
+         * @brief Tests if execution profile is collected.
+         * @return true if the profiling mode is enabled, or false otherwise.
+         */
+        bool getProfilingMode() const;
+
+        /**
+         * @brief Defines profiling mode for next query execution.
+         * @param value true to collect execution profile, or false to disable it.
+         *
+         * In profiling mode the executor measures time of each executor step, reads the whole page
+         * of results right after the execution, collects SQLite counters of the last statement
+         * and its EXPLAIN QUERY PLAN. The profile is available with getProfile() once
+         * the execution is finished.
+         *
+         * Profiling adds the cost of the query plan determination to the execution,
+         * so it's disabled by default.
+         */
+        void setProfilingMode(bool value);
+
+        /**
+         * @brief Provides profile of the recent execution.
+         * @return Execution profile. It's empty if the profiling mode was disabled.
+         *
+         * See Profile for details.
+         */
+        Profile getProfile() const;
+
         /**
          * @brief Defines results preloading.
          * @param value true to preload results.
@@ -1223,6 +1431,35 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
 
         QStringList applyLimitForSimpleMethod(const QStringList &queries);
 
+        /**
+         * @brief Prepares empty execution profile.
+         *
+         * It's used when the simple execution method is started directly, without resetting the whole context.
+         */
+        void resetProfile();
+
+        void addProfileStep(const QString& name, qint64 time);
+        QString getProfileStepName(QueryExecutorStep* step);
+
+        /**
+         * @brief Fills execution profile with results of the last query.
+         * @param results Results of the last query. They're preloaded by this method.
+         * @param query The last query, as it was executed.
+         *
+         * Measures time of reading the results and reads the statement counters.
+         * It's called by the executor (or its QueryExecutorExecute step) in profiling mode only.
+         */
+        void collectResultsProfile(SqlQueryPtr results, const QString& query);
+
+        /**
+         * @brief Fills execution profile with the plan of the last query.
+         * @param query The last query, as it was executed.
+         * @param params Parameters bound to the query.
+         *
+         * It's called by the executor (or its QueryExecutorExecute step) in profiling mode only.
+         */
+        void collectQueryPlanProfile(const QString& query, const QHash<QString, QVariant>& params);
+
         /**
          * @brief Creates instances of steps for all registered factories for given position.
          * @param position Position for which factories will be used.
@@ -1296,6 +1533,27 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         SortList sortOrder;
 
+        /**
+         * @brief Flag indicating that keyset paging is enabled.
+         *
+         * See setKeysetPaging() for details.
+         */
+        bool keysetPaging = false;
+
+        /**
+         * @brief Key columns that the #keysetBoundaries were remembered for.
+         */
+        QStringList keysetBoundaryColumns;
+
+        /**
+         * @brief Keys of last rows of loaded pages.
+         *
+         * Page index is the key and values of key columns are the value.
+         * Accessed from execution thread, therefore protected by #keysetMutex.
+         */
+        QHash<int,QList<QVariant>> keysetBoundaries;
+        mutable QMutex keysetMutex;
+
         /**
          * @brief Flag indicating that the execution is currently in progress.
          *
@@ -1332,6 +1590,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool explainMode = false;
 
+        /**
+         * @brief Flag indicating that the execution profile is collected.
+         *
+         * See setProfilingMode() for details.
+         */
+        bool profilingMode = false;
+
         /**
          * @brief Flag indicating that the row counting was disabled.
          *
@@ -1362,6 +1627,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         qint64 simpleExecutionStartTime;
 
+        /**
+         * @brief Measures duration of the simple execution and of the asynchronous row counting.
+         *
+         * Used only in profiling mode.
+         */
+        QElapsedTimer profileTimer;
+
         /**
          * @brief Asynchronous ID of counting query execution.
          *
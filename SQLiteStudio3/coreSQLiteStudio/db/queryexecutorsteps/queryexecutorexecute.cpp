@@ -38,7 +38,7 @@ bool QueryExecutorExecute::executeQueries()
     context->rowsAffected = 0;
     QStack<int> rowsAffectedBeforeTransaction;
 
-    Db::Flags flags;
+    Db::Flags flags = Db::Flag::COLUMNAR_RESULTS;
     if (context->preloadResults)
         flags |= Db::Flag::PRELOAD;
 
@@ -74,7 +74,17 @@ bool QueryExecutorExecute::executeQueries()
                 context->rowsAffected = rowsAffectedBeforeTransaction.pop();
         }
     }
+
+    // Results are read for the profile before they are handled, so the statement counters cover all rows,
+    // while the query plan is determined after that, as it's done only for the profile.
+    if (context->profilingMode)
+        queryExecutor->collectResultsProfile(results, queryStr);
+
     handleSuccessfulResult(results);
+
+    if (context->profilingMode)
+        queryExecutor->collectQueryPlanProfile(queryStr, bindParamsForQuery);
+
     return true;
 }
 
@@ -90,11 +100,18 @@ void QueryExecutorExecute::handleSuccessfulResult(SqlQueryPtr results)
 
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - startTime;
 
+    // Rows read only for the profile would not be read here otherwise, so reading them doesn't count as the execution
+    if (context->profilingMode && context->profile.fetchTime > 0)
+        context->executionTime = qMax(0LL, context->executionTime - context->profile.fetchTime / 1000000);
+
     // For PRAGMA and EXPLAIN we simply count results for rows returned
     SqliteQueryPtr lastQuery = context->parsedQueries.last();
     if (lastQuery->queryType != SqliteQueryType::Select || lastQuery->explain)
         context->rowsCountingRequired = true;
 
+    if (!context->keysetColumns.isEmpty())
+        storeKeysetBoundary(results);
+
     if (context->resultsHandler)
     {
         context->resultsHandler(results);
@@ -104,6 +121,26 @@ void QueryExecutorExecute::handleSuccessfulResult(SqlQueryPtr results)
     context->executionResults = results;
 }
 
+void QueryExecutorExecute::storeKeysetBoundary(SqlQueryPtr results)
+{
+    // Page is limited by the Limit step, so preloading it here is cheap.
+    QList<SqlResultsRowPtr> rows = results->getAll();
+    if (rows.isEmpty())
+        return;
+
+    SqlResultsRowPtr lastRow = rows.last();
+    QList<QVariant> values;
+    for (const QString& col : context->keysetColumns)
+    {
+        if (!lastRow->contains(col))
+            return;
+
+        values << lastRow->value(col);
+    }
+
+    queryExecutor->setKeysetBoundary(queryExecutor->getPage(), context->keysetColumns, values);
+}
+
 void QueryExecutorExecute::handleFailResult(SqlQueryPtr results)
 {
     if (!results->isInterrupted())
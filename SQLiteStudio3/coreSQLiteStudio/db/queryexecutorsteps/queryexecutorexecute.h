@@ -42,6 +42,9 @@ class QueryExecutorExecute : public QueryExecutorStep
          *
          * If QueryExecutor::Context::preloadResults is true, then also Db::Flag::PRELOAD
          * is appended to execution flags.
+         *
+         * In profiling mode results of the last query are preloaded and profiled
+         * with QueryExecutor::collectResultsProfile() and QueryExecutor::collectQueryPlanProfile().
          */
         bool executeQueries();
 
@@ -53,6 +56,15 @@ class QueryExecutorExecute : public QueryExecutorStep
          */
         void handleSuccessfulResult(SqlQueryPtr results);
 
+        /**
+         * @brief Remembers paging key of the last row in results.
+         * @param results Execution results.
+         *
+         * Used when the Limit step applied keyset paging (see QueryExecutor::Context::keysetColumns),
+         * so the next page can be selected by seeking from this key, instead of using OFFSET.
+         */
+        void storeKeysetBoundary(SqlQueryPtr results);
+
         /**
          * @brief Handles failed execution.
          * @param results Execution results.
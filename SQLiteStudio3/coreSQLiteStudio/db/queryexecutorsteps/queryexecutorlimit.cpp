@@ -1,4 +1,7 @@
 #include "queryexecutorlimit.h"
+#include "common/utils_sql.h"
+#include "schemaresolver.h"
+#include "parser/ast/sqlitecreatetable.h"
 #include <QDebug>
 
 bool QueryExecutorLimit::exec()
@@ -17,13 +20,181 @@ bool QueryExecutorLimit::exec()
     quint64 limit = queryExecutor->getResultsPerPage();
     quint64 offset = limit * page;
 
-    // The original query is last, so if it contained any %N strings,
-    // they won't be replaced.
-    static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
-    QString newSelect = selectTpl.arg(select->detokenize(), QString::number(limit), QString::number(offset));
+    QString newSelect;
+    if (queryExecutor->getKeysetPaging())
+        newSelect = getKeysetSelect(select, page, limit);
+
+    if (newSelect.isNull())
+    {
+        // The original query is last, so if it contained any %N strings,
+        // they won't be replaced.
+        static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
+        newSelect = selectTpl.arg(select->detokenize(), QString::number(limit), QString::number(offset));
+    }
 
     int begin = select->tokens.first()->start;
     int length = select->tokens.last()->end - select->tokens.first()->start + 1;
     context->processedQuery = context->processedQuery.replace(begin, length, newSelect);
     return true;
 }
+
+QString QueryExecutorLimit::getKeysetSelect(SqliteSelectPtr select, int page, quint64 limit)
+{
+    static_qstring(firstPageTpl, "SELECT * FROM (%1) ORDER BY %2 LIMIT %3");
+    static_qstring(seekTpl, "SELECT * FROM (%1) WHERE %2 ORDER BY %3 LIMIT %4");
+    static_qstring(offsetTpl, "SELECT * FROM (%1) ORDER BY %2 LIMIT %3 OFFSET %4");
+    static_qstring(seekCondTpl, "(%1) %2 (%3)");
+    static_qstring(nullsAfterTpl, "(%1 OR %2 IS NULL)");
+    static_qstring(paramTpl, ":sqlitestudio_keyset_%1");
+
+    bool desc = false;
+    bool nullableFirst = false;
+    QStringList keyColumns = getKeysetColumns(select, desc, nullableFirst);
+    if (keyColumns.isEmpty())
+        return QString();
+
+    QStringList wrappedColumns;
+    QStringList orderBy;
+    for (const QString& col : keyColumns)
+    {
+        wrappedColumns << wrapObjIfNeeded(col);
+        orderBy << wrappedColumns.last() + (desc ? " DESC" : " ASC");
+    }
+
+    context->keysetColumns = keyColumns;
+    QString selectStr = select->detokenize();
+    QString orderByStr = orderBy.join(", ");
+    QString limitStr = QString::number(limit);
+    if (page == 0)
+        return firstPageTpl.arg(selectStr, orderByStr, limitStr);
+
+    QList<QVariant> boundary;
+    if (queryExecutor->hasKeysetBoundary(page - 1, keyColumns))
+        boundary = queryExecutor->getKeysetBoundary(page - 1);
+
+    bool boundaryUsable = (boundary.size() == keyColumns.size());
+    for (const QVariant& value : boundary)
+    {
+        // Row value comparison with NULL is never true, so we cannot seek from such key.
+        if (value.isNull())
+            boundaryUsable = false;
+    }
+
+    if (!boundaryUsable)
+        return offsetTpl.arg(selectStr, orderByStr, limitStr, QString::number(limit * page));
+
+    QStringList params;
+    QString paramName;
+    for (int i = 0; i < boundary.size(); i++)
+    {
+        paramName = paramTpl.arg(i);
+        params << paramName;
+        context->queryParameters[paramName] = boundary[i];
+    }
+
+    QString condition = seekCondTpl.arg(wrappedColumns.join(", "), desc ? "<" : ">", params.join(", "));
+    if (desc && nullableFirst)
+        condition = nullsAfterTpl.arg(condition, wrappedColumns.first()); // NULLs go last in descending order
+
+    return seekTpl.arg(selectStr, condition, orderByStr, limitStr);
+}
+
+QStringList QueryExecutorLimit::getKeysetColumns(SqliteSelectPtr select, bool& desc, bool& nullableFirst)
+{
+    QStringList columns;
+
+    // With single data source table the ROWID is unique across result rows.
+    if (context->rowIdColumns.size() != 1)
+        return columns;
+
+    QStringList rowIdColumns = getRowIdKeyColumns(context->rowIdColumns.first());
+    if (rowIdColumns.isEmpty())
+        return columns;
+
+    QueryExecutor::SortList sortOrder = queryExecutor->getSortOrder();
+    if (sortOrder.isEmpty())
+    {
+        // Ordering by the ROWID would change order defined by the user in the query.
+        if (hasOwnOrderOrLimit(select.data()))
+            return columns;
+
+        desc = false;
+        nullableFirst = false;
+        return rowIdColumns;
+    }
+
+    if (sortOrder.size() > 1)
+        return columns;
+
+    const QueryExecutor::Sort& sort = sortOrder.first();
+    if (sort.column < 0 || sort.column >= context->resultColumns.size() || sort.order == QueryExecutor::Sort::NONE)
+        return columns;
+
+    desc = (sort.order == QueryExecutor::Sort::DESC);
+    nullableFirst = true;
+    columns << context->resultColumns[sort.column]->queryExecutorAlias;
+    columns += rowIdColumns;
+    return columns;
+}
+
+QStringList QueryExecutorLimit::getRowIdKeyColumns(const QueryExecutor::ResultRowIdColumnPtr& rowIdColumn)
+{
+    const QHash<QString, QString>& aliasToColumn = rowIdColumn->queryExecutorAliasToColumn;
+    if (aliasToColumn.size() <= 1)
+        return aliasToColumn.keys();
+
+    // WITHOUT ROWID table. The key has to follow the primary key declaration, so SQLite can walk its index.
+    SchemaResolver resolver(db);
+    SqliteQueryPtr query = resolver.getParsedObject(rowIdColumn->database, rowIdColumn->table, SchemaResolver::TABLE);
+    SqliteCreateTablePtr createTable = query.dynamicCast<SqliteCreateTable>();
+    if (!createTable)
+        return QStringList();
+
+    QStringList aliases;
+    for (const QString& pkColumn : createTable->getPrimaryKeyColumns())
+    {
+        bool found = false;
+        for (auto it = aliasToColumn.cbegin(), end = aliasToColumn.cend(); it != end; ++it)
+        {
+            if (it.value().compare(pkColumn, Qt::CaseInsensitive) == 0)
+            {
+                aliases << it.key();
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+            return QStringList();
+    }
+
+    if (aliases.size() != aliasToColumn.size())
+        return QStringList();
+
+    return aliases;
+}
+
+bool QueryExecutorLimit::hasOwnOrderOrLimit(SqliteSelect* select)
+{
+    if (!select)
+        return false;
+
+    for (SqliteSelect::Core* core : select->coreSelects)
+    {
+        if (core->orderBy.size() > 0 || core->limit)
+            return true;
+
+        if (!core->from)
+            continue;
+
+        if (core->from->singleSource && hasOwnOrderOrLimit(core->from->singleSource->select))
+            return true;
+
+        for (SqliteSelect::Core::JoinSourceOther* otherSource : core->from->otherSources)
+        {
+            if (otherSource->singleSource && hasOwnOrderOrLimit(otherSource->singleSource->select))
+                return true;
+        }
+    }
+    return false;
+}
@@ -10,6 +10,11 @@
  * and QueryExecutor::Context::setResultsPerPage), then the SELECT query
  * is wrapped with another SELECT which defines it's own LIMIT and OFFSET
  * basing on the page and the results per page parameters.
+ *
+ * If keyset paging is enabled (QueryExecutor::setKeysetPaging()) and the query
+ * has a usable key, then the wrapping SELECT orders rows by that key and the page
+ * following an already loaded page is selected with WHERE clause comparing the key
+ * with the key of the last row from that loaded page, instead of using OFFSET.
  */
 class QueryExecutorLimit : public QueryExecutorStep
 {
@@ -17,6 +22,42 @@ class QueryExecutorLimit : public QueryExecutorStep
 
     public:
         bool exec();
+
+    private:
+        /**
+         * @brief Builds wrapping SELECT for the keyset paging.
+         * @param select Query to wrap.
+         * @param page Requested page.
+         * @param limit Number of rows per page.
+         * @return Wrapping SELECT, or null string if the keyset paging is not applicable to this query.
+         */
+        QString getKeysetSelect(SqliteSelectPtr select, int page, quint64 limit);
+
+        /**
+         * @brief Provides columns usable as the paging key.
+         * @param select Query to provide key for.
+         * @param desc[out] Set to true if the key is in descending order.
+         * @param nullableFirst[out] Set to true if the first key column is not a ROWID column (and so it may contain NULLs).
+         * @return Query executor aliases of key columns, or empty list if the query has no usable key.
+         */
+        QStringList getKeysetColumns(SqliteSelectPtr select, bool& desc, bool& nullableFirst);
+
+        /**
+         * @brief Provides ROWID columns of the data source table in order usable as the paging key.
+         * @param rowIdColumn ROWID result column of the table.
+         * @return Query executor aliases of ROWID columns, or empty list if their order could not be determined.
+         *
+         * For WITHOUT ROWID tables the order is the one of PRIMARY KEY declaration, so the ORDER BY of the page
+         * matches the primary key index.
+         */
+        QStringList getRowIdKeyColumns(const QueryExecutor::ResultRowIdColumnPtr& rowIdColumn);
+
+        /**
+         * @brief Tells if the SELECT or any of its subselects defines its own ORDER BY or LIMIT.
+         * @param select SELECT to check.
+         * @return true if there is ORDER BY or LIMIT that would be overridden by the paging key order.
+         */
+        bool hasOwnOrderOrLimit(SqliteSelect* select);
 };
 
 #endif // QUERYEXECUTORLIMIT_H
@@ -0,0 +1,98 @@
+#include "sqlfunctionvalue.h"
+#include <QStringList>
+
+void SqlFunctionValue::setNull()
+{
+    type = Type::NULL_TYPE;
+}
+
+void SqlFunctionValue::setInteger(qint64 value)
+{
+    type = Type::INTEGER;
+    integer = value;
+}
+
+void SqlFunctionValue::setReal(double value)
+{
+    type = Type::REAL;
+    real = value;
+}
+
+void SqlFunctionValue::setText(const QString& value)
+{
+    type = Type::TEXT;
+    text = value;
+}
+
+void SqlFunctionValue::setBlob(const QByteArray& value)
+{
+    type = Type::BLOB;
+    blob = value;
+}
+
+QVariant SqlFunctionValue::toVariant() const
+{
+    switch (type)
+    {
+        case Type::INTEGER:
+            return integer;
+        case Type::REAL:
+            return real;
+        case Type::TEXT:
+            return text;
+        case Type::BLOB:
+            return blob;
+        case Type::NULL_TYPE:
+            break;
+    }
+    return QVariant(QVariant::String);
+}
+
+SqlFunctionValue SqlFunctionValue::fromVariant(const QVariant& value)
+{
+    SqlFunctionValue result;
+    if (value.isNull())
+        return result;
+
+    switch (value.type())
+    {
+        case QVariant::ByteArray:
+            result.setBlob(value.toByteArray());
+            break;
+        case QVariant::Int:
+        case QVariant::Bool:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+            result.setInteger(value.toLongLong());
+            break;
+        case QVariant::Double:
+            result.setReal(value.toDouble());
+            break;
+        case QVariant::List:
+        {
+            QStringList strList;
+            for (const QVariant& v : value.toList())
+                strList << v.toString();
+
+            result.setText(strList.join(" "));
+            break;
+        }
+        case QVariant::StringList:
+            result.setText(value.toStringList().join(" "));
+            break;
+        default:
+            result.setText(value.toString());
+            break;
+    }
+    return result;
+}
+
+QList<QVariant> SqlFunctionValue::toVariantList(const SqlFunctionValue* values, int count)
+{
+    QList<QVariant> results;
+    results.reserve(count);
+    for (int i = 0; i < count; i++)
+        results << values[i].toVariant();
+
+    return results;
+}
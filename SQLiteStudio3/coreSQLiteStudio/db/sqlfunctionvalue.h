@@ -0,0 +1,60 @@
+#ifndef SQLFUNCTIONVALUE_H
+#define SQLFUNCTIONVALUE_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QByteArray>
+#include <QVariant>
+
+/**
+ * @brief Argument or result value of custom SQL function.
+ *
+ * It carries value in one of SQLite storage classes, without wrapping it in QVariant.
+ * It's used to pass values between SQLite and function implementations (see FunctionManager::ResolvedFunction
+ * and ScriptingPlugin::CompiledFunction) on every function call, so basic types (integers, reals and text)
+ * are stored directly in their fields.
+ */
+struct API_EXPORT SqlFunctionValue
+{
+    enum class Type
+    {
+        NULL_TYPE,
+        INTEGER,
+        REAL,
+        TEXT,
+        BLOB
+    };
+
+    void setNull();
+    void setInteger(qint64 value);
+    void setReal(double value);
+    void setText(const QString& value);
+    void setBlob(const QByteArray& value);
+
+    /**
+     * @brief Converts value to QVariant.
+     * @return The same QVariant as the one that would be passed to the function implementation taking QVariant arguments.
+     *
+     * NULL is converted to null QString variant, which is consistent with function arguments provided by AbstractDb3.
+     */
+    QVariant toVariant() const;
+
+    /**
+     * @brief Converts QVariant returned from function implementation.
+     * @param value Value to convert.
+     * @return Value of corresponding SQLite type.
+     *
+     * Lists are joined into a single text with spaces, just like results of functions returning QVariant.
+     */
+    static SqlFunctionValue fromVariant(const QVariant& value);
+
+    static QList<QVariant> toVariantList(const SqlFunctionValue* values, int count);
+
+    Type type = Type::NULL_TYPE;
+    qint64 integer = 0;
+    double real = 0.0;
+    QString text;
+    QByteArray blob;
+};
+
+#endif // SQLFUNCTIONVALUE_H
@@ -91,6 +91,11 @@ qint64 SqlQuery::getRegularInsertRowId()
     return insertRowId["ROWID"].toLongLong();
 }
 
+SqlQuery::StatementStats SqlQuery::getStatementStats()
+{
+    return StatementStats();
+}
+
 QString SqlQuery::getQuery() const
 {
     return query;
@@ -65,6 +65,43 @@ typedef QHash<QString,QVariant> RowId;
 class API_EXPORT SqlQuery
 {
     public:
+        /**
+         * @brief Performance counters of the executed statement.
+         *
+         * Counters are collected by SQLite (see sqlite3_stmt_status()) during all executions
+         * of the statement so far. Value -1 means that the counter is not available.
+         */
+        struct StatementStats
+        {
+            /**
+             * @brief Number of forward steps made in full table scans.
+             *
+             * Large number may indicate a missing index.
+             */
+            qint64 fullScanSteps = -1;
+
+            /**
+             * @brief Number of sort operations.
+             *
+             * Sorts may indicate a missing index that could be used by ORDER BY or GROUP BY.
+             */
+            qint64 sorts = -1;
+
+            /**
+             * @brief Number of rows inserted into automatic indexes, created by SQLite for the statement.
+             *
+             * Non-zero value indicates a missing index that would be worth creating permanently.
+             */
+            qint64 autoIndexRows = -1;
+
+            /**
+             * @brief Number of virtual machine operations run.
+             *
+             * It's a rough measure of the total work done by SQLite.
+             */
+            qint64 vmSteps = -1;
+        };
+
         /**
          * @brief Produces empty, erronous result.
          * @param errorText Error message returned with #getErrorText() of the returned object.
@@ -210,6 +247,15 @@ class API_EXPORT SqlQuery
          */
         virtual qint64 getRegularInsertRowId();
 
+        /**
+         * @brief Provides performance counters of the statement.
+         * @return Counters collected so far.
+         *
+         * Rows are read from the database as they are requested, so to get counters for the complete execution,
+         * read all rows first (or preload() them). Default implementation returns no counters.
+         */
+        virtual StatementStats getStatementStats();
+
         /**
          * @brief columnAsList
          * @tparam T Data type to use for the result list.
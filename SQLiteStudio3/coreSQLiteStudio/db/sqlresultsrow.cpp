@@ -10,33 +10,80 @@ SqlResultsRow::~SqlResultsRow()
 
 const QVariant SqlResultsRow::value(const QString &key) const
 {
-    return valuesMap[key];
+    if (valuesMapLoaded)
+        return valuesMap[key];
+
+    int idx = indexOf(key);
+    if (idx < 0)
+        return QVariant();
+
+    return valueAt(idx);
 }
 
 const QHash<QString, QVariant> &SqlResultsRow::valueMap() const
 {
+    if (!valuesMapLoaded)
+    {
+        int cnt = qMin(columns.size(), valueCount());
+        valuesMap.reserve(cnt);
+        for (int i = 0; i < cnt; i++)
+            valuesMap[columns[i]] = valueAt(i);
+
+        valuesMapLoaded = true;
+    }
     return valuesMap;
 }
 
 const QList<QVariant>& SqlResultsRow::valueList() const
 {
+    if (!valuesLoaded)
+    {
+        int cnt = valueCount();
+        values.reserve(cnt);
+        for (int i = 0; i < cnt; i++)
+            values << valueAt(i);
+
+        valuesLoaded = true;
+    }
     return values;
 }
 
 const QVariant SqlResultsRow::value(int idx) const
 {
-    if (idx < 0 || idx >= values.size())
+    if (idx < 0 || idx >= valueCount())
         return QVariant();
 
-    return values[idx];
+    return valueAt(idx);
 }
 
 bool SqlResultsRow::contains(const QString &key) const
 {
-    return valuesMap.contains(key);
+    if (valuesMapLoaded)
+        return valuesMap.contains(key);
+
+    return indexOf(key) > -1;
 }
 
 bool SqlResultsRow::contains(int idx) const
 {
-    return idx >= 0 && idx < values.size();
+    return idx >= 0 && idx < valueCount();
+}
+
+int SqlResultsRow::valueCount() const
+{
+    return values.size();
+}
+
+QVariant SqlResultsRow::valueAt(int idx) const
+{
+    return values[idx];
+}
+
+int SqlResultsRow::indexOf(const QString& key) const
+{
+    int idx = columns.lastIndexOf(key);
+    if (idx >= valueCount())
+        return -1;
+
+    return idx;
 }
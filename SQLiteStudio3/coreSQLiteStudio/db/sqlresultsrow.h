@@ -5,6 +5,7 @@
 #include <QVariant>
 #include <QList>
 #include <QHash>
+#include <QStringList>
 #include <QSharedPointer>
 
 /** @file */
@@ -21,6 +22,11 @@
  * is just an interface to read data from it.
  *
  * In other words, it's kind of an abstract class.
+ *
+ * Derived classes may either populate #values and #valuesMap directly (which is what the default implementation expects),
+ * or provide #columns with #values and leave #valuesMap to be built lazily on the first call to valueMap().
+ * Classes that keep values in some other storage (see ColumnarResultsRow) implement valueCount() and valueAt()
+ * and let this class materialize #values only if somebody asks for the valueList().
  */
 class API_EXPORT SqlResultsRow
 {
@@ -79,10 +85,38 @@ class API_EXPORT SqlResultsRow
     protected:
         SqlResultsRow();
 
+        /**
+         * @brief Provides number of values in the row.
+         * @return Number of values.
+         *
+         * Default implementation returns size of #values. Derived classes that don't use #values
+         * as the primary storage should reimplement it together with valueAt().
+         */
+        virtual int valueCount() const;
+
+        /**
+         * @brief Provides value from the primary storage of the row.
+         * @param idx 0-based index of column. It's always in range of valueCount().
+         * @return Value from requested column.
+         */
+        virtual QVariant valueAt(int idx) const;
+
+        /**
+         * @brief Finds index of the column with given name.
+         * @param key Column name. Case sensitive.
+         * @return 0-based index of the column, or -1 if there is no such column.
+         *
+         * If the same name appears multiple times, the last one wins, just like it does in the #valuesMap.
+         */
+        int indexOf(const QString& key) const;
+
         /**
          * @brief Columns and their values in the row.
+         *
+         * If #valuesMapLoaded is false, then it's built upon first call to valueMap().
          */
-        QHash<QString,QVariant> valuesMap;
+        mutable QHash<QString,QVariant> valuesMap;
+
         /**
          * @brief Ordered list of values in the row.
          *
@@ -90,8 +124,28 @@ class API_EXPORT SqlResultsRow
          * We keep list of values next to valuesMap, so we have it in the same order as column names when asked by valueList().
          * This looks like having redundant data storage, but Qt container classes (such as QVariant)
          * use smart pointers to keep their data internally, so here we actually keep only reference objects.
+         *
+         * If #valuesLoaded is false, then it's built upon first call to valueList() using valueAt().
+         */
+        mutable QList<QVariant> values;
+
+        /**
+         * @brief Ordered list of column names.
+         *
+         * It's implicitly shared with the query that produced the row, so it costs nothing to keep it per row.
+         * It's used to build #valuesMap lazily. It may be left empty if #valuesMap is populated directly.
+         */
+        QStringList columns;
+
+        /**
+         * @brief Tells whether the #valuesMap is up to date.
+         */
+        mutable bool valuesMapLoaded = true;
+
+        /**
+         * @brief Tells whether the #values is up to date.
          */
-        QList<QVariant> values;
+        mutable bool valuesLoaded = true;
 };
 
 /**
@@ -0,0 +1,255 @@
+#include "sqlscriptexecutor.h"
+#include "common/utils_sql.h"
+#include <QIODevice>
+#include <QTextCodec>
+#include <QTextDecoder>
+#include <QScopedPointer>
+
+SqlScriptExecutor::SqlScriptExecutor(Db* db, QObject* parent) :
+    QObject(parent), db(db)
+{
+}
+
+bool SqlScriptExecutor::getIgnoreErrors() const
+{
+    return ignoreErrors;
+}
+
+void SqlScriptExecutor::setIgnoreErrors(bool value)
+{
+    ignoreErrors = value;
+}
+
+bool SqlScriptExecutor::getTransactional() const
+{
+    return transactional;
+}
+
+void SqlScriptExecutor::setTransactional(bool value)
+{
+    transactional = value;
+}
+
+int SqlScriptExecutor::getCommitInterval() const
+{
+    return commitInterval;
+}
+
+void SqlScriptExecutor::setCommitInterval(int value)
+{
+    commitInterval = value;
+}
+
+void SqlScriptExecutor::setResultsHandler(Db::QueryResultsHandler handler)
+{
+    resultsHandler = handler;
+}
+
+bool SqlScriptExecutor::exec(QIODevice* input, const QString& codec, Db::InterruptedCheck interrupted)
+{
+    reset();
+    interruptedCheck = interrupted;
+
+    QTextCodec* textCodec = codec.isEmpty() ? QTextCodec::codecForLocale() : QTextCodec::codecForName(codec.toLatin1());
+    if (!textCodec)
+    {
+        errorText = tr("Unsupported text encoding: %1").arg(codec);
+        return false;
+    }
+
+    if (!start())
+        return false;
+
+    QScopedPointer<QTextDecoder> decoder(textCodec->makeDecoder());
+    qint64 bytesTotal = input->isSequential() ? -1 : input->size();
+    qint64 bytesProcessed = 0;
+    qint64 bytesReported = 0;
+    qint64 charsProcessed = 0;
+    bool ok = true;
+    QByteArray block;
+    QString text;
+    SqlStatementSplitter::Statement stmt;
+    while (ok && !isInterrupted())
+    {
+        block = input->read(READ_BLOCK_SIZE);
+        if (block.isEmpty())
+            break;
+
+        text = decoder->toUnicode(block);
+        splitter.append(text);
+        while (ok && splitter.hasStatement() && !isInterrupted())
+        {
+            stmt = splitter.takeStatement();
+            ok = execStatement(stmt.sql);
+
+            // Position of the statement end in the block is estimated from its position among decoded characters
+            qint64 bytesDone = bytesProcessed;
+            if (!text.isEmpty())
+                bytesDone += block.size() * (stmt.end - charsProcessed) / text.size();
+
+            if (bytesDone - bytesReported >= PROGRESS_STEP)
+            {
+                bytesReported = bytesDone;
+                emit progress(bytesDone, bytesTotal);
+            }
+        }
+
+        bytesProcessed += block.size();
+        charsProcessed += text.size();
+    }
+
+    if (ok && !isInterrupted())
+        ok = execStatement(splitter.takeRemainder().sql);
+
+    splitter.reset();
+    emit progress(bytesProcessed, bytesTotal);
+    return finish(ok);
+}
+
+bool SqlScriptExecutor::exec(const QString& script, Db::InterruptedCheck interrupted)
+{
+    reset();
+    interruptedCheck = interrupted;
+    if (!start())
+        return false;
+
+    splitter.append(script);
+    bool ok = true;
+    while (ok && splitter.hasStatement() && !isInterrupted())
+        ok = execStatement(splitter.takeStatement().sql);
+
+    if (ok && !isInterrupted())
+        ok = execStatement(splitter.takeRemainder().sql);
+
+    splitter.reset();
+    return finish(ok);
+}
+
+int SqlScriptExecutor::getExecutedCount() const
+{
+    return executed;
+}
+
+int SqlScriptExecutor::getAttemptedCount() const
+{
+    return attempted;
+}
+
+QList<SqlScriptExecutor::Error> SqlScriptExecutor::getErrors() const
+{
+    return errors;
+}
+
+QString SqlScriptExecutor::getErrorText() const
+{
+    return errorText;
+}
+
+bool SqlScriptExecutor::wasInterrupted() const
+{
+    return interrupted;
+}
+
+SqlQueryPtr SqlScriptExecutor::getLastResults() const
+{
+    return lastResults;
+}
+
+void SqlScriptExecutor::reset()
+{
+    executed = 0;
+    attempted = 0;
+    uncommitted = 0;
+    errors.clear();
+    errorText.clear();
+    interrupted = false;
+    lastResults.clear();
+    splitter.reset();
+}
+
+bool SqlScriptExecutor::start()
+{
+    if (!transactional)
+        return true;
+
+    if (!db->begin())
+    {
+        errorText = tr("Could not start a transaction: %1").arg(db->getErrorText());
+        return false;
+    }
+    return true;
+}
+
+bool SqlScriptExecutor::finish(bool successful)
+{
+    if (!transactional)
+        return successful && !interrupted;
+
+    // Error text is set when committing a batch has failed
+    if (interrupted || !errorText.isEmpty() || (!successful && !ignoreErrors))
+    {
+        db->rollback();
+        return false;
+    }
+
+    if (!db->commit())
+    {
+        errorText = tr("Could not commit the transaction: %1").arg(db->getErrorText());
+        db->rollback();
+        return false;
+    }
+    return successful;
+}
+
+bool SqlScriptExecutor::execStatement(const QString& sql)
+{
+    static const QStringList transactionCommands = {"BEGIN", "COMMIT", "END", "ROLLBACK"};
+
+    QString command = getLeadingWord(sql);
+    if (command.isEmpty())
+        return true; // only whitespaces and comments
+
+    if (transactional && transactionCommands.contains(command, Qt::CaseInsensitive))
+        return true;
+
+    SqlQueryPtr results = db->exec(sql);
+    attempted++;
+    if (results->isError())
+    {
+        // Error caused by the interruption is not an error of the statement
+        if (isInterrupted())
+            return false;
+
+        errors << Error(sql, results->getErrorText());
+        return ignoreErrors;
+    }
+
+    executed++;
+    if (resultsHandler)
+        resultsHandler(results);
+
+    if (!transactional)
+    {
+        lastResults = results;
+        return true;
+    }
+
+    if (commitInterval > 0 && ++uncommitted >= commitInterval)
+    {
+        uncommitted = 0;
+        if (!db->commit() || !db->begin())
+        {
+            errorText = tr("Could not commit the transaction: %1").arg(db->getErrorText());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SqlScriptExecutor::isInterrupted()
+{
+    if (!interrupted && interruptedCheck && interruptedCheck())
+        interrupted = true;
+
+    return interrupted;
+}
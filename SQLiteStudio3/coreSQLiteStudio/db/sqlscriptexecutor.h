@@ -0,0 +1,160 @@
+#ifndef SQLSCRIPTEXECUTOR_H
+#define SQLSCRIPTEXECUTOR_H
+
+#include "db/db.h"
+#include "parser/sqlstatementsplitter.h"
+#include <QObject>
+#include <QPair>
+
+class QIODevice;
+
+/**
+ * @brief Executes SQL script, statement by statement, while reading it.
+ *
+ * The script is read in large blocks and split into statements with SqlStatementSplitter,
+ * so executing even multi-gigabyte SQL dumps needs only a little memory and no statement is scanned twice.
+ *
+ * By default all statements are executed in a single transaction, which is committed at the end
+ * (or rolled back, if any statement failed and errors are not ignored). BEGIN, COMMIT, END and ROLLBACK
+ * statements from the script are skipped then. The transaction can also be committed periodically
+ * (see setCommitInterval()), or transactions can be left entirely to the script (see setTransactional()).
+ *
+ * Execution is synchronous, so usually it's run in a separate thread. Progress is reported
+ * with the progress() signal, which is emitted in the executing thread.
+ */
+class API_EXPORT SqlScriptExecutor : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /**
+         * @brief Failed statement and its error message.
+         */
+        typedef QPair<QString, QString> Error;
+
+        /**
+         * @brief Number of bytes read from the input at once.
+         */
+        static const int READ_BLOCK_SIZE = 1024 * 1024;
+
+        /**
+         * @brief Minimal number of bytes processed between emissions of progress().
+         */
+        static const int PROGRESS_STEP = 256 * 1024;
+
+        /**
+         * @brief Creates executor.
+         * @param db Database to execute script in.
+         * @param parent Parent object for QObject.
+         */
+        explicit SqlScriptExecutor(Db* db, QObject* parent = nullptr);
+
+        bool getIgnoreErrors() const;
+
+        /**
+         * @brief Defines whether execution continues after a statement failed.
+         * @param value true to continue (and commit successful statements), false to stop (and roll back).
+         */
+        void setIgnoreErrors(bool value);
+
+        bool getTransactional() const;
+
+        /**
+         * @brief Defines whether the executor wraps statements in a transaction.
+         * @param value true to use transaction (default), false to execute statements as they are.
+         *
+         * Disable it when executing the script as a part of already running transaction or statement.
+         */
+        void setTransactional(bool value);
+
+        int getCommitInterval() const;
+
+        /**
+         * @brief Defines after how many statements the transaction is committed and a new one is started.
+         * @param value Number of statements, or 0 to use single transaction for the whole script (default).
+         *
+         * Committing in batches keeps the size of the rollback journal (or WAL file) limited for huge scripts,
+         * at the cost of atomicity: when a statement fails, only the current batch is rolled back.
+         */
+        void setCommitInterval(int value);
+
+        /**
+         * @brief Defines function called with results of every successfully executed statement.
+         * @param handler Function reading the results. It's called before the next statement is executed.
+         *
+         * Results are not preloaded, so the handler can read even huge results row by row.
+         */
+        void setResultsHandler(Db::QueryResultsHandler handler);
+
+        /**
+         * @brief Executes script read from the input device.
+         * @param input Open device to read the script from. It can be sequential (like the standard input).
+         * @param codec Name of the script encoding. If empty, the system default encoding is used.
+         * @param interrupted Function checked between statements. If it returns true, execution stops and is rolled back.
+         * @return true if all statements were executed successfully (and committed, if the transaction was used).
+         */
+        bool exec(QIODevice* input, const QString& codec = QString(), Db::InterruptedCheck interrupted = nullptr);
+
+        /**
+         * @brief Executes the script.
+         * @param script Contents of the script.
+         * @param interrupted Function checked between statements.
+         * @return true if all statements were executed successfully.
+         * @overload
+         *
+         * The progress() signal is not emitted in this case.
+         */
+        bool exec(const QString& script, Db::InterruptedCheck interrupted = nullptr);
+
+        int getExecutedCount() const;
+        int getAttemptedCount() const;
+        QList<Error> getErrors() const;
+
+        /**
+         * @brief Provides error not related to any particular statement.
+         * @return Error message, like failure of starting or committing the transaction, or empty string.
+         */
+        QString getErrorText() const;
+
+        bool wasInterrupted() const;
+
+        /**
+         * @brief Provides results of the last successfully executed statement.
+         * @return Results, or null if no statement was executed.
+         *
+         * Results are kept only if the transaction is not used (see setTransactional()).
+         */
+        SqlQueryPtr getLastResults() const;
+
+    private:
+        void reset();
+        bool start();
+        bool finish(bool successful);
+        bool execStatement(const QString& sql);
+        bool isInterrupted();
+
+        Db* db = nullptr;
+        bool ignoreErrors = false;
+        bool transactional = true;
+        int commitInterval = 0;
+        int executed = 0;
+        int attempted = 0;
+        int uncommitted = 0;
+        QList<Error> errors;
+        QString errorText;
+        bool interrupted = false;
+        Db::InterruptedCheck interruptedCheck;
+        Db::QueryResultsHandler resultsHandler;
+        SqlQueryPtr lastResults;
+        SqlStatementSplitter splitter;
+
+    signals:
+        /**
+         * @brief Emitted periodically while executing the script.
+         * @param bytesProcessed Number of bytes of the script processed so far.
+         * @param bytesTotal Size of the script in bytes, or -1 if it's unknown (like for the standard input).
+         */
+        void progress(qint64 bytesProcessed, qint64 bytesTotal);
+};
+
+#endif // SQLSCRIPTEXECUTOR_H
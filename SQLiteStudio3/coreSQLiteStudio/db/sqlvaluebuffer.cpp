@@ -0,0 +1,101 @@
+#include "sqlvaluebuffer.h"
+
+SqlValueBuffer::SqlValueBuffer(int columnCount) :
+    columnCount(columnCount)
+{
+}
+
+void SqlValueBuffer::clear()
+{
+    // QVector::resize(0) and QByteArray::resize(0) keep the capacity (unlike clear())
+    values.resize(0);
+    bytes.resize(0);
+}
+
+void SqlValueBuffer::appendNull()
+{
+    values.append(Value());
+}
+
+void SqlValueBuffer::appendInteger(qint64 value)
+{
+    Value v;
+    v.type = Type::INTEGER;
+    v.integer = value;
+    values.append(v);
+}
+
+void SqlValueBuffer::appendReal(double value)
+{
+    Value v;
+    v.type = Type::REAL;
+    v.real = value;
+    values.append(v);
+}
+
+void SqlValueBuffer::appendText(const char* data, int size)
+{
+    Value v;
+    v.type = Type::TEXT;
+    v.offset = bytes.size();
+    v.size = size;
+    bytes.append(data, size);
+    values.append(v);
+}
+
+void SqlValueBuffer::appendBlob(const void* data, int size)
+{
+    Value v;
+    v.type = Type::BLOB;
+    v.offset = bytes.size();
+    v.size = size;
+    bytes.append(static_cast<const char*>(data), size);
+    values.append(v);
+}
+
+int SqlValueBuffer::getColumnCount() const
+{
+    return columnCount;
+}
+
+int SqlValueBuffer::getRowCount() const
+{
+    if (columnCount == 0)
+        return 0;
+
+    return values.size() / columnCount;
+}
+
+int SqlValueBuffer::getDataSize() const
+{
+    return bytes.size();
+}
+
+const SqlValueBuffer::Value& SqlValueBuffer::value(int row, int column) const
+{
+    return values[row * columnCount + column];
+}
+
+const char* SqlValueBuffer::data(const SqlValueBuffer::Value& value) const
+{
+    return bytes.constData() + value.offset;
+}
+
+QVariant SqlValueBuffer::toVariant(int row, int column) const
+{
+    const Value& v = value(row, column);
+    switch (v.type)
+    {
+        case Type::INTEGER:
+            return v.integer;
+        case Type::REAL:
+            return v.real;
+        case Type::TEXT:
+            return QString::fromUtf8(data(v), v.size);
+        case Type::BLOB:
+            return QByteArray(data(v), v.size);
+        case Type::NULL_TYPE:
+            break;
+    }
+    return QVariant(QVariant::String);
+}
@@ -0,0 +1,101 @@
+#ifndef SQLVALUEBUFFER_H
+#define SQLVALUEBUFFER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QByteArray>
+#include <QVector>
+#include <QVariant>
+
+/**
+ * @brief Rows of raw SQLite values.
+ *
+ * It's used to pass rows between databases which use different SQLite libraries
+ * (like a plain SQLite 3 database and an encrypted one), so the values don't have to be converted
+ * to QVariant (and text values to QString) and back again. Text values are kept in UTF-8,
+ * exactly as they were read from the database.
+ *
+ * Bytes of all text and blob values are stored one after another in a single byte array,
+ * so appending values doesn't allocate memory for each of them. The clear() method keeps allocated memory,
+ * so the same buffer can be filled again with next batch of rows.
+ */
+class API_EXPORT SqlValueBuffer
+{
+    public:
+        enum class Type : quint8
+        {
+            NULL_TYPE,
+            INTEGER,
+            REAL,
+            TEXT,
+            BLOB
+        };
+
+        struct API_EXPORT Value
+        {
+            Type type = Type::NULL_TYPE;
+            qint64 integer = 0;
+            double real = 0.0;
+
+            /**
+             * @brief Position of text or blob bytes in the buffer data.
+             */
+            int offset = 0;
+
+            /**
+             * @brief Number of text or blob bytes.
+             */
+            int size = 0;
+        };
+
+        /**
+         * @brief Creates empty buffer.
+         * @param columnCount Number of values in every row.
+         */
+        explicit SqlValueBuffer(int columnCount = 0);
+
+        /**
+         * @brief Removes all rows, but keeps allocated memory.
+         */
+        void clear();
+
+        void appendNull();
+        void appendInteger(qint64 value);
+        void appendReal(double value);
+        void appendText(const char* data, int size);
+        void appendBlob(const void* data, int size);
+
+        int getColumnCount() const;
+        int getRowCount() const;
+
+        /**
+         * @brief Provides number of bytes used by text and blob values.
+         * @return Size of the data.
+         *
+         * It can be used to flush the buffer earlier than after the usual number of rows, when values are large.
+         */
+        int getDataSize() const;
+
+        const Value& value(int row, int column) const;
+
+        /**
+         * @brief Provides bytes of text or blob value.
+         * @param value Value from this buffer.
+         * @return Pointer to the first byte of the value. It's valid until the buffer is modified.
+         */
+        const char* data(const Value& value) const;
+
+        /**
+         * @brief Converts the value to QVariant, the same way as values of query results are converted.
+         * @param row Row index.
+         * @param column Column index.
+         * @return Value as QVariant.
+         */
+        QVariant toVariant(int row, int column) const;
+
+    private:
+        int columnCount = 0;
+        QVector<Value> values;
+        QByteArray bytes;
+};
+
+#endif // SQLVALUEBUFFER_H
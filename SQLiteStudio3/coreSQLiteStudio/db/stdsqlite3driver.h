@@ -20,6 +20,10 @@
         static const int BUSY = UppercasePrefix##SQLITE_BUSY; \
         static const int ROW = UppercasePrefix##SQLITE_ROW; \
         static const int DONE = UppercasePrefix##SQLITE_DONE; \
+        static const int STMTSTATUS_FULLSCAN_STEP = UppercasePrefix##SQLITE_STMTSTATUS_FULLSCAN_STEP; \
+        static const int STMTSTATUS_SORT = UppercasePrefix##SQLITE_STMTSTATUS_SORT; \
+        static const int STMTSTATUS_AUTOINDEX = UppercasePrefix##SQLITE_STMTSTATUS_AUTOINDEX; \
+        static const int STMTSTATUS_VM_STEP = UppercasePrefix##SQLITE_STMTSTATUS_VM_STEP; \
         \
         typedef Prefix##sqlite3 handle; \
         typedef Prefix##sqlite3_stmt stmt; \
@@ -29,6 +33,7 @@
         typedef Prefix##sqlite3_destructor_type destructor_type; \
         \
         static destructor_type TRANSIENT() {return UppercasePrefix##SQLITE_TRANSIENT;} \
+        static destructor_type STATIC() {return UppercasePrefix##SQLITE_STATIC;} \
         static void interrupt(handle* arg) {Prefix##sqlite3_interrupt(arg);} \
         static const void *value_blob(value* arg) {return Prefix##sqlite3_value_blob(arg);} \
         static double value_double(value* arg) {return Prefix##sqlite3_value_double(arg);} \
@@ -43,7 +48,11 @@
         static int bind_int64(stmt* a1, int a2, int64 a3) {return Prefix##sqlite3_bind_int64(a1, a2, a3);} \
         static int bind_null(stmt* a1, int a2) {return Prefix##sqlite3_bind_null(a1, a2);} \
         static int bind_parameter_index(stmt* a1, const char* a2) {return Prefix##sqlite3_bind_parameter_index(a1, a2);} \
+        static int bind_parameter_count(stmt* a1) {return Prefix##sqlite3_bind_parameter_count(a1);} \
+        static const char* bind_parameter_name(stmt* a1, int a2) {return Prefix##sqlite3_bind_parameter_name(a1, a2);} \
+        static int bind_text(stmt* a1, int a2, const char* a3, int a4, void(*a5)(void*)) {return Prefix##sqlite3_bind_text(a1, a2, a3, a4, a5);} \
         static int bind_text16(stmt* a1, int a2, const void* a3, int a4, void(*a5)(void*)) {return Prefix##sqlite3_bind_text16(a1, a2, a3, a4, a5);} \
+        static int bind_value(stmt* a1, int a2, const value* a3) {return Prefix##sqlite3_bind_value(a1, a2, a3);} \
         static void result_blob(context* a1, const void* a2, int a3, void(*a4)(void*)) {Prefix##sqlite3_result_blob(a1, a2, a3, a4);} \
         static void result_double(context* a1, double a2) {Prefix##sqlite3_result_double(a1, a2);} \
         static void result_error16(context* a1, const void* a2, int a3) {Prefix##sqlite3_result_error16(a1, a2, a3);} \
@@ -62,17 +71,21 @@
         static int column_bytes16(stmt* arg1, int arg2) {return Prefix##sqlite3_column_bytes16(arg1, arg2);} \
         static double column_double(stmt* arg1, int arg2) {return Prefix##sqlite3_column_double(arg1, arg2);} \
         static int64 column_int64(stmt* arg1, int arg2) {return Prefix##sqlite3_column_int64(arg1, arg2);} \
+        static const unsigned char *column_text(stmt* arg1, int arg2) {return Prefix##sqlite3_column_text(arg1, arg2);} \
         static const void *column_text16(stmt* arg1, int arg2) {return Prefix##sqlite3_column_text16(arg1, arg2);} \
+        static value *column_value(stmt* arg1, int arg2) {return Prefix##sqlite3_column_value(arg1, arg2);} \
         static const char *column_name(stmt* arg1, int arg2) {return Prefix##sqlite3_column_name(arg1, arg2);} \
         static int column_count(stmt* arg1) {return Prefix##sqlite3_column_count(arg1);} \
         static const char *column_database_name(stmt* arg1, int arg2) {return Prefix##sqlite3_column_database_name(arg1, arg2);} \
         static const char *column_table_name(stmt* arg1, int arg2) {return Prefix##sqlite3_column_table_name(arg1, arg2);} \
         static const char *column_origin_name(stmt* arg1, int arg2) {return Prefix##sqlite3_column_origin_name(arg1, arg2);} \
         static int changes(handle* arg) {return Prefix##sqlite3_changes(arg);} \
+        static int get_autocommit(handle* arg) {return Prefix##sqlite3_get_autocommit(arg);} \
         static int total_changes(handle* arg) {return Prefix##sqlite3_total_changes(arg);} \
         static int64 last_insert_rowid(handle* arg) {return Prefix##sqlite3_last_insert_rowid(arg);} \
         static int step(stmt* arg) {return Prefix##sqlite3_step(arg);} \
         static int reset(stmt* arg) {return Prefix##sqlite3_reset(arg);} \
+        static int stmt_status(stmt* a1, int a2, int a3) {return Prefix##sqlite3_stmt_status(a1, a2, a3);} \
         static int close(handle* arg) {return Prefix##sqlite3_close(arg);} \
         static void free(void* arg) {return Prefix##sqlite3_free(arg);} \
         static int enable_load_extension(handle* arg1, int arg2) {return Prefix##sqlite3_enable_load_extension(arg1, arg2);} \
@@ -433,48 +433,26 @@ bool DbObjectOrganizer::copyDataAsMiddleware(const QString& table)
 {
     QStringList srcColumns = srcResolver->getTableColumns(srcTable);
     QString wrappedSrcTable = wrapObjIfNeeded(srcTable);
-    SqlQueryPtr results = srcDb->prepare("SELECT * FROM " + wrappedSrcTable);
-    if (!results->execute())
-    {
-        notifyError(tr("Error while copying data for table %1: %2").arg(table).arg(results->getErrorText()));
-        return false;
-    }
+    QString selectSql = "SELECT * FROM " + wrappedSrcTable;
 
     QStringList argPlaceholderList;
     for (int i = 0, total = srcColumns.size(); i < total; ++i)
         argPlaceholderList << "?";
 
     QString wrappedDstTable = wrapObjIfNeeded(table);
-    QString sql = "INSERT INTO " + wrappedDstTable + " VALUES (" + argPlaceholderList.join(", ") + ")";
-    SqlQueryPtr insertQuery = dstDb->prepare(sql);
-
-    SqlResultsRowPtr row;
-    int i = 0;
-    while (results->hasNext())
-    {
-        row = results->next();
-        if (!row)
-        {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(results->getErrorText()));
-            return false;
-        }
-
-        insertQuery->setArgs(row->valueList());
-        if (!insertQuery->execute())
-        {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(insertQuery->getErrorText()));
-            return false;
-        }
-
-        if ((i % 1000) == 0 && isInterrupted())
-            return false;
-
-        i++;
-    }
+    QString insertSql = "INSERT INTO " + wrappedDstTable + " VALUES (" + argPlaceholderList.join(", ") + ")";
 
+    // Both databases are in transaction started by processAll(), so rows are committed all at once
+    QString errorMessage;
+    bool ok = srcDb->copyQueryResults(selectSql, dstDb, insertSql, [this]() -> bool {return isInterrupted();}, errorMessage);
     if (isInterrupted())
         return false;
 
+    if (!ok)
+    {
+        notifyError(tr("Error while copying data to table %1: %2").arg(table, errorMessage));
+        return false;
+    }
     return true;
 }
 
@@ -6,9 +6,64 @@
 #include "common/utils.h"
 #include "db/sqlresultsrow.h"
 #include "common/compatibility.h"
+#include "common/unused.h"
+#include "plugins/dbplugin.h"
+#include "services/pluginmanager.h"
 #include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QDebug>
 
+/**
+ * @brief Output device passing written data to the queue, in chunks of given size.
+ */
+class ChunkQueueDevice : public QIODevice
+{
+    public:
+        ChunkQueueDevice(BoundedQueue<QByteArray>* queue, int chunkSize) :
+            queue(queue), chunkSize(chunkSize)
+        {
+        }
+
+        /**
+         * @brief Passes remaining data to the queue.
+         * @return true on success, or false if the queue was aborted.
+         */
+        bool flushChunk()
+        {
+            if (chunk.isEmpty())
+                return true;
+
+            bool res = queue->push(chunk);
+            chunk.clear();
+            return res;
+        }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize)
+        {
+            UNUSED(data);
+            UNUSED(maxSize);
+            return -1;
+        }
+
+        qint64 writeData(const char* data, qint64 size)
+        {
+            chunk.append(data, static_cast<int>(size));
+            if (chunk.size() >= chunkSize && !flushChunk())
+                return -1;
+
+            return size;
+        }
+
+    private:
+        BoundedQueue<QByteArray>* queue = nullptr;
+        int chunkSize = 0;
+        QByteArray chunk;
+};
+
 ExportWorker::ExportWorker(ExportPlugin* plugin, ExportManager::StandardExportConfig* config, QIODevice* output, QObject *parent) :
     QObject(parent), plugin(plugin), config(config), output(output)
 {
@@ -21,6 +76,16 @@ ExportWorker::~ExportWorker()
 {
     safe_delete(executor);
     safe_delete(parser);
+
+    // Table exporters were created in the main thread, so they are deleted there
+    for (ExportPlugin* exporter : tableExporters)
+    {
+        QObject* exporterObject = dynamic_cast<QObject*>(exporter);
+        if (exporterObject)
+            exporterObject->deleteLater();
+        else
+            delete exporter;
+    }
 }
 
 void ExportWorker::run()
@@ -53,7 +118,10 @@ void ExportWorker::run()
             break;
     }
 
+    plugin->flushOutput();
     plugin->cleanupAfterExport();
+    for (ExportPlugin* exporter : tableExporters)
+        exporter->cleanupAfterExport();
 
     emit finished(res, output);
 }
@@ -72,6 +140,7 @@ void ExportWorker::prepareExportDatabase(Db* db, const QStringList& objectListTo
     this->objectListToExport = objectListToExport;
     exportMode = ExportManager::DATABASE;
     prepareParser();
+    prepareTableExporters();
 }
 
 void ExportWorker::prepareExportTable(Db* db, const QString& database, const QString& table)
@@ -89,6 +158,42 @@ void ExportWorker::prepareParser()
     parser = new Parser();
 }
 
+void ExportWorker::prepareTableExporters()
+{
+    // Each table exported in parallel is read with its own connection, so it has to be a database file
+    int threadCount = QThread::idealThreadCount();
+    if (!config->exportData || threadCount < 2 || !QFileInfo(db->getPath()).isFile())
+        return;
+
+    for (DbPlugin* dbPlugin : PLUGINS->getLoadedPlugins<DbPlugin>())
+    {
+        if (dbPlugin->checkIfDbServedByPlugin(db))
+        {
+            tableDbPlugin = dbPlugin;
+            break;
+        }
+    }
+
+    if (!tableDbPlugin)
+        return;
+
+    ExportPlugin* exporter = nullptr;
+    for (int i = 0; i < threadCount; i++)
+    {
+        exporter = plugin->createTableExporter();
+        if (!exporter)
+            break;
+
+        tableExporters << exporter;
+    }
+
+    tableDbPath = db->getPath();
+    tableDbOptions = db->getConnectionOptions();
+
+    // Each table connection is used by a single exporter thread, so it doesn't need any read connections of its own
+    tableDbOptions.remove(DB_READ_POOL_SIZE);
+}
+
 void ExportWorker::interrupt()
 {
     QMutexLocker locker(&interruptMutex);
@@ -218,7 +323,7 @@ QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderData
 bool ExportWorker::exportDatabase()
 {
     QString err;
-    QList<ExportManager::ExportObjectPtr> dbObjects = collectDbObjects(&err);
+    QList<ExportManager::ExportObjectPtr> dbObjects = collectDbObjects(&err, tableExporters.isEmpty());
     if (!err.isNull())
     {
         logExportFail("exportDatabase() -> dbObjects");
@@ -250,7 +355,11 @@ bool ExportWorker::exportDatabase()
         return false;
     }
 
-    if (!exportDatabaseObjects(dbObjects, ExportManager::ExportObject::TABLE))
+    bool tablesExported = tableExporters.isEmpty() ?
+                exportDatabaseObjects(dbObjects, ExportManager::ExportObject::TABLE) :
+                exportTablesInParallel(dbObjects);
+
+    if (!tablesExported)
     {
         logExportFail("exportDatabaseObjects()");
         return false;
@@ -352,7 +461,7 @@ bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObject
         switch (obj->type)
         {
             case ExportManager::ExportObject::TABLE:
-                res = exportTableInternal(obj->database, obj->name, obj->ddl, parsedQuery, obj->data, obj->providerData);
+                res = exportTableInternal(plugin, obj->database, obj->name, obj->ddl, parsedQuery, obj->data, obj->providerData);
                 break;
             case ExportManager::ExportObject::INDEX:
                 res = plugin->exportIndex(obj->database, obj->name, obj->ddl, parsedQuery.dynamicCast<SqliteCreateIndex>());
@@ -383,6 +492,176 @@ bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObject
     return true;
 }
 
+bool ExportWorker::exportTablesInParallel(const QList<ExportManager::ExportObjectPtr>& dbObjects)
+{
+    QList<ParallelTablePtr> tables;
+    ParallelTablePtr table;
+    for (const ExportManager::ExportObjectPtr& obj : dbObjects)
+    {
+        if (obj->type != ExportManager::ExportObject::TABLE)
+            continue;
+
+        if (!parser->parse(obj->ddl) || parser->getQueries().size() < 1)
+        {
+            qCritical() << "Could not parse" << obj->name << ", the DDL was:" << obj->ddl << ", error is:" << parser->getErrorString();
+            notifyWarn(tr("Could not parse %1 in order to export it. It will be excluded from the export output.").arg(obj->name));
+            continue;
+        }
+
+        table = ParallelTablePtr::create();
+        table->object = obj;
+        table->parsedDdl = parser->getQueries().first();
+        tables << table;
+    }
+
+    if (tables.isEmpty())
+        return true;
+
+    // The first table is exported by the main plugin instance, so the state of the export (like separators
+    // between objects) is the same as after any other table, when table exporters copy it.
+    table = tables.takeFirst();
+    ExportManager::ExportObjectPtr obj = table->object;
+    QString errorMessage;
+    queryTableDataToExport(db, obj->name, obj->data, obj->providerData, &errorMessage);
+    if (!errorMessage.isNull())
+    {
+        logExportFail("fetching table data");
+        notifyError(errorMessage);
+        return false;
+    }
+
+    bool res = exportTableInternal(plugin, obj->database, obj->name, obj->ddl, table->parsedDdl, obj->data, obj->providerData);
+    obj->data.clear();
+    if (!res)
+    {
+        logExportFail("database objects export " + obj->name);
+        return false;
+    }
+
+    if (isInterrupted())
+    {
+        logExportFail("database objects export (interrupted)");
+        return false;
+    }
+
+    // From now on tables are written to the output directly, so whatever the plugin buffered goes first
+    plugin->flushOutput();
+
+    freeTableExporters = tableExporters;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(tableExporters.size());
+
+    // Tables are started in order, so the one currently written to the output is always running,
+    // while the following ones wait when their queues get full.
+    for (const ParallelTablePtr& parallelTable : tables)
+        QtConcurrent::run(&threadPool, this, &ExportWorker::exportParallelTable, parallelTable.data());
+
+    QByteArray chunk;
+    for (const ParallelTablePtr& parallelTable : tables)
+    {
+        while (parallelTable->chunks.pop(chunk))
+            output->write(chunk);
+
+        if (!parallelTable->successful)
+        {
+            logExportFail("database objects export " + parallelTable->object->name);
+            res = false;
+
+            // Stopping remaining tables
+            interrupt();
+            for (const ParallelTablePtr& tableToAbort : tables)
+                tableToAbort->chunks.abort();
+
+            break;
+        }
+    }
+
+    threadPool.waitForDone();
+    return res;
+}
+
+void ExportWorker::exportParallelTable(ParallelTable* table)
+{
+    if (isInterrupted())
+    {
+        table->chunks.close();
+        return;
+    }
+
+    ExportManager::ExportObjectPtr obj = table->object;
+    SqlQueryPtr results;
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
+    QString errorMessage;
+    Db* tableDb = openParallelTableDb();
+    if (tableDb)
+        queryTableDataToExport(tableDb, obj->name, results, providerData, &errorMessage);
+
+    // Separate connection may not be able to read the table (like when it uses something registered
+    // only in the main connection), so the main connection is used then.
+    if (!results || results->isError())
+    {
+        results.clear();
+        providerData.clear();
+        errorMessage.clear();
+        queryTableDataToExport(db, obj->name, results, providerData, &errorMessage);
+    }
+
+    bool res = false;
+    if (errorMessage.isNull())
+    {
+        ChunkQueueDevice device(&table->chunks, PARALLEL_EXPORT_CHUNK_SIZE);
+        device.open(QIODevice::WriteOnly);
+
+        ExportPlugin* exporter = takeTableExporter();
+        if (plugin->initTableExporter(exporter, &device))
+        {
+            res = exportTableInternal(exporter, obj->database, obj->name, obj->ddl, table->parsedDdl, results, providerData);
+            exporter->flushOutput();
+            res = res && device.flushChunk();
+        }
+        releaseTableExporter(exporter);
+    }
+    else
+        notifyError(errorMessage);
+
+    results.clear();
+    if (tableDb)
+    {
+        tableDb->closeQuiet();
+        delete tableDb;
+    }
+
+    table->successful = res;
+    table->chunks.close();
+}
+
+Db* ExportWorker::openParallelTableDb() const
+{
+    Db* tableDb = tableDbPlugin->getInstance(QString(), tableDbPath, tableDbOptions);
+    if (!tableDb)
+        return nullptr;
+
+    if (!tableDb->openQuiet())
+    {
+        delete tableDb;
+        return nullptr;
+    }
+    return tableDb;
+}
+
+ExportPlugin* ExportWorker::takeTableExporter()
+{
+    // There are as many exporters, as threads exporting tables, so there's always a free one
+    QMutexLocker locker(&tableExportersMutex);
+    return freeTableExporters.takeLast();
+}
+
+void ExportWorker::releaseTableExporter(ExportPlugin* exporter)
+{
+    QMutexLocker locker(&tableExportersMutex);
+    freeTableExporters << exporter;
+}
+
 bool ExportWorker::exportTable()
 {
     SqlQueryPtr results;
@@ -413,7 +692,7 @@ bool ExportWorker::exportTable()
         return false;
     }
 
-    if (!exportTableInternal(database, table, ddl, createTable, results, providerData))
+    if (!exportTableInternal(plugin, database, table, ddl, createTable, results, providerData))
     {
         logExportFail("exportTableInternal()");
         return false;
@@ -478,7 +757,7 @@ bool ExportWorker::exportTable()
     return true;
 }
 
-bool ExportWorker::exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
+bool ExportWorker::exportTableInternal(ExportPlugin* exporter, const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
                                        const QHash<ExportManager::ExportProviderFlag,QVariant>& providerData)
 {
     SqliteCreateTablePtr createTable = parsedDdl.dynamicCast<SqliteCreateTable>();
@@ -493,7 +772,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
         if (!results)
             colNames = createTable->getColumnNames();
 
-        if (!plugin->exportTable(database, table, colNames, ddl, createTable, providerData))
+        if (!exporter->exportTable(database, table, colNames, ddl, createTable, providerData))
         {
             logExportFail("exportTable()");
             return false;
@@ -501,7 +780,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
     }
     else
     {
-        if (!plugin->exportVirtualTable(database, table, colNames, ddl, createVirtualTable, providerData))
+        if (!exporter->exportVirtualTable(database, table, colNames, ddl, createVirtualTable, providerData))
         {
             logExportFail("exportVirtualTable()");
             return false;
@@ -520,7 +799,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
         while (results->hasNext())
         {
             row = results->next();
-            if (!plugin->exportTableRow(row))
+            if (!exporter->exportTableRow(row))
             {
                 logExportFail("exportTableRow()");
                 return false;
@@ -534,7 +813,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
         }
     }
 
-    if (!plugin->afterExportTable())
+    if (!exporter->afterExportTable())
     {
         logExportFail("afterExportTable()");
         return false;
@@ -543,7 +822,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
     return true;
 }
 
-QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* errorMessage)
+QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* errorMessage, bool queryTableData)
 {
     SchemaResolver resolver(db);
     StrHash<SchemaResolver::ObjectDetails> allDetails = resolver.getAllObjectDetails();
@@ -564,9 +843,12 @@ QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* er
         if (details.type == SchemaResolver::TABLE)
         {
             exportObj->type = ExportManager::ExportObject::TABLE;
-            queryTableDataToExport(db, objName, exportObj->data, exportObj->providerData, errorMessage);
-            if (!errorMessage->isNull())
-                return objectsToExport;
+            if (queryTableData)
+            {
+                queryTableDataToExport(db, objName, exportObj->data, exportObj->providerData, errorMessage);
+                if (!errorMessage->isNull())
+                    return objectsToExport;
+            }
         }
         else if (details.type == SchemaResolver::INDEX)
             exportObj->type = ExportManager::ExportObject::INDEX;
@@ -603,14 +885,15 @@ void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQuery
 
     if (config->exportData)
     {
+        // Tables are read only by name, so the read connection sees the same table, or fails and the main one is used
         QString wrappedTable = wrapObjIfNeeded(table);
-        dataPtr = db->exec(sql.arg(wrappedTable));
+        dataPtr = db->exec(sql.arg(wrappedTable), Db::Flag::COLUMNAR_RESULTS|Db::Flag::READ_POOL);
         if (dataPtr->isError() && !errorMessage->isNull())
             *errorMessage = tr("Error while reading data to export from table %1: %2").arg(table, dataPtr->getErrorText());
 
         if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
         {
-            SqlQueryPtr countQuery = db->exec(countSql.arg(wrappedTable));
+            SqlQueryPtr countQuery = db->exec(countSql.arg(wrappedTable), Db::Flag::READ_POOL);
             if (countQuery->isError())
             {
                 if (!errorMessage->isNull())
@@ -626,7 +909,7 @@ void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQuery
             for (const QString& col : dataPtr->getColumnNames())
                 wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col));
 
-            SqlQueryPtr colLengthQuery = db->exec(colLengthSql.arg(wrappedCols.join(", "), wrappedTable));
+            SqlQueryPtr colLengthQuery = db->exec(colLengthSql.arg(wrappedCols.join(", "), wrappedTable), Db::Flag::READ_POOL);
             if (colLengthQuery->isError())
             {
                 if (!errorMessage->isNull())
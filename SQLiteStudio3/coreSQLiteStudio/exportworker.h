@@ -4,11 +4,13 @@
 #include "services/exportmanager.h"
 #include "db/queryexecutor.h"
 #include "parser/ast/sqlitecreatetable.h"
+#include "common/boundedqueue.h"
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
 
 class Db;
+class DbPlugin;
 
 class API_EXPORT ExportWorker : public QObject, public QRunnable
 {
@@ -23,15 +25,55 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         void prepareExportTable(Db* db, const QString& database, const QString& table);
 
     private:
+        /**
+         * @brief Number of chunks of exported data kept in memory for each of tables exported in parallel.
+         */
+        static const int PARALLEL_EXPORT_QUEUED_CHUNKS = 64;
+
+        /**
+         * @brief Size of single chunk of exported data of a table exported in parallel.
+         */
+        static const int PARALLEL_EXPORT_CHUNK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Table exported in parallel with other tables, during database export.
+         */
+        struct ParallelTable
+        {
+            ExportManager::ExportObjectPtr object;
+            SqliteQueryPtr parsedDdl;
+
+            /**
+             * @brief Exported data of the table, in order.
+             *
+             * It's filled by the thread exporting the table and consumed by the thread writing to the output.
+             * It's closed when the table is done.
+             */
+            BoundedQueue<QByteArray> chunks{PARALLEL_EXPORT_QUEUED_CHUNKS};
+
+            /**
+             * @brief Result of the table export. It's set before chunks are closed.
+             */
+            bool successful = false;
+        };
+
+        typedef QSharedPointer<ParallelTable> ParallelTablePtr;
+
         void prepareParser();
+        void prepareTableExporters();
         bool exportQueryResults();
         QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults();
         bool exportDatabase();
         bool exportDatabaseObjects(const QList<ExportManager::ExportObjectPtr>& dbObjects, ExportManager::ExportObject::Type type);
+        bool exportTablesInParallel(const QList<ExportManager::ExportObjectPtr>& dbObjects);
+        void exportParallelTable(ParallelTable* table);
+        Db* openParallelTableDb() const;
+        ExportPlugin* takeTableExporter();
+        void releaseTableExporter(ExportPlugin* exporter);
         bool exportTable();
-        bool exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
+        bool exportTableInternal(ExportPlugin* exporter, const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
                                  const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData);
-        QList<ExportManager::ExportObjectPtr> collectDbObjects(QString* errorMessage);
+        QList<ExportManager::ExportObjectPtr> collectDbObjects(QString* errorMessage, bool queryTableData);
         void queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QHash<ExportManager::ExportProviderFlag, QVariant>& providerData,
                                     QString* errorMessage) const;
         bool isInterrupted();
@@ -51,6 +93,18 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         QMutex interruptMutex;
         Parser* parser = nullptr;
 
+        /**
+         * @brief Plugin instances exporting tables in parallel during database export.
+         *
+         * If it's empty, tables are exported one by one.
+         */
+        QList<ExportPlugin*> tableExporters;
+        QList<ExportPlugin*> freeTableExporters;
+        QMutex tableExportersMutex;
+        DbPlugin* tableDbPlugin = nullptr;
+        QString tableDbPath;
+        QHash<QString,QVariant> tableDbOptions;
+
     public slots:
         void interrupt();
 
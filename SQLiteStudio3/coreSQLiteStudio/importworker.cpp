@@ -4,6 +4,29 @@
 #include "db/db.h"
 #include "plugins/importplugin.h"
 #include "common/utils.h"
+#include <QThread>
+#include <functional>
+
+namespace
+{
+    class ImportReaderThread : public QThread
+    {
+        public:
+            explicit ImportReaderThread(const std::function<void()>& body) :
+                body(body)
+            {
+            }
+
+        protected:
+            void run()
+            {
+                body();
+            }
+
+        private:
+            std::function<void()> body;
+    };
+}
 
 ImportWorker::ImportWorker(ImportPlugin* plugin, ImportManager::StandardImportConfig* config, Db* db, const QString& table, QObject *parent) :
     QObject(parent), plugin(plugin), config(config), db(db), table(table)
@@ -12,62 +35,134 @@ ImportWorker::ImportWorker(ImportPlugin* plugin, ImportManager::StandardImportCo
 
 void ImportWorker::run()
 {
-    if (!plugin->beforeImport(*config))
+    if (!startPlugin())
     {
+        stopPlugin();
         emit finished(false, 0);
         return;
     }
 
-    readPluginColumns();
     if (columnsFromPlugin.size() == 0)
     {
         error(tr("No columns provided by the import plugin."));
+        stopPlugin();
+        emit finished(false, 0);
         return;
     }
 
-    if (!config->skipTransaction && !db->begin())
+    enableFastMode();
+
+    int rowCount = 0;
+    bool result = importInTransaction(rowCount);
+
+    // Journal mode cannot be changed while transaction is active, so it's restored after commit/rollback.
+    restoreFastMode();
+
+    if (result && tableCreated)
+        emit createdTable(db, table);
+
+    stopPlugin();
+    emit finished(result, result ? rowCount : 0);
+}
+
+void ImportWorker::interrupt()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = true;
+    if (batchQueue)
+        batchQueue->abort();
+}
+
+bool ImportWorker::startPlugin()
+{
+    if (config->bufferedBatches <= 0)
     {
-        error(tr("Could not start transaction in order to import a data: %1").arg(db->getErrorText()));
-        return;
+        pluginStartResult = plugin->beforeImport(*config);
+        if (pluginStartResult)
+            readPluginColumns();
+
+        return pluginStartResult;
     }
 
-    if (!prepareTable())
     {
-        if (!config->skipTransaction)
-            db->rollback();
-
-        return;
+        QMutexLocker locker(&interruptMutex);
+        batchQueue = new BatchQueue(config->bufferedBatches);
+        if (interrupted)
+            batchQueue->abort();
     }
 
-    int rowCount = 0;
-    if (!importData(rowCount))
+    readingAllowed = false;
+    readingPermissionGiven = false;
+    readerThread = new ImportReaderThread([this]()
     {
-        if (!config->skipTransaction)
-            db->rollback();
+        readInput();
+    });
+    readerThread->start();
+
+    // Semaphores make results of the reader thread visible to this thread.
+    pluginStarted.acquire();
+    return pluginStartResult;
+}
+
+void ImportWorker::stopPlugin()
+{
+    if (!readerThread)
+    {
+        if (pluginStartResult)
+            plugin->afterImport();
 
         return;
     }
 
-    if (!config->skipTransaction && !db->commit())
+    // Reader may be still waiting for the permission (if inserting didn't even start), or pushing batches.
+    permitReading(false);
     {
-        error(tr("Could not commit transaction for imported data: %1").arg(db->getErrorText()));
-        if (!config->skipTransaction)
-            db->rollback();
+        QMutexLocker locker(&interruptMutex);
+        batchQueue->abort();
+    }
+
+    readerThread->wait();
+    delete readerThread;
+    readerThread = nullptr;
+
+    QMutexLocker locker(&interruptMutex);
+    delete batchQueue;
+    batchQueue = nullptr;
+}
+
+void ImportWorker::readInput()
+{
+    pluginStartResult = plugin->beforeImport(*config);
+    if (pluginStartResult)
+        readPluginColumns();
 
+    pluginStarted.release();
+    if (!pluginStartResult)
         return;
-    }
 
-    if (tableCreated)
-        emit createdTable(db, table);
+    readingPermitted.acquire();
+    if (readingAllowed)
+    {
+        QList<QVariant> args;
+        while (readBatch(args))
+        {
+            if (!batchQueue->push(args))
+                break; // importing was stopped
+        }
+        batchQueue->close();
+    }
 
     plugin->afterImport();
-    emit finished(true, rowCount);
 }
 
-void ImportWorker::interrupt()
+void ImportWorker::permitReading(bool allowed)
 {
-    QMutexLocker locker(&interruptMutex);
-    interrupted = true;
+    if (readingPermissionGiven)
+        return;
+
+    readingPermissionGiven = true;
+    readingAllowed = allowed;
+    readingPermitted.release();
 }
 
 void ImportWorker::readPluginColumns()
@@ -83,8 +178,39 @@ void ImportWorker::readPluginColumns()
 void ImportWorker::error(const QString& err)
 {
     notifyError(err);
-    plugin->afterImport();
-    emit finished(false, 0);
+}
+
+bool ImportWorker::importInTransaction(int& rowCount)
+{
+    if (!config->skipTransaction && !db->begin())
+    {
+        error(tr("Could not start transaction in order to import a data: %1").arg(db->getErrorText()));
+        return false;
+    }
+
+    if (!prepareTable())
+    {
+        if (!config->skipTransaction)
+            db->rollback();
+
+        return false;
+    }
+
+    if (!importData(rowCount))
+    {
+        if (!config->skipTransaction)
+            db->rollback();
+
+        return false;
+    }
+
+    if (!config->skipTransaction && !db->commit())
+    {
+        error(tr("Could not commit transaction for imported data: %1").arg(db->getErrorText()));
+        db->rollback();
+        return false;
+    }
+    return true;
 }
 
 bool ImportWorker::prepareTable()
@@ -140,59 +266,180 @@ bool ImportWorker::prepareTable()
 
 bool ImportWorker::importData(int& rowCount)
 {
-    static const QString insertTemplate = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)");
+    int colCount = targetColumns.size();
+    rowsPerInsert = qBound(1, config->rowsPerInsert, qMax(1, MAX_BOUND_PARAMETERS / colCount));
+
+    singleRowInsert = prepareInsert(1);
+    batchInsert = (rowsPerInsert > 1) ? prepareInsert(rowsPerInsert) : singleRowInsert;
 
+    rowCount = 0;
+    bool result = true;
+    QList<QVariant> args;
+    if (readerThread)
+    {
+        // Plugin parses the input in the reader thread, while this one is inserting.
+        // The queue is aborted on interruption, so waiting for batches always ends.
+        permitReading(true);
+        while (batchQueue->pop(args))
+        {
+            if (!insertBatch(args, rowCount))
+            {
+                result = false;
+                break;
+            }
+        }
+
+        if (result && isInterrupted())
+        {
+            error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
+            result = false;
+        }
+    }
+    else
+    {
+        while (readBatch(args))
+        {
+            if (!insertBatch(args, rowCount))
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    batchInsert.clear();
+    singleRowInsert.clear();
+    return result;
+}
+
+bool ImportWorker::readBatch(QList<QVariant>& args)
+{
     int colCount = targetColumns.size();
+    args.clear();
+    args.reserve(rowsPerInsert * colCount);
+
+    QList<QVariant> row;
+    for (int rows = 0; rows < rowsPerInsert && (row = plugin->next()).size() > 0; rows++)
+    {
+        // Fill up missing values in the line, skip excessive ones
+        for (int i = 0; i < colCount; i++)
+            args << ((i < row.size()) ? row[i] : QVariant(QVariant::String));
+    }
+    return args.size() > 0;
+}
+
+bool ImportWorker::insertBatch(const QList<QVariant>& args, int& rowCount)
+{
+    int rows = args.size() / targetColumns.size();
+    SqlQueryPtr query;
+    if (rows == rowsPerInsert)
+        query = batchInsert;
+    else if (rows == 1)
+        query = singleRowInsert;
+    else
+        query = prepareInsert(rows); // the last, incomplete batch
+
+    if (!insertRows(query, args, rowCount + 1))
+        return false;
+
+    rowCount += rows;
+    if (isInterrupted())
+    {
+        error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
+        return false;
+    }
+    return true;
+}
+
+SqlQueryPtr ImportWorker::prepareInsert(int rows)
+{
+    static_qstring(insertTemplate, "INSERT INTO %1 (%2) VALUES %3");
+    static_qstring(valuesTemplate, "(%1)");
+
     QStringList valList;
-    for (int i = 0; i < colCount; i++)
+    for (int i = 0, total = targetColumns.size(); i < total; i++)
         valList << "?";
 
+    QString rowValues = valuesTemplate.arg(valList.join(", "));
+    QStringList rowList;
+    for (int i = 0; i < rows; i++)
+        rowList << rowValues;
+
     QString theInsert = insertTemplate.arg(wrapObjIfNeeded(table),
                                            wrapObjNamesIfNeeded(targetColumns).join(", "),
-                                           valList.join(", "));
+                                           rowList.join(", "));
 
     SqlQueryPtr query = db->prepare(theInsert);
     query->setFlags(Db::Flag::SKIP_DROP_DETECTION|Db::Flag::SKIP_PARAM_COUNTING|Db::Flag::NO_LOCK);
+    return query;
+}
 
-    rowCount = 0;
-    QList<QVariant> row;
-    while ((row = plugin->next()).size() > 0)
-    {
-        // Fill up missing values in the line
-        for (int i = row.size(); i < colCount; i++)
-            row << QVariant(QVariant::String);
+bool ImportWorker::insertRows(SqlQueryPtr query, const QList<QVariant>& args, int firstRowNumber)
+{
+    query->setArgs(args);
+    if (query->execute())
+        return true;
 
-        // Assign argument values
-        query->setArgs(row.mid(0, colCount));
+    if (!config->ignoreErrors)
+    {
+        error(tr("Error while importing data: %1").arg(query->getErrorText()));
+        return false;
+    }
 
-        if (!query->execute())
-        {
-            if (config->ignoreErrors)
-            {
-                qDebug() << "Could not import data row number" << (rowCount+1) << ". The row was ignored. Problem details:"
-                         << query->getErrorText();
+    if (query == singleRowInsert)
+    {
+        qDebug() << "Could not import data row number" << firstRowNumber << ". The row was ignored. Problem details:"
+                 << query->getErrorText();
 
-                notifyWarn(tr("Could not import data row number %1. The row was ignored. Problem details: %2")
-                           .arg(QString::number(rowCount + 1), query->getErrorText()));
-            }
-            else
-            {
-                error(tr("Error while importing data: %1").arg(query->getErrorText()));
-                return false;
-            }
-        }
+        notifyWarn(tr("Could not import data row number %1. The row was ignored. Problem details: %2")
+                   .arg(QString::number(firstRowNumber), query->getErrorText()));
+        return true;
+    }
 
-        if ((rowCount % 100) == 0 && isInterrupted())
-        {
-            error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
+    // The whole statement was rejected. Insert its rows one by one, so only the problematic ones are skipped.
+    int colCount = targetColumns.size();
+    int rows = args.size() / colCount;
+    for (int i = 0; i < rows; i++)
+    {
+        if (!insertRows(singleRowInsert, args.mid(i * colCount, colCount), firstRowNumber + i))
             return false;
-        }
-        rowCount++;
     }
-
     return true;
 }
 
+void ImportWorker::enableFastMode()
+{
+    if (!config->fastMode || config->skipTransaction)
+        return;
+
+    origSynchronous = db->exec("PRAGMA synchronous;")->getSingleCell().toString();
+    origJournalMode = db->exec("PRAGMA journal_mode;")->getSingleCell().toString();
+    fastModeEnabled = true;
+
+    db->exec("PRAGMA synchronous = OFF;");
+
+    // WAL mode is persistent and it's already cheap for bulk inserts, so it's left as it is.
+    if (origJournalMode.compare("wal", Qt::CaseInsensitive) != 0)
+        db->exec("PRAGMA journal_mode = MEMORY;");
+}
+
+void ImportWorker::restoreFastMode()
+{
+    if (!fastModeEnabled)
+        return;
+
+    static_qstring(syncTpl, "PRAGMA synchronous = %1;");
+    static_qstring(journalTpl, "PRAGMA journal_mode = %1;");
+
+    if (!origSynchronous.isEmpty())
+        db->exec(syncTpl.arg(origSynchronous));
+
+    if (!origJournalMode.isEmpty() && origJournalMode.compare("wal", Qt::CaseInsensitive) != 0)
+        db->exec(journalTpl.arg(origJournalMode));
+
+    fastModeEnabled = false;
+}
+
 bool ImportWorker::isInterrupted()
 {
     QMutexLocker locker(&interruptMutex);
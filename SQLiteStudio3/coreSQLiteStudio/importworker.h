@@ -2,11 +2,24 @@
 #define IMPORTWORKER_H
 
 #include "services/importmanager.h"
+#include "db/sqlquery.h"
+#include "common/boundedqueue.h"
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
+#include <QSemaphore>
 
-class ImportWorker : public QObject, public QRunnable
+class QThread;
+
+/**
+ * @brief Imports data provided by the ImportPlugin into the table.
+ *
+ * If StandardImportConfig::bufferedBatches is greater than 0, the plugin is used only from a dedicated reader thread
+ * (started by this worker), which calls ImportPlugin::beforeImport(), reads all rows ahead of inserts
+ * and finally calls ImportPlugin::afterImport(). The reader doesn't use any thread pool, so the import
+ * never waits for a free pool thread, even when the pool is busy with other work (including this worker).
+ */
+class API_EXPORT ImportWorker : public QObject, public QRunnable
 {
         Q_OBJECT
     public:
@@ -15,12 +28,47 @@ class ImportWorker : public QObject, public QRunnable
         void run();
 
     private:
+        typedef BoundedQueue<QList<QVariant>> BatchQueue;
+
+        bool startPlugin();
+        void stopPlugin();
         void readPluginColumns();
         void error(const QString& err);
+        bool importInTransaction(int& rowCount);
         bool prepareTable();
         bool importData(int& rowCount);
+        bool readBatch(QList<QVariant>& args);
+
+        /**
+         * @brief Body of the reader thread.
+         *
+         * Starts the plugin, waits until the worker decides whether rows should be read (see permitReading()),
+         * then reads them into the #batchQueue and finally stops the plugin.
+         */
+        void readInput();
+
+        /**
+         * @brief Lets the reader thread continue after the plugin was started.
+         * @param allowed true if rows should be read, false if the reader should only stop the plugin.
+         *
+         * Only the first call has any effect.
+         */
+        void permitReading(bool allowed);
+        bool insertBatch(const QList<QVariant>& args, int& rowCount);
+        SqlQueryPtr prepareInsert(int rows);
+        bool insertRows(SqlQueryPtr query, const QList<QVariant>& args, int firstRowNumber);
+        void enableFastMode();
+        void restoreFastMode();
         bool isInterrupted();
 
+        /**
+         * @brief Upper limit of parameters bound to a single statement.
+         *
+         * It's the default SQLITE_MAX_VARIABLE_NUMBER of SQLite versions prior to 3.32.0,
+         * so it's safe no matter which SQLite the database was opened with.
+         */
+        static const int MAX_BOUND_PARAMETERS = 999;
+
         ImportPlugin* plugin = nullptr;
         ImportManager::StandardImportConfig* config = nullptr;
         Db* db = nullptr;
@@ -32,6 +80,25 @@ class ImportWorker : public QObject, public QRunnable
         bool interrupted = false;
         QMutex interruptMutex;
         bool tableCreated = false;
+        int rowsPerInsert = 1;
+        SqlQueryPtr batchInsert;
+        SqlQueryPtr singleRowInsert;
+        bool fastModeEnabled = false;
+        QString origSynchronous;
+        QString origJournalMode;
+
+        /**
+         * @brief Queue of batches read by the reader thread. Null if batches are not buffered.
+         *
+         * The pointer itself is guarded by #interruptMutex, so interrupt() can abort the queue.
+         */
+        BatchQueue* batchQueue = nullptr;
+        QThread* readerThread = nullptr;
+        QSemaphore pluginStarted;
+        QSemaphore readingPermitted;
+        bool pluginStartResult = false;
+        bool readingAllowed = false;
+        bool readingPermissionGiven = false;
 
     public slots:
         void interrupt();
@@ -0,0 +1,181 @@
+#include "incrementalparser.h"
+#include "parser/lexer.h"
+#include "common/utils_sql.h"
+#include <algorithm>
+
+IncrementalParser::IncrementalParser() :
+    cache(CACHE_SIZE)
+{
+}
+
+bool IncrementalParser::parse(const QString& sql)
+{
+    if (sql == this->sql)
+        return isSuccessful();
+
+    // Range of characters that differ between old and new contents
+    int oldLength = this->sql.length();
+    int newLength = sql.length();
+    int minLength = qMin(oldLength, newLength);
+    const QChar* oldData = this->sql.constData();
+    const QChar* newData = sql.constData();
+
+    int prefix = 0;
+    while (prefix < minLength && oldData[prefix] == newData[prefix])
+        prefix++;
+
+    int suffix = 0;
+    while (suffix < minLength - prefix && oldData[oldLength - 1 - suffix] == newData[newLength - 1 - suffix])
+        suffix++;
+
+    int delta = newLength - oldLength;
+
+    // Statements touched by the modification
+    int first = 0;
+    int last = statements.size() - 1;
+    if (!statements.isEmpty())
+    {
+        first = getStatementIndex(prefix);
+        last = getStatementIndex(qMax(prefix, oldLength - suffix - 1));
+    }
+
+    // Lexing from the beginning of the first touched statement. If the modified range doesn't end
+    // with a complete statement (like when a quote or a trigger body was opened), following statements
+    // are included, until statements are split at the same place as they were before.
+    int regionStart = statements.isEmpty() ? 0 : statements[first].start;
+    int regionEnd;
+    int step = 1;
+    bool complete;
+    TokenList tokens;
+    QList<TokenList> tokenizedStatements;
+    while (true)
+    {
+        regionEnd = (statements.isEmpty() ? oldLength : (statements[last].start + statements[last].length)) + delta;
+        tokens = Lexer::tokenize(sql.mid(regionStart, regionEnd - regionStart));
+        tokenizedStatements = splitQueries(tokens, &complete);
+        if (last >= statements.size() - 1 || isSplitBoundary(tokens, complete))
+            break;
+
+        last = qMin(last + step, statements.size() - 1);
+        step *= 2;
+    }
+
+    // Results of replaced statements go to the cache, so they can be found by the same text
+    for (int i = first; i <= last; i++)
+        cache.insert(this->sql.mid(statements[i].start, statements[i].length), new ResultsPtr(statements[i].results));
+
+    this->sql = sql;
+    QList<Statement> newStatements = splitRegion(regionStart, tokenizedStatements);
+
+    if (!statements.isEmpty())
+        statements.remove(first, last - first + 1);
+
+    for (int i = first; i < statements.size(); i++)
+        statements[i].start += delta;
+
+    int idx = first;
+    for (const Statement& stmt : newStatements)
+        statements.insert(idx++, stmt);
+
+    return isSuccessful();
+}
+
+void IncrementalParser::reset()
+{
+    sql.clear();
+    statements.clear();
+    cache.clear();
+    parser.reset();
+}
+
+bool IncrementalParser::isSuccessful() const
+{
+    for (const Statement& stmt : statements)
+    {
+        if (!stmt.results->successful)
+            return false;
+    }
+    return true;
+}
+
+const QVector<IncrementalParser::Statement>& IncrementalParser::getStatements() const
+{
+    return statements;
+}
+
+int IncrementalParser::getStatementIndex(int position) const
+{
+    if (statements.isEmpty())
+        return -1;
+
+    auto it = std::upper_bound(statements.begin(), statements.end(), position, [](int pos, const Statement& stmt)
+    {
+        return pos < stmt.start;
+    });
+
+    return qMax(static_cast<int>(it - statements.begin()) - 1, 0);
+}
+
+QList<ParserError> IncrementalParser::getErrors() const
+{
+    QList<ParserError> errors;
+    for (const Statement& stmt : statements)
+    {
+        for (ParserError error : stmt.results->errors)
+        {
+            if (error.getFrom() < 0)
+                errors << error;
+            else
+                errors << ParserError(stmt.start + error.getFrom(), stmt.start + error.getTo(), error.getMessage());
+        }
+    }
+    return errors;
+}
+
+QString IncrementalParser::getStatementSql(int index) const
+{
+    if (index < 0 || index >= statements.size())
+        return QString();
+
+    return sql.mid(statements[index].start, statements[index].length);
+}
+
+bool IncrementalParser::isSplitBoundary(const TokenList& tokens, bool complete)
+{
+    if (tokens.isEmpty())
+        return true;
+
+    // Following statements are split in the same way as before, if the region ends with semicolon terminating a statement
+    TokenPtr lastToken = tokens.last();
+    return complete && lastToken->type == Token::OPERATOR && lastToken->value == ";";
+}
+
+QList<IncrementalParser::Statement> IncrementalParser::splitRegion(int regionStart, const QList<TokenList>& tokenizedStatements)
+{
+    QList<Statement> results;
+    for (const TokenList& tokens : tokenizedStatements)
+    {
+        Statement stmt;
+        stmt.start = regionStart + static_cast<int>(tokens.first()->start);
+        stmt.length = static_cast<int>(tokens.last()->end - tokens.first()->start + 1);
+        stmt.results = parseStatement(sql.mid(stmt.start, stmt.length));
+        results << stmt;
+    }
+    return results;
+}
+
+IncrementalParser::ResultsPtr IncrementalParser::parseStatement(const QString& statementSql)
+{
+    ResultsPtr* cached = cache.object(statementSql);
+    if (cached)
+        return *cached;
+
+    ResultsPtr results = ResultsPtr::create();
+    results->successful = parser.parse(statementSql);
+    results->queries = parser.getQueries();
+    for (ParserError* error : parser.getErrors())
+        results->errors << *error;
+
+    parser.reset();
+    return results;
+}
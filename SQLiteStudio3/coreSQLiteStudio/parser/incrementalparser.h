@@ -0,0 +1,118 @@
+#ifndef INCREMENTALPARSER_H
+#define INCREMENTALPARSER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "parser/parser.h"
+#include "parser/parsererror.h"
+#include <QVector>
+#include <QCache>
+#include <QSharedPointer>
+
+/**
+ * @brief Parser keeping results for a document which is being edited.
+ *
+ * The document is split into statements (the same way as splitQueries() does it) and each statement
+ * is parsed on its own. When parse() is called again with modified document, only statements touched
+ * by the modification are lexed and parsed again. All other statements keep their parse results,
+ * only their start positions are shifted.
+ *
+ * Parse results are also cached by the statement text, so statements that were removed from the document
+ * and then restored (like with undo, or cut and paste) are not parsed again. Identical statements
+ * in the document share the same results.
+ *
+ * All positions in the parse results (tokens of queries, errors) are relative to the beginning
+ * of the statement. Add Statement::start to get position in the document.
+ */
+class API_EXPORT IncrementalParser
+{
+    public:
+        /**
+         * @brief Parse results of a single statement.
+         */
+        struct API_EXPORT Results
+        {
+            QList<SqliteQueryPtr> queries;
+            QList<ParserError> errors;
+            bool successful = true;
+        };
+
+        typedef QSharedPointer<Results> ResultsPtr;
+
+        /**
+         * @brief Statement of the document.
+         */
+        struct API_EXPORT Statement
+        {
+            /**
+             * @brief Position of the first character of the statement in the document.
+             */
+            int start = 0;
+
+            /**
+             * @brief Length of the statement, including leading whitespaces and comments.
+             */
+            int length = 0;
+
+            ResultsPtr results;
+        };
+
+        IncrementalParser();
+
+        /**
+         * @brief Parses the document.
+         * @param sql Current contents of the document.
+         * @return true if all statements were parsed successfully.
+         *
+         * The document is compared with the one passed in previous call and only the statements
+         * at the modified range are processed.
+         */
+        bool parse(const QString& sql);
+
+        /**
+         * @brief Forgets the document and all cached results.
+         */
+        void reset();
+
+        bool isSuccessful() const;
+        const QVector<Statement>& getStatements() const;
+
+        /**
+         * @brief Finds statement at given document position.
+         * @param position Character position in the document.
+         * @return Index of the statement, or -1 if there are no statements.
+         *
+         * Position just after the end of the document is considered to be in the last statement,
+         * which is consistent with getQueryWithPosition().
+         */
+        int getStatementIndex(int position) const;
+
+        /**
+         * @brief Provides all errors of the document.
+         * @return Errors with positions relative to the beginning of the document.
+         */
+        QList<ParserError> getErrors() const;
+
+        /**
+         * @brief Provides text of the statement.
+         * @param index Index of the statement.
+         * @return Statement text, as it appears in the document.
+         */
+        QString getStatementSql(int index) const;
+
+    private:
+        static bool isSplitBoundary(const TokenList& tokens, bool complete);
+        QList<Statement> splitRegion(int regionStart, const QList<TokenList>& tokenizedStatements);
+        ResultsPtr parseStatement(const QString& statementSql);
+
+        /**
+         * @brief Number of parse results of statements that are no longer in the document, kept in the cache.
+         */
+        static const int CACHE_SIZE = 1000;
+
+        Parser parser;
+        QString sql;
+        QVector<Statement> statements;
+        QCache<QString, ResultsPtr> cache;
+};
+
+#endif // INCREMENTALPARSER_H
@@ -2,6 +2,8 @@
 #include "sqlite3_parse.h"
 #include <QDebug>
 #include <QList>
+#include <QVector>
+#include <cstring>
 
 QHash<QString,int> keywords3;
 QSet<QString> softKeywords3;
@@ -11,13 +13,128 @@ QStringList fkMatchKeywords;
 QStringList conflictAlgoKeywords;
 QStringList generatedColumnKeywords;
 
+/**
+ * @brief Keyword entry of the perfect hash table.
+ */
+struct KeywordHashEntry
+{
+    QByteArray keyword;
+    int id = TK3_ID;
+};
+
+/**
+ * @brief Keywords referenced by the perfect hash table.
+ */
+QVector<KeywordHashEntry> keywordHashEntries;
+
+/**
+ * @brief Perfect hash table of keywords. Each slot is an index in keywordHashEntries, or -1.
+ */
+QVector<qint16> keywordHashSlots;
+quint32 keywordHashSeed = 0;
+int maxKeywordLength = 0;
+
+static const int MAX_KEYWORD_HASH_SEEDS = 1000;
+
+static quint32 keywordHash(const char* upperStr, int length, quint32 seed)
+{
+    // FNV-1a
+    quint32 hash = 2166136261u ^ seed;
+    for (int i = 0; i < length; i++)
+    {
+        hash ^= static_cast<uchar>(upperStr[i]);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+/**
+ * @brief Builds perfect hash table for all keywords.
+ *
+ * Table size and hash seed are picked so that no two keywords fall into the same slot.
+ * Then lookup is a single hash calculation and comparison with a single keyword.
+ */
+static void initKeywordHashTable()
+{
+    keywordHashEntries.clear();
+    maxKeywordLength = 0;
+    QHashIterator<QString,int> it(keywords3);
+    while (it.hasNext())
+    {
+        it.next();
+        KeywordHashEntry entry;
+        entry.keyword = it.key().toLatin1();
+        entry.id = it.value();
+        keywordHashEntries << entry;
+        maxKeywordLength = qMax(maxKeywordLength, entry.keyword.size());
+    }
+
+    int size = 1;
+    while (size < keywordHashEntries.size() * 16)
+        size *= 2;
+
+    QVector<qint16> table;
+    for (;; size *= 2)
+    {
+        for (quint32 seed = 0; seed < MAX_KEYWORD_HASH_SEEDS; seed++)
+        {
+            table.fill(-1, size);
+            bool collision = false;
+            for (int i = 0; i < keywordHashEntries.size() && !collision; i++)
+            {
+                const QByteArray& keyword = keywordHashEntries[i].keyword;
+                int slot = keywordHash(keyword.constData(), keyword.size(), seed) & (size - 1);
+                if (table[slot] > -1)
+                    collision = true;
+                else
+                    table[slot] = static_cast<qint16>(i);
+            }
+
+            if (!collision)
+            {
+                keywordHashSlots = table;
+                keywordHashSeed = seed;
+                return;
+            }
+        }
+    }
+}
+
 int getKeywordId3(const QString& str)
 {
-    QString upStr = str.toUpper();
-    if (keywords3.contains(upStr))
-        return keywords3[upStr];
-    else
+    return getKeywordId3(str.constData(), str.length());
+}
+
+int getKeywordId3(const QChar* str, int length)
+{
+    if (length > maxKeywordLength || keywordHashSlots.isEmpty())
         return TK3_ID;
+
+    // All keywords are ASCII, so anything else is not a keyword
+    char upperStr[64];
+    ushort c;
+    for (int i = 0; i < length; i++)
+    {
+        c = str[i].unicode();
+        if (c >= 128)
+            return TK3_ID;
+
+        if (c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+
+        upperStr[i] = static_cast<char>(c);
+    }
+
+    int slot = keywordHash(upperStr, length, keywordHashSeed) & (keywordHashSlots.size() - 1);
+    int idx = keywordHashSlots[slot];
+    if (idx < 0)
+        return TK3_ID;
+
+    const KeywordHashEntry& entry = keywordHashEntries[idx];
+    if (entry.keyword.size() != length || memcmp(entry.keyword.constData(), upperStr, length) != 0)
+        return TK3_ID;
+
+    return entry.id;
 }
 
 bool isRowIdKeyword(const QString& str)
@@ -199,6 +316,8 @@ void initKeywords()
                   << "RECURSIVE" << "RELEASE" << "REPLACE" << "RESTRICT" << "ROW" << "ROWS" << "ROLLBACK" << "SAVEPOINT" << "TEMP" << "TIES"
                   << "TRIGGER" << "UNBOUNDED" << "VACUUM" << "VIEW" << "VIRTUAL" << "WITH" << "WITHOUT" << "REINDEX" << "RENAME" << "IF"
                   << "CURRENT_DATE" << "CURRENT_TIME" << "CURRENT_TIMESTAMP";
+
+    initKeywordHashTable();
 }
 
 
@@ -224,7 +343,7 @@ bool isFkMatchKeyword(const QString &str)
 
 bool isKeyword(const QString& str)
 {
-    return keywords3.contains(str.toUpper());
+    return getKeywordId3(str) != TK3_ID;
 }
 
 QStringList getConflictAlgorithms()
@@ -18,6 +18,17 @@
  */
 API_EXPORT int getKeywordId3(const QString& str);
 
+/**
+ * @brief Translates keyword into it's Lemon token ID for SQLite 3 dialect.
+ * @param str Pointer to the first character of the keyword.
+ * @param length Number of characters of the keyword.
+ * @return Lemon generated token ID, or TK3_ID value when the string was not recognized as a valid SQLite 3 keyword.
+ *
+ * This is the version used by the Lexer. It uses perfect hash table built by initKeywords(),
+ * so it doesn't allocate any memory, nor does it need to convert the string to upper case.
+ */
+API_EXPORT int getKeywordId3(const QChar* str, int length);
+
 /**
  * @brief Tests whether given string represents a keyword in SQLite dialect.
  * @param str String to test.
@@ -24,30 +24,8 @@ Lexer::~Lexer()
 TokenList Lexer::process(const QString &sql)
 {
     TokenList resultList;
-    int lgt;
-    TokenPtr token;
-    QString str = sql;
-
-    quint64 pos = 0;
-    for (;str.size() > 0;)
-    {
-        if (tolerant)
-            token = TolerantTokenPtr::create();
-        else
-            token = TokenPtr::create();
-
-        lgt = lexerGetToken(str, token, 3, tolerant);
-        if (lgt == 0)
-            break;
-
-        token->value = str.mid(0, lgt);
-        token->start = pos;
-        token->end = pos + lgt - 1;
-
-        resultList << token;
-        str = str.mid(lgt);
-        pos += lgt;
-    }
+    for (const RawToken& rawToken : tokenizeRaw(sql, tolerant))
+        resultList << createToken(sql, rawToken);
 
     return resultList;
 }
@@ -60,27 +38,19 @@ void Lexer::prepare(const QString &sql)
 
 TokenPtr Lexer::getToken()
 {
-    if (sqlToTokenize.isEmpty())
+    if (isEnd())
         return TokenPtr();
 
-    TokenPtr token;
-    if (tolerant)
-        token = TolerantTokenPtr::create();
-    else
-        token = TokenPtr::create();
-
-    int lgt = lexerGetToken(sqlToTokenize, token, 3, tolerant);
-    if (lgt == 0)
+    // Tokenizing from current position, without cutting already tokenized part off the string
+    int position = static_cast<int>(tokenPosition);
+    RawToken rawToken;
+    rawToken.start = position;
+    rawToken.length = lexerGetToken(sqlToTokenize.constData() + position, sqlToTokenize.length() - position, rawToken, tolerant);
+    if (rawToken.length == 0)
         return TokenPtr();
 
-    token->value = sqlToTokenize.mid(0, lgt);
-    token->start = tokenPosition;
-    token->end = tokenPosition + lgt - 1;
-
-    sqlToTokenize = sqlToTokenize.mid(lgt);
-    tokenPosition += lgt;
-
-    return token;
+    tokenPosition += rawToken.length;
+    return createToken(sqlToTokenize, rawToken);
 }
 
 void Lexer::cleanUp()
@@ -121,7 +91,7 @@ QSet<TokenPtr> Lexer::getEveryTokenType(QSet<Token::Type> types)
 
 bool Lexer::isEnd() const
 {
-    return sqlToTokenize.isEmpty();
+    return tokenPosition >= static_cast<quint64>(sqlToTokenize.length());
 }
 
 TokenPtr Lexer::getSemicolonToken()
@@ -249,6 +219,27 @@ TokenList Lexer::tokenize(const QString& sql)
     return lexer.process(sql);
 }
 
+RawTokenList Lexer::tokenizeRaw(const QString& sql, bool tolerant)
+{
+    RawTokenList tokens;
+    RawToken token;
+    const QChar* data = sql.constData();
+    int length = sql.length();
+    int pos = 0;
+    while (pos < length)
+    {
+        token = RawToken();
+        token.start = pos;
+        token.length = lexerGetToken(data + pos, length - pos, token, tolerant);
+        if (token.length == 0)
+            break;
+
+        tokens << token;
+        pos += token.length;
+    }
+    return tokens;
+}
+
 TokenPtr Lexer::getEveryTokenTypePtr(Token *token)
 {
     if (everyTokenTypePtrMap.contains(token))
@@ -258,6 +249,28 @@ TokenPtr Lexer::getEveryTokenTypePtr(Token *token)
     return TokenPtr();
 }
 
+TokenPtr Lexer::createToken(const QString& sql, const RawToken& rawToken) const
+{
+    TokenPtr token;
+    if (tolerant)
+    {
+        TolerantTokenPtr tolerantToken = TolerantTokenPtr::create();
+        tolerantToken->invalid = rawToken.invalid;
+        token = tolerantToken;
+    }
+    else
+    {
+        token = TokenPtr::create();
+    }
+
+    token->lemonType = rawToken.lemonType;
+    token->type = rawToken.type;
+    token->value = sql.mid(rawToken.start, rawToken.length);
+    token->start = rawToken.start;
+    token->end = rawToken.start + rawToken.length - 1;
+    return token;
+}
+
 TokenPtr Lexer::createTokenType(int lemonType, Token::Type type, const QString &value)
 {
     TokenPtr tokenPtr = TokenPtr::create(lemonType, type, value, -100, -100);
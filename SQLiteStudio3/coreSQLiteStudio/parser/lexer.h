@@ -148,6 +148,18 @@ class API_EXPORT Lexer
          */
         static TokenList tokenize(const QString& sql);
 
+        /**
+         * @brief Tokenizes given SQL without creating Token objects.
+         * @param sql SQL query to tokenize.
+         * @param tolerant If true, tokens are produced like in tolerant mode (see setTolerantMode()).
+         * @return List of raw tokens.
+         *
+         * This is much faster than tokenize() for big texts, because token values are not copied
+         * and all tokens are kept in a single block of memory. Use it when you only need types
+         * and positions of tokens.
+         */
+        static RawTokenList tokenizeRaw(const QString& sql, bool tolerant = false);
+
         /**
          * @brief Translates token pointer into common token shared pointer.
          * @param token Token pointer to translate.
@@ -187,6 +199,14 @@ class API_EXPORT Lexer
          */
         static TokenPtr createTokenType(int lemonType, Token::Type type, const QString& value);
 
+        /**
+         * @brief Creates token object from the raw token.
+         * @param sql Tokenized string, that the raw token refers to.
+         * @param rawToken Raw token.
+         * @return Token, or TolerantToken if the tolerant mode is enabled.
+         */
+        TokenPtr createToken(const QString& sql, const RawToken& rawToken) const;
+
         /**
          * @brief Current "tolerant mode" flag.
          *
@@ -209,7 +229,7 @@ class API_EXPORT Lexer
          *
          * It's reset to 0 by prepare() and cleanUp().
          */
-        quint64 tokenPosition;
+        quint64 tokenPosition = 0;
 
         /**
          * @brief Internal table of every token type for SQLite 3.
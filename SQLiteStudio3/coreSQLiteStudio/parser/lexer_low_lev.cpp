@@ -8,16 +8,40 @@
 #include <QByteArray>
 #include <QChar>
 #include <QDebug>
+#include <QVector>
 
 //
 // Low-level lexer routines based on tokenizer from SQLite 3.7.15.2
 //
 
-bool isIdChar(const QChar& c)
+static bool isIdCharNoCache(const QChar& c)
 {
     return c.isPrint() && !c.isSpace() && !doesObjectNeedWrapping(c);
 }
 
+bool isIdChar(const QChar& c)
+{
+    // Most of characters are ASCII, so results for them are computed once
+    static const QVector<bool> asciiIdChars = []()
+    {
+        QVector<bool> table(128);
+        for (int i = 0; i < 128; i++)
+            table[i] = isIdCharNoCache(QChar(i));
+
+        return table;
+    }();
+
+    if (c.unicode() < 128)
+        return asciiIdChars[c.unicode()];
+
+    return isIdCharNoCache(c);
+}
+
+static inline QChar charAt(const QChar* z, int length, int pos)
+{
+    return pos < length ? z[pos] : QChar(0);
+}
+
 int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tolerant)
 {
     if (sqliteVersion < 3 || sqliteVersion > 3)
@@ -32,90 +56,102 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         return 0;
     }
 
+    RawToken rawToken;
+    int lgt = lexerGetToken(z.constData(), z.length(), rawToken, tolerant);
+    token->lemonType = rawToken.lemonType;
+    token->type = rawToken.type;
+    if (tolerant && rawToken.invalid)
+        token.dynamicCast<TolerantToken>()->invalid = true;
+
+    return lgt;
+}
+
+int lexerGetToken(const QChar* z, int length, RawToken& token, bool tolerant)
+{
     int i;
     QChar c;
-    QChar z0 = charAt(z, 0);
+    QChar z0 = charAt(z, length, 0);
 
     for (;;)
     {
         if (z0.isSpace())
         {
-            for(i=1; charAt(z, i).isSpace(); i++) {}
-            token->lemonType = TK3_SPACE;
-            token->type = Token::SPACE;
+            for(i=1; charAt(z, length, i).isSpace(); i++) {}
+            token.lemonType = TK3_SPACE;
+            token.type = Token::SPACE;
             return i;
         }
         if (z0 == '-')
         {
-            if (charAt(z, 1) == '-')
+            if (charAt(z, length, 1) == '-')
             {
-                for (i=2; !(c = charAt(z, i)).isNull() && c != '\n'; i++) {}
-                token->lemonType = TK3_COMMENT;
-                token->type = Token::COMMENT;
+                for (i=2; !(c = charAt(z, length, i)).isNull() && c != '\n'; i++) {}
+                token.lemonType = TK3_COMMENT;
+                token.type = Token::COMMENT;
                 return i;
             }
-            else if (charAt(z, 1) == '>')
+            else if (charAt(z, length, 1) == '>')
             {
-                token->lemonType = TK3_PTR;
-                token->type = Token::OPERATOR;
-                return (charAt(z, 2) == '>') ? 3 : 2;
+                token.lemonType = TK3_PTR;
+                token.type = Token::OPERATOR;
+                return (charAt(z, length, 2) == '>') ? 3 : 2;
             }
-            token->lemonType = TK3_MINUS;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_MINUS;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '(')
         {
-            token->lemonType = TK3_LP;
-            token->type = Token::PAR_LEFT;
+            token.lemonType = TK3_LP;
+            token.type = Token::PAR_LEFT;
             return 1;
         }
         if (z0 == ')')
         {
-            token->lemonType = TK3_RP;
-            token->type = Token::PAR_RIGHT;
+            token.lemonType = TK3_RP;
+            token.type = Token::PAR_RIGHT;
             return 1;
         }
         if (z0 == ';')
         {
-            token->lemonType = TK3_SEMI;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_SEMI;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '+')
         {
-            token->lemonType = TK3_PLUS;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_PLUS;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '*')
         {
-            token->lemonType = TK3_STAR;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_STAR;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '/')
         {
-            if ( charAt(z, 1) != '*' )
+            if ( charAt(z, length, 1) != '*' )
             {
-                token->lemonType = TK3_SLASH;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_SLASH;
+                token.type = Token::OPERATOR;
                 return 1;
             }
 
-            if ( charAt(z, 2).isNull() )
+            if ( charAt(z, length, 2).isNull() )
             {
-                token->lemonType = TK3_COMMENT;
-                token->type = Token::COMMENT;
+                token.lemonType = TK3_COMMENT;
+                token.type = Token::COMMENT;
                 if (tolerant)
-                    token.dynamicCast<TolerantToken>()->invalid = true;
+                    token.invalid = true;
 
                 return 2;
             }
-            for (i = 3, c = charAt(z, 2); (c != '*' || charAt(z, i) != '/') && !(c = charAt(z, i)).isNull(); i++) {}
+            for (i = 3, c = charAt(z, length, 2); (c != '*' || charAt(z, length, i) != '/') && !(c = charAt(z, length, i)).isNull(); i++) {}
 
-            if (tolerant && (c != '*' || charAt(z, i) != '/'))
-                token.dynamicCast<TolerantToken>()->invalid = true;
+            if (tolerant && (c != '*' || charAt(z, length, i) != '/'))
+                token.invalid = true;
 
 #if QT_VERSION >= 0x050800
             if ( c.unicode() > 0 )
@@ -123,116 +159,116 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             if ( c > 0 )
 #endif
                 i++;
-            token->lemonType = TK3_COMMENT;
-            token->type = Token::COMMENT;
+            token.lemonType = TK3_COMMENT;
+            token.type = Token::COMMENT;
             return i;
         }
         if (z0 == '%')
         {
-            token->lemonType = TK3_REM;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_REM;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '=')
         {
-            token->lemonType = TK3_EQ;
-            token->type = Token::OPERATOR;
-            return 1 + (charAt(z, 1) == '=');
+            token.lemonType = TK3_EQ;
+            token.type = Token::OPERATOR;
+            return 1 + (charAt(z, length, 1) == '=');
         }
         if (z0 == '<')
         {
-            if ( (c = charAt(z, 1)) == '=' )
+            if ( (c = charAt(z, length, 1)) == '=' )
             {
-                token->lemonType = TK3_LE;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_LE;
+                token.type = Token::OPERATOR;
                 return 2;
             }
             else if ( c == '>' )
             {
-                token->lemonType = TK3_NE;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_NE;
+                token.type = Token::OPERATOR;
                 return 2;
             }
             else if( c == '<' )
             {
-                token->lemonType = TK3_LSHIFT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_LSHIFT;
+                token.type = Token::OPERATOR;
                 return 2;
             }
             else
             {
-                token->lemonType = TK3_LT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_LT;
+                token.type = Token::OPERATOR;
                 return 1;
             }
         }
         if (z0 == '>')
         {
-            if ( (c = charAt(z, 1)) == '=' )
+            if ( (c = charAt(z, length, 1)) == '=' )
             {
-                token->lemonType = TK3_GE;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_GE;
+                token.type = Token::OPERATOR;
                 return 2;
             }
             else if ( c == '>' )
             {
-                token->lemonType = TK3_RSHIFT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_RSHIFT;
+                token.type = Token::OPERATOR;
                 return 2;
             }
             else
             {
-                token->lemonType = TK3_GT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_GT;
+                token.type = Token::OPERATOR;
                 return 1;
             }
         }
         if (z0 == '!')
         {
-            if ( charAt(z, 1) != '=' )
+            if ( charAt(z, length, 1) != '=' )
             {
-                token->lemonType = TK3_ILLEGAL;
-                token->type = Token::INVALID;
+                token.lemonType = TK3_ILLEGAL;
+                token.type = Token::INVALID;
                 return 2;
             }
             else
             {
-                token->lemonType = TK3_NE;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_NE;
+                token.type = Token::OPERATOR;
                 return 2;
             }
         }
         if (z0 == '|')
         {
-            if( charAt(z, 1) != '|' )
+            if( charAt(z, length, 1) != '|' )
             {
-                token->lemonType = TK3_BITOR;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_BITOR;
+                token.type = Token::OPERATOR;
                 return 1;
             }
             else
             {
-                token->lemonType = TK3_CONCAT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_CONCAT;
+                token.type = Token::OPERATOR;
                 return 2;
             }
         }
         if (z0 == ',')
         {
-            token->lemonType = TK3_COMMA;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_COMMA;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '&')
         {
-            token->lemonType = TK3_BITAND;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_BITAND;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '~')
         {
-            token->lemonType = TK3_BITNOT;
-            token->type = Token::OPERATOR;
+            token.lemonType = TK3_BITNOT;
+            token.type = Token::OPERATOR;
             return 1;
         }
         if (z0 == '`' ||
@@ -240,11 +276,11 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             z0 == '"')
         {
             QChar delim = z0;
-            for (i = 1; !(c = charAt(z, i)).isNull(); i++)
+            for (i = 1; !(c = charAt(z, length, i)).isNull(); i++)
             {
                 if ( c == delim )
                 {
-                    if( charAt(z, i+1) == delim )
+                    if( charAt(z, length, i+1) == delim )
                         i++;
                     else
                         break;
@@ -252,44 +288,44 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             }
             if ( c == '\'' )
             {
-                token->lemonType = TK3_STRING;
-                token->type = Token::STRING;
+                token.lemonType = TK3_STRING;
+                token.type = Token::STRING;
                 return i+1;
             }
             else if ( !c.isNull() )
             {
-                token->lemonType = TK3_ID;
-                token->type = Token::OTHER;
+                token.lemonType = TK3_ID;
+                token.type = Token::OTHER;
                 return i+1;
             }
             else if (tolerant)
             {
                 if (z0 == '\'')
                 {
-                    token->lemonType = TK3_STRING;
-                    token->type = Token::STRING;
+                    token.lemonType = TK3_STRING;
+                    token.type = Token::STRING;
                 }
                 else
                 {
-                    token->lemonType = TK3_ID;
-                    token->type = Token::OTHER;
+                    token.lemonType = TK3_ID;
+                    token.type = Token::OTHER;
                 }
-                token.dynamicCast<TolerantToken>()->invalid = true;
+                token.invalid = true;
                 return i;
             }
             else
             {
-                token->lemonType = TK3_ILLEGAL;
-                token->type = Token::INVALID;
+                token.lemonType = TK3_ILLEGAL;
+                token.type = Token::INVALID;
                 return i;
             }
         }
         if (z0 == '.')
         {
-            if( !charAt(z, 1).isDigit() )
+            if( !charAt(z, length, 1).isDigit() )
             {
-                token->lemonType = TK3_DOT;
-                token->type = Token::OPERATOR;
+                token.lemonType = TK3_DOT;
+                token.type = Token::OPERATOR;
                 return 1;
             }
             /*
@@ -299,70 +335,70 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0.isDigit() || z0 == '.')
         {
-            token->lemonType = TK3_INTEGER;
-            token->type = Token::INTEGER;
-            if (charAt(z, 0) == '0' && (charAt(z, 1) == 'x' || charAt(z, 1) == 'X') && isHex(charAt(z, 2)))
+            token.lemonType = TK3_INTEGER;
+            token.type = Token::INTEGER;
+            if (charAt(z, length, 0) == '0' && (charAt(z, length, 1) == 'x' || charAt(z, length, 1) == 'X') && isHex(charAt(z, length, 2)))
             {
-                for (i=3; isHex(charAt(z, i)); i++) {}
+                for (i=3; isHex(charAt(z, length, i)); i++) {}
                 return i;
             }
-            for (i=0; charAt(z, i).isDigit(); i++) {}
-            if ( charAt(z, i) == '.' )
+            for (i=0; charAt(z, length, i).isDigit(); i++) {}
+            if ( charAt(z, length, i) == '.' )
             {
                 i++;
-                while ( charAt(z, i).isDigit() )
+                while ( charAt(z, length, i).isDigit() )
                     i++;
 
-                token->lemonType = TK3_FLOAT;
-                token->type = Token::FLOAT;
+                token.lemonType = TK3_FLOAT;
+                token.type = Token::FLOAT;
             }
-            if ( (charAt(z, i) == 'e' || charAt(z, i) == 'E') &&
-                 ( charAt(z, i+1).isDigit()
-                   || ((charAt(z, i+1) == '+' || charAt(z, i+1) == '-') && charAt(z, i+2).isDigit())
+            if ( (charAt(z, length, i) == 'e' || charAt(z, length, i) == 'E') &&
+                 ( charAt(z, length, i+1).isDigit()
+                   || ((charAt(z, length, i+1) == '+' || charAt(z, length, i+1) == '-') && charAt(z, length, i+2).isDigit())
                  )
                )
             {
                 i += 2;
-                while ( charAt(z, i).isDigit() )
+                while ( charAt(z, length, i).isDigit() )
                     i++;
 
-                token->lemonType = TK3_FLOAT;
-                token->type = Token::FLOAT;
+                token.lemonType = TK3_FLOAT;
+                token.type = Token::FLOAT;
             }
-            while ( isIdChar(charAt(z, i)) )
+            while ( isIdChar(charAt(z, length, i)) )
             {
-                token->lemonType = TK3_ILLEGAL;
-                token->type = Token::INVALID;
+                token.lemonType = TK3_ILLEGAL;
+                token.type = Token::INVALID;
                 i++;
             }
             return i;
         }
         if (z0 == '[')
         {
-            for (i = 1, c = z0; c!=']' && !(c = charAt(z, i)).isNull(); i++) {}
+            for (i = 1, c = z0; c!=']' && !(c = charAt(z, length, i)).isNull(); i++) {}
             if (c == ']')
             {
-                token->lemonType = TK3_ID;
-                token->type = Token::OTHER;
+                token.lemonType = TK3_ID;
+                token.type = Token::OTHER;
             }
             else if (tolerant)
             {
-                token->lemonType = TK3_ID;
-                token->type = Token::OTHER;
-                token.dynamicCast<TolerantToken>()->invalid = true;
+                token.lemonType = TK3_ID;
+                token.type = Token::OTHER;
+                token.invalid = true;
             }
             else
             {
-                token->lemonType = TK3_ILLEGAL;
-                token->type = Token::INVALID;
+                token.lemonType = TK3_ILLEGAL;
+                token.type = Token::INVALID;
             }
             return i;
         }
         if (z0 == '?')
         {
-            token->lemonType = TK3_VARIABLE;
-            token->type = Token::BIND_PARAM;
-            for (i=1; charAt(z, i).isDigit(); i++) {}
+            token.lemonType = TK3_VARIABLE;
+            token.type = Token::BIND_PARAM;
+            for (i=1; charAt(z, length, i).isDigit(); i++) {}
             return i;
         }
         if (z0 == '$' ||
@@ -370,9 +406,9 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             z0 == ':')
         {
             int n = 0;
-            token->lemonType = TK3_VARIABLE;
-            token->type = Token::BIND_PARAM;
-            for (i = 1; !(c = charAt(z, i)).isNull(); i++)
+            token.lemonType = TK3_VARIABLE;
+            token.type = Token::BIND_PARAM;
+            for (i = 1; !(c = charAt(z, length, i)).isNull(); i++)
             {
                 if ( isIdChar(c) )
                 {
@@ -384,7 +420,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
                     {
                         i++;
                     }
-                    while ( !(c = charAt(z, i)).isNull() && !c.isSpace() && c != ')' );
+                    while ( !(c = charAt(z, length, i)).isNull() && !c.isSpace() && c != ')' );
 
                     if ( c==')' )
                     {
@@ -392,12 +428,12 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
                     }
                     else
                     {
-                        token->lemonType = TK3_ILLEGAL;
-                        token->type = Token::INVALID;
+                        token.lemonType = TK3_ILLEGAL;
+                        token.type = Token::INVALID;
                     }
                     break;
                 }
-                else if ( c == ':' && charAt(z, i+1) == ':' )
+                else if ( c == ':' && charAt(z, length, i+1) == ':' )
                 {
                     i++;
                 }
@@ -408,43 +444,43 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             }
             if( n == 0 )
             {
-                token->lemonType = TK3_ILLEGAL;
-                token->type = Token::INVALID;
+                token.lemonType = TK3_ILLEGAL;
+                token.type = Token::INVALID;
             }
 
             return i;
         }
         if (z0 == 'x' || z0 == 'X')
         {
-            if ( charAt(z, 1) == '\'' )
+            if ( charAt(z, length, 1) == '\'' )
             {
-                token->lemonType = TK3_BLOB;
-                token->type = Token::BLOB;
-                for (i = 2; isXDigit(charAt(z, i)); i++) {}
-                if (charAt(z, i) != '\'' || i%2)
+                token.lemonType = TK3_BLOB;
+                token.type = Token::BLOB;
+                for (i = 2; isXDigit(charAt(z, length, i)); i++) {}
+                if (charAt(z, length, i) != '\'' || i%2)
                 {
                     if (tolerant)
                     {
-                        token->lemonType = TK3_BLOB;
-                        token->type = Token::BLOB;
-                        token.dynamicCast<TolerantToken>()->invalid = true;
+                        token.lemonType = TK3_BLOB;
+                        token.type = Token::BLOB;
+                        token.invalid = true;
                     }
                     else
                     {
-                        token->lemonType = TK3_ILLEGAL;
-                        token->type = Token::INVALID;
+                        token.lemonType = TK3_ILLEGAL;
+                        token.type = Token::INVALID;
                     }
 #if QT_VERSION >= 0x050800
-                    while (charAt(z, i).unicode() > 0 && charAt(z, i).unicode() != '\'')
+                    while (charAt(z, length, i).unicode() > 0 && charAt(z, length, i).unicode() != '\'')
 #else
-                    while (charAt(z, i) > 0 && charAt(z, i) != '\'')
+                    while (charAt(z, length, i) > 0 && charAt(z, length, i) != '\'')
 #endif
                         i++;
                 }
 #if QT_VERSION >= 0x050800
-                if ( charAt(z, i).unicode() > 0 )
+                if ( charAt(z, length, i).unicode() > 0 )
 #else
-                if ( charAt(z, i) > 0 )
+                if ( charAt(z, length, i) > 0 )
 #endif
                     i++;
 
@@ -457,21 +493,21 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             if (!isIdChar(z0))
                 break;
 
-            for (i = 1; isIdChar(charAt(z, i)); i++) {}
+            for (i = 1; isIdChar(charAt(z, length, i)); i++) {}
 
-                token->lemonType = getKeywordId3(z.mid(0, i));
+            token.lemonType = getKeywordId3(z, i);
 
-            if (token->lemonType == TK3_ID)
-                token->type = Token::OTHER;
+            if (token.lemonType == TK3_ID)
+                token.type = Token::OTHER;
             else
-                token->type = Token::KEYWORD;
+                token.type = Token::KEYWORD;
 
             return i;
         }
     }
 
-    token->lemonType = TK3_ILLEGAL;
-    token->type = Token::INVALID;
+    token.lemonType = TK3_ILLEGAL;
+    token.type = Token::INVALID;
     return 1;
 }
 
@@ -25,4 +25,16 @@
  */
 int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tolerant = false);
 
+/**
+ * @brief Low level tokenizer function working directly on characters.
+ * @param z Pointer to the first character to tokenize.
+ * @param length Number of characters available from \p z.
+ * @param[out] token Token description to fill. Its start and length are not touched.
+ * @param tolerant Same as for the other version of lexerGetToken(). Unfinished tokens are reported with token.invalid.
+ * @return Length of the token.
+ *
+ * This is the actual tokenizer. It only reads characters, so it doesn't allocate any memory.
+ */
+int lexerGetToken(const QChar* z, int length, RawToken& token, bool tolerant = false);
+
 #endif // LEXER_LOW_LEV_H
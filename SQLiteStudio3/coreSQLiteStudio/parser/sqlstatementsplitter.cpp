@@ -0,0 +1,240 @@
+#include "sqlstatementsplitter.h"
+#include "common/global.h"
+
+// Same as in sqlite3_complete(). Rows are states, columns are tokens.
+const quint8 SqlStatementSplitter::transitions[8][8] = {
+    /*                 SEMI      WS          OTHER       EXPLAIN     CREATE      TEMP        TRIGGER     END */
+    /* INVALID */   {ST_START, ST_INVALID, ST_NORMAL,  ST_EXPLAIN, ST_CREATE,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL},
+    /* START */     {ST_START, ST_START,   ST_NORMAL,  ST_EXPLAIN, ST_CREATE,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL},
+    /* NORMAL */    {ST_START, ST_NORMAL,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL},
+    /* EXPLAIN */   {ST_START, ST_EXPLAIN, ST_EXPLAIN, ST_NORMAL,  ST_CREATE,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL},
+    /* CREATE */    {ST_START, ST_CREATE,  ST_NORMAL,  ST_NORMAL,  ST_NORMAL,  ST_CREATE,  ST_TRIGGER, ST_NORMAL},
+    /* TRIGGER */   {ST_SEMI,  ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER},
+    /* SEMI */      {ST_SEMI,  ST_SEMI,    ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_END},
+    /* END */       {ST_START, ST_END,     ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER, ST_TRIGGER}
+};
+
+void SqlStatementSplitter::append(const QString& text)
+{
+    buffer.append(text);
+
+    int statementStart = 0;
+    const QChar* data = buffer.constData();
+    int size = buffer.size();
+    int i = scanPos;
+    QChar c;
+    while (i < size)
+    {
+        c = data[i];
+        switch (scan)
+        {
+            case Scan::NORMAL:
+            {
+                if (isWordChar(c))
+                {
+                    scan = Scan::WORD;
+                    wordStart = i;
+                }
+                else if (c == ';')
+                {
+                    feed(TK_SEMI);
+                    if (state == ST_START)
+                    {
+                        Statement stmt;
+                        stmt.sql = buffer.mid(statementStart, i + 1 - statementStart);
+                        stmt.end = bufferOffset + i + 1;
+                        statements.enqueue(stmt);
+                        statementStart = i + 1;
+                    }
+                }
+                else if (c.isSpace())
+                    feed(TK_WS);
+                else if (c == '\'')
+                    scan = Scan::SINGLE_QUOTE;
+                else if (c == '"')
+                    scan = Scan::DOUBLE_QUOTE;
+                else if (c == '`')
+                    scan = Scan::BACK_QUOTE;
+                else if (c == '[')
+                    scan = Scan::BRACKET;
+                else if (c == '-')
+                    scan = Scan::MINUS;
+                else if (c == '/')
+                    scan = Scan::SLASH;
+                else
+                    feed(TK_OTHER);
+
+                break;
+            }
+            case Scan::WORD:
+            {
+                if (isWordChar(c))
+                    break;
+
+                feed(classifyWord(wordStart, i));
+                scan = Scan::NORMAL;
+                continue; // the character is processed again, in normal mode
+            }
+            case Scan::SINGLE_QUOTE:
+            case Scan::DOUBLE_QUOTE:
+            case Scan::BACK_QUOTE:
+            case Scan::BRACKET:
+            {
+                // Escaped quote (doubled) is simply taken as two quoted elements next to each other
+                if ((scan == Scan::SINGLE_QUOTE && c == '\'') || (scan == Scan::DOUBLE_QUOTE && c == '"') ||
+                    (scan == Scan::BACK_QUOTE && c == '`') || (scan == Scan::BRACKET && c == ']'))
+                {
+                    feed(TK_OTHER);
+                    scan = Scan::NORMAL;
+                }
+                break;
+            }
+            case Scan::MINUS:
+            {
+                if (c == '-')
+                {
+                    scan = Scan::LINE_COMMENT;
+                    break;
+                }
+
+                feed(TK_OTHER);
+                scan = Scan::NORMAL;
+                continue;
+            }
+            case Scan::LINE_COMMENT:
+            {
+                if (c == '\n')
+                {
+                    feed(TK_WS);
+                    scan = Scan::NORMAL;
+                }
+                break;
+            }
+            case Scan::SLASH:
+            {
+                if (c == '*')
+                {
+                    scan = Scan::BLOCK_COMMENT;
+                    break;
+                }
+
+                feed(TK_OTHER);
+                scan = Scan::NORMAL;
+                continue;
+            }
+            case Scan::BLOCK_COMMENT:
+            {
+                if (c == '*')
+                    scan = Scan::BLOCK_COMMENT_STAR;
+
+                break;
+            }
+            case Scan::BLOCK_COMMENT_STAR:
+            {
+                if (c == '/')
+                {
+                    feed(TK_WS);
+                    scan = Scan::NORMAL;
+                }
+                else if (c != '*')
+                    scan = Scan::BLOCK_COMMENT;
+
+                break;
+            }
+        }
+        i++;
+    }
+
+    // Text of complete statements is no longer needed
+    if (statementStart > 0)
+    {
+        buffer.remove(0, statementStart);
+        bufferOffset += statementStart;
+        wordStart -= statementStart;
+    }
+    scanPos = buffer.size();
+}
+
+bool SqlStatementSplitter::hasStatement() const
+{
+    return !statements.isEmpty();
+}
+
+SqlStatementSplitter::Statement SqlStatementSplitter::takeStatement()
+{
+    if (statements.isEmpty())
+        return Statement();
+
+    return statements.dequeue();
+}
+
+SqlStatementSplitter::Statement SqlStatementSplitter::takeRemainder()
+{
+    Statement stmt;
+    stmt.sql = buffer;
+    stmt.end = bufferOffset + buffer.size();
+
+    qint64 offset = stmt.end;
+    reset();
+    bufferOffset = offset;
+    return stmt;
+}
+
+void SqlStatementSplitter::reset()
+{
+    buffer.clear();
+    bufferOffset = 0;
+    scanPos = 0;
+    wordStart = 0;
+    scan = Scan::NORMAL;
+    state = ST_INVALID;
+    statements.clear();
+}
+
+bool SqlStatementSplitter::isWordChar(const QChar& c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '$';
+}
+
+SqlStatementSplitter::Token SqlStatementSplitter::classifyWord(int from, int to) const
+{
+    static_qstring(explainKw, "EXPLAIN");
+    static_qstring(createKw, "CREATE");
+    static_qstring(tempKw, "TEMP");
+    static_qstring(temporaryKw, "TEMPORARY");
+    static_qstring(triggerKw, "TRIGGER");
+    static_qstring(endKw, "END");
+
+    QStringRef word = buffer.midRef(from, to - from);
+    switch (word.size())
+    {
+        case 3:
+            if (word.compare(endKw, Qt::CaseInsensitive) == 0)
+                return TK_END;
+            break;
+        case 4:
+            if (word.compare(tempKw, Qt::CaseInsensitive) == 0)
+                return TK_TEMP;
+            break;
+        case 6:
+            if (word.compare(createKw, Qt::CaseInsensitive) == 0)
+                return TK_CREATE;
+            break;
+        case 7:
+            if (word.compare(explainKw, Qt::CaseInsensitive) == 0)
+                return TK_EXPLAIN;
+            if (word.compare(triggerKw, Qt::CaseInsensitive) == 0)
+                return TK_TRIGGER;
+            break;
+        case 9:
+            if (word.compare(temporaryKw, Qt::CaseInsensitive) == 0)
+                return TK_TEMP;
+            break;
+    }
+    return TK_OTHER;
+}
+
+void SqlStatementSplitter::feed(Token token)
+{
+    state = transitions[state][token];
+}
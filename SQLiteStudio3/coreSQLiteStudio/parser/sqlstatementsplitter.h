@@ -0,0 +1,139 @@
+#ifndef SQLSTATEMENTSPLITTER_H
+#define SQLSTATEMENTSPLITTER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QQueue>
+
+/**
+ * @brief Splits SQL script into statements, while the script is being read.
+ *
+ * The script is fed in parts of any size with append(). Complete statements become available
+ * as soon as their terminating semicolon is appended, so even huge scripts can be executed
+ * without reading them entirely into memory.
+ *
+ * Every character is scanned only once. Statement boundaries are determined by the same rules
+ * as sqlite3_complete() uses: semicolons in string literals, quoted names and comments are ignored,
+ * and so are semicolons in the body of CREATE TRIGGER statement, which ends only with "END;".
+ */
+class API_EXPORT SqlStatementSplitter
+{
+    public:
+        struct API_EXPORT Statement
+        {
+            /**
+             * @brief Statement text, including leading whitespaces and comments and the terminating semicolon.
+             */
+            QString sql;
+
+            /**
+             * @brief Position just after the statement, counted in characters appended to the splitter.
+             */
+            qint64 end = 0;
+        };
+
+        /**
+         * @brief Appends next part of the script.
+         * @param text Script contents.
+         */
+        void append(const QString& text);
+
+        /**
+         * @brief Tells if there is a complete statement to be taken.
+         * @return true if takeStatement() will return next statement.
+         */
+        bool hasStatement() const;
+
+        /**
+         * @brief Takes next complete statement.
+         * @return The statement, or empty statement if there is none.
+         */
+        Statement takeStatement();
+
+        /**
+         * @brief Takes the text appended after the last complete statement.
+         * @return The rest of the script, as a statement.
+         *
+         * Use it when the end of the script is reached, to get the last statement, not terminated with semicolon.
+         * The result may contain only whitespaces and comments. The splitter is ready for a new script afterwards.
+         */
+        Statement takeRemainder();
+
+        /**
+         * @brief Forgets all appended text and statements.
+         */
+        void reset();
+
+    private:
+        /**
+         * @brief Kind of lexical element that is being scanned.
+         */
+        enum class Scan
+        {
+            NORMAL,
+            WORD,
+            SINGLE_QUOTE,
+            DOUBLE_QUOTE,
+            BACK_QUOTE,
+            BRACKET,
+            MINUS,
+            LINE_COMMENT,
+            SLASH,
+            BLOCK_COMMENT,
+            BLOCK_COMMENT_STAR
+        };
+
+        /**
+         * @brief Token classes of the sqlite3_complete() state machine.
+         */
+        enum Token
+        {
+            TK_SEMI,
+            TK_WS,
+            TK_OTHER,
+            TK_EXPLAIN,
+            TK_CREATE,
+            TK_TEMP,
+            TK_TRIGGER,
+            TK_END
+        };
+
+        /**
+         * @brief States of the sqlite3_complete() state machine.
+         */
+        enum State
+        {
+            ST_INVALID,
+            ST_START,
+            ST_NORMAL,
+            ST_EXPLAIN,
+            ST_CREATE,
+            ST_TRIGGER,
+            ST_SEMI,
+            ST_END
+        };
+
+        static bool isWordChar(const QChar& c);
+        Token classifyWord(int from, int to) const;
+        void feed(Token token);
+
+        static const quint8 transitions[8][8];
+
+        /**
+         * @brief Text appended after the last complete statement.
+         */
+        QString buffer;
+
+        /**
+         * @brief Position of the buffer beginning in the whole script.
+         */
+        qint64 bufferOffset = 0;
+
+        int scanPos = 0;
+        int wordStart = 0;
+        Scan scan = Scan::NORMAL;
+        quint8 state = ST_INVALID;
+        QQueue<Statement> statements;
+};
+
+#endif // SQLSTATEMENTSPLITTER_H
@@ -4,6 +4,7 @@
 #include "common/utils.h"
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QSharedPointer>
 
 /** @file */
@@ -304,6 +305,49 @@ struct TolerantToken : public Token
     bool invalid = false;
 };
 
+/**
+ * @brief Token description without the token value.
+ *
+ * RawToken is produced by Lexer::tokenizeRaw(). It keeps only position of the token in tokenized string,
+ * so no string is copied and no object is allocated per token. Tokens are kept by value in the RawTokenList,
+ * which is a single contiguous block of memory. Value of the token can be read from the tokenized string
+ * (with QString::midRef()), if it's needed at all.
+ *
+ * This is meant for code that goes through all tokens of big texts, like the syntax highlighter.
+ */
+struct RawToken
+{
+    /**
+     * @brief Lemon token ID. Equivalent of Token::lemonType.
+     */
+    int lemonType = 0;
+
+    /**
+     * @brief Token type. Equivalent of Token::type.
+     */
+    Token::Type type = Token::INVALID;
+
+    /**
+     * @brief Position of the first character of the token in tokenized string.
+     */
+    int start = 0;
+
+    /**
+     * @brief Number of characters in the token.
+     */
+    int length = 0;
+
+    /**
+     * @brief Equivalent of TolerantToken::invalid. Can be true only if tokenized in tolerant mode.
+     */
+    bool invalid = false;
+};
+
+/**
+ * @brief Contiguous list of raw tokens.
+ */
+typedef QVector<RawToken> RawTokenList;
+
 /**
  * @brief Ordered list of tokens.
  *
@@ -32,7 +32,20 @@ QString DbPluginSqlite3::getLabel() const
 
 QList<DbPluginOption> DbPluginSqlite3::getOptionsList() const
 {
-    return QList<DbPluginOption>();
+    QList<DbPluginOption> opts;
+
+    DbPluginOption opt;
+    opt.type = DbPluginOption::INT;
+    opt.key = DB_READ_POOL_SIZE;
+    opt.label = tr("Additional read connections");
+    opt.toolTip = tr("Number of additional connections used to read data in parallel (for example while exporting).\n"
+                     "They are used only when the database is in the WAL journal mode. Zero disables them.");
+    opt.defaultValue = 0;
+    opt.minValue = 0;
+    opt.maxValue = 8;
+    opts << opt;
+
+    return opts;
 }
 
 QString DbPluginSqlite3::generateDbName(const QVariant& baseValue)
@@ -368,6 +368,43 @@ class ExportPlugin : virtual public Plugin
          * This method is guaranteed to be executed, no matter if export was successful or not.
          */
         virtual void cleanupAfterExport() = 0;
+
+        /**
+         * @brief Writes any data buffered by the plugin to the output device.
+         *
+         * Plugins may keep exported data in a buffer, instead of writing every piece of it to the output device
+         * as soon as it's produced. This is called at the end of every export (even failed one) and before anything
+         * else is written to the output device, so all data gets to the output and in the right order.
+         */
+        virtual void flushOutput() = 0;
+
+        /**
+         * @brief Creates another instance of the plugin, to export tables of a database in parallel.
+         * @return New instance, or null if the plugin (or its current configuration) doesn't support parallel export.
+         *
+         * When a database is exported, tables other than the first one may be exported in parallel,
+         * each by one of instances created with this method, into its own buffer. Buffers are then written
+         * to the actual output in the order of tables, so the output is the same as if tables were exported one by one.
+         *
+         * This is called from the main thread, before the export starts. The caller takes ownership of the instance.
+         * The instance is prepared with initTableExporter() before every table it exports.
+         */
+        virtual ExportPlugin* createTableExporter() = 0;
+
+        /**
+         * @brief Prepares instance returned from createTableExporter() to export a single table.
+         * @param exporter Instance created with createTableExporter().
+         * @param output Output device to write the table to.
+         * @return true for success, or false in case of a fatal error.
+         *
+         * This is called on the instance doing the database export, after it exported the first table.
+         * It should copy all settings and state of the export to the exporter, so that exportTable() (or exportVirtualTable()),
+         * exportTableRow() and afterExportTable() called on the exporter produce exactly what they would produce
+         * if called on this instance.
+         *
+         * It's called from several threads at the same time (for different exporters), so it must not modify this instance.
+         */
+        virtual bool initTableExporter(ExportPlugin* exporter, QIODevice* output) = 0;
 };
 
 #endif // EXPORTPLUGIN_H
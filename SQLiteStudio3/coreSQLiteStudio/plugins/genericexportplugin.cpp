@@ -5,6 +5,8 @@
 #include "config_builder.h"
 #include <QTextCodec>
 
+static const int UTF8_MIB = 106;
+
 bool GenericExportPlugin::initBeforeExport(Db* db, QIODevice* output, const ExportManager::StandardExportConfig& config)
 {
     this->db = db;
@@ -21,6 +23,10 @@ bool GenericExportPlugin::initBeforeExport(Db* db, QIODevice* output, const Expo
         }
     }
 
+    utf8Output = (codec && codec->mibEnum() == UTF8_MIB);
+    outputBuffer.resize(0);
+    outputBuffer.reserve(OUTPUT_BUFFER_SIZE);
+
     return beforeExport();
 }
 
@@ -87,12 +93,140 @@ bool GenericExportPlugin::initBeforeExport()
 
 void GenericExportPlugin::write(const QString& str)
 {
-    output->write(codec->fromUnicode(str));
+    if (utf8Output)
+        appendUtf8(str);
+    else
+        outputBuffer.append(codec->fromUnicode(str));
+
+    flushOutputIfFull();
 }
 
 void GenericExportPlugin::writeln(const QString& str)
 {
-    write(str + "\n");
+    if (!utf8Output)
+    {
+        write(str + "\n");
+        return;
+    }
+
+    appendUtf8(str);
+    outputBuffer.append('\n');
+    flushOutputIfFull();
+}
+
+bool GenericExportPlugin::writeInteger(const QVariant& value)
+{
+    if (!isInteger(value))
+        return false;
+
+    if (value.type() == QVariant::UInt || value.type() == QVariant::ULongLong)
+    {
+        appendInteger(value.toULongLong(), false);
+    }
+    else
+    {
+        qint64 signedValue = value.toLongLong();
+        quint64 absValue = static_cast<quint64>(signedValue);
+        appendInteger(signedValue < 0 ? 0 - absValue : absValue, signedValue < 0);
+    }
+
+    flushOutputIfFull();
+    return true;
+}
+
+bool GenericExportPlugin::isInteger(const QVariant& value)
+{
+    if (value.isNull())
+        return false;
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+void GenericExportPlugin::appendInteger(quint64 absValue, bool negative)
+{
+    // Digits are produced from the end of a stack buffer (20 digits of the max. 64-bit value and the sign)
+    char digits[21];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    do
+    {
+        *--begin = static_cast<char>('0' + absValue % 10);
+        absValue /= 10;
+    }
+    while (absValue > 0);
+
+    if (negative)
+        *--begin = '-';
+
+    int length = static_cast<int>(end - begin);
+    if (utf8Output)
+        outputBuffer.append(begin, length);
+    else
+        outputBuffer.append(codec->fromUnicode(QString::fromLatin1(begin, length)));
+}
+
+void GenericExportPlugin::appendUtf8(const QString& str)
+{
+    // Space for the worst case (3 bytes per UTF-16 code unit) is made upfront and the unused part is cut off at the end.
+    // Resizing QByteArray keeps its capacity, so the buffer is allocated only once per export.
+    int startSize = outputBuffer.size();
+    outputBuffer.resize(startSize + str.size() * 3);
+    char* dst = outputBuffer.data() + startSize;
+
+    const ushort* src = str.utf16();
+    const ushort* end = src + str.size();
+    ushort ch;
+    uint ucs4;
+    while (src < end)
+    {
+        ch = *src++;
+        if (ch < 0x80)
+        {
+            *dst++ = static_cast<char>(ch);
+        }
+        else if (ch < 0x800)
+        {
+            *dst++ = static_cast<char>(0xc0 | (ch >> 6));
+            *dst++ = static_cast<char>(0x80 | (ch & 0x3f));
+        }
+        else if (QChar::isHighSurrogate(ch) && src < end && QChar::isLowSurrogate(*src))
+        {
+            ucs4 = QChar::surrogateToUcs4(ch, *src++);
+            *dst++ = static_cast<char>(0xf0 | (ucs4 >> 18));
+            *dst++ = static_cast<char>(0x80 | ((ucs4 >> 12) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | ((ucs4 >> 6) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | (ucs4 & 0x3f));
+        }
+        else if (QChar::isSurrogate(ch))
+        {
+            // Unpaired surrogate, replaced the same way as QTextCodec does it
+            *dst++ = '?';
+        }
+        else
+        {
+            *dst++ = static_cast<char>(0xe0 | (ch >> 12));
+            *dst++ = static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | (ch & 0x3f));
+        }
+    }
+
+    outputBuffer.resize(static_cast<int>(dst - outputBuffer.constData()));
+}
+
+void GenericExportPlugin::flushOutputIfFull()
+{
+    if (outputBuffer.size() >= OUTPUT_BUFFER_SIZE)
+        flushOutput();
 }
 
 bool GenericExportPlugin::isTableExport() const
@@ -154,6 +288,39 @@ void GenericExportPlugin::cleanupAfterExport()
 {
 }
 
+void GenericExportPlugin::flushOutput()
+{
+    if (outputBuffer.isEmpty())
+        return;
+
+    output->write(outputBuffer);
+    outputBuffer.resize(0);
+}
+
+ExportPlugin* GenericExportPlugin::createTableExporter()
+{
+    return nullptr;
+}
+
+bool GenericExportPlugin::initTableExporter(ExportPlugin* exporter, QIODevice* output)
+{
+    UNUSED(exporter);
+    UNUSED(output);
+    return false;
+}
+
+void GenericExportPlugin::initTableExporterBase(GenericExportPlugin* exporter, QIODevice* output) const
+{
+    exporter->db = db;
+    exporter->output = output;
+    exporter->config = config;
+    exporter->codec = codec;
+    exporter->exportMode = exportMode;
+    exporter->utf8Output = utf8Output;
+    exporter->outputBuffer.resize(0);
+    exporter->outputBuffer.reserve(OUTPUT_BUFFER_SIZE);
+}
+
 bool GenericExportPlugin::beforeExport()
 {
     return true;
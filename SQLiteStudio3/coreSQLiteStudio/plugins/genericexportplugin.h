@@ -32,6 +32,9 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         bool afterExportDatabase();
         bool afterExport();
         void cleanupAfterExport();
+        void flushOutput();
+        ExportPlugin* createTableExporter();
+        bool initTableExporter(ExportPlugin* exporter, QIODevice* output);
 
         /**
          * @brief Does the initial entry in the export.
@@ -44,15 +47,57 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
 
     protected:
         virtual bool initBeforeExport();
+        /**
+         * @brief Writes the string to the output, encoded with the configured codec.
+         * @param str String to write.
+         *
+         * Encoded data is collected in a buffer and written to the output device in large blocks.
+         * UTF-8 (the most common encoding) is encoded directly into the buffer, without temporary byte arrays.
+         */
         void write(const QString& str);
         void writeln(const QString& str);
+
+        /**
+         * @brief Writes the integer value to the output, without converting it to a string first.
+         * @param value Value to write.
+         * @return true if the value was written, or false if it's not an integer (nothing is written then).
+         *
+         * Digits are formatted straight into the output buffer. Other types are left to the caller,
+         * as every format has its own rules for them.
+         */
+        bool writeInteger(const QVariant& value);
+
+        static bool isInteger(const QVariant& value);
         bool isTableExport() const;
 
+        /**
+         * @brief Copies common export settings to the table exporter.
+         * @param exporter Instance created with createTableExporter().
+         * @param output Output device for the exporter.
+         *
+         * It's a helper for initTableExporter() implementations. It copies database, config, codec and export mode,
+         * and sets the output device of the exporter.
+         */
+        void initTableExporterBase(GenericExportPlugin* exporter, QIODevice* output) const;
+
         Db* db = nullptr;
         QIODevice* output = nullptr;
         const ExportManager::StandardExportConfig* config = nullptr;
         QTextCodec* codec = nullptr;
         ExportManager::ExportMode exportMode = ExportManager::UNDEFINED;
+
+    private:
+        void appendUtf8(const QString& str);
+        void appendInteger(quint64 absValue, bool negative);
+        void flushOutputIfFull();
+
+        /**
+         * @brief Size of buffered data which is written to the output device at once.
+         */
+        static const int OUTPUT_BUFFER_SIZE = 256 * 1024;
+
+        QByteArray outputBuffer;
+        bool utf8Output = false;
 };
 
 #endif // GENERICEXPORTPLUGIN_H
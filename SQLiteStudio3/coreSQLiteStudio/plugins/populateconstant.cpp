@@ -28,6 +28,21 @@ QVariant PopulateConstantEngine::nextValue(bool& nextValueError)
     return cfg.PopulateConstant.Value.get();
 }
 
+void PopulateConstantEngine::nextValues(QList<QVariant>& values, int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QVariant value = cfg.PopulateConstant.Value.get();
+    values.clear();
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << value;
+}
+
+bool PopulateConstantEngine::canGenerateConcurrently() const
+{
+    return true;
+}
+
 void PopulateConstantEngine::afterPopulating()
 {
 }
@@ -32,6 +32,8 @@ class PopulateConstantEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        void nextValues(QList<QVariant>& values, int count, bool& nextValueError);
+        bool canGenerateConcurrently() const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -45,8 +45,7 @@ bool PopulateDictionaryEngine::beforePopulating(Db* db, const QString& table)
 
     dictionaryPos = 0;
     dictionarySize = dictionary.size();
-    if (cfg.PopulateDictionary.Random.get())
-        QRandomGenerator::system()->seed(QDateTime::currentDateTime().toTime_t());
+    randomGenerator = seeded ? QRandomGenerator(seed) : QRandomGenerator::securelySeeded();
 
     return true;
 }
@@ -56,7 +55,7 @@ QVariant PopulateDictionaryEngine::nextValue(bool& nextValueError)
     UNUSED(nextValueError);
     if (cfg.PopulateDictionary.Random.get())
     {
-        int r = QRandomGenerator::system()->generate() % dictionarySize;
+        int r = randomGenerator.bounded(dictionarySize);
         return dictionary[r];
     }
     else
@@ -68,6 +67,17 @@ QVariant PopulateDictionaryEngine::nextValue(bool& nextValueError)
     }
 }
 
+bool PopulateDictionaryEngine::canGenerateConcurrently() const
+{
+    return true;
+}
+
+void PopulateDictionaryEngine::setRandomSeed(quint32 seed)
+{
+    this->seed = seed;
+    seeded = true;
+}
+
 void PopulateDictionaryEngine::afterPopulating()
 {
     dictionary.clear();
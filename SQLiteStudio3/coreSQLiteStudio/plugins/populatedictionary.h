@@ -4,6 +4,7 @@
 #include "builtinplugin.h"
 #include "populateplugin.h"
 #include "config_builder.h"
+#include <QRandomGenerator>
 
 class QFile;
 class QTextStream;
@@ -37,6 +38,8 @@ class PopulateDictionaryEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        bool canGenerateConcurrently() const;
+        void setRandomSeed(quint32 seed);
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -47,6 +50,9 @@ class PopulateDictionaryEngine : public PopulateEngine
         QStringList dictionary;
         int dictionarySize = 0;
         int dictionaryPos = 0;
+        QRandomGenerator randomGenerator;
+        quint32 seed = 0;
+        bool seeded = false;
 };
 
 #endif // POPULATEDICTIONARY_H
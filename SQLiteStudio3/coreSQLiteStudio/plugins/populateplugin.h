@@ -3,6 +3,9 @@
 
 #include "coreSQLiteStudio_global.h"
 #include "plugins/plugin.h"
+#include "common/unused.h"
+#include <QList>
+#include <QVariant>
 
 class CfgMain;
 class PopulateEngine;
@@ -23,6 +26,51 @@ class API_EXPORT PopulateEngine
         virtual QVariant nextValue(bool& nextValueError) = 0;
         virtual void afterPopulating() = 0;
 
+        /**
+         * @brief Generates values for multiple rows at once.
+         * @param values List to fill with generated values. It's cleared first.
+         * @param count Number of values to generate.
+         * @param nextValueError Set to true if generating failed. No more values are generated then.
+         *
+         * The populating worker asks for values of a whole batch of rows with this method.
+         * The default implementation calls nextValue() for each row. Engines can override it
+         * to prepare everything only once per batch.
+         */
+        virtual void nextValues(QList<QVariant>& values, int count, bool& nextValueError)
+        {
+            values.clear();
+            values.reserve(count);
+            for (int i = 0; i < count && !nextValueError; i++)
+                values << nextValue(nextValueError);
+        }
+
+        /**
+         * @brief Tells if the engine can generate values in other thread than the one populating the table.
+         * @return true if nextValues() can be called from a thread pool.
+         *
+         * Values of such columns are generated at the same time, each column in its own thread.
+         * Engines using the database or thread-bound objects (like scripting contexts) should return false,
+         * which is the default. They are called from the populating thread, still at the same time
+         * as other columns are generated in the pool.
+         */
+        virtual bool canGenerateConcurrently() const
+        {
+            return false;
+        }
+
+        /**
+         * @brief Sets seed for random values generated by the engine.
+         * @param seed Seed derived from the populating seed and the column name.
+         *
+         * It's called before beforePopulating(). Engines generating random values should use it,
+         * so that populating with the same seed produces the same data, regardless of the order
+         * in which columns were generated.
+         */
+        virtual void setRandomSeed(quint32 seed)
+        {
+            UNUSED(seed);
+        }
+
         /**
          * @brief Provides config object that holds configuration for populating.
          * @return Config object, or null if the importing with this plugin is not configurable.
@@ -22,7 +22,7 @@ bool PopulateRandomEngine::beforePopulating(Db* db, const QString& table)
 {
     UNUSED(db);
     UNUSED(table);
-    randomGenerator = QRandomGenerator::securelySeeded();
+    randomGenerator = seeded ? QRandomGenerator(seed) : QRandomGenerator::securelySeeded();
     range = cfg.PopulateRandom.MaxValue.get() - cfg.PopulateRandom.MinValue.get() + 1;
     return (range > 0);
 }
@@ -34,6 +34,32 @@ QVariant PopulateRandomEngine::nextValue(bool& nextValueError)
     return (cfg.PopulateRandom.Prefix.get() + randValue + cfg.PopulateRandom.Suffix.get());
 }
 
+void PopulateRandomEngine::nextValues(QList<QVariant>& values, int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+
+    // Config values are read once per batch
+    QString prefix = cfg.PopulateRandom.Prefix.get();
+    QString suffix = cfg.PopulateRandom.Suffix.get();
+    int minValue = cfg.PopulateRandom.MinValue.get();
+
+    values.clear();
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << (prefix + QString::number((randomGenerator.generate() % range) + minValue) + suffix);
+}
+
+bool PopulateRandomEngine::canGenerateConcurrently() const
+{
+    return true;
+}
+
+void PopulateRandomEngine::setRandomSeed(quint32 seed)
+{
+    this->seed = seed;
+    seeded = true;
+}
+
 void PopulateRandomEngine::afterPopulating()
 {
 }
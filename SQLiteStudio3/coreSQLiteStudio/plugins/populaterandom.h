@@ -36,6 +36,9 @@ class PopulateRandomEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        void nextValues(QList<QVariant>& values, int count, bool& nextValueError);
+        bool canGenerateConcurrently() const;
+        void setRandomSeed(quint32 seed);
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -45,5 +48,7 @@ class PopulateRandomEngine : public PopulateEngine
         CFG_LOCAL(PopulateRandomConfig, cfg)
         int range;
         QRandomGenerator randomGenerator;
+        quint32 seed = 0;
+        bool seeded = false;
 };
 #endif // POPULATERANDOM_H
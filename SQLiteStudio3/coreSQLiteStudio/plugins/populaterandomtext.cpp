@@ -1,5 +1,4 @@
 #include "populaterandomtext.h"
-#include "common/utils.h"
 #include "common/unused.h"
 #include "services/populatemanager.h"
 
@@ -23,8 +22,9 @@ bool PopulateRandomTextEngine::beforePopulating(Db* db, const QString& table)
 {
     UNUSED(db);
     UNUSED(table);
-    randomGenerator = QRandomGenerator::securelySeeded();
-    range = cfg.PopulateRandomText.MaxLength.get() - cfg.PopulateRandomText.MinLength.get() + 1;
+    randomGenerator = seeded ? QRandomGenerator(seed) : QRandomGenerator::securelySeeded();
+    minLength = cfg.PopulateRandomText.MinLength.get();
+    range = cfg.PopulateRandomText.MaxLength.get() - minLength + 1;
 
     chars = "";
 
@@ -55,8 +55,26 @@ bool PopulateRandomTextEngine::beforePopulating(Db* db, const QString& table)
 QVariant PopulateRandomTextEngine::nextValue(bool& nextValueError)
 {
     UNUSED(nextValueError);
-    int lgt = (randomGenerator.generate() % range) + cfg.PopulateRandomText.MinLength.get();
-    return randStr(lgt, chars);
+    int lgt = (randomGenerator.generate() % range) + minLength;
+
+    // Characters come from the engine's own generator, so the text depends only on the seed
+    QString value;
+    value.reserve(lgt);
+    for (int i = 0; i < lgt; i++)
+        value += chars[randomGenerator.bounded(chars.size())];
+
+    return value;
+}
+
+bool PopulateRandomTextEngine::canGenerateConcurrently() const
+{
+    return true;
+}
+
+void PopulateRandomTextEngine::setRandomSeed(quint32 seed)
+{
+    this->seed = seed;
+    seeded = true;
 }
 
 void PopulateRandomTextEngine::afterPopulating()
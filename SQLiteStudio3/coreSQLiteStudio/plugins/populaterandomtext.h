@@ -39,6 +39,8 @@ class PopulateRandomTextEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        bool canGenerateConcurrently() const;
+        void setRandomSeed(quint32 seed);
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -47,8 +49,11 @@ class PopulateRandomTextEngine : public PopulateEngine
     private:
         CFG_LOCAL(PopulateRandomTextConfig, cfg)
         int range;
+        int minLength = 0;
         QString chars;
         QRandomGenerator randomGenerator;
+        quint32 seed = 0;
+        bool seeded = false;
 };
 
 #endif // POPULATERANDOMTEXT_H
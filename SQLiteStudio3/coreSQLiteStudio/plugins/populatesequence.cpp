@@ -33,6 +33,20 @@ QVariant PopulateSequenceEngine::nextValue(bool& nextValueError)
     return seq += step;
 }
 
+void PopulateSequenceEngine::nextValues(QList<QVariant>& values, int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    values.clear();
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << (seq += step);
+}
+
+bool PopulateSequenceEngine::canGenerateConcurrently() const
+{
+    return true;
+}
+
 void PopulateSequenceEngine::afterPopulating()
 {
 }
@@ -33,6 +33,8 @@ class PopulateSequenceEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        void nextValues(QList<QVariant>& values, int count, bool& nextValueError);
+        bool canGenerateConcurrently() const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
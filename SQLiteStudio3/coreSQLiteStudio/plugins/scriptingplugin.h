@@ -2,6 +2,8 @@
 #define SCRIPTINGPLUGIN_H
 
 #include "plugin.h"
+#include "db/sqlfunctionvalue.h"
+#include "common/unused.h"
 #include <QVariant>
 
 class Db;
@@ -23,6 +25,32 @@ class ScriptingPlugin : virtual public Plugin
                 virtual bool getUndefinedArgs() const = 0;
         };
 
+        /**
+         * @brief Function code prepared once and called many times.
+         *
+         * It's used for custom SQL functions, which are called for every row of the query.
+         * Arguments and the result are passed as SqlFunctionValue, so the plugin can convert them
+         * directly to and from its native values, without the QVariant.
+         *
+         * The object is owned by the caller. It must not be used after the plugin was unloaded.
+         */
+        class CompiledFunction
+        {
+            public:
+                virtual ~CompiledFunction() {}
+
+                /**
+                 * @brief Calls the function.
+                 * @param args Argument values.
+                 * @param argCount Number of arguments.
+                 * @param db Database that the function is called for. Database is already locked for the query, so the function must not lock it.
+                 * @param result Value returned by the function.
+                 * @param errorMessage Filled with the error message if the function failed.
+                 * @return true on success, false on failure.
+                 */
+                virtual bool call(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, QString& errorMessage) = 0;
+        };
+
         virtual QString getLanguage() const = 0;
         virtual Context* createContext() = 0;
         virtual void releaseContext(Context* context) = 0;
@@ -36,6 +64,45 @@ class ScriptingPlugin : virtual public Plugin
         virtual QVariant evaluate(const QString& code, const FunctionInfo& funcInfo, const QList<QVariant>& args = QList<QVariant>(),
                                   QString* errorMessage = nullptr) = 0;
         virtual QString getIconPath() const = 0;
+
+        /**
+         * @brief Prepares function code for repeated calls.
+         * @param code Code of the function.
+         * @param funcInfo Information about the function.
+         * @return Compiled function, or null if the plugin doesn't support it. Ownership is passed to the caller.
+         *
+         * Plugins don't have to implement it. Functions are then evaluated with evaluate().
+         */
+        virtual CompiledFunction* compileFunction(const QString& code, const FunctionInfo& funcInfo)
+        {
+            UNUSED(code);
+            UNUSED(funcInfo);
+            return nullptr;
+        }
+
+        /**
+         * @brief Evaluates the same code for multiple rows of arguments.
+         * @param context Context to evaluate in.
+         * @param code Code to evaluate.
+         * @param funcInfo Information about the function.
+         * @param args Argument values of all rows, one row after another.
+         * @param argCount Number of arguments in each row.
+         * @param rowCount Number of rows.
+         * @param db Database that the code is evaluated for. Database is already locked, so the code must not lock it.
+         *
+         * It's used for steps of aggregate functions. Results of evaluations are discarded.
+         * Evaluation stops at the first row that caused an error, which is then reported by hasError().
+         *
+         * The default implementation calls evaluate() for each row. Plugins may override it to prepare
+         * everything only once for all rows.
+         */
+        virtual void evaluateBatch(Context* context, const QString& code, const FunctionInfo& funcInfo, const SqlFunctionValue* args,
+                                   int argCount, int rowCount, Db* db)
+        {
+            UNUSED(db);
+            for (int row = 0; row < rowCount && !hasError(context); row++)
+                evaluate(context, code, funcInfo, SqlFunctionValue::toVariantList(args + row * argCount, argCount));
+        }
 };
 
 class DbAwareScriptingPlugin : public ScriptingPlugin
@@ -55,6 +122,13 @@ class DbAwareScriptingPlugin : public ScriptingPlugin
         {
             return evaluate(code, funcInfo, args, nullptr, true, errorMessage);
         }
+
+        void evaluateBatch(Context* context, const QString& code, const FunctionInfo& funcInfo, const SqlFunctionValue* args,
+                           int argCount, int rowCount, Db* db)
+        {
+            for (int row = 0; row < rowCount && !hasError(context); row++)
+                evaluate(context, code, funcInfo, SqlFunctionValue::toVariantList(args + row * argCount, argCount), db, false);
+        }
 };
 
 Q_DECLARE_METATYPE(ScriptingPlugin::Context*)
@@ -2,20 +2,21 @@
 #include "common/unused.h"
 #include "common/global.h"
 #include "scriptingqtdbproxy.h"
+#include "scriptingthreadcontexts.h"
 #include "services/notifymanager.h"
 #include <QJSEngine>
-#include <QMutex>
-#include <QMutexLocker>
+#include <QAtomicInt>
 #include <QDebug>
 
+static QAtomicInt lastCompiledFunctionId;
+
 ScriptingQt::ScriptingQt()
 {
-    mainEngineMutex = new QMutex();
 }
 
 ScriptingQt::~ScriptingQt()
 {
-    safe_delete(mainEngineMutex);
+    safe_delete(threadContexts);
 }
 
 QJSValueList ScriptingQt::toValueList(QJSEngine* engine, const QList<QVariant>& values)
@@ -58,14 +59,22 @@ void ScriptingQt::resetContext(ScriptingPlugin::Context* context)
 
 QVariant ScriptingQt::evaluate(const QString& code, const FunctionInfo& funcInfo, const QList<QVariant>& args, Db* db, bool locking, QString* errorMessage)
 {
-    QMutexLocker locker(mainEngineMutex);
+    ScriptingThreadContexts::Usage usage(threadContexts);
+    ContextQt* ctx = static_cast<ContextQt*>(usage.getContext());
+    if (!ctx)
+    {
+        if (errorMessage)
+            *errorMessage = tr("JavaScript engine is not initialized.");
+
+        return QVariant();
+    }
 
     // Call the function
-    QVariant result = evaluate(mainContext, code, funcInfo, args, db, locking);
+    QVariant result = evaluate(ctx, code, funcInfo, args, db, locking);
 
     // Handle errors
-    if (!mainContext->error.isEmpty())
-        *errorMessage = mainContext->error;
+    if (errorMessage && !ctx->error.isEmpty())
+        *errorMessage = ctx->error;
 
     return result;
 }
@@ -98,11 +107,7 @@ QVariant ScriptingQt::evaluate(ContextQt* ctx, const QString& code, const Functi
     // Handle errors
     ctx->error.clear();
     if (result.isError())
-    {
-        ctx->error = QString("Uncaught exception at line %1: %2").arg(
-                        result.property("lineNumber").toString(),
-                        result.toString());
-    }
+        ctx->error = formatException(result);
 
     ctx->dbProxy->setDb(nullptr);
     ctx->dbProxy->setUseDbLocking(false);
@@ -205,10 +210,51 @@ QString ScriptingQt::getIconPath() const
     return ":/images/plugins/scriptingqt.png";
 }
 
+ScriptingPlugin::CompiledFunction* ScriptingQt::compileFunction(const QString& code, const FunctionInfo& funcInfo)
+{
+    return new CompiledFunctionQt(this, getFunctionCode(code, funcInfo));
+}
+
+void ScriptingQt::evaluateBatch(ScriptingPlugin::Context* context, const QString& code, const FunctionInfo& funcInfo,
+                                const SqlFunctionValue* args, int argCount, int rowCount, Db* db)
+{
+    ContextQt* ctx = getContext(context);
+    if (!ctx)
+        return;
+
+    // Function value and the db are set up once for all rows
+    QJSValue functionValue = getFunctionValue(ctx, code, funcInfo);
+    ctx->dbProxy->setDb(db);
+    ctx->dbProxy->setUseDbLocking(false);
+    ctx->error.clear();
+
+    QJSValueList jsArgs;
+    QJSValue result;
+    const SqlFunctionValue* rowArgs = args;
+    for (int row = 0; row < rowCount; row++, rowArgs += argCount)
+    {
+        jsArgs.clear();
+        for (int i = 0; i < argCount; i++)
+            jsArgs << toScriptValue(ctx->engine, rowArgs[i]);
+
+        result = functionValue.call(jsArgs);
+        if (result.isError())
+        {
+            ctx->error = formatException(result);
+            break;
+        }
+    }
+
+    ctx->dbProxy->setDb(nullptr);
+}
+
 bool ScriptingQt::init()
 {
-    QMutexLocker locker(mainEngineMutex);
-    mainContext = new ContextQt;
+    safe_delete(threadContexts);
+    threadContexts = new ScriptingThreadContexts([]() -> Context*
+    {
+        return new ContextQt;
+    });
     return true;
 }
 
@@ -218,9 +264,7 @@ void ScriptingQt::deinit()
         delete ctx;
 
     contexts.clear();
-
-    QMutexLocker locker(mainEngineMutex);
-    safe_delete(mainContext);
+    safe_delete(threadContexts);
 }
 
 ScriptingQt::ContextQt* ScriptingQt::getContext(ScriptingPlugin::Context* context) const
@@ -234,9 +278,7 @@ ScriptingQt::ContextQt* ScriptingQt::getContext(ScriptingPlugin::Context* contex
 
 QJSValue ScriptingQt::getFunctionValue(ContextQt* ctx, const QString& code, const FunctionInfo& funcInfo)
 {
-    static const QString fnDef = QStringLiteral("(function (%1) {%2\n})");
-
-    QString fullCode = fnDef.arg(funcInfo.getArguments().join(", "), code);
+    QString fullCode = getFunctionCode(code, funcInfo);
     if (ctx->scriptCache.contains(fullCode))
         return *(ctx->scriptCache[fullCode]);
 
@@ -245,6 +287,107 @@ QJSValue ScriptingQt::getFunctionValue(ContextQt* ctx, const QString& code, cons
     return *func;
 }
 
+QString ScriptingQt::getFunctionCode(const QString& code, const FunctionInfo& funcInfo)
+{
+    static const QString fnDef = QStringLiteral("(function (%1) {%2\n})");
+    return fnDef.arg(funcInfo.getArguments().join(", "), code);
+}
+
+QString ScriptingQt::formatException(const QJSValue& result)
+{
+    return QString("Uncaught exception at line %1: %2").arg(result.property("lineNumber").toString(), result.toString());
+}
+
+QJSValue ScriptingQt::toScriptValue(QJSEngine* engine, const SqlFunctionValue& value)
+{
+    switch (value.type)
+    {
+        case SqlFunctionValue::Type::INTEGER:
+            return QJSValue(static_cast<double>(value.integer));
+        case SqlFunctionValue::Type::REAL:
+            return QJSValue(value.real);
+        case SqlFunctionValue::Type::TEXT:
+            return QJSValue(value.text);
+        case SqlFunctionValue::Type::NULL_TYPE:
+        case SqlFunctionValue::Type::BLOB:
+            break;
+    }
+    return engine->toScriptValue(value.toVariant());
+}
+
+void ScriptingQt::fromScriptValue(const QJSValue& jsValue, SqlFunctionValue& value)
+{
+    if (jsValue.isNumber())
+    {
+        // Integral numbers are returned as integers, the same way as QJSValue::toVariant() does it
+        double number = jsValue.toNumber();
+        qint32 integer = jsValue.toInt();
+        if (number == integer)
+            value.setInteger(integer);
+        else
+            value.setReal(number);
+    }
+    else if (jsValue.isString())
+        value.setText(jsValue.toString());
+    else if (jsValue.isBool())
+        value.setInteger(jsValue.toBool() ? 1 : 0);
+    else if (jsValue.isNull() || jsValue.isUndefined())
+        value.setNull();
+    else
+        value = SqlFunctionValue::fromVariant(convertVariant(jsValue.toVariant()));
+}
+
+ScriptingQt::CompiledFunctionQt::CompiledFunctionQt(ScriptingQt* plugin, const QString& fullCode) :
+    plugin(plugin), fullCode(fullCode), id(lastCompiledFunctionId.fetchAndAddRelaxed(1) + 1)
+{
+}
+
+bool ScriptingQt::CompiledFunctionQt::call(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, QString& errorMessage)
+{
+    ScriptingThreadContexts::Usage usage(plugin->threadContexts);
+    ContextQt* ctx = static_cast<ContextQt*>(usage.getContext());
+    if (!ctx)
+    {
+        errorMessage = QObject::tr("JavaScript engine is not initialized.");
+        return false;
+    }
+
+    // Copied, because nested calls (through the db object) may modify the hash
+    QJSValue function;
+    auto it = ctx->compiledFunctions.constFind(id);
+    if (it == ctx->compiledFunctions.constEnd())
+    {
+        function = ctx->engine->evaluate(fullCode);
+        ctx->compiledFunctions[id] = function;
+    }
+    else
+    {
+        function = it.value();
+    }
+
+    QJSValueList jsArgs;
+    jsArgs.reserve(argCount);
+    for (int i = 0; i < argCount; i++)
+        jsArgs << toScriptValue(ctx->engine, args[i]);
+
+    // Database is already locked by the query calling this function
+    ctx->dbProxy->setDb(db);
+    ctx->dbProxy->setUseDbLocking(false);
+
+    QJSValue jsResult = function.call(jsArgs);
+
+    ctx->dbProxy->setDb(nullptr);
+
+    if (jsResult.isError())
+    {
+        errorMessage = formatException(jsResult);
+        return false;
+    }
+
+    fromScriptValue(jsResult, result);
+    return true;
+}
+
 ScriptingQt::ContextQt::ContextQt()
 {
     engine = new QJSEngine();
@@ -8,8 +8,8 @@
 #include <QCache>
 #include <QJSValue>
 
-class QMutex;
 class ScriptingQtDbProxy;
+class ScriptingThreadContexts;
 class ScriptingQtConsole;
 
 class ScriptingQt : public BuiltInPlugin, public DbAwareScriptingPlugin
@@ -39,12 +39,35 @@ class ScriptingQt : public BuiltInPlugin, public DbAwareScriptingPlugin
         bool hasError(Context* context) const;
         QString getErrorMessage(Context* context) const;
         QString getIconPath() const;
+        CompiledFunction* compileFunction(const QString& code, const FunctionInfo& funcInfo);
+        void evaluateBatch(Context* context, const QString& code, const FunctionInfo& funcInfo, const SqlFunctionValue* args,
+                           int argCount, int rowCount, Db* db);
         bool init();
         void deinit();
 
     private:
         using DbAwareScriptingPlugin::evaluate;
 
+        /**
+         * @brief Function evaluated once in the engine of the calling thread and then called directly.
+         *
+         * Arguments of basic types are converted straight into QJSValue and the result is read
+         * from QJSValue, without QVariant. Each thread context keeps its own function value,
+         * stored under the unique id of the compiled function.
+         */
+        class CompiledFunctionQt : public CompiledFunction
+        {
+            public:
+                CompiledFunctionQt(ScriptingQt* plugin, const QString& fullCode);
+
+                bool call(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, QString& errorMessage);
+
+            private:
+                ScriptingQt* plugin = nullptr;
+                QString fullCode;
+                int id = 0;
+        };
+
         class ContextQt : public ScriptingPlugin::Context
         {
             public:
@@ -57,17 +80,31 @@ class ScriptingQt : public BuiltInPlugin, public DbAwareScriptingPlugin
                 ScriptingQtDbProxy* dbProxy = nullptr;
                 ScriptingQtConsole* console = nullptr;
                 QJSValue dbProxyScriptValue;
+
+                /**
+                 * @brief Function values of compiled functions called in this context, by compiled function id.
+                 */
+                QHash<int, QJSValue> compiledFunctions;
         };
 
         ContextQt* getContext(ScriptingPlugin::Context* context) const;
         QJSValue getFunctionValue(ContextQt* ctx, const QString& code, const FunctionInfo& funcInfo);
         QVariant evaluate(ContextQt* ctx, const QString& code, const FunctionInfo& funcInfo, const QList<QVariant>& args, Db* db, bool locking);
 
+        static QString getFunctionCode(const QString& code, const FunctionInfo& funcInfo);
+        static QString formatException(const QJSValue& result);
+        static QJSValue toScriptValue(QJSEngine* engine, const SqlFunctionValue& value);
+        static void fromScriptValue(const QJSValue& jsValue, SqlFunctionValue& value);
+
         static const constexpr int cacheSize = 5;
 
-        ContextQt* mainContext = nullptr;
+        /**
+         * @brief Contexts used by evaluations without explicit context, one per thread.
+         *
+         * It's created by init() and deleted by deinit().
+         */
+        ScriptingThreadContexts* threadContexts = nullptr;
         QList<Context*> contexts;
-        QMutex* mainEngineMutex = nullptr;
 };
 
 class ScriptingQtConsole : public QObject
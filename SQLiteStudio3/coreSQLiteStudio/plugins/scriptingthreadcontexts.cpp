@@ -0,0 +1,162 @@
+#include "scriptingthreadcontexts.h"
+#include <QThread>
+#include <QMutexLocker>
+
+ScriptingThreadContexts::Usage::Usage(ScriptingThreadContexts* contexts) :
+    contexts(contexts)
+{
+    if (contexts)
+        context = contexts->acquire();
+}
+
+ScriptingThreadContexts::Usage::~Usage()
+{
+    if (context)
+        contexts->release();
+}
+
+ScriptingPlugin::Context* ScriptingThreadContexts::Usage::getContext() const
+{
+    return context;
+}
+
+ScriptingThreadContexts::ScriptingThreadContexts(Factory factory) :
+    factory(factory)
+{
+}
+
+ScriptingThreadContexts::~ScriptingThreadContexts()
+{
+    QList<Entry> toDelete;
+    {
+        QMutexLocker locker(&mutex);
+        closing = true;
+
+        // Evaluations running in other threads have to finish, before their contexts can be deleted
+        bool inUse = true;
+        while (inUse)
+        {
+            inUse = false;
+            for (const Entry& entry : entries)
+                inUse |= (entry.usages > 0);
+
+            if (inUse)
+                released.wait(&mutex);
+        }
+
+        toDelete = entries.values();
+        entries.clear();
+    }
+
+    for (const Entry& entry : toDelete)
+    {
+        QObject::disconnect(entry.connection);
+        delete entry.context;
+    }
+}
+
+void ScriptingThreadContexts::clear()
+{
+    QThread* thread = QThread::currentThread();
+    QList<ScriptingPlugin::Context*> toDelete;
+    {
+        QMutexLocker locker(&mutex);
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it.key() == thread && it->usages == 0)
+            {
+                QObject::disconnect(it->connection);
+                toDelete << it->context;
+                it = entries.erase(it);
+                continue;
+            }
+
+            it->stale = true;
+            ++it;
+        }
+    }
+
+    qDeleteAll(toDelete);
+}
+
+ScriptingPlugin::Context* ScriptingThreadContexts::acquire()
+{
+    QThread* thread = QThread::currentThread();
+    ScriptingPlugin::Context* staleContext = nullptr;
+    {
+        QMutexLocker locker(&mutex);
+        if (closing)
+            return nullptr;
+
+        auto it = entries.find(thread);
+        if (it != entries.end())
+        {
+            // Nested usage keeps the context of the outer one, even if it got stale in the meantime
+            if (!it->stale || it->usages > 0)
+            {
+                it->usages++;
+                return it->context;
+            }
+
+            QObject::disconnect(it->connection);
+            staleContext = it->context;
+            entries.erase(it);
+        }
+    }
+
+    // Only this thread can delete or create context for itself, so the engine is handled without holding the lock
+    delete staleContext;
+
+    Entry entry;
+    entry.context = factory();
+    entry.usages = 1;
+    entry.connection = QObject::connect(thread, &QThread::finished, [this, thread]()
+    {
+        threadFinished(thread);
+    });
+
+    QMutexLocker locker(&mutex);
+    entries[thread] = entry;
+    return entry.context;
+}
+
+void ScriptingThreadContexts::release()
+{
+    QThread* thread = QThread::currentThread();
+    ScriptingPlugin::Context* staleContext = nullptr;
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(thread);
+        if (it == entries.end())
+            return;
+
+        if (--it->usages > 0)
+            return;
+
+        if (it->stale)
+        {
+            QObject::disconnect(it->connection);
+            staleContext = it->context;
+            entries.erase(it);
+        }
+        released.wakeAll();
+    }
+
+    delete staleContext;
+}
+
+void ScriptingThreadContexts::threadFinished(QThread* thread)
+{
+    Entry entry;
+    {
+        QMutexLocker locker(&mutex);
+        if (!entries.contains(thread))
+            return;
+
+        entry = entries.take(thread);
+    }
+
+    // Called from the finishing thread, so the context is deleted in the thread where it was created
+    QObject::disconnect(entry.connection);
+    delete entry.context;
+}
@@ -0,0 +1,92 @@
+#ifndef SCRIPTINGTHREADCONTEXTS_H
+#define SCRIPTINGTHREADCONTEXTS_H
+
+#include "coreSQLiteStudio_global.h"
+#include "plugins/scriptingplugin.h"
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <functional>
+
+class QThread;
+
+/**
+ * @brief Scripting contexts dedicated to threads.
+ *
+ * It's a helper for scripting plugins that evaluate in per-thread contexts. Context of a thread is created
+ * by the factory with the first Usage in that thread, so the script engine is created in the thread that is going
+ * to use it. Contexts are deleted by the thread that owns them: when the thread finishes, or after clear(),
+ * once the thread doesn't use its context anymore.
+ *
+ * The only exception is deleting the helper itself (when the plugin is being unloaded), because the plugin's code
+ * is not available afterwards. It waits until no evaluation is running and then deletes contexts of all threads,
+ * so contexts must tolerate being deleted by another thread while they are idle.
+ */
+class API_EXPORT ScriptingThreadContexts
+{
+    public:
+        typedef std::function<ScriptingPlugin::Context*()> Factory;
+
+        /**
+         * @brief Context of the calling thread, reserved for the time of an evaluation.
+         *
+         * Context is not deleted as long as there is any usage of it, not even by clear() or when the helper
+         * is being deleted. Usages can be nested, when an evaluation triggers another evaluation in the same thread.
+         */
+        class API_EXPORT Usage
+        {
+            public:
+                /**
+                 * @param contexts Contexts to use. Can be null, then there is no context.
+                 */
+                explicit Usage(ScriptingThreadContexts* contexts);
+                ~Usage();
+
+                /**
+                 * @brief Provides context of the calling thread.
+                 * @return Context, or null if there are no contexts, or they are being deleted.
+                 */
+                ScriptingPlugin::Context* getContext() const;
+
+            private:
+                Usage(const Usage&) = delete;
+                Usage& operator=(const Usage&) = delete;
+
+                ScriptingThreadContexts* contexts = nullptr;
+                ScriptingPlugin::Context* context = nullptr;
+        };
+
+        explicit ScriptingThreadContexts(Factory factory);
+        ~ScriptingThreadContexts();
+
+        /**
+         * @brief Discards contexts of all threads.
+         *
+         * Context of the calling thread is deleted immediately (unless it's being used). Contexts of other threads
+         * are only marked as stale and each of them is deleted by its own thread, when it's not used anymore.
+         * Threads get new contexts with their next Usage.
+         */
+        void clear();
+
+    private:
+        struct Entry
+        {
+            ScriptingPlugin::Context* context = nullptr;
+            QMetaObject::Connection connection;
+            int usages = 0;
+            bool stale = false;
+        };
+
+        ScriptingPlugin::Context* acquire();
+        void release();
+        void threadFinished(QThread* thread);
+
+        Factory factory;
+        QHash<QThread*, Entry> entries;
+        QMutex mutex;
+        QWaitCondition released;
+        bool closing = false;
+};
+
+#endif // SCRIPTINGTHREADCONTEXTS_H
@@ -4,9 +4,13 @@
 #include "db/sqlquery.h"
 #include "plugins/populateplugin.h"
 #include "services/notifymanager.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtConcurrent/QtConcurrentRun>
 
-PopulateWorker::PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows, QObject* parent) :
-    QObject(parent), db(db), table(table), columns(columns), engines(engines), rows(rows)
+PopulateWorker::PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows,
+                               quint32 seed, QObject* parent) :
+    QObject(parent), db(db), table(table), columns(columns), engines(engines), rows(rows), seed(seed)
 {
 }
 
@@ -16,8 +20,6 @@ PopulateWorker::~PopulateWorker()
 
 void PopulateWorker::run()
 {
-    static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3);");
-
     if (!db->begin())
     {
         notifyError(tr("Could not start transaction in order to perform table populating. Error details: %1").arg(db->getErrorText()));
@@ -25,54 +27,80 @@ void PopulateWorker::run()
         return;
     }
 
-    QString wrappedTable = wrapObjIfNeeded(table);
+    // Each column gets its own seed, derived from its name, so the data doesn't depend
+    // on the order of columns, nor on the order in which threads generate them.
+    quint32 baseSeed = seed ? seed : QRandomGenerator::global()->generate();
+    for (int col = 0; col < engines.size(); col++)
+        engines[col]->setRandomSeed(qHash(columns[col], baseSeed));
 
-    QStringList cols;
-    QStringList argList;
-    for (const QString& column : columns)
-    {
-        cols << wrapObjIfNeeded(column);
-        argList << "?";
-    }
+    if (rows > 0 && !beforePopulating())
+        return;
+
+    // Multiple rows are inserted with a single statement. Batch of generated rows is a multiple
+    // of the rows per statement, so only the very last batch may need a shorter statement.
+    int rowsPerInsert = qBound(1, MAX_INSERT_ARGS / qMax(columns.size(), 1), BATCH_SIZE);
+    int batchSize = rowsPerInsert * qMax(BATCH_SIZE / rowsPerInsert, 1);
 
-    QString finalSql = insertSql.arg(wrappedTable, cols.join(", "), argList.join(", "));
-    SqlQueryPtr query = db->prepare(finalSql);
+    SqlQueryPtr query = db->prepare(getInsertSql(rowsPerInsert));
+    SqlQueryPtr lastQuery;
+    int lastQueryRows = 0;
 
+    QVector<QList<QVariant>> columnValues(engines.size());
     QList<QVariant> args;
-    bool nextValueError = false;
-    for (qint64 i = 0; i < rows; i++)
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+    for (qint64 done = 0; done < rows;)
     {
-        if (i == 0 && !beforePopulating())
-            return;
-
         if (isInterrupted())
         {
-            db->rollback();
-            emit finished(false);
+            fail();
             return;
         }
 
-        args.clear();
-        for (PopulateEngine* engine : engines)
-            args << engine->nextValue(nextValueError);
-
-        if (nextValueError)
+        int batchRows = static_cast<int>(qMin<qint64>(batchSize, rows - done));
+        if (!generateValues(columnValues, batchRows))
         {
-            db->rollback();
-            emit finished(false);
+            fail();
             return;
         }
 
-        query->setArgs(args);
-        if (!query->execute())
+        for (int row = 0; row < batchRows; row += rowsPerInsert)
         {
-            notifyError(tr("Error while populating table: %1").arg(query->getErrorText()));
-            db->rollback();
-            emit finished(false);
-            return;
+            int insertRows = qMin(rowsPerInsert, batchRows - row);
+            args.clear();
+            for (int r = row; r < row + insertRows; r++)
+            {
+                for (const QList<QVariant>& values : columnValues)
+                    args << values[r];
+            }
+
+            SqlQueryPtr insertQuery = query;
+            if (insertRows != rowsPerInsert)
+            {
+                if (lastQueryRows != insertRows)
+                {
+                    lastQuery = db->prepare(getInsertSql(insertRows));
+                    lastQueryRows = insertRows;
+                }
+                insertQuery = lastQuery;
+            }
+
+            insertQuery->setArgs(args);
+            if (!insertQuery->execute())
+            {
+                notifyError(tr("Error while populating table: %1").arg(insertQuery->getErrorText()));
+                fail();
+                return;
+            }
         }
 
-        emit finishedStep(i + 1);
+        // Progress goes to the UI thread through the event queue, so it's reported at a limited rate
+        done += batchRows;
+        if (done == rows || progressTimer.elapsed() >= PROGRESS_INTERVAL)
+        {
+            emit finishedStep(static_cast<int>(done));
+            progressTimer.restart();
+        }
     }
 
     if (!db->commit())
@@ -113,6 +141,76 @@ void PopulateWorker::afterPopulating()
         engine->afterPopulating();
 }
 
+QString PopulateWorker::getInsertSql(int rowCount) const
+{
+    static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES %3;");
+
+    QStringList cols;
+    QStringList argList;
+    for (const QString& column : columns)
+    {
+        cols << wrapObjIfNeeded(column);
+        argList << "?";
+    }
+
+    QString rowArgs = "(" + argList.join(", ") + ")";
+    QStringList rowList;
+    for (int i = 0; i < rowCount; i++)
+        rowList << rowArgs;
+
+    return insertSql.arg(wrapObjIfNeeded(table), cols.join(", "), rowList.join(", "));
+}
+
+bool PopulateWorker::generateValues(QVector<QList<QVariant>>& columnValues, int rowCount)
+{
+    // Columns that can be generated in other threads go to the pool, unless there is nothing to run in parallel with
+    QList<QFuture<bool>> futures;
+    QList<int> localColumns;
+    for (int col = 0; col < engines.size(); col++)
+    {
+        PopulateEngine* engine = engines[col];
+        if (engines.size() == 1 || !engine->canGenerateConcurrently())
+        {
+            localColumns << col;
+            continue;
+        }
+
+        QList<QVariant>* values = &columnValues[col];
+        futures << QtConcurrent::run(&threadPool, [engine, values, rowCount]() -> bool
+        {
+            bool nextValueError = false;
+            engine->nextValues(*values, rowCount, nextValueError);
+            return !nextValueError;
+        });
+    }
+
+    bool result = true;
+    for (int col : localColumns)
+    {
+        bool nextValueError = false;
+        engines[col]->nextValues(columnValues[col], rowCount, nextValueError);
+        if (nextValueError)
+        {
+            result = false;
+            break;
+        }
+    }
+
+    // All threads have to finish before the values (or engines) can be touched again
+    for (QFuture<bool>& future : futures)
+    {
+        if (!future.result())
+            result = false;
+    }
+    return result;
+}
+
+void PopulateWorker::fail()
+{
+    db->rollback();
+    emit finished(false);
+}
+
 void PopulateWorker::interrupt()
 {
     QMutexLocker locker(&interruptMutex);
@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QRunnable>
 #include <QStringList>
+#include <QThreadPool>
+#include <QVector>
 
 class Db;
 class PopulateEngine;
@@ -13,22 +15,53 @@ class PopulateWorker : public QObject, public QRunnable
 {
         Q_OBJECT
     public:
-        explicit PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows, QObject *parent = 0);
+        explicit PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows,
+                                quint32 seed = 0, QObject *parent = 0);
         ~PopulateWorker();
 
         void run();
 
     private:
+        /**
+         * @brief Approximate number of rows generated and inserted at once.
+         */
+        static const int BATCH_SIZE = 1000;
+
+        /**
+         * @brief Maximum number of bound arguments in a single INSERT statement.
+         *
+         * It's the lowest limit of bound parameters among supported SQLite versions.
+         */
+        static const int MAX_INSERT_ARGS = 999;
+
+        /**
+         * @brief Minimum time between progress reports, in milliseconds.
+         */
+        static const int PROGRESS_INTERVAL = 100;
+
         bool isInterrupted();
         bool beforePopulating();
         void afterPopulating();
+        QString getInsertSql(int rowCount) const;
+        bool generateValues(QVector<QList<QVariant>>& columnValues, int rowCount);
+        void fail();
 
         Db* db = nullptr;
         QString table;
         QStringList columns;
         QList<PopulateEngine*> engines;
         qint64 rows;
+
+        /**
+         * @brief Seed for random values, or 0 to use a random seed.
+         */
+        quint32 seed = 0;
         bool interrupted = false;
+
+        /**
+         * @brief Threads generating values of columns which support it.
+         */
+        QThreadPool threadPool;
         QMutex interruptMutex;
 
     public slots:
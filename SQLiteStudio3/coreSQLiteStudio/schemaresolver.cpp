@@ -16,6 +16,8 @@ const char* sqliteTempMasterDdl =
     "CREATE TABLE sqlite_temp_master (type text, name text, tbl_name text, rootpage integer, sql text)";
 
 ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
+ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::versionedCache(10000, 600000);
+QMutex SchemaResolver::cacheMutex;
 ExpiringCache<QString, QString> SchemaResolver::autoIndexDdlCache;
 
 SchemaResolver::SchemaResolver(Db *db)
@@ -327,8 +329,9 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
     QString typeStr = objectTypeToString(type);
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DDL, db, dbName, lowerName, typeStr);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toString();
+    QVariant cachedValue;
+    if (useCache && getFromCache(key, database, cachedValue))
+        return cachedValue.toString();
 
     // Get the DDL
     QString resStr = getObjectDdlWithSimpleName(dbName, lowerName, targetTable, type);
@@ -340,7 +343,7 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
         resStr += ";";
 
     if (useCache)
-        cache.insert(key, new QVariant(resStr));
+        putToCache(key, resStr);
 
     // Return the DDL
     return resStr;
@@ -398,7 +401,7 @@ QString SchemaResolver::getObjectDdlWithSimpleName(const QString &dbName, const
     {
         queryResults = db->exec(QString(
                     "SELECT sql FROM %1.%4 WHERE lower(name) = '%2' AND type = '%3';").arg(dbName, escapeString(lowerName), typeStr, targetTable),
-                    dbFlags
+                    getSchemaReadFlags(dbName)
                 );
 
     }
@@ -406,7 +409,7 @@ QString SchemaResolver::getObjectDdlWithSimpleName(const QString &dbName, const
     {
         queryResults = db->exec(QString(
                     "SELECT sql FROM %1.%3 WHERE lower(name) = '%2';").arg(dbName, escapeString(lowerName), targetTable),
-                    dbFlags
+                    getSchemaReadFlags(dbName)
                 );
     }
 
@@ -611,9 +614,12 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
     // First, let's try to use cached value
     static_qstring(cacheKeyTpl, "%1.%2");
     QString cacheKey = cacheKeyTpl.arg(database, index).toLower();
-    QString* cachedDdlPtr = autoIndexDdlCache[cacheKey];
-    if (cachedDdlPtr)
-        return *(cachedDdlPtr);
+    {
+        QMutexLocker locker(&cacheMutex);
+        QString* cachedDdlPtr = autoIndexDdlCache[cacheKey];
+        if (cachedDdlPtr)
+            return *(cachedDdlPtr);
+    }
 
     // Not in cache. We need to find out indexed table.
     // Let's try to find it in sqlite_master.
@@ -677,6 +683,7 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
                 columns.join(", ")
                 );
 
+    QMutexLocker locker(&cacheMutex);
     autoIndexDdlCache.insert(cacheKey, new QString(ddl));
     return ddl;
 }
@@ -715,13 +722,15 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database, type);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    key.ignoreSystemObjects = ignoreSystemObjects;
+    QVariant cachedValue;
+    if (useCache && getFromCache(key, database, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
 
-    SqlQueryPtr results = db->exec(QString("SELECT name FROM %1.sqlite_master WHERE type = ?;").arg(dbName), {type}, dbFlags);
+    SqlQueryPtr results = db->exec(QString("SELECT name FROM %1.sqlite_master WHERE type = ?;").arg(dbName), {type}, getSchemaReadFlags(dbName));
 
     QString value;
     for (SqlResultsRowPtr row : results->getAll())
@@ -732,7 +741,7 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        putToCache(key, resList);
 
     return resList;
 }
@@ -746,13 +755,15 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    key.ignoreSystemObjects = ignoreSystemObjects;
+    QVariant cachedValue;
+    if (useCache && getFromCache(key, database, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
 
-    SqlQueryPtr results = db->exec(QString("SELECT name, type FROM %1.sqlite_master;").arg(dbName), dbFlags);
+    SqlQueryPtr results = db->exec(QString("SELECT name, type FROM %1.sqlite_master;").arg(dbName), getSchemaReadFlags(dbName));
 
     QString value;
     QString type;
@@ -765,7 +776,7 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        putToCache(key, resList);
 
     return resList;
 }
@@ -928,13 +939,15 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
     QList<QVariant> rows;
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DETAILS, db, database);
-    if (useCache && cache.contains(key))
+    QVariant cachedValue;
+    if (useCache && getFromCache(key, database, cachedValue))
     {
-        rows = cache.object(key, true)->toList();
+        rows = cachedValue.toList();
     }
     else
     {
-        SqlQueryPtr results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master").arg(getPrefixDb(database)), dbFlags);
+        QString dbName = getPrefixDb(database);
+        SqlQueryPtr results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master").arg(dbName), getSchemaReadFlags(dbName));
         if (results->isError())
         {
             qCritical() << "Error while getting all object details in SchemaResolver:" << results->getErrorCode();
@@ -945,7 +958,7 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
             rows << row->valueMap();
 
         if (useCache)
-            cache.insert(key, new QVariant(rows));
+            putToCache(key, rows);
     }
 
     QHash<QString, QVariant> row;
@@ -1089,11 +1102,105 @@ void SchemaResolver::staticInit()
     cache.setExpireTime(3000);
 }
 
+void SchemaResolver::clearCache(const QString& dbName)
+{
+    QMutexLocker locker(&cacheMutex);
+    for (ExpiringCache<ObjectCacheKey,QVariant>* targetCache : {&cache, &versionedCache})
+    {
+        for (const ObjectCacheKey& key : targetCache->keys())
+        {
+            if (key.dbName.compare(dbName, Qt::CaseInsensitive) == 0)
+                targetCache->remove(key);
+        }
+    }
+}
+
 bool SchemaResolver::usesCache()
+{
+    if (usesTimeLimitedCache())
+        return true;
+
+    QHash<QString,QVariant>& options = db->getConnectionOptions();
+    if (options.contains(USE_SCHEMA_VERSION_CACHING) && !options[USE_SCHEMA_VERSION_CACHING].toBool())
+        return false;
+
+    return !db->isTransactionActive();
+}
+
+bool SchemaResolver::usesTimeLimitedCache()
 {
     return db->getConnectionOptions().contains(USE_SCHEMA_CACHING) && db->getConnectionOptions()[USE_SCHEMA_CACHING].toBool();
 }
 
+qint64 SchemaResolver::getSchemaVersion(const QString& database)
+{
+    static_qstring(versionQuery, "PRAGMA %1.schema_version;");
+
+    SqlQueryPtr results = db->exec(versionQuery.arg(getPrefixDb(database)), dbFlags);
+    if (results->isError())
+        return -1;
+
+    bool ok;
+    qint64 version = results->getSingleCell().toLongLong(&ok);
+    return ok ? version : -1;
+}
+
+QString SchemaResolver::getSchemaFile(const QString& database)
+{
+    static_qstring(listQuery, "PRAGMA database_list;");
+
+    SqlQueryPtr results = db->exec(listQuery, dbFlags);
+    if (results->isError())
+        return QString();
+
+    QString name = database.isEmpty() ? QStringLiteral("main") : database;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        if (row->value("name").toString().compare(name, Qt::CaseInsensitive) == 0)
+            return row->value("file").toString();
+    }
+    return QString();
+}
+
+bool SchemaResolver::getFromCache(ObjectCacheKey& key, const QString& database, QVariant& value)
+{
+    if (!usesTimeLimitedCache())
+    {
+        // Entries cached for older schema version (or another file attached under the same name) simply won't match the key anymore.
+        key.schemaVersion = getSchemaVersion(database);
+        if (key.schemaVersion < 0)
+            return false;
+
+        key.schemaFile = getSchemaFile(database);
+        if (key.schemaFile.isEmpty())
+        {
+            key.schemaVersion = -1; // nothing to identify the schema with, so it's not cached at all
+            return false;
+        }
+    }
+
+    QMutexLocker locker(&cacheMutex);
+    ExpiringCache<ObjectCacheKey,QVariant>& targetCache = (key.schemaVersion < 0) ? cache : versionedCache;
+    QVariant* cachedValue = targetCache.object(key);
+    if (!cachedValue)
+        return false;
+
+    value = *cachedValue;
+    return true;
+}
+
+void SchemaResolver::putToCache(const ObjectCacheKey& key, const QVariant& value)
+{
+    if (key.schemaVersion < 0 && !usesTimeLimitedCache())
+        return; // schema version was not available
+
+    QMutexLocker locker(&cacheMutex);
+    ExpiringCache<ObjectCacheKey,QVariant>& targetCache = (key.schemaVersion < 0) ? cache : versionedCache;
+    targetCache.insert(key, new QVariant(value));
+}
+
 QList<SqliteCreateViewPtr> SchemaResolver::getParsedViewsForTable(const QString& database, const QString& table)
 {
     QList<SqliteCreateViewPtr> createViewList;
@@ -1244,6 +1351,16 @@ bool SchemaResolver::getNoDbLocking() const
     return dbFlags.testFlag(Db::Flag::NO_LOCK);
 }
 
+Db::Flags SchemaResolver::getSchemaReadFlags(const QString& database) const
+{
+    // Read connections see only the main database. Queries executed without lock are part
+    // of another operation on the connection (which may have changed the schema), so they stay here too.
+    if (dbFlags.testFlag(Db::Flag::NO_LOCK) || database.compare("main", Qt::CaseInsensitive) != 0)
+        return dbFlags;
+
+    return dbFlags|Db::Flag::READ_POOL;
+}
+
 void SchemaResolver::setNoDbLocking(bool value)
 {
     if (value)
@@ -1254,16 +1371,18 @@ void SchemaResolver::setNoDbLocking(bool value)
 
 
 SchemaResolver::ObjectCacheKey::ObjectCacheKey(Type type, Db* db, const QString& value1, const QString& value2, const QString& value3) :
-    type(type), db(db), value1(value1), value2(value2), value3(value3)
+    type(type), dbName(db->getName()), value1(value1), value2(value2), value3(value3)
 {
 }
 
 int qHash(const SchemaResolver::ObjectCacheKey& key)
 {
-    return qHash(key.type) ^ qHash(key.db) ^ qHash(key.value1) ^ qHash(key.value2) ^ qHash(key.value3);
+    return qHash(key.type) ^ qHash(key.dbName) ^ qHash(key.value1) ^ qHash(key.value2) ^ qHash(key.value3) ^ qHash(key.schemaVersion) ^
+            qHash(key.schemaFile) ^ qHash(key.ignoreSystemObjects);
 }
 
 int operator==(const SchemaResolver::ObjectCacheKey& k1, const SchemaResolver::ObjectCacheKey& k2)
 {
-    return (k1.type == k2.type && k1.db == k2.db && k1.value1 == k2.value1 && k1.value2 == k2.value2 && k1.value3 == k2.value3);
+    return (k1.type == k2.type && k1.dbName == k2.dbName && k1.value1 == k2.value1 && k1.value2 == k2.value2 && k1.value3 == k2.value3 &&
+            k1.schemaVersion == k2.schemaVersion && k1.schemaFile == k2.schemaFile && k1.ignoreSystemObjects == k2.ignoreSystemObjects);
 }
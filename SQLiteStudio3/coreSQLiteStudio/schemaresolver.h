@@ -16,11 +16,10 @@
 #include "common/strhash.h"
 #include "common/expiringcache.h"
 #include <QStringList>
+#include <QMutex>
 
 class SqliteCreateTable;
 
-// TODO add cache
-
 class API_EXPORT SchemaResolver
 {
     public:
@@ -51,10 +50,37 @@ class API_EXPORT SchemaResolver
             ObjectCacheKey(Type type, Db* db, const QString& value1 = QString(), const QString& value2 = QString(), const QString& value3 = QString());
 
             Type type;
-            Db* db;
+
+            /**
+             * @brief Name of the database (as registered in DbManager).
+             *
+             * Name is used instead of the Db pointer, because the address of a deleted Db can be reused
+             * by another database, which would then be served entries of the deleted one.
+             */
+            QString dbName;
             QString value1;
             QString value2;
             QString value3;
+
+            /**
+             * @brief Schema version of the database at the time of caching.
+             *
+             * It's -1 for time-limited caching (see USE_SCHEMA_CACHING).
+             */
+            qint64 schemaVersion = -1;
+
+            /**
+             * @brief File of the schema (main or attached database) at the time of caching.
+             *
+             * Aliases of attached databases are reused after detaching, so the schema version alone
+             * doesn't tell if it's still the same database. It's empty for time-limited caching.
+             */
+            QString schemaFile;
+
+            /**
+             * @brief Whether system objects were filtered out of cached object names.
+             */
+            bool ignoreSystemObjects = false;
         };
 
         explicit SchemaResolver(Db* db);
@@ -191,10 +217,44 @@ class API_EXPORT SchemaResolver
         static ObjectType stringToObjectType(const QString& type);
         static void staticInit();
 
+        /**
+         * @brief Removes all cached schema information of the database.
+         * @param dbName Name of the database (see ObjectCacheKey::dbName).
+         *
+         * It's called by DbManager when the database is removed, updated or disconnected,
+         * so a database registered later under the same name (or reopened in-memory database,
+         * which starts with the same schema version) doesn't get stale entries.
+         */
+        static void clearCache(const QString& dbName);
+
+        /**
+         * @brief Connection option enabling time-limited caching of schema information.
+         *
+         * Cached information expires after 3 seconds. It's meant for databases where the schema version cannot
+         * be queried cheaply (like remote databases). For other databases schema version caching is used
+         * (see USE_SCHEMA_VERSION_CACHING).
+         */
         static_char* USE_SCHEMA_CACHING = "useSchemaCaching";
 
+        /**
+         * @brief Connection option controlling caching of schema information by schema version.
+         *
+         * Unless it's set to false, the schema information is cached per database (including attached ones)
+         * together with its <tt>PRAGMA schema_version</tt> and file, so it stays valid until the schema actually changes.
+         * In-memory and temporary schemas have no file to tell them apart, so they are not cached this way.
+         * Caching is not used while a transaction is open on the connection, because rolled back schema changes
+         * make the schema version go back and then be reused for a different schema.
+         */
+        static_char* USE_SCHEMA_VERSION_CACHING = "useSchemaVersionCaching";
+
     private:
         bool usesCache();
+        bool usesTimeLimitedCache();
+        qint64 getSchemaVersion(const QString& database);
+        QString getSchemaFile(const QString& database);
+        Db::Flags getSchemaReadFlags(const QString& database) const;
+        bool getFromCache(ObjectCacheKey& key, const QString& database, QVariant& value);
+        void putToCache(const ObjectCacheKey& key, const QVariant& value);
         SqliteQueryPtr getParsedDdl(const QString& ddl);
         SqliteCreateTablePtr virtualTableAsRegularTable(const QString& database, const QString& table);
         StrHash< QStringList> getGroupedObjects(const QString &database, const QStringList& inputList, SqliteQueryType type);
@@ -214,6 +274,8 @@ class API_EXPORT SchemaResolver
         Db::Flags dbFlags;
 
         static ExpiringCache<ObjectCacheKey,QVariant> cache;
+        static ExpiringCache<ObjectCacheKey,QVariant> versionedCache;
+        static QMutex cacheMutex;
         static ExpiringCache<QString, QString> autoIndexDdlCache;
 };
 
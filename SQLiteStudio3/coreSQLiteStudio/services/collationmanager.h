@@ -25,12 +25,60 @@ class API_EXPORT CollationManager : public QObject
 
         typedef QSharedPointer<Collation> CollationPtr;
 
+        /**
+         * @brief Collation resolved for repeated comparisons.
+         *
+         * It's obtained once, when the collation is registered in the database, so the collation
+         * doesn't have to be looked up by its name (and its scripting plugin doesn't have to be looked up)
+         * for every comparison. Values are passed as they come from SQLite, in UTF-8,
+         * so comparators that can work on raw bytes don't need to decode them at all.
+         *
+         * Comparators of user defined collations are shared by all databases, so compare() can be called
+         * by several threads at once and implementations have to be thread-safe. Built-in comparators
+         * that are not (like ones using QCollator) are created separately for each database.
+         */
+        class API_EXPORT Comparator
+        {
+            public:
+                virtual ~Comparator() {}
+
+                /**
+                 * @brief Compares two values.
+                 * @param value1 First value, UTF-8 encoded, not null-terminated.
+                 * @param length1 Number of bytes in value1.
+                 * @param value2 Second value, UTF-8 encoded, not null-terminated.
+                 * @param length2 Number of bytes in value2.
+                 * @return Negative number, 0 or positive number, as SQLite's collation specification demands it.
+                 */
+                virtual int compare(const char* value1, int length1, const char* value2, int length2) = 0;
+        };
+
+        typedef QSharedPointer<Comparator> ComparatorPtr;
+
         virtual void setCollations(const QList<CollationPtr>& newCollations) = 0;
         virtual QList<CollationPtr> getAllCollations() const = 0;
         virtual QList<CollationPtr> getCollationsForDatabase(const QString& dbName) const = 0;
         virtual int evaluate(const QString& name, const QString& value1, const QString& value2) = 0;
         virtual int evaluateDefault(const QString& value1, const QString& value2) = 0;
 
+        /**
+         * @brief Resolves collation for registration in the database.
+         * @param name Name of the collation.
+         * @return Comparator implementing the collation, or null if there is no such collation.
+         *
+         * User defined collations take precedence over the built-in ones (see getNativeCollationNames()).
+         */
+        virtual ComparatorPtr resolveCollation(const QString& name) = 0;
+
+        /**
+         * @brief Provides names of collations implemented natively.
+         * @return Names of built-in collations.
+         *
+         * Besides these, there is a LOCALE_ collation for any locale name accepted by QLocale
+         * (like LOCALE_de_DE or LOCALE_pl).
+         */
+        virtual QStringList getNativeCollationNames() const = 0;
+
     signals:
         void collationListChanged();
 };
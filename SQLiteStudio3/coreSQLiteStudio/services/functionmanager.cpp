@@ -8,6 +8,18 @@ FunctionManager::FunctionBase::~FunctionBase()
 {
 }
 
+FunctionManager::ResolvedFunction::~ResolvedFunction()
+{
+}
+
+FunctionManager::AggregateState::~AggregateState()
+{
+}
+
+FunctionManager::ResolvedAggregateFunction::~ResolvedAggregateFunction()
+{
+}
+
 QString FunctionManager::FunctionBase::toString() const
 {
     static const QString format = "%1(%2)";
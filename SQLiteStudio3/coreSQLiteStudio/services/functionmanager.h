@@ -3,6 +3,7 @@
 
 #include "coreSQLiteStudio_global.h"
 #include "common/global.h"
+#include "db/sqlfunctionvalue.h"
 #include <QVariant>
 #include <QList>
 #include <QSharedPointer>
@@ -57,12 +58,115 @@ class API_EXPORT FunctionManager : public QObject
             ImplementationFunction functionPtr;
         };
 
+        /**
+         * @brief Scalar function resolved for repeated evaluation.
+         *
+         * It's obtained once, when the function is registered in the database. Evaluation of each call
+         * then doesn't need to look up the function by its name, nor the scripting plugin by the language,
+         * and script functions are compiled only once (if the scripting plugin supports it).
+         *
+         * The object keeps its own copy of the function definition, so it stays valid even after
+         * the list of functions was changed. It's safe to evaluate it from multiple threads.
+         */
+        class API_EXPORT ResolvedFunction
+        {
+            public:
+                virtual ~ResolvedFunction();
+
+                /**
+                 * @brief Evaluates the function.
+                 * @param args Argument values.
+                 * @param argCount Number of arguments.
+                 * @param db Database that the function is called for.
+                 * @param result Result of the function, or error message (as text) if evaluation failed.
+                 * @param ok Set to false if evaluation failed.
+                 */
+                virtual void evaluate(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, bool& ok) = 0;
+        };
+
+        typedef QSharedPointer<ResolvedFunction> ResolvedFunctionPtr;
+
+        /**
+         * @brief State of aggregate function evaluation for a single group of rows.
+         *
+         * It's created by ResolvedAggregateFunction::createState() for the first row of the group,
+         * kept in place in the SQLite aggregate context for all following rows and deleted after the final step.
+         */
+        class API_EXPORT AggregateState
+        {
+            public:
+                virtual ~AggregateState();
+        };
+
+        /**
+         * @brief Aggregate function resolved for repeated evaluation.
+         *
+         * Just like ResolvedFunction, it's obtained when the function is registered in the database.
+         * Steps of the aggregate modify the AggregateState directly, so nothing is copied in or out
+         * of the SQLite aggregate context for each row.
+         *
+         * It's safe to use it from multiple threads, as long as each AggregateState is used by one thread at a time.
+         */
+        class API_EXPORT ResolvedAggregateFunction
+        {
+            public:
+                virtual ~ResolvedAggregateFunction();
+
+                /**
+                 * @brief Starts evaluation for a new group of rows.
+                 * @param db Database that the function is called for.
+                 * @return New state, owned by the caller.
+                 *
+                 * This is where the initial code of the function is executed.
+                 */
+                virtual AggregateState* createState(Db* db) = 0;
+
+                /**
+                 * @brief Processes single row of the group.
+                 * @param state State of the group.
+                 * @param args Argument values.
+                 * @param argCount Number of arguments.
+                 * @param db Database that the function is called for.
+                 *
+                 * Implementation may collect rows and process them in batches, as long as all of them
+                 * are processed (in the same order) before finish() returns.
+                 */
+                virtual void step(AggregateState* state, const SqlFunctionValue* args, int argCount, Db* db) = 0;
+
+                /**
+                 * @brief Finishes evaluation for the group.
+                 * @param state State of the group.
+                 * @param db Database that the function is called for.
+                 * @param result Result of the function, or error message (as text) if evaluation failed.
+                 * @param ok Set to false if evaluation failed.
+                 */
+                virtual void finish(AggregateState* state, Db* db, SqlFunctionValue& result, bool& ok) = 0;
+        };
+
+        typedef QSharedPointer<ResolvedAggregateFunction> ResolvedAggregateFunctionPtr;
+
         virtual void setScriptFunctions(const QList<ScriptFunction*>& newFunctions) = 0;
         virtual QList<ScriptFunction*> getAllScriptFunctions() const = 0;
         virtual QList<ScriptFunction*> getScriptFunctionsForDatabase(const QString& dbName) const = 0;
         virtual QList<NativeFunction*> getAllNativeFunctions() const = 0;
 
         virtual QVariant evaluateScalar(const QString& name, int argCount, const QList<QVariant>& args, Db* db, bool& ok) = 0;
+
+        /**
+         * @brief Resolves scalar function for repeated evaluation.
+         * @param name Function name.
+         * @param argCount Number of arguments (-1 for undefined).
+         * @return Resolved function, or null if there is no such function.
+         */
+        virtual ResolvedFunctionPtr resolveScalar(const QString& name, int argCount) = 0;
+
+        /**
+         * @brief Resolves aggregate function for repeated evaluation.
+         * @param name Function name.
+         * @param argCount Number of arguments (-1 for undefined).
+         * @return Resolved function, or null if there is no such function.
+         */
+        virtual ResolvedAggregateFunctionPtr resolveAggregate(const QString& name, int argCount) = 0;
         virtual void evaluateAggregateInitial(const QString& name, int argCount, Db* db, QHash<QString, QVariant>& aggregateStorage) = 0;
         virtual void evaluateAggregateStep(const QString& name, int argCount, const QList<QVariant>& args, Db* db,
                                            QHash<QString, QVariant>& aggregateStorage) = 0;
@@ -4,7 +4,12 @@
 #include "services/notifymanager.h"
 #include "services/dbmanager.h"
 #include "common/utils.h"
+#include "common/unused.h"
 #include <QDebug>
+#include <QCollator>
+#include <QMutexLocker>
+#include <QReadWriteLock>
+#include <QAtomicInt>
 
 class CollationFunctionInfoImpl : public ScriptingPlugin::FunctionInfo
 {
@@ -16,6 +21,288 @@ class CollationFunctionInfoImpl : public ScriptingPlugin::FunctionInfo
 
 CollationFunctionInfoImpl collationFunctionInfo;
 
+class ScriptCollationComparator : public CollationManager::Comparator
+{
+    public:
+        explicit ScriptCollationComparator(const CollationManager::CollationPtr& collation);
+        ~ScriptCollationComparator();
+
+        int compare(const char* value1, int length1, const char* value2, int length2);
+
+        /**
+         * @brief Forgets the scripting plugin and deletes the compiled collation code.
+         * @param plugin Plugin to release. If it's not the plugin used by this collation, nothing happens.
+         *
+         * The plugin is resolved again with the next comparison.
+         */
+        void release(ScriptingPlugin* plugin);
+
+    private:
+        void resolvePlugin();
+        int compareDefault(const QString& value1, const QString& value2, const QString& warning);
+
+        QString name;
+        QString lang;
+        QString code;
+
+        /**
+         * @brief Guards the plugin and the compiled code.
+         *
+         * Comparisons only read them, so databases used by different threads can compare at the same time.
+         */
+        QReadWriteLock lock;
+        ScriptingPlugin* plugin = nullptr;
+        ScriptingPlugin::CompiledFunction* compiled = nullptr;
+
+        /**
+         * @brief Tells if the fallback to default collation was already reported.
+         *
+         * Broken collation would otherwise flood the log with a warning for every single comparison.
+         */
+        QAtomicInt warned;
+};
+
+class NaturalCollationComparator : public CollationManager::Comparator
+{
+    public:
+        int compare(const char* value1, int length1, const char* value2, int length2);
+};
+
+class UnicodeNoCaseCollationComparator : public CollationManager::Comparator
+{
+    public:
+        int compare(const char* value1, int length1, const char* value2, int length2);
+};
+
+class LocaleCollationComparator : public CollationManager::Comparator
+{
+    public:
+        LocaleCollationComparator(const QLocale& locale, Qt::CaseSensitivity caseSensitivity);
+
+        int compare(const char* value1, int length1, const char* value2, int length2);
+
+    private:
+        QCollator collator;
+};
+
+static bool isAscii(const char* value, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        if (static_cast<uchar>(value[i]) >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool isDigit(const QChar& c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+static char foldAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+static QChar foldUnicode(QChar c)
+{
+    return c.toCaseFolded();
+}
+
+/**
+ * @brief Compares strings so that numbers in them are ordered by their value.
+ * @param value1 First string.
+ * @param length1 Number of characters in value1.
+ * @param value2 Second string.
+ * @param length2 Number of characters in value2.
+ * @param fold Function folding case of a single character.
+ * @return Negative number, 0 or positive number.
+ *
+ * Runs of digits are compared as numbers of any length (without converting them, so they can't overflow),
+ * with leading zeros ignored. Other characters are compared one by one after case folding.
+ * This makes "file2" go before "file10" and "File2" equal to "file02".
+ */
+template <class C, class F>
+static int naturalCompare(const C* value1, int length1, const C* value2, int length2, F fold)
+{
+    int i = 0;
+    int j = 0;
+    while (i < length1 && j < length2)
+    {
+        if (isDigit(value1[i]) && isDigit(value2[j]))
+        {
+            while (i < length1 && value1[i] == '0')
+                i++;
+
+            while (j < length2 && value2[j] == '0')
+                j++;
+
+            int numberStart1 = i;
+            int numberStart2 = j;
+            while (i < length1 && isDigit(value1[i]))
+                i++;
+
+            while (j < length2 && isDigit(value2[j]))
+                j++;
+
+            // Longer number (without leading zeros) is the greater one
+            int digits1 = i - numberStart1;
+            int digits2 = j - numberStart2;
+            if (digits1 != digits2)
+                return digits1 - digits2;
+
+            for (int k = 0; k < digits1; k++)
+            {
+                if (value1[numberStart1 + k] != value2[numberStart2 + k])
+                    return value1[numberStart1 + k] < value2[numberStart2 + k] ? -1 : 1;
+            }
+            continue;
+        }
+
+        C c1 = fold(value1[i]);
+        C c2 = fold(value2[j]);
+        if (c1 != c2)
+            return c1 < c2 ? -1 : 1;
+
+        i++;
+        j++;
+    }
+
+    if (i < length1)
+        return 1;
+
+    if (j < length2)
+        return -1;
+
+    return 0;
+}
+
+ScriptCollationComparator::ScriptCollationComparator(const CollationManager::CollationPtr& collation) :
+    name(collation->name), lang(collation->lang), code(collation->code), lock(QReadWriteLock::Recursive)
+{
+}
+
+ScriptCollationComparator::~ScriptCollationComparator()
+{
+    safe_delete(compiled);
+}
+
+int ScriptCollationComparator::compare(const char* value1, int length1, const char* value2, int length2)
+{
+    QString str1 = QString::fromUtf8(value1, length1);
+    QString str2 = QString::fromUtf8(value2, length2);
+
+    QReadLocker locker(&lock);
+    if (!plugin)
+    {
+        locker.unlock();
+        resolvePlugin();
+        locker.relock();
+        if (!plugin)
+            return compareDefault(str1, str2, QString("Plugin for collation %1 not loaded, so using default collation.").arg(name));
+    }
+
+    QString err;
+    QVariant result;
+    if (compiled)
+    {
+        SqlFunctionValue args[2];
+        args[0].setText(str1);
+        args[1].setText(str2);
+
+        SqlFunctionValue compiledResult;
+        if (compiled->call(args, 2, nullptr, compiledResult, err))
+            result = compiledResult.toVariant();
+    }
+    else
+    {
+        // Plugin doesn't support compiled functions
+        result = plugin->evaluate(code, collationFunctionInfo, {str1, str2}, &err);
+    }
+
+    if (!err.isEmpty())
+        return compareDefault(str1, str2, QString("Error while evaluating collation %1: %2").arg(name, err));
+
+    bool ok;
+    int intResult = result.toInt(&ok);
+    if (!ok)
+        return compareDefault(str1, str2, QString("Not integer result from collation %1: %2").arg(name, result.toString()));
+
+    return intResult;
+}
+
+void ScriptCollationComparator::resolvePlugin()
+{
+    QWriteLocker locker(&lock);
+    if (plugin)
+        return;
+
+    plugin = PLUGINS->getScriptingPlugin(lang);
+    if (plugin)
+        compiled = plugin->compileFunction(code, collationFunctionInfo);
+}
+
+void ScriptCollationComparator::release(ScriptingPlugin* plugin)
+{
+    QWriteLocker locker(&lock);
+    if (!this->plugin || this->plugin != plugin)
+        return;
+
+    safe_delete(compiled);
+    this->plugin = nullptr;
+}
+
+int ScriptCollationComparator::compareDefault(const QString& value1, const QString& value2, const QString& warning)
+{
+    if (warned.testAndSetRelaxed(0, 1))
+        qWarning() << warning;
+
+    return value1.compare(value2, Qt::CaseInsensitive);
+}
+
+int NaturalCollationComparator::compare(const char* value1, int length1, const char* value2, int length2)
+{
+    if (isAscii(value1, length1) && isAscii(value2, length2))
+        return naturalCompare(value1, length1, value2, length2, foldAscii);
+
+    QString str1 = QString::fromUtf8(value1, length1);
+    QString str2 = QString::fromUtf8(value2, length2);
+    return naturalCompare(str1.constData(), str1.length(), str2.constData(), str2.length(), foldUnicode);
+}
+
+int UnicodeNoCaseCollationComparator::compare(const char* value1, int length1, const char* value2, int length2)
+{
+    if (!isAscii(value1, length1) || !isAscii(value2, length2))
+        return QString::fromUtf8(value1, length1).compare(QString::fromUtf8(value2, length2), Qt::CaseInsensitive);
+
+    int length = qMin(length1, length2);
+    for (int i = 0; i < length; i++)
+    {
+        char c1 = foldAscii(value1[i]);
+        char c2 = foldAscii(value2[i]);
+        if (c1 != c2)
+            return c1 < c2 ? -1 : 1;
+    }
+    return length1 - length2;
+}
+
+LocaleCollationComparator::LocaleCollationComparator(const QLocale& locale, Qt::CaseSensitivity caseSensitivity) :
+    collator(locale)
+{
+    collator.setCaseSensitivity(caseSensitivity);
+}
+
+int LocaleCollationComparator::compare(const char* value1, int length1, const char* value2, int length2)
+{
+    return collator.compare(QString::fromUtf8(value1, length1), QString::fromUtf8(value2, length2));
+}
+
 CollationManagerImpl::CollationManagerImpl()
 {
     init();
@@ -25,6 +312,10 @@ void CollationManagerImpl::setCollations(const QList<CollationManager::Collation
 {
     collations = newCollations;
     refreshCollationsByKey();
+    {
+        QMutexLocker locker(&resolvedCollationsMutex);
+        resolvedScriptCollations.clear();
+    }
     storeInConfig();
     emit collationListChanged();
 }
@@ -85,10 +376,39 @@ int CollationManagerImpl::evaluateDefault(const QString& value1, const QString&
     return value1.compare(value2, Qt::CaseInsensitive);
 }
 
+CollationManager::ComparatorPtr CollationManagerImpl::resolveCollation(const QString& name)
+{
+    if (!collationsByKey.contains(name))
+        return resolveNativeCollation(name);
+
+    QMutexLocker locker(&resolvedCollationsMutex);
+    if (resolvedScriptCollations.contains(name))
+        return resolvedScriptCollations[name];
+
+    QSharedPointer<ScriptCollationComparator> comparator = QSharedPointer<ScriptCollationComparator>::create(collationsByKey[name]);
+    resolvedScriptCollations[name] = comparator;
+
+    QMutableListIterator<QWeakPointer<ScriptCollationComparator>> it(resolvedScriptCollationRefs);
+    while (it.hasNext())
+    {
+        if (it.next().isNull())
+            it.remove();
+    }
+    resolvedScriptCollationRefs << comparator;
+    return comparator;
+}
+
+QStringList CollationManagerImpl::getNativeCollationNames() const
+{
+    static const QStringList names = {"LOCALE", "LOCALE_NOCASE", "NATURAL", "UNICODE_NOCASE"};
+    return names;
+}
+
 void CollationManagerImpl::init()
 {
     loadFromConfig();
     refreshCollationsByKey();
+    connect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(aboutToUnload(Plugin*,PluginType*)));
 }
 
 void CollationManagerImpl::storeInConfig()
@@ -141,3 +461,50 @@ QString CollationManagerImpl::updateScriptingQtLang(const QString& lang) const
 
     return lang;
 }
+
+CollationManager::ComparatorPtr CollationManagerImpl::resolveNativeCollation(const QString& name)
+{
+    // Comparators are not shared, because QCollator can't be used by multiple threads at once.
+    // Each database registers its own instance.
+    QString upperName = name.toUpper();
+    if (upperName == "NATURAL")
+        return QSharedPointer<NaturalCollationComparator>::create();
+
+    if (upperName == "UNICODE_NOCASE")
+        return QSharedPointer<UnicodeNoCaseCollationComparator>::create();
+
+    if (upperName == "LOCALE")
+        return QSharedPointer<LocaleCollationComparator>::create(QLocale(), Qt::CaseSensitive);
+
+    if (upperName == "LOCALE_NOCASE")
+        return QSharedPointer<LocaleCollationComparator>::create(QLocale(), Qt::CaseInsensitive);
+
+    if (upperName.startsWith("LOCALE_"))
+    {
+        // QLocale falls back to the C locale for names it doesn't recognize
+        QLocale locale(name.mid(7));
+        if (locale.language() == QLocale::C)
+            return ComparatorPtr();
+
+        return QSharedPointer<LocaleCollationComparator>::create(locale, Qt::CaseSensitive);
+    }
+
+    return ComparatorPtr();
+}
+
+void CollationManagerImpl::aboutToUnload(Plugin* plugin, PluginType* type)
+{
+    UNUSED(type);
+    ScriptingPlugin* scriptingPlugin = dynamic_cast<ScriptingPlugin*>(plugin);
+    if (!scriptingPlugin)
+        return;
+
+    // Compiled collation code belongs to the plugin, so it has to be deleted while the plugin is still loaded
+    QMutexLocker locker(&resolvedCollationsMutex);
+    for (const QWeakPointer<ScriptCollationComparator>& ref : resolvedScriptCollationRefs)
+    {
+        QSharedPointer<ScriptCollationComparator> comparator = ref.toStrongRef();
+        if (comparator)
+            comparator->release(scriptingPlugin);
+    }
+}
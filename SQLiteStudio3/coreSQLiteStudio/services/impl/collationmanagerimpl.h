@@ -2,13 +2,18 @@
 #define COLLATIONMANAGERIMPL_H
 
 #include "services/collationmanager.h"
+#include <QMutex>
+#include <QWeakPointer>
 
 class ScriptingPlugin;
 class Plugin;
 class PluginType;
+class ScriptCollationComparator;
 
 class API_EXPORT CollationManagerImpl : public CollationManager
 {
+    Q_OBJECT
+
     public:
         CollationManagerImpl();
 
@@ -17,6 +22,15 @@ class API_EXPORT CollationManagerImpl : public CollationManager
         QList<CollationPtr> getCollationsForDatabase(const QString& dbName) const;
         int evaluate(const QString& name, const QString& value1, const QString& value2);
         int evaluateDefault(const QString& value1, const QString& value2);
+        ComparatorPtr resolveCollation(const QString& name);
+        QStringList getNativeCollationNames() const;
+
+        /**
+         * @brief Creates comparator of the built-in collation.
+         * @param name Name of the collation (case insensitive), one of getNativeCollationNames() or LOCALE_ with locale name.
+         * @return New comparator instance, or null if there is no such built-in collation.
+         */
+        static ComparatorPtr resolveNativeCollation(const QString& name);
 
     private:
         void init();
@@ -27,11 +41,25 @@ class API_EXPORT CollationManagerImpl : public CollationManager
 
         QList<CollationPtr> collations;
         QHash<QString,CollationPtr> collationsByKey;
-        QHash<QString,ScriptingPlugin*> scriptingPlugins;
+
+        /**
+         * @brief Comparators of user defined collations, shared by all databases.
+         *
+         * It's cleared when collations are redefined, but comparators already registered in databases
+         * stay alive until the databases drop them.
+         */
+        QHash<QString,QSharedPointer<ScriptCollationComparator>> resolvedScriptCollations;
+
+        /**
+         * @brief All comparators of user defined collations that are still in use.
+         *
+         * They need to release their scripting plugin when it's being unloaded.
+         */
+        QList<QWeakPointer<ScriptCollationComparator>> resolvedScriptCollationRefs;
+        QMutex resolvedCollationsMutex;
 
     private slots:
-        void pluginLoaded(Plugin* plugin, PluginType* type);
-        void pluginUnloaded(Plugin* plugin, PluginType* type);
+        void aboutToUnload(Plugin* plugin, PluginType* type);
 };
 
 #endif // COLLATIONMANAGERIMPL_H
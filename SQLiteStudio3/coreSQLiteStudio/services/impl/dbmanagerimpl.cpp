@@ -5,6 +5,7 @@
 #include "services/pluginmanager.h"
 #include "services/notifymanager.h"
 #include "common/utils.h"
+#include "schemaresolver.h"
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <QHash>
@@ -96,6 +97,8 @@ bool DbManagerImpl::updateDb(Db* db, const QString &name, const QString &path, c
     bool pathDifferent = db->getPath() != normalizedPath;
 
     QString oldName = db->getName();
+    SchemaResolver::clearCache(oldName);
+    SchemaResolver::clearCache(name);
     db->setName(name);
     db->setPath(normalizedPath);
     db->setConnectionOptions(options);
@@ -202,6 +205,7 @@ void DbManagerImpl::removeDbInternal(Db* db, bool alsoFromConfig)
     nameToDb.remove(name);
     pathToDb.remove(db->getPath());
     dbList.removeOne(db);
+    SchemaResolver::clearCache(name);
     disconnect(db, SIGNAL(connected()), this, SLOT(dbConnectedSlot()));
     disconnect(db, SIGNAL(disconnected()), this, SLOT(dbDisconnectedSlot()));
     disconnect(db, SIGNAL(aboutToDisconnect(bool&)), this, SLOT(dbAboutToDisconnect(bool&)));
@@ -564,6 +568,7 @@ void DbManagerImpl::dbDisconnectedSlot()
         qWarning() << "Received disconnected() signal but could not cast it to Db!";
         return;
     }
+    SchemaResolver::clearCache(db->getName());
     emit dbDisconnected(db);
 }
 
@@ -7,7 +7,7 @@
 #include "common/utils.h"
 #include "common/utils_sql.h"
 #include "services/dbmanager.h"
-#include "db/queryexecutor.h"
+#include "db/sqlscriptexecutor.h"
 #include "db/sqlquery.h"
 #include "services/importmanager.h"
 #include <QVariantList>
@@ -16,6 +16,9 @@
 #include <QRegularExpression>
 #include <QFile>
 #include <QUrl>
+#include <QMutexLocker>
+#include <QReadWriteLock>
+#include <algorithm>
 #include <plugins/importplugin.h>
 
 class FunctionInfoImpl : public ScriptingPlugin::FunctionInfo
@@ -60,6 +63,333 @@ bool FunctionInfoImpl::getUndefinedArgs() const
     return undefinedArgs;
 }
 
+/**
+ * @brief Evaluates code in the context of the calling thread.
+ * @param plugin Plugin to evaluate with.
+ * @param dbAwarePlugin The same plugin, if it's db-aware, or null otherwise.
+ * @param code Code to evaluate.
+ * @param info Information about the function.
+ * @param args Argument values.
+ * @param db Database that the code is evaluated for. It's already locked.
+ * @param error Filled with the error message if evaluation failed.
+ * @return Result of evaluation.
+ *
+ * Calls from different threads (like several exports and the query executor at once) don't wait for each other
+ * if the plugin evaluates calls without explicit context in per-thread contexts (like JavaScript and Tcl do).
+ * The plugin keeps the thread's context reserved for the whole evaluation, so it can't be deleted in the meantime.
+ */
+static QVariant evaluateInThreadContext(ScriptingPlugin* plugin, DbAwareScriptingPlugin* dbAwarePlugin, const QString& code,
+                                        const ScriptingPlugin::FunctionInfo& info, const QList<QVariant>& args, Db* db, QString& error)
+{
+    if (dbAwarePlugin)
+        return dbAwarePlugin->evaluate(code, info, args, db, false, &error);
+
+    return plugin->evaluate(code, info, args, &error);
+}
+
+class ResolvedScriptFunction : public FunctionManager::ResolvedFunction
+{
+    public:
+        ResolvedScriptFunction(FunctionManager::ScriptFunction* func, const QString& langUnsupportedError);
+        ~ResolvedScriptFunction();
+
+        void evaluate(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, bool& ok);
+
+        /**
+         * @brief Forgets the scripting plugin and deletes the compiled function.
+         * @param plugin Plugin to release. If it's not the plugin used by this function, nothing happens.
+         *
+         * The plugin is resolved again with the next evaluation.
+         */
+        void release(ScriptingPlugin* plugin);
+
+    private:
+        void resolvePlugin();
+
+        QString lang;
+        QString code;
+        FunctionInfoImpl info;
+        QString langUnsupportedError;
+
+        /**
+         * @brief Guards the plugin and the compiled function.
+         *
+         * Evaluations only read them, so they hold the lock for reading and can run in multiple threads at once.
+         * It's recursive, because the function can be called again from within itself (through the database).
+         */
+        QReadWriteLock lock;
+        ScriptingPlugin* plugin = nullptr;
+        DbAwareScriptingPlugin* dbAwarePlugin = nullptr;
+        ScriptingPlugin::CompiledFunction* compiled = nullptr;
+};
+
+class ScriptAggregateState : public FunctionManager::AggregateState
+{
+    public:
+        ~ScriptAggregateState();
+
+        ScriptingPlugin* plugin = nullptr;
+        ScriptingPlugin::Context* context = nullptr;
+        bool error = false;
+        QString errorMessage;
+
+        /**
+         * @brief Arguments of rows collected for the next batch, one row after another.
+         */
+        QVector<SqlFunctionValue> rows;
+        int rowCount = 0;
+};
+
+class ResolvedScriptAggregate : public FunctionManager::ResolvedAggregateFunction
+{
+    public:
+        ResolvedScriptAggregate(FunctionManager::ScriptFunction* func, const QString& langUnsupportedError);
+
+        FunctionManager::AggregateState* createState(Db* db);
+        void step(FunctionManager::AggregateState* state, const SqlFunctionValue* args, int argCount, Db* db);
+        void finish(FunctionManager::AggregateState* state, Db* db, SqlFunctionValue& result, bool& ok);
+
+        /**
+         * @brief Forgets the scripting plugin, if it's the given one.
+         * @param plugin Plugin to release.
+         *
+         * States created earlier keep using the plugin.
+         */
+        void release(ScriptingPlugin* plugin);
+
+    private:
+        QVariant evaluate(ScriptAggregateState* state, const QString& code, Db* db);
+        void flush(ScriptAggregateState* state, Db* db);
+
+        /**
+         * @brief Number of rows passed to the scripting plugin at once.
+         */
+        static const int BATCH_SIZE = 256;
+
+        QString code;
+        QString initCode;
+        QString finalCode;
+        QString lang;
+        FunctionInfoImpl info;
+        QString langUnsupportedError;
+        QMutex mutex;
+        ScriptingPlugin* plugin = nullptr;
+};
+
+class ResolvedNativeFunction : public FunctionManager::ResolvedFunction
+{
+    public:
+        explicit ResolvedNativeFunction(FunctionManager::NativeFunction* func);
+
+        void evaluate(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, bool& ok);
+
+    private:
+        FunctionManager::NativeFunction::ImplementationFunction functionPtr;
+};
+
+ResolvedScriptFunction::ResolvedScriptFunction(FunctionManager::ScriptFunction* func, const QString& langUnsupportedError) :
+    lang(func->lang), code(func->code), info(func), langUnsupportedError(langUnsupportedError), lock(QReadWriteLock::Recursive)
+{
+}
+
+ResolvedScriptFunction::~ResolvedScriptFunction()
+{
+    safe_delete(compiled);
+}
+
+void ResolvedScriptFunction::evaluate(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, bool& ok)
+{
+    QReadLocker locker(&lock);
+    if (!plugin)
+    {
+        locker.unlock();
+        resolvePlugin();
+        locker.relock();
+        if (!plugin)
+        {
+            ok = false;
+            result.setText(langUnsupportedError);
+            return;
+        }
+    }
+
+    QString error;
+    if (compiled)
+    {
+        if (!compiled->call(args, argCount, db, result, error))
+        {
+            ok = false;
+            result.setText(error);
+        }
+        return;
+    }
+
+    // Plugin doesn't support compiled functions
+    QList<QVariant> argList = SqlFunctionValue::toVariantList(args, argCount);
+    QVariant value = evaluateInThreadContext(plugin, dbAwarePlugin, code, info, argList, db, error);
+
+    if (!error.isEmpty())
+    {
+        ok = false;
+        result.setText(error);
+        return;
+    }
+    result = SqlFunctionValue::fromVariant(value);
+}
+
+void ResolvedScriptFunction::resolvePlugin()
+{
+    QWriteLocker locker(&lock);
+    if (plugin)
+        return;
+
+    plugin = PLUGINS->getScriptingPlugin(lang);
+    if (!plugin)
+        return;
+
+    dbAwarePlugin = dynamic_cast<DbAwareScriptingPlugin*>(plugin);
+    compiled = plugin->compileFunction(code, info);
+}
+
+void ResolvedScriptFunction::release(ScriptingPlugin* plugin)
+{
+    QWriteLocker locker(&lock);
+    if (!this->plugin || this->plugin != plugin)
+        return;
+
+    safe_delete(compiled);
+    this->plugin = nullptr;
+    dbAwarePlugin = nullptr;
+}
+
+ScriptAggregateState::~ScriptAggregateState()
+{
+    if (context)
+        plugin->releaseContext(context);
+}
+
+ResolvedScriptAggregate::ResolvedScriptAggregate(FunctionManager::ScriptFunction* func, const QString& langUnsupportedError) :
+    code(func->code), initCode(func->initCode), finalCode(func->finalCode), lang(func->lang), info(func),
+    langUnsupportedError(langUnsupportedError)
+{
+}
+
+FunctionManager::AggregateState* ResolvedScriptAggregate::createState(Db* db)
+{
+    ScriptAggregateState* state = new ScriptAggregateState();
+    {
+        QMutexLocker locker(&mutex);
+        if (!plugin)
+            plugin = PLUGINS->getScriptingPlugin(lang);
+
+        state->plugin = plugin;
+    }
+
+    if (!state->plugin)
+    {
+        state->error = true;
+        state->errorMessage = langUnsupportedError;
+        return state;
+    }
+
+    state->context = state->plugin->createContext();
+    evaluate(state, initCode, db);
+    return state;
+}
+
+void ResolvedScriptAggregate::step(FunctionManager::AggregateState* state, const SqlFunctionValue* args, int argCount, Db* db)
+{
+    ScriptAggregateState* scriptState = static_cast<ScriptAggregateState*>(state);
+    if (scriptState->error)
+        return;
+
+    if (scriptState->rows.isEmpty())
+        scriptState->rows.resize(BATCH_SIZE * argCount);
+
+    SqlFunctionValue* row = scriptState->rows.data() + scriptState->rowCount * argCount;
+    for (int i = 0; i < argCount; i++)
+        row[i] = args[i];
+
+    if (++scriptState->rowCount >= BATCH_SIZE)
+        flush(scriptState, db);
+}
+
+void ResolvedScriptAggregate::finish(FunctionManager::AggregateState* state, Db* db, SqlFunctionValue& result, bool& ok)
+{
+    ScriptAggregateState* scriptState = static_cast<ScriptAggregateState*>(state);
+    flush(scriptState, db);
+
+    QVariant value;
+    if (!scriptState->error)
+        value = evaluate(scriptState, finalCode, db);
+
+    if (scriptState->error)
+    {
+        ok = false;
+        result.setText(scriptState->errorMessage);
+        return;
+    }
+    result = SqlFunctionValue::fromVariant(value);
+}
+
+void ResolvedScriptAggregate::release(ScriptingPlugin* plugin)
+{
+    QMutexLocker locker(&mutex);
+    if (this->plugin == plugin)
+        this->plugin = nullptr;
+}
+
+QVariant ResolvedScriptAggregate::evaluate(ScriptAggregateState* state, const QString& code, Db* db)
+{
+    DbAwareScriptingPlugin* dbAwarePlugin = dynamic_cast<DbAwareScriptingPlugin*>(state->plugin);
+
+    QVariant result;
+    if (dbAwarePlugin)
+        result = dbAwarePlugin->evaluate(state->context, code, info, {}, db, false);
+    else
+        result = state->plugin->evaluate(state->context, code, info, {});
+
+    if (state->plugin->hasError(state->context))
+    {
+        state->error = true;
+        state->errorMessage = state->plugin->getErrorMessage(state->context);
+    }
+    return result;
+}
+
+void ResolvedScriptAggregate::flush(ScriptAggregateState* state, Db* db)
+{
+    if (state->rowCount == 0 || state->error)
+        return;
+
+    int argCount = state->rows.size() / BATCH_SIZE;
+    state->plugin->evaluateBatch(state->context, code, info, state->rows.constData(), argCount, state->rowCount, db);
+    state->rowCount = 0;
+
+    if (state->plugin->hasError(state->context))
+    {
+        state->error = true;
+        state->errorMessage = state->plugin->getErrorMessage(state->context);
+    }
+}
+
+ResolvedNativeFunction::ResolvedNativeFunction(FunctionManager::NativeFunction* func) :
+    functionPtr(func->functionPtr)
+{
+}
+
+void ResolvedNativeFunction::evaluate(const SqlFunctionValue* args, int argCount, Db* db, SqlFunctionValue& result, bool& ok)
+{
+    // Number of arguments is already checked by SQLite, as native functions are registered with exact count
+    QVariant value = functionPtr(SqlFunctionValue::toVariantList(args, argCount), db, ok);
+    if (!ok)
+    {
+        result.setText(value.toString());
+        return;
+    }
+    result = SqlFunctionValue::fromVariant(value);
+}
+
 
 
 FunctionManagerImpl::FunctionManagerImpl()
@@ -72,6 +402,11 @@ void FunctionManagerImpl::setScriptFunctions(const QList<ScriptFunction*>& newFu
     clearFunctions();
     functions = newFunctions;
     refreshFunctionsByKey();
+    {
+        QMutexLocker locker(&resolvedFunctionsMutex);
+        resolvedScriptFunctions.clear();
+        resolvedScriptAggregates.clear();
+    }
     storeInConfig();
     emit functionListChanged();
 }
@@ -113,6 +448,58 @@ QVariant FunctionManagerImpl::evaluateScalar(const QString& name, int argCount,
     return cannotFindFunctionError(name, argCount);
 }
 
+FunctionManager::ResolvedFunctionPtr FunctionManagerImpl::resolveScalar(const QString& name, int argCount)
+{
+    Key key;
+    key.name = name;
+    key.argCount = argCount;
+    key.type = ScriptFunction::SCALAR;
+    if (functionsByKey.contains(key))
+    {
+        QMutexLocker locker(&resolvedFunctionsMutex);
+        if (resolvedScriptFunctions.contains(key))
+            return resolvedScriptFunctions[key];
+
+        ScriptFunction* function = functionsByKey[key];
+        QSharedPointer<ResolvedScriptFunction> resolved = QSharedPointer<ResolvedScriptFunction>::create(
+                    function, langUnsupportedError(name, argCount, function->lang));
+
+        resolvedScriptFunctions[key] = resolved;
+        pruneRefs(resolvedScriptFunctionRefs);
+        resolvedScriptFunctionRefs << resolved;
+        return resolved;
+    }
+    else if (nativeFunctionsByKey.contains(key))
+    {
+        return QSharedPointer<ResolvedNativeFunction>::create(nativeFunctionsByKey[key]);
+    }
+
+    return ResolvedFunctionPtr();
+}
+
+FunctionManager::ResolvedAggregateFunctionPtr FunctionManagerImpl::resolveAggregate(const QString& name, int argCount)
+{
+    Key key;
+    key.name = name;
+    key.argCount = argCount;
+    key.type = ScriptFunction::AGGREGATE;
+    if (!functionsByKey.contains(key))
+        return ResolvedAggregateFunctionPtr();
+
+    QMutexLocker locker(&resolvedFunctionsMutex);
+    if (resolvedScriptAggregates.contains(key))
+        return resolvedScriptAggregates[key];
+
+    ScriptFunction* function = functionsByKey[key];
+    QSharedPointer<ResolvedScriptAggregate> resolved = QSharedPointer<ResolvedScriptAggregate>::create(
+                function, langUnsupportedError(name, argCount, function->lang));
+
+    resolvedScriptAggregates[key] = resolved;
+    pruneRefs(resolvedScriptAggregateRefs);
+    resolvedScriptAggregateRefs << resolved;
+    return resolved;
+}
+
 void FunctionManagerImpl::evaluateAggregateInitial(const QString& name, int argCount, Db* db, QHash<QString,QVariant>& aggregateStorage)
 {
     Key key;
@@ -167,12 +554,7 @@ QVariant FunctionManagerImpl::evaluateScriptScalar(ScriptFunction* func, const Q
     FunctionInfoImpl info(func);
 
     QString error;
-    QVariant result;
-
-    if (dbAwarePlugin)
-        result = dbAwarePlugin->evaluate(func->code, info, args, db, false, &error);
-    else
-        result = plugin->evaluate(func->code, info, args, &error);
+    QVariant result = evaluateInThreadContext(plugin, dbAwarePlugin, func->code, info, args, db, error);
 
     if (!error.isEmpty())
     {
@@ -292,6 +674,8 @@ void FunctionManagerImpl::init()
     loadFromConfig();
     initNativeFunctions();
     refreshFunctionsByKey();
+
+    connect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(aboutToUnload(Plugin*,PluginType*)));
 }
 
 void FunctionManagerImpl::initNativeFunctions()
@@ -390,6 +774,36 @@ void FunctionManagerImpl::clearFunctions()
     functions.clear();
 }
 
+void FunctionManagerImpl::aboutToUnload(Plugin* plugin, PluginType* type)
+{
+    UNUSED(type);
+    ScriptingPlugin* scriptingPlugin = dynamic_cast<ScriptingPlugin*>(plugin);
+    if (!scriptingPlugin)
+        return;
+
+    // Compiled functions belong to the plugin, so they have to be deleted while the plugin is still loaded
+    QMutexLocker locker(&resolvedFunctionsMutex);
+    for (const QWeakPointer<ResolvedScriptFunction>& ref : resolvedScriptFunctionRefs)
+    {
+        QSharedPointer<ResolvedScriptFunction> resolved = ref.toStrongRef();
+        if (resolved)
+            resolved->release(scriptingPlugin);
+    }
+
+    for (const QWeakPointer<ResolvedScriptAggregate>& ref : resolvedScriptAggregateRefs)
+    {
+        QSharedPointer<ResolvedScriptAggregate> resolved = ref.toStrongRef();
+        if (resolved)
+            resolved->release(scriptingPlugin);
+    }
+}
+
+template <class R>
+void FunctionManagerImpl::pruneRefs(QList<QWeakPointer<R>>& refs)
+{
+    refs.erase(std::remove_if(refs.begin(), refs.end(), [](const QWeakPointer<R>& ref) {return ref.isNull();}), refs.end());
+}
+
 QString FunctionManagerImpl::cannotFindFunctionError(const QString& name, int argCount)
 {
     QStringList argMarkers = getArgMarkers(argCount);
@@ -439,19 +853,22 @@ QVariant FunctionManagerImpl::nativeSqlFile(const QList<QVariant>& args, Db* db,
         return tr("Could not open file %1 for reading: %2").arg(args[0].toString(), file.errorString());
     }
 
-    QTextStream stream(&file);
-    QString sql = stream.readAll();
+    // The file is executed as it's read, without loading it into memory at once.
+    // Transactions are left to the file, as the function is called in the middle of a statement.
+    SqlScriptExecutor executor(db);
+    executor.setTransactional(false);
+    bool res = executor.exec(&file);
     file.close();
-
-    QueryExecutor executor(db);
-    executor.setAsyncMode(false);
-    executor.exec(sql);
-    SqlQueryPtr results = executor.getResults();
-    if (results->isError())
+    if (!res)
     {
         ok = false;
-        return results->getErrorText();
+        return executor.getErrors().isEmpty() ? executor.getErrorText() : executor.getErrors().last().second;
     }
+
+    SqlQueryPtr results = executor.getLastResults();
+    if (!results)
+        return QVariant();
+
     return results->getSingleCell();
 }
 
@@ -535,12 +952,7 @@ QVariant FunctionManagerImpl::nativeScript(const QList<QVariant>& args, Db* db,
     FunctionInfoImpl info;
 
     QString error;
-    QVariant result;
-
-    if (dbAwarePlugin)
-        result = dbAwarePlugin->evaluate(args[1].toString(), info, QList<QVariant>(), db, false, &error);
-    else
-        result = plugin->evaluate(args[1].toString(), info, QList<QVariant>(), &error);
+    QVariant result = evaluateInThreadContext(plugin, dbAwarePlugin, args[1].toString(), info, QList<QVariant>(), db, error);
 
     if (!error.isEmpty())
     {
@@ -3,10 +3,14 @@
 
 #include "services/functionmanager.h"
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QWeakPointer>
 
 class SqlFunctionPlugin;
 class Plugin;
 class PluginType;
+class ResolvedScriptFunction;
+class ResolvedScriptAggregate;
 
 class API_EXPORT FunctionManagerImpl : public FunctionManager
 {
@@ -20,6 +24,8 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         QList<ScriptFunction*> getScriptFunctionsForDatabase(const QString& dbName) const;
         QList<NativeFunction*> getAllNativeFunctions() const;
         QVariant evaluateScalar(const QString& name, int argCount, const QList<QVariant>& args, Db* db, bool& ok);
+        ResolvedFunctionPtr resolveScalar(const QString& name, int argCount);
+        ResolvedAggregateFunctionPtr resolveAggregate(const QString& name, int argCount);
         void evaluateAggregateInitial(const QString& name, int argCount, Db* db, QHash<QString, QVariant>& aggregateStorage);
         void evaluateAggregateStep(const QString& name, int argCount, const QList<QVariant>& args, Db* db, QHash<QString, QVariant>& aggregateStorage);
         QVariant evaluateAggregateFinal(const QString& name, int argCount, Db* db, bool& ok, QHash<QString, QVariant>& aggregateStorage);
@@ -93,6 +99,29 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         QHash<Key,ScriptFunction*> functionsByKey;
         QList<NativeFunction*> nativeFunctions;
         QHash<Key,NativeFunction*> nativeFunctionsByKey;
+
+        /**
+         * @brief Resolved script functions, shared by all databases.
+         *
+         * It's cleared when the list of functions changes, so databases registering functions again get new definitions.
+         */
+        QHash<Key,QSharedPointer<ResolvedScriptFunction>> resolvedScriptFunctions;
+        QHash<Key,QSharedPointer<ResolvedScriptAggregate>> resolvedScriptAggregates;
+
+        /**
+         * @brief All resolved script functions that are still in use.
+         *
+         * Used to release compiled functions of the scripting plugin that is being unloaded.
+         */
+        QList<QWeakPointer<ResolvedScriptFunction>> resolvedScriptFunctionRefs;
+        QList<QWeakPointer<ResolvedScriptAggregate>> resolvedScriptAggregateRefs;
+        QMutex resolvedFunctionsMutex;
+
+        template <class R>
+        static void pruneRefs(QList<QWeakPointer<R>>& refs);
+
+    private slots:
+        void aboutToUnload(Plugin* plugin, PluginType* type);
 };
 
 int qHash(const FunctionManagerImpl::Key& key);
@@ -39,6 +39,34 @@ class API_EXPORT ImportManager : public PluginServiceBase
 
             bool ignoreErrors = false;
             bool skipTransaction = false;
+
+            /**
+             * @brief Maximum number of rows inserted with a single INSERT statement.
+             *
+             * Rows are grouped into multi-row INSERT ... VALUES (...), (...) statements. Actual number of rows
+             * per statement may be lower, so the number of bound parameters doesn't exceed SQLite's limit.
+             * Value of 1 makes every row inserted with its own statement.
+             */
+            int rowsPerInsert = 100;
+
+            /**
+             * @brief Relaxes database durability for the time of import.
+             *
+             * If enabled, PRAGMA synchronous is set to OFF and the rollback journal is kept in memory
+             * (unless the database is in WAL mode) while data is imported. Previous settings are restored
+             * once the import is finished. It's ignored when skipTransaction is enabled.
+             */
+            bool fastMode = false;
+
+            /**
+             * @brief Number of row batches that can be read ahead of the database inserts.
+             *
+             * If greater than 0, the data is read from the import plugin in a separate thread,
+             * which fills up a queue of this many batches (see rowsPerInsert), while the import thread
+             * inserts batches from the queue into the database. This way the parsing of the input
+             * and the inserting are done at the same time. Value of 0 makes both done in the import thread.
+             */
+            int bufferedBatches = 4;
         };
 
         enum StandardConfigFlag
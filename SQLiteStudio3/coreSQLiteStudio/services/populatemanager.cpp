@@ -23,7 +23,7 @@ PopulateManager::PopulateManager(QObject *parent) :
     PLUGINS->loadBuiltInPlugin(new PopulateScript());
 }
 
-void PopulateManager::populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows)
+void PopulateManager::populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows, quint32 seed)
 {
     if (workInProgress)
     {
@@ -53,7 +53,7 @@ void PopulateManager::populate(Db* db, const QString& table, const QHash<QString
     this->db = db;
     this->table = table;
 
-    PopulateWorker* worker = new PopulateWorker(db, table, columns, engineList, rows);
+    PopulateWorker* worker = new PopulateWorker(db, table, columns, engineList, rows, seed);
     connect(worker, SIGNAL(finished(bool)), this, SLOT(finalizePopulating(bool)));
     connect(worker, SIGNAL(finishedStep(int)), this, SIGNAL(finishedStep(int)));
     connect(this, SIGNAL(orderWorkerToInterrupt()), worker, SLOT(interrupt()));
@@ -18,7 +18,16 @@ class API_EXPORT PopulateManager : public PluginServiceBase
     public:
         explicit PopulateManager(QObject *parent = 0);
 
-        void populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows);
+        /**
+         * @brief Populates table in a background thread.
+         * @param db Database with the table.
+         * @param table Table to populate.
+         * @param engines Engines generating values, by column names.
+         * @param rows Number of rows to insert.
+         * @param seed Seed for random values. Populating with the same seed and configuration produces the same data.
+         * If it's 0, a random seed is used.
+         */
+        void populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows, quint32 seed = 0);
 
     private:
         void error();
@@ -68,8 +68,10 @@ void TableModifier::renameTo(const QString& newName)
 
     // Using ALTER TABLE RENAME TO is not a good solution here, because it automatically renames all occurrences in REFERENCES,
     // which we don't want, because we rename a lot to temporary tables and drop them.
-    sqls << QString("CREATE TABLE %1 AS SELECT * FROM %2;").arg(wrapObjIfNeeded(newName), wrapObjIfNeeded(table))
-         << QString("DROP TABLE %1;").arg(wrapObjIfNeeded(table));
+    sqls << QString("CREATE TABLE %1 AS SELECT * FROM %2;").arg(wrapObjIfNeeded(newName), wrapObjIfNeeded(table));
+    addChunkedCopy(QString("CREATE TABLE %1 AS SELECT * FROM %2 WHERE 0;").arg(wrapObjIfNeeded(newName), wrapObjIfNeeded(table)),
+                   QString("INSERT INTO %1 SELECT * FROM %2").arg(wrapObjIfNeeded(newName), wrapObjIfNeeded(table)));
+    sqls << QString("DROP TABLE %1;").arg(wrapObjIfNeeded(table));
 
     table = newName;
     createTable->table = newName;
@@ -131,6 +133,11 @@ void TableModifier::handleFks()
         subModifier.newName = fkTable;
         subModifier.tablesHandledForFk = tablesHandledForFk;
         subModifier.handleFks(originalTable, newName);
+
+        QHash<int,ChainExecutor::ChunkedQuery> subChunkedQueries = subModifier.getChunkedQueries();
+        for (auto it = subChunkedQueries.cbegin(); it != subChunkedQueries.cend(); ++it)
+            chunkedQueries[sqls.size() + it.key()] = it.value();
+
         sqls += subModifier.generateSqls();
         modifiedTables << fkTable;
 
@@ -509,7 +516,7 @@ void TableModifier::handleTrigger(SqliteCreateTriggerPtr trigger)
     if (alreadyProcessedOnce)
     {
         // We will add new sql to list, at the end, so it's executed after all tables were altered.
-        sqls.removeOne(triggerNameToDdlMap[trigger->trigger]);
+        removeSql(triggerNameToDdlMap[trigger->trigger]);
     }
 
     if (!forThisTable)
@@ -935,8 +942,64 @@ SqliteQueryPtr TableModifier::parseQuery(const QString& ddl)
 
 void TableModifier::copyDataTo(const QString& targetTable, const QStringList& srcCols, const QStringList& dstCols)
 {
-    sqls << QString("INSERT INTO %1 (%2) SELECT %3 FROM %4;").arg(wrapObjIfNeeded(targetTable), dstCols.join(", "), srcCols.join(", "),
-                                                                 wrapObjIfNeeded(table));
+    QString sql = QStringLiteral("INSERT INTO %1 (%2) SELECT %3 FROM %4").arg(wrapObjIfNeeded(targetTable), dstCols.join(", "), srcCols.join(", "),
+                                                                             wrapObjIfNeeded(table));
+    sqls << sql + ";";
+    addChunkedCopy(QString(), sql);
+}
+
+QString TableModifier::getRowIdName() const
+{
+    // Temporary copies of the table are created with CREATE TABLE AS SELECT, so they always have rowid
+    if (createTable->withOutRowId && table.compare(originalTable, Qt::CaseInsensitive) == 0)
+        return QString();
+
+    QStringList columns = createTable->getColumnNames();
+    for (const QString& name : {QStringLiteral("rowid"), QStringLiteral("_rowid_"), QStringLiteral("oid")})
+    {
+        if (indexOf(columns, name, Qt::CaseInsensitive) == -1)
+            return name;
+    }
+    return QString();
+}
+
+void TableModifier::addChunkedCopy(const QString& initSql, const QString& copySql)
+{
+    QString rowId = getRowIdName();
+    if (rowId.isNull())
+        return;
+
+    ChainExecutor::ChunkedQuery chunked;
+    chunked.table = wrapObjIfNeeded(table);
+    chunked.rowId = rowId;
+    chunked.initQuery = initSql;
+    chunked.chunkQuery = copySql + " WHERE " + rowId + " BETWEEN :chunkFrom AND :chunkTo;";
+    chunkedQueries[sqls.size() - 1] = chunked;
+}
+
+void TableModifier::removeSql(const QString& sql)
+{
+    int idx = sqls.indexOf(sql);
+    if (idx < 0)
+        return;
+
+    sqls.removeAt(idx);
+
+    // Chunked queries are registered by index of the statement, so ones registered after the removed one move up
+    QHash<int,ChainExecutor::ChunkedQuery> shiftedQueries;
+    for (auto it = chunkedQueries.cbegin(); it != chunkedQueries.cend(); ++it)
+    {
+        if (it.key() == idx)
+            continue;
+
+        shiftedQueries[it.key() > idx ? it.key() - 1 : it.key()] = it.value();
+    }
+    chunkedQueries = shiftedQueries;
+}
+
+QHash<int, ChainExecutor::ChunkedQuery> TableModifier::getChunkedQueries() const
+{
+    return chunkedQueries;
 }
 
 QStringList TableModifier::generateSqls() const
@@ -2,6 +2,7 @@
 #define TABLEMODIFIER_H
 
 #include "db/db.h"
+#include "db/chainexecutor.h"
 #include "selectresolver.h"
 #include "parser/ast/sqlitecreatetable.h"
 #include "parser/ast/sqliteupdate.h"
@@ -30,10 +31,41 @@ class API_EXPORT TableModifier
         QStringList getModifiedViews() const;
         bool hasMessages() const;
 
+        /**
+         * @brief Provides chunked variants of the data copying statements.
+         * @return Chunked queries by index of the statement in generateSqls() results.
+         *
+         * Statements copying whole tables can be executed in chunks by ChainExecutor::setChunkedQueries(),
+         * so the progress can be reported and execution can be interrupted between chunks.
+         * Copies from tables without rowid are not included.
+         */
+        QHash<int,ChainExecutor::ChunkedQuery> getChunkedQueries() const;
+
     private:
         void init();
         void parseDdl();
         QString getTempTableName();
+
+        /**
+         * @brief Provides name to refer to rowid of the table being copied.
+         * @return One of rowid, _rowid_ or oid, which is not used as a column name, or null string if there is no rowid to use.
+         */
+        QString getRowIdName() const;
+
+        /**
+         * @brief Registers the last statement as copying data from the current table in chunks.
+         * @param initSql Statement to execute before copying chunks (if any).
+         * @param copySql Statement copying all data (without WHERE clause), to be limited to a single chunk.
+         */
+        void addChunkedCopy(const QString& initSql, const QString& copySql);
+
+        /**
+         * @brief Removes the first occurrence of the statement from sqls.
+         * @param sql Statement to remove.
+         *
+         * Statements must not be removed from sqls directly, because indexes of chunked queries must follow them.
+         */
+        void removeSql(const QString& sql);
         void copyDataTo(const QString& targetTable, const QStringList& srcCols, const QStringList& dstCols);
         void renameTo(const QString& newName);
         QString renameToTemp();
@@ -148,6 +180,11 @@ class API_EXPORT TableModifier
          */
         QStringList sqls;
 
+        /**
+         * @brief Chunked variants of data copying statements, by index in sqls.
+         */
+        QHash<int,ChainExecutor::ChunkedQuery> chunkedQueries;
+
         QStringList warnings;
         QStringList errors;
 
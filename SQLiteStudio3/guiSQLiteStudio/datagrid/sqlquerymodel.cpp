@@ -24,6 +24,7 @@
 #include <QtMath>
 #include <QMessageBox>
 #include <QThread>
+#include <QSignalBlocker>
 
 QSet<SqlQueryModel*> SqlQueryModel::existingModels;
 
@@ -40,6 +41,11 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
     connect(notifyManager, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handlePossibleTableModification(Db*,QString,QString)));
     connect(notifyManager, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(handlePossibleTableRename(Db*,QString,QString,QString)));
 
+    // Connected before any view, so the pending rows are in sync by the time views handle these signals
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(insertPendingRows(QModelIndex,int,int)));
+    connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(removePendingRows(QModelIndex,int,int)));
+    connect(this, SIGNAL(modelReset()), this, SLOT(clearPendingRows()));
+
     setItemPrototype(new SqlQueryItem());
     existingModels << this;
 }
@@ -196,11 +202,15 @@ QList<SqlQueryModelColumnPtr> SqlQueryModel::getColumns()
 
 SqlQueryItem *SqlQueryModel::itemFromIndex(const QModelIndex &index) const
 {
+    if (index.isValid() && !index.parent().isValid())
+        loadPendingItem(index.row(), index.column());
+
     return dynamic_cast<SqlQueryItem*>(QStandardItemModel::itemFromIndex(index));
 }
 
 SqlQueryItem*SqlQueryModel::itemFromIndex(int row, int column) const
 {
+    loadPendingItem(row, column);
     return dynamic_cast<SqlQueryItem*>(item(row, column));
 }
 
@@ -959,16 +969,20 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
     rowNumBase = getCurrentPage() * rowsPerPage + 1;
 
     updateColumnHeaderLabels();
-    QList<QList<QStandardItem*>> rowList;
+    pendingColumnNames = results->getColumnNames();
+    pendingTypeColumns = queryExecutor->getTypeColumns();
+
+    // Only rows are kept here (columnar results keep them compact). Items are created for cells that get used.
+    QVector<SqlResultsRowPtr> rowList;
     while (results->hasNext() && rowIdx < rowsPerPage)
     {
         row = results->next();
         if (!row)
             break;
 
-        rowList << loadRow(row, results);
+        rowList << row;
 
-        if ((rowIdx % 50) == 0)
+        if ((rowIdx % 1000) == 0)
         {
             qApp->processEvents();
             if (!existingModels.contains(this))
@@ -984,33 +998,58 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
                              .arg(columnRatioBasedRowLimit).arg(columns.size()));
     }
 
-    rowIdx = 0;
-    for (const QList<QStandardItem*>& row : rowList)
-        insertRow(rowIdx++, row);
+    setRowCount(rowList.size());
+    pendingRows = rowList;
 
     allDataLoaded = true;
     return true;
 }
 
-QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row, SqlQueryPtr results)
+bool SqlQueryModel::isItemPending(int row, int column) const
 {
-    QStringList columnNames = results->getColumnNames();
-    BiStrHash typeColumnToResColumn = queryExecutor->getTypeColumns();
+    if (row < 0 || row >= pendingRows.size() || column < 0 || column >= resultColumnCount)
+        return false;
 
-    QList<QStandardItem*> itemList;
-    SqlQueryItem* item = nullptr;
-    RowId rowId;
-    int colIdx = 0;
-    for (const QVariant& value : row->valueList().mid(0, resultColumnCount))
-    {
-        item = new SqlQueryItem();
-        rowId = getRowIdValue(row, colIdx);
-        updateItem(item, value, colIdx, rowId, row, columnNames, typeColumnToResColumn);
-        itemList << item;
-        colIdx++;
-    }
+    const SqlResultsRowPtr& resultsRow = pendingRows[row];
+    return resultsRow && resultsRow->contains(column) && !item(row, column);
+}
 
-    return itemList;
+void SqlQueryModel::loadPendingItem(int row, int column) const
+{
+    if (!isItemPending(row, column))
+        return;
+
+    // Creating the item doesn't change the data of the model, it only changes the way it's stored
+    SqlQueryModel* self = const_cast<SqlQueryModel*>(this);
+    SqlResultsRowPtr resultsRow = pendingRows[row];
+    SqlQueryItem* item = new SqlQueryItem();
+    RowId rowId = self->getRowIdValue(resultsRow, column);
+    self->updateItem(item, resultsRow->value(column), column, rowId, resultsRow, pendingColumnNames, pendingTypeColumns);
+
+    // Setting the item emits layout change signals, which must not reach views (it's often called while they paint)
+    QSignalBlocker blocker(self);
+    self->setItem(row, column, item);
+}
+
+void SqlQueryModel::insertPendingRows(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid() || first > pendingRows.size())
+        return;
+
+    pendingRows.insert(first, last - first + 1, SqlResultsRowPtr());
+}
+
+void SqlQueryModel::removePendingRows(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid() || first >= pendingRows.size())
+        return;
+
+    pendingRows.remove(first, qMin(last, pendingRows.size() - 1) - first + 1);
+}
+
+void SqlQueryModel::clearPendingRows()
+{
+    pendingRows.clear();
 }
 
 RowId SqlQueryModel::getRowIdValue(SqlResultsRowPtr row, int columnIdx)
@@ -1218,11 +1257,12 @@ bool SqlQueryModel::readColumns()
     tablesForColumns = getTablesForColumns();
     columnEditionStatus = getColumnEditionEnabledList();
 
-    // Rows limit to avoid out of memory problems
+    // Rows limit to avoid out of memory problems. Cells don't get items until they're used,
+    // so only the loaded rows and a pointer per cell count here.
     columnRatioBasedRowLimit = -1;
     int rowsPerPage = getRowsPerPage();
     if (!columns.isEmpty() && CFG_UI.General.LimitRowsForManyColumns.get())
-        columnRatioBasedRowLimit = 50000 / columns.size();
+        columnRatioBasedRowLimit = 5000000 / columns.size();
 
     bool rowsLimited = (columnRatioBasedRowLimit > -1 && columnRatioBasedRowLimit < rowsPerPage);
 
@@ -2040,6 +2080,43 @@ void SqlQueryModel::resetFilter()
     // For custom query this is not supported.
 }
 
+QVariant SqlQueryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.parent().isValid() && isItemPending(index.row(), index.column()))
+    {
+        switch (role)
+        {
+            // These are checked for all cells when looking for modified ones.
+            // Cell that has no item yet was not touched since it was loaded, so there's no need to create the item.
+            case SqlQueryItem::DataRole::UNCOMMITTED:
+            case SqlQueryItem::DataRole::NEW_ROW:
+            case SqlQueryItem::DataRole::DELETED:
+                return false;
+            default:
+                loadPendingItem(index.row(), index.column());
+                break;
+        }
+    }
+
+    return QStandardItemModel::data(index, role);
+}
+
+bool SqlQueryModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (index.isValid() && !index.parent().isValid())
+        loadPendingItem(index.row(), index.column());
+
+    return QStandardItemModel::setData(index, value, role);
+}
+
+Qt::ItemFlags SqlQueryModel::flags(const QModelIndex& index) const
+{
+    if (index.isValid() && !index.parent().isValid())
+        loadPendingItem(index.row(), index.column());
+
+    return QStandardItemModel::flags(index);
+}
+
 int SqlQueryModel::columnCount(const QModelIndex& parent) const
 {
     UNUSED(parent);
@@ -62,6 +62,9 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QList<SqlQueryItem*> getRow(int row);
         int columnCount(const QModelIndex& parent = QModelIndex()) const;
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+        QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+        bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
+        Qt::ItemFlags flags(const QModelIndex& index) const;
         bool isExecutionInProgress() const;
         StrHash<QString> attachDependencyTables();
         void detachDependencyTables();
@@ -337,7 +340,24 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         bool loadData(SqlQueryPtr results);
 
-        QList<QStandardItem*> loadRow(SqlResultsRowPtr row, SqlQueryPtr results);
+        /**
+         * @brief Tells if the cell has loaded value, but the item for it was not created yet.
+         * @param row Row of the cell.
+         * @param column Column of the cell.
+         * @return true if the item can be created with loadPendingItem().
+         */
+        bool isItemPending(int row, int column) const;
+
+        /**
+         * @brief Creates item for the cell from its row of results, if it was not created yet.
+         * @param row Row of the cell.
+         * @param column Column of the cell.
+         *
+         * It's called whenever the cell is accessed by a view or by the code working with items,
+         * so only cells that were displayed or used get their items.
+         */
+        void loadPendingItem(int row, int column) const;
+
         RowId getRowIdValue(SqlResultsRowPtr row, int columnIdx);
         bool readColumns();
         void readColumnDetails();
@@ -464,6 +484,25 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
 
         int resultColumnCount = 0;
 
+        /**
+         * @brief Rows of results loaded for the current page, by model row.
+         *
+         * Items of cells are not created when the page is loaded. They're created from these rows
+         * when cells are accessed (see loadPendingItem()). Rows added by the user, or rows beyond the list
+         * have null entries. The list follows rows inserted and removed from the model.
+         */
+        QVector<SqlResultsRowPtr> pendingRows;
+
+        /**
+         * @brief Result column names of the current page, used to create pending items.
+         */
+        QStringList pendingColumnNames;
+
+        /**
+         * @brief Type columns of the current page (see QueryExecutor::getTypeColumns()), used to create pending items.
+         */
+        BiStrHash pendingTypeColumns;
+
         /**
          * @brief tablesForColumns
          * List of tables associated to \link #columns by order index.
@@ -492,6 +531,9 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         static QSet<SqlQueryModel*> existingModels;
 
     private slots:
+        void insertPendingRows(const QModelIndex& parent, int first, int last);
+        void removePendingRows(const QModelIndex& parent, int first, int last);
+        void clearPendingRows();
         void handleExecFinished(SqlQueryPtr results);
         void handleExecFailed(int code, QString errorMessage);
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
@@ -12,6 +12,8 @@
 SqlTableModel::SqlTableModel(QObject *parent) :
     SqlDataSourceQueryModel(parent)
 {
+    // Table data is usually browsed page by page, so let the next page be seeked by ROWID.
+    queryExecutor->setKeysetPaging(true);
 }
 
 QString SqlTableModel::getTable() const
@@ -29,6 +29,7 @@
 #include "querygenerator.h"
 #include "dialogs/execfromfiledialog.h"
 #include "dialogs/fileexecerrorsdialog.h"
+#include "db/sqlscriptexecutor.h"
 #include "common/compatibility.h"
 #include <QApplication>
 #include <QClipboard>
@@ -96,8 +97,8 @@ void DbTree::init()
 
         if (this->executingQueriesFromFileDb) // should always be there, but just in case
         {
+            // Executor rolls back the transaction once the current query is interrupted
             this->executingQueriesFromFileDb->interrupt();
-            this->executingQueriesFromFileDb->rollback();
             this->executingQueriesFromFileDb = nullptr;
             notifyWarn(tr("Execution from file cancelled. Any queries executed so far have been rolled back."));
         }
@@ -1745,7 +1746,7 @@ void DbTree::deleteItems(const QList<DbTreeItem*>& itemsToDelete)
 void DbTree::refreshSchemas()
 {
     for (Db* db : DBLIST->getDbList())
-        treeModel->refreshSchema(db);
+        treeModel->refreshSchemaAsync(db);
 
     updateActionsForCurrent();
 }
@@ -1882,21 +1883,16 @@ void DbTree::execSqlFromFile()
     executingQueriesFromFileDb = db;
     fileExecWidgetCover->setProgress(0);
     fileExecWidgetCover->show();
-    if (!db->begin())
-    {
-        notifyError(tr("Could not execute SQL, because application has failed to start transaction: %1").arg(db->getErrorText()));
-        fileExecWidgetCover->hide();
-        return;
-    }
 
-    QtConcurrent::run(this, &DbTree::execFromFileAsync, dialog.filePath(), db, dialog.ignoreErrors(), dialog.codec());
+    QtConcurrent::run(this, &DbTree::execFromFileAsync, dialog.filePath(), db, dialog.ignoreErrors(), dialog.commitInterval(),
+                      dialog.codec());
 }
 
-void DbTree::execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, const QString& codec)
+void DbTree::execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, int commitInterval, const QString& codec)
 {
     // Open file
     QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         notifyError(tr("Could not open file '%1' for reading: %2").arg(path).arg(file.errorString()));
         executingQueriesFromFile = 0;
@@ -1904,24 +1900,27 @@ void DbTree::execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, c
         return;
     }
 
-
-    QTextStream stream(&file);
-    stream.setCodec(codec.toLatin1().constData());
-
-    qint64 fileSize = file.size();
-    int attemptedExecutions = 0;
-    int executed = 0;
-    bool ok = true;
+    SqlScriptExecutor executor(db);
+    executor.setIgnoreErrors(ignoreErrors);
+    executor.setCommitInterval(commitInterval);
+    connect(&executor, &SqlScriptExecutor::progress, [this](qint64 bytesProcessed, qint64 bytesTotal)
+    {
+        if (bytesTotal > 0)
+            emit updateFileExecProgress(static_cast<int>(100 * bytesProcessed / bytesTotal));
+    });
 
     QElapsedTimer timer;
     timer.start();
-    QList<QPair<QString, QString>> errors = executeFileQueries(db, stream, executed, attemptedExecutions, ok, ignoreErrors, fileSize);
+    bool ok = executor.exec(&file, codec, [this]() -> bool
+    {
+        return !executingQueriesFromFile.loadAcquire();
+    });
     int millis = timer.elapsed();
     if (executingQueriesFromFile.loadAcquire())
     {
-        handleFileQueryExecution(db, executed, attemptedExecutions, ok, ignoreErrors, millis);
-        if (!errors.isEmpty())
-            emit fileExecErrors(errors, !ok && !ignoreErrors);
+        handleFileQueryExecution(db, executor, ok, millis);
+        if (!executor.getErrors().isEmpty())
+            emit fileExecErrors(executor.getErrors(), !ignoreErrors);
     }
 
     file.close();
@@ -1929,103 +1928,31 @@ void DbTree::execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, c
     executingQueriesFromFile = 0;
 }
 
-QList<QPair<QString, QString>> DbTree::executeFileQueries(Db* db, QTextStream& stream, int& executed, int& attemptedExecutions, bool& ok, bool ignoreErrors, qint64 fileSize)
+void DbTree::handleFileQueryExecution(Db* db, const SqlScriptExecutor& executor, bool ok, int millis)
 {
-    QList<QPair<QString, QString>> errors;
-    qint64 pos = 0;
-    QChar c;
-    QString sql;
-    sql.reserve(10000);
-    SqlQueryPtr results;
-    while (!stream.atEnd() && executingQueriesFromFile.loadAcquire())
+    int executed = executor.getExecutedCount();
+    if (!executor.getErrorText().isEmpty())
     {
-        while (!db->isComplete(sql) && !stream.atEnd())
-        {
-            stream >> c;
-            sql.append(c);
-            while (c != ';' && !stream.atEnd())
-            {
-                stream >> c;
-                sql.append(c);
-            }
-        }
-
-        if (shouldSkipQueryFromFileExecution(sql))
-        {
-            sql.clear();;
-            continue;
-        }
-
-        results = db->exec(sql);
-        attemptedExecutions++;
-        if (results->isError())
-        {
-            ok = false;
-            errors << QPair<QString, QString>(sql, results->getErrorText());
-
-            if (!ignoreErrors)
-                break;
-        }
-        else
-            executed++;
-
-        sql.clear();
-        if (attemptedExecutions % 100 == 0)
-        {
-            pos = stream.device()->pos();
-            emit updateFileExecProgress(static_cast<int>(100 * pos / fileSize));
-        }
+        notifyError(tr("Could not execute SQL: %1").arg(executor.getErrorText()));
     }
-    return errors;
-}
-
-bool DbTree::shouldSkipQueryFromFileExecution(const QString& sql)
-{
-    if (sql.trimmed().isEmpty())
-        return true;
-
-    QString upper = sql.toUpper().trimmed().split("\n").last().trimmed();
-    return (upper.startsWith("BEGIN") ||
-            upper.startsWith("COMMIT") ||
-            upper.startsWith("ROLLBACK") ||
-            upper.startsWith("END"));
-}
-
-void DbTree::handleFileQueryExecution(Db* db, int executed, int attemptedExecutions, bool ok, bool ignoreErrors, int millis)
-{
-    bool doCommit = ok ? true : ignoreErrors;
-    if (doCommit)
+    else if (ok && executor.getErrors().isEmpty())
     {
-        if (!db->commit())
-        {
-            notifyError(tr("Could not execute SQL, because application has failed to commit the transaction: %1").arg(db->getErrorText()));
-            db->rollback();
-        }
-        else if (!ok) // committed with errors
-        {
-            notifyInfo(tr("Finished executing %1 queries in %2 seconds. %3 were not executed due to errors.")
-                       .arg(executed).arg(millis / 1000.0).arg(attemptedExecutions - executed));
+        notifyInfo(tr("Finished executing %1 queries in %2 seconds.").arg(executed).arg(millis / 1000.0));
+        emit schemaNeedsRefreshing(db);
+    }
+    else if (ok && executor.getIgnoreErrors()) // committed with errors
+    {
+        notifyInfo(tr("Finished executing %1 queries in %2 seconds. %3 were not executed due to errors.")
+                   .arg(executed).arg(millis / 1000.0).arg(executor.getAttemptedCount() - executed));
 
-            emit schemaNeedsRefreshing(db);
-        }
-        else
-        {
-            notifyInfo(tr("Finished executing %1 queries in %2 seconds.").arg(executed).arg(millis / 1000.0));
-            emit schemaNeedsRefreshing(db);
-        }
+        emit schemaNeedsRefreshing(db);
     }
     else
     {
-        db->rollback();
         notifyError(tr("Could not execute SQL due to error."));
     }
 }
 
-bool DbTree::execQueryFromFile(Db* db, const QString& sql)
-{
-    return !db->exec(sql)->isError();
-}
-
 void DbTree::setupDefShortcuts()
 {
     setShortcutContext({
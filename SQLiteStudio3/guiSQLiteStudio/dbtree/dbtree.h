@@ -20,6 +20,7 @@ class TableWindow;
 class ViewWindow;
 class UserInputFilter;
 class DbTreeView;
+class SqlScriptExecutor;
 
 namespace Ui {
     class DbTree;
@@ -151,11 +152,8 @@ class GUI_API_EXPORT DbTree : public QDockWidget, public ExtActionContainer
         QString getSelectedViewName() const;
         QList<DbTreeItem*> getSelectedItems(DbTreeItem::Type itemType);
         QList<DbTreeItem*> getSelectedItems(ItemFilterFunc filterFunc = nullptr);
-        void execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, const QString& codec);
-        bool execQueryFromFile(Db* db, const QString& sql);
-        void handleFileQueryExecution(Db* db, int executed, int attemptedExecutions, bool ok, bool ignoreErrors, int millis);
-        QList<QPair<QString, QString>> executeFileQueries(Db* db, QTextStream& stream, int& executed, int& attemptedExecutions, bool& ok, bool ignoreErrors, qint64 fileSize);
-        bool shouldSkipQueryFromFileExecution(const QString& sql);
+        void execFromFileAsync(const QString& path, Db* db, bool ignoreErrors, int commitInterval, const QString& codec);
+        void handleFileQueryExecution(Db* db, const SqlScriptExecutor& executor, bool ok, int millis);
 
         static bool areDbTreeItemsValidForItem(QList<DbTreeItem*> srcItems, const DbTreeItem* dstItem, bool forPasting = false);
         static bool areUrlsValidForItem(const QList<QUrl>& srcUrls, const DbTreeItem* dstItem);
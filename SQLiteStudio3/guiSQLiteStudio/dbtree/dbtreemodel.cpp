@@ -24,6 +24,8 @@
 #include <QCheckBox>
 #include <QWidgetAction>
 #include <QClipboard>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 const QString DbTreeModel::toolTipTableTmp = "<table>%1</table>";
 const QString DbTreeModel::toolTipHdrRowTmp = "<tr><th><img src=\"%1\"/></th><th colspan=2>%2</th></tr>";
@@ -34,6 +36,7 @@ DbTreeModel::DbTreeModel()
 {
     setItemPrototype(DbTreeItemFactory::createPrototype());
     connectDbManagerSignals();
+    schemaLoadPool.setMaxThreadCount(2);
 
     connect(CFG, SIGNAL(massSaveBegins()), this, SLOT(massSaveBegins()));
     connect(CFG, SIGNAL(massSaveCommitted()), this, SLOT(massSaveCommitted()));
@@ -47,6 +50,8 @@ DbTreeModel::DbTreeModel()
 
 DbTreeModel::~DbTreeModel()
 {
+    for (Db* db : schemaLoadFutures.keys())
+        waitForSchemaLoading(db);
 }
 
 void DbTreeModel::connectDbManagerSignals()
@@ -55,6 +60,7 @@ void DbTreeModel::connectDbManagerSignals()
     connect(DBLIST, SIGNAL(dbUpdated(QString,Db*)), this, SLOT(dbUpdated(QString,Db*)));
     connect(DBLIST, SIGNAL(dbRemoved(Db*)), this, SLOT(dbRemoved(Db*)));
     connect(DBLIST, SIGNAL(dbConnected(Db*)), this, SLOT(dbConnected(Db*)));
+    connect(DBLIST, SIGNAL(dbAboutToBeDisconnected(Db*,bool&)), this, SLOT(dbAboutToBeDisconnected(Db*,bool&)));
     connect(DBLIST, SIGNAL(dbDisconnected(Db*)), this, SLOT(dbDisconnected(Db*)));
     connect(DBLIST, SIGNAL(dbLoaded(Db*)), this, SLOT(dbLoaded(Db*)));
     connect(DBLIST, SIGNAL(dbUnloaded(Db*)), this, SLOT(dbUnloaded(Db*)));
@@ -280,8 +286,22 @@ void DbTreeModel::expanded(const QModelIndex &index)
         return;
     }
 
-    if (dynamic_cast<DbTreeItem*>(item)->getType() == DbTreeItem::Type::DIR)
-        itemFromIndex(index)->setIcon(ICONS.DIRECTORY_OPEN);
+    DbTreeItem* dbTreeItem = dynamic_cast<DbTreeItem*>(item);
+    switch (dbTreeItem->getType())
+    {
+        case DbTreeItem::Type::DIR:
+            item->setIcon(ICONS.DIRECTORY_OPEN);
+            break;
+        case DbTreeItem::Type::TABLE:
+        case DbTreeItem::Type::VIRTUAL_TABLE:
+            // Columns are loaded when the table is expanded for the first time
+            if (CFG_UI.General.LoadColumnsOnExpand.get() && item->child(0) && !item->child(0)->hasChildren())
+                loadTableColumns(dbTreeItem);
+
+            break;
+        default:
+            break;
+    }
 }
 
 void DbTreeModel::collapsed(const QModelIndex &index)
@@ -314,6 +334,7 @@ void DbTreeModel::dbUpdated(const QString& oldName, Db* db)
 
 void DbTreeModel::dbRemoved(Db* db)
 {
+    waitForSchemaLoading(db);
     dbRemoved(db->getName());
 }
 
@@ -467,9 +488,13 @@ QString DbTreeModel::getTableToolTip(DbTreeItem* item) const
     for (int i = 0; i < triggersCount; i++)
         triggers << triggersItem->child(i)->text();
 
-    rows << toolTipIconRowTmp.arg(ICONS.COLUMN.getPath())
-                             .arg(tr("Columns (%1):", "dbtree tooltip").arg(columnCnt))
-                             .arg(columns.join(", "));
+    // Columns might not be loaded yet, if they're loaded on demand
+    if (columnCnt > 0)
+    {
+        rows << toolTipIconRowTmp.arg(ICONS.COLUMN.getPath())
+                                 .arg(tr("Columns (%1):", "dbtree tooltip").arg(columnCnt))
+                                 .arg(columns.join(", "));
+    }
     rows << toolTipIconRowTmp.arg(ICONS.INDEX.getPath())
                              .arg(tr("Indexes (%1):", "dbtree tooltip").arg(indexesCount))
                              .arg(indexes.join(", "));
@@ -485,36 +510,108 @@ void DbTreeModel::refreshSchema(Db* db, QStandardItem *item)
     if (!db->isOpen())
         return;
 
-    // Remember expanded state of this branch
-    QHash<QString, bool> expandedState;
-    collectExpandedState(expandedState, item);
+    // Results of any asynchronous refresh started before are outdated now
+    schemaLoadGeneration[db] = ++schemaLoadCounter;
 
-    // Delete child nodes
-    while (item->rowCount() > 0)
-        item->removeRow(0);
+    SchemaSnapshotPtr snapshot = loadSchemaSnapshot(db, getSchemaLoadOptions());
+    applySchemaSnapshot(item, db, *snapshot);
+}
+
+void DbTreeModel::refreshSchemaAsync(Db* db, bool expandItem)
+{
+    if (!db->isOpen())
+        return;
+
+    quint64 generation = ++schemaLoadCounter;
+    schemaLoadGeneration[db] = generation;
+
+    QFuture<SchemaSnapshotPtr> future = QtConcurrent::run(&schemaLoadPool, &DbTreeModel::loadSchemaSnapshot, db, getSchemaLoadOptions());
+    schemaLoadFutures[db] << future;
+
+    QFutureWatcher<SchemaSnapshotPtr>* watcher = new QFutureWatcher<SchemaSnapshotPtr>(this);
+    connect(watcher, &QFutureWatcher<SchemaSnapshotPtr>::finished, this, [this, watcher, db, generation, expandItem]()
+    {
+        watcher->deleteLater();
+        if (!schemaLoadFutures.contains(db))
+            return; // db was removed in the meantime
+
+        schemaLoadFutures[db].removeOne(watcher->future());
+        applySchemaSnapshotFinished(db, generation, watcher->result(), expandItem);
+    });
+    watcher->setFuture(future);
+}
+
+DbTreeModel::SchemaSnapshotPtr DbTreeModel::loadSchemaSnapshot(Db* db, const SchemaLoadOptions& options)
+{
+    QSharedPointer<SchemaSnapshot> snapshot = QSharedPointer<SchemaSnapshot>::create();
+    snapshot->withColumns = options.withColumns;
+    if (!db->isOpen())
+        return snapshot;
 
-    // Now prepare to create new branch
     SchemaResolver resolver(db);
-    resolver.setIgnoreSystemObjects(!CFG_UI.General.ShowSystemObjects.get());
+    resolver.setIgnoreSystemObjects(options.ignoreSystemObjects);
 
-    // Collect all db objects and build the db branch
-    bool sort = CFG_UI.General.SortObjects.get();
-    QStringList tables = resolver.getTables();
-    QStringList virtualTables;
-    for (const QString& table : tables)
+    snapshot->tables = resolver.getTables();
+    for (const QString& table : snapshot->tables)
     {
         if (resolver.isVirtualTable(table))
-            virtualTables << table;
+            snapshot->virtualTables << table;
     }
 
-    QList<QStandardItem*> tableItems = refreshSchemaTables(tables, virtualTables, sort);
-    StrHash<QList<QStandardItem*>> allTableColumns = refreshSchemaTableColumns(resolver.getAllTableColumns());
-    StrHash<QList<QStandardItem*>> indexItems = refreshSchemaIndexes(resolver.getGroupedIndexes(), sort);
-    StrHash<QList<QStandardItem*>> triggerItems = refreshSchemaTriggers(resolver.getGroupedTriggers(), sort);
-    QList<QStandardItem*> viewItems = refreshSchemaViews(resolver.getViews(), sort);
-    refreshSchemaBuild(item, tableItems, indexItems, triggerItems, viewItems, allTableColumns);
-    populateChildItemsWithDb(item, db);
-    restoreExpandedState(expandedState, item);
+    if (options.withColumns)
+        snapshot->columns = resolver.getAllTableColumns();
+
+    snapshot->indexes = resolver.getGroupedIndexes();
+    snapshot->triggers = resolver.getGroupedTriggers();
+    snapshot->views = resolver.getViews();
+
+    if (options.sortObjects)
+    {
+        snapshot->tables.sort(Qt::CaseInsensitive);
+        snapshot->views.sort(Qt::CaseInsensitive);
+        for (const QString& key : snapshot->indexes.keys())
+            snapshot->indexes[key].sort(Qt::CaseInsensitive);
+
+        for (const QString& key : snapshot->triggers.keys())
+            snapshot->triggers[key].sort(Qt::CaseInsensitive);
+    }
+
+    if (options.sortColumns)
+    {
+        for (const QString& key : snapshot->columns.keys())
+            ::sSort(snapshot->columns[key]);
+    }
+
+    return snapshot;
+}
+
+DbTreeModel::SchemaLoadOptions DbTreeModel::getSchemaLoadOptions()
+{
+    SchemaLoadOptions options;
+    options.ignoreSystemObjects = !CFG_UI.General.ShowSystemObjects.get();
+    options.sortObjects = CFG_UI.General.SortObjects.get();
+    options.sortColumns = CFG_UI.General.SortColumns.get();
+    options.withColumns = !CFG_UI.General.LoadColumnsOnExpand.get();
+    return options;
+}
+
+void DbTreeModel::applySchemaSnapshotFinished(Db* db, quint64 generation, const SchemaSnapshotPtr& snapshot, bool expandItem)
+{
+    // Another refresh was requested in the meantime, or the database was disconnected
+    if (schemaLoadGeneration.value(db) != generation || !db->isOpen())
+        return;
+
+    QStandardItem* item = findItem(DbTreeItem::Type::DB, db);
+    if (!item)
+    {
+        qWarning() << "Loaded schema of db that couldn't be found in the model:" << db->getName();
+        return;
+    }
+
+    applySchemaSnapshot(item, db, *snapshot);
+    applyFilter(item, currentFilter);
+    if (expandItem)
+        expandDbItem(item);
 }
 
 void DbTreeModel::collectExpandedState(QHash<QString, bool> &state, QStandardItem *parentItem)
@@ -530,143 +627,190 @@ void DbTreeModel::collectExpandedState(QHash<QString, bool> &state, QStandardIte
         collectExpandedState(state, parentItem->child(i));
 }
 
-QList<QStandardItem *> DbTreeModel::refreshSchemaTables(const QStringList &tables, const QStringList& virtualTables, bool sort)
+void DbTreeModel::applySchemaSnapshot(QStandardItem* dbItem, Db* db, const SchemaSnapshot& snapshot)
 {
-    QStringList sortedTables = tables;
-    if (sort)
-        sortedTables.sort(Qt::CaseInsensitive);
+    // Remember expanded state of this branch
+    QHash<QString, bool> expandedState;
+    collectExpandedState(expandedState, dbItem);
+
+    // Whole difference is applied at once, the view is repainted only after that
+    treeView->setUpdatesEnabled(false);
 
-    QList<QStandardItem *> items;
-    for (const QString& table : sortedTables)
+    DbTreeItem* tablesItem = syncSchemaDir(dbItem, 0, DbTreeItem::Type::TABLES, db);
+    DbTreeItem* viewsItem = syncSchemaDir(dbItem, 1, DbTreeItem::Type::VIEWS, db);
+
+    QList<SchemaEntry> tableEntries;
+    for (const QString& table : snapshot.tables)
     {
-        if (virtualTables.contains(table))
-            items += DbTreeItemFactory::createVirtualTable(table, this);
-        else
-            items += DbTreeItemFactory::createTable(table, this);
+        DbTreeItem::Type type = snapshot.virtualTables.contains(table) ? DbTreeItem::Type::VIRTUAL_TABLE : DbTreeItem::Type::TABLE;
+        tableEntries << SchemaEntry(type, table);
     }
 
-    return items;
-}
-
-StrHash<QList<QStandardItem*>> DbTreeModel::refreshSchemaTableColumns(const StrHash<QStringList> &columns)
-{
-    QStringList sortedColumns;
-    bool doSort = CFG_UI.General.SortColumns.get();
-    StrHash<QList<QStandardItem*>> items;
-    for (const QString& key : columns.keys())
+    DbTreeItem* columnsItem = nullptr;
+    DbTreeItem* indexesItem = nullptr;
+    DbTreeItem* triggersItem = nullptr;
+    QString table;
+    for (DbTreeItem* tableItem : syncSchemaItems(tablesItem, tableEntries, db))
     {
-        sortedColumns = columns[key];
-        if (doSort)
-            ::sSort(sortedColumns);
+        table = tableItem->text();
+        columnsItem = syncSchemaDir(tableItem, 0, DbTreeItem::Type::COLUMNS, db);
+        indexesItem = syncSchemaDir(tableItem, 1, DbTreeItem::Type::INDEXES, db);
+        triggersItem = syncSchemaDir(tableItem, 2, DbTreeItem::Type::TRIGGERS, db);
+
+        if (snapshot.withColumns)
+            syncSchemaItems(columnsItem, toSchemaEntries(DbTreeItem::Type::COLUMN, snapshot.columns[table]), db);
+        else if (expandedState.value(tableItem->signature()))
+            loadTableColumns(tableItem);
+        else
+            columnsItem->removeRows(0, columnsItem->rowCount());
 
-        for (const QString& column : sortedColumns)
-            items[key] += DbTreeItemFactory::createColumn(column, this);
+        syncSchemaItems(indexesItem, toSchemaEntries(DbTreeItem::Type::INDEX, snapshot.indexes[table]), db);
+        syncSchemaItems(triggersItem, toSchemaEntries(DbTreeItem::Type::TRIGGER, snapshot.triggers[table]), db);
     }
-    return items;
-}
 
-StrHash<QList<QStandardItem *> > DbTreeModel::refreshSchemaIndexes(const StrHash<QStringList> &indexes, bool sort)
-{
-    StrHash<QList<QStandardItem *> > items;
-    QStringList sortedIndexes;
-    for (const QString& key : indexes.keys())
+    for (DbTreeItem* viewItem : syncSchemaItems(viewsItem, toSchemaEntries(DbTreeItem::Type::VIEW, snapshot.views), db))
     {
-        sortedIndexes = indexes[key];
-        if (sort)
-            sortedIndexes.sort(Qt::CaseInsensitive);
-
-        for (const QString& index : sortedIndexes)
-            items[key] += DbTreeItemFactory::createIndex(index, this);
+        triggersItem = syncSchemaDir(viewItem, 0, DbTreeItem::Type::TRIGGERS, db);
+        syncSchemaItems(triggersItem, toSchemaEntries(DbTreeItem::Type::TRIGGER, snapshot.triggers[viewItem->text()]), db);
     }
-    return items;
+
+    restoreExpandedState(expandedState, dbItem);
+    treeView->setUpdatesEnabled(true);
 }
 
-StrHash<QList<QStandardItem*>> DbTreeModel::refreshSchemaTriggers(const StrHash<QStringList> &triggers, bool sort)
+QList<DbTreeItem*> DbTreeModel::syncSchemaItems(QStandardItem* parentItem, const QList<SchemaEntry>& entries, Db* db)
 {
-    StrHash<QList<QStandardItem*>> items;
-    QStringList sortedTriggers;
-    for (const QString& key : triggers.keys())
+    static_qstring(keyTpl, "%1:%2");
+
+    QSet<QString> expectedKeys;
+    for (const SchemaEntry& entry : entries)
+        expectedKeys << keyTpl.arg(static_cast<int>(entry.first)).arg(entry.second);
+
+    // Drop items of objects that no longer exist, remember the rest
+    QHash<QString, DbTreeItem*> existingItems;
+    DbTreeItem* item = nullptr;
+    QString key;
+    for (int i = parentItem->rowCount() - 1; i >= 0; i--)
     {
-        sortedTriggers = triggers[key];
-        if (sort)
-            sortedTriggers.sort(Qt::CaseInsensitive);
+        item = dynamic_cast<DbTreeItem*>(parentItem->child(i));
+        key = keyTpl.arg(static_cast<int>(item->getType())).arg(item->text());
+        if (expectedKeys.contains(key) && !existingItems.contains(key))
+            existingItems[key] = item;
+        else
+            parentItem->removeRow(i);
+    }
 
-        for (const QString& trigger : sortedTriggers)
-            items[key] += DbTreeItemFactory::createTrigger(trigger, this);
+    // Put existing items in the expected order and create missing ones
+    QList<DbTreeItem*> items;
+    for (int row = 0; row < entries.size(); row++)
+    {
+        const SchemaEntry& entry = entries[row];
+        item = existingItems.value(keyTpl.arg(static_cast<int>(entry.first)).arg(entry.second));
+        if (!item)
+        {
+            item = createSchemaItem(entry.first, entry.second);
+            item->setDb(db);
+            parentItem->insertRow(row, item);
+        }
+        else if (item->row() != row)
+        {
+            parentItem->insertRow(row, parentItem->takeRow(item->row()));
+        }
+        items << item;
     }
     return items;
 }
 
-QList<QStandardItem *> DbTreeModel::refreshSchemaViews(const QStringList &views, bool sort)
+DbTreeItem* DbTreeModel::syncSchemaDir(QStandardItem* parentItem, int row, DbTreeItem::Type type, Db* db)
 {
-    QStringList sortedViews = views;
-    if (sort)
-        sortedViews.sort(Qt::CaseInsensitive);
+    DbTreeItem* item = dynamic_cast<DbTreeItem*>(parentItem->child(row));
+    if (item && item->getType() == type)
+        return item;
 
-    QList<QStandardItem *> items;
-    for (const QString& view : sortedViews)
-        items += DbTreeItemFactory::createView(view, this);
+    // Directories have fixed positions, so anything else at this place is out of date
+    if (parentItem->rowCount() > row)
+        parentItem->removeRows(row, parentItem->rowCount() - row);
 
-    return items;
+    item = createSchemaItem(type, QString());
+    item->setDb(db);
+    parentItem->appendRow(item);
+    return item;
 }
 
-void DbTreeModel::populateChildItemsWithDb(QStandardItem *parentItem, Db* db)
+DbTreeItem* DbTreeModel::createSchemaItem(DbTreeItem::Type type, const QString& name)
 {
-    QStandardItem* childItem = nullptr;
-    for (int i = 0; i < parentItem->rowCount(); i++)
+    switch (type)
     {
-        childItem = parentItem->child(i);
-        dynamic_cast<DbTreeItem*>(childItem)->setDb(db);
-        populateChildItemsWithDb(childItem, db);
+        case DbTreeItem::Type::TABLES:
+            return DbTreeItemFactory::createTables(this);
+        case DbTreeItem::Type::VIEWS:
+            return DbTreeItemFactory::createViews(this);
+        case DbTreeItem::Type::COLUMNS:
+            return DbTreeItemFactory::createColumns(this);
+        case DbTreeItem::Type::INDEXES:
+            return DbTreeItemFactory::createIndexes(this);
+        case DbTreeItem::Type::TRIGGERS:
+            return DbTreeItemFactory::createTriggers(this);
+        case DbTreeItem::Type::TABLE:
+            return DbTreeItemFactory::createTable(name, this);
+        case DbTreeItem::Type::VIRTUAL_TABLE:
+            return DbTreeItemFactory::createVirtualTable(name, this);
+        case DbTreeItem::Type::INDEX:
+            return DbTreeItemFactory::createIndex(name, this);
+        case DbTreeItem::Type::TRIGGER:
+            return DbTreeItemFactory::createTrigger(name, this);
+        case DbTreeItem::Type::VIEW:
+            return DbTreeItemFactory::createView(name, this);
+        case DbTreeItem::Type::COLUMN:
+            return DbTreeItemFactory::createColumn(name, this);
+        default:
+            break;
     }
+    qCritical() << "Unsupported schema item type in DbTreeModel::createSchemaItem():" << static_cast<int>(type);
+    return DbTreeItemFactory::createDir(name, this);
 }
 
-void DbTreeModel::refreshSchemaBuild(QStandardItem *dbItem,
-                                     QList<QStandardItem*> tables,
-                                     StrHash<QList<QStandardItem*> > indexes,
-                                     StrHash<QList<QStandardItem*> > triggers,
-                                     QList<QStandardItem*> views,
-                                     StrHash<QList<QStandardItem*> > allTableColumns)
+QList<DbTreeModel::SchemaEntry> DbTreeModel::toSchemaEntries(DbTreeItem::Type type, const QStringList& names)
 {
-    DbTreeItem* tablesItem = DbTreeItemFactory::createTables(this);
-    DbTreeItem* viewsItem = DbTreeItemFactory::createViews(this);
+    QList<SchemaEntry> entries;
+    for (const QString& name : names)
+        entries << SchemaEntry(type, name);
 
-    dbItem->appendRow(tablesItem);
-    dbItem->appendRow(viewsItem);
+    return entries;
+}
 
-    DbTreeItem* columnsItem = nullptr;
-    DbTreeItem* indexesItem = nullptr;
-    DbTreeItem* triggersItem = nullptr;
-    for (QStandardItem* tableItem : tables)
-    {
-        tablesItem->appendRow(tableItem);
+void DbTreeModel::loadTableColumns(DbTreeItem* tableItem)
+{
+    Db* db = tableItem->getDb();
+    DbTreeItem* columnsItem = dynamic_cast<DbTreeItem*>(tableItem->child(0));
+    if (!db || !db->isOpen() || !columnsItem || columnsItem->getType() != DbTreeItem::Type::COLUMNS)
+        return;
 
-        columnsItem = DbTreeItemFactory::createColumns(this);
-        indexesItem = DbTreeItemFactory::createIndexes(this);
-        triggersItem = DbTreeItemFactory::createTriggers(this);
+    SchemaResolver resolver(db);
+    QStringList columns = resolver.getTableColumns(tableItem->text());
+    if (CFG_UI.General.SortColumns.get())
+        ::sSort(columns);
 
-        tableItem->appendRow(columnsItem);
-        tableItem->appendRow(indexesItem);
-        tableItem->appendRow(triggersItem);
+    syncSchemaItems(columnsItem, toSchemaEntries(DbTreeItem::Type::COLUMN, columns), db);
+}
 
-        for (QStandardItem* columnItem : allTableColumns[tableItem->text()])
-            columnsItem->appendRow(columnItem);
+void DbTreeModel::expandDbItem(QStandardItem* dbItem)
+{
+    treeView->expand(dbItem->index());
+    if (CFG_UI.General.ExpandTables.get())
+        treeView->expand(dbItem->model()->index(0, 0, dbItem->index())); // also expand tables
 
-        for (QStandardItem* indexItem : indexes[tableItem->text()])
-            indexesItem->appendRow(indexItem);
+    if (CFG_UI.General.ExpandViews.get())
+        treeView->expand(dbItem->model()->index(1, 0, dbItem->index())); // also expand views
+}
 
-        for (QStandardItem* triggerItem : triggers[tableItem->text()])
-            triggersItem->appendRow(triggerItem);
-    }
-    for (QStandardItem* viewItem : views)
-    {
-        viewsItem->appendRow(viewItem);
+void DbTreeModel::waitForSchemaLoading(Db* db)
+{
+    for (QFuture<SchemaSnapshotPtr>& future : schemaLoadFutures[db])
+        future.waitForFinished();
 
-        triggersItem = DbTreeItemFactory::createTriggers(this);
-        viewItem->appendRow(triggersItem);
-        for (QStandardItem* triggerItem : triggers[viewItem->text()])
-            triggersItem->appendRow(triggerItem);
-    }
+    schemaLoadFutures.remove(db);
+    schemaLoadGeneration.remove(db);
 }
 
 void DbTreeModel::restoreExpandedState(const QHash<QString, bool>& expandedState, QStandardItem* parentItem)
@@ -704,21 +848,25 @@ void DbTreeModel::dbConnected(Db* db, bool expandItem)
         qWarning() << "Connected to db that couldn't be found in the model:" << db->getName();
         return;
     }
-    refreshSchema(db, item);
-    if (expandItem)
-    {
-        treeView->expand(item->index());
-        if (CFG_UI.General.ExpandTables.get())
-            treeView->expand(item->model()->index(0, 0, item->index())); // also expand tables
-
-        if (CFG_UI.General.ExpandViews.get())
-            treeView->expand(item->model()->index(1, 0, item->index())); // also expand views
-    }
+    refreshSchemaAsync(db, expandItem);
     treeView->setCurrentIndex(item->index());
 }
 
+void DbTreeModel::dbAboutToBeDisconnected(Db* db, bool& deny)
+{
+    UNUSED(deny);
+
+    // The disconnecting may still be denied, so results are only waited for (not discarded),
+    // just to keep loading threads away from the database while it's being closed.
+    for (QFuture<SchemaSnapshotPtr> future : schemaLoadFutures.value(db))
+        future.waitForFinished();
+}
+
 void DbTreeModel::dbDisconnected(Db* db)
 {
+    // Results of loading started before disconnecting are outdated, even if the database gets reconnected
+    waitForSchemaLoading(db);
+
     QStandardItem* item = findItem(DbTreeItem::Type::DB, db);
     if (!item)
     {
@@ -769,7 +917,7 @@ void DbTreeModel::massSaveCommitted()
         for (Db* db : DBLIST->getDbList())
         {
             if (db->isOpen())
-                refreshSchema(db);
+                refreshSchemaAsync(db);
         }
     }
 }
@@ -8,6 +8,10 @@
 #include "common/strhash.h"
 #include <QStandardItemModel>
 #include <QObject>
+#include <QSharedPointer>
+#include <QSet>
+#include <QFuture>
+#include <QThreadPool>
 
 class DbManager;
 class DbTreeView;
@@ -38,6 +42,17 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         QStringList getGroupFor(QStandardItem* item);
         void storeGroups();
         void refreshSchema(Db* db);
+
+        /**
+         * @brief Refreshes schema branch of the database without blocking the GUI.
+         * @param db Database to refresh.
+         * @param expandItem If true, the database item (and tables/views, if configured so) is expanded when the schema is loaded.
+         *
+         * Schema is read in a thread pool (so multiple databases are read in parallel) and the resulting
+         * snapshot is applied to the tree once it's ready. If another refresh is requested for the same database
+         * in the meantime, results of the earlier one are discarded.
+         */
+        void refreshSchemaAsync(Db* db, bool expandItem = false);
         QList<DbTreeItem*> getAllItemsAsFlatList() const;
         void setTreeView(DbTreeView *value);
         QVariant data(const QModelIndex &index, int role) const;
@@ -62,21 +77,68 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         static const constexpr char* MIMETYPE = "application/x-sqlitestudio-dbtreeitem";
 
     private:
+        /**
+         * @brief Immutable copy of database schema, as it's presented in the tree.
+         *
+         * All lists are already sorted according to the configuration.
+         */
+        struct SchemaSnapshot
+        {
+            QStringList tables;
+            QSet<QString> virtualTables;
+            bool withColumns = true;
+            StrHash<QStringList> columns;
+            StrHash<QStringList> indexes;
+            StrHash<QStringList> triggers;
+            QStringList views;
+        };
+
+        typedef QSharedPointer<const SchemaSnapshot> SchemaSnapshotPtr;
+
+        /**
+         * @brief Configuration affecting schema loading.
+         *
+         * It's read from config in the GUI thread, before schema is loaded in another thread.
+         */
+        struct SchemaLoadOptions
+        {
+            bool ignoreSystemObjects = true;
+            bool sortObjects = true;
+            bool sortColumns = false;
+            bool withColumns = true;
+        };
+
+        typedef QPair<DbTreeItem::Type, QString> SchemaEntry;
+
+        static SchemaSnapshotPtr loadSchemaSnapshot(Db* db, const SchemaLoadOptions& options);
+        static SchemaLoadOptions getSchemaLoadOptions();
+
         void readGroups(QList<Db*> dbList);
         QList<Config::DbGroupPtr> childsToConfig(QStandardItem* item);
         void restoreGroup(const Config::DbGroupPtr& group, QList<Db*>* dbList = nullptr, QStandardItem *parent = nullptr);
         bool applyFilter(QStandardItem* parentItem, const QString& filter);
         void refreshSchema(Db* db, QStandardItem* item);
         void collectExpandedState(QHash<QString, bool>& state, QStandardItem* parentItem = nullptr);
-        QStandardItem* refreshSchemaDb(Db* db);
-        QList<QStandardItem*> refreshSchemaTables(const QStringList &tables, const QStringList& virtualTables, bool sort);
-        StrHash<QList<QStandardItem*>> refreshSchemaTableColumns(const StrHash<QStringList>& columns);
-        StrHash<QList<QStandardItem*>> refreshSchemaIndexes(const StrHash<QStringList>& indexes, bool sort);
-        StrHash<QList<QStandardItem*>> refreshSchemaTriggers(const StrHash<QStringList>& triggers, bool sort);
-        QList<QStandardItem*> refreshSchemaViews(const QStringList &views, bool sort);
-        void populateChildItemsWithDb(QStandardItem* parentItem, Db* db);
-        void refreshSchemaBuild(QStandardItem* dbItem, QList<QStandardItem*> tables, StrHash<QList<QStandardItem*> > indexes,
-                                StrHash<QList<QStandardItem*> > triggers, QList<QStandardItem*> views, StrHash<QList<QStandardItem*> > allTableColumns);
+        void applySchemaSnapshot(QStandardItem* dbItem, Db* db, const SchemaSnapshot& snapshot);
+        void applySchemaSnapshotFinished(Db* db, quint64 generation, const SchemaSnapshotPtr& snapshot, bool expandItem);
+
+        /**
+         * @brief Updates child items, so they match given entries.
+         * @param parentItem Item to update children of.
+         * @param entries Types and names of expected children, in expected order.
+         * @param db Database to assign to created items.
+         * @return Child items matching entries, in the same order.
+         *
+         * Existing items that match entries are kept (together with their children), items missing in entries
+         * are removed and new items are created only for new entries.
+         */
+        QList<DbTreeItem*> syncSchemaItems(QStandardItem* parentItem, const QList<SchemaEntry>& entries, Db* db);
+        DbTreeItem* syncSchemaDir(QStandardItem* parentItem, int row, DbTreeItem::Type type, Db* db);
+        DbTreeItem* createSchemaItem(DbTreeItem::Type type, const QString& name);
+        QList<SchemaEntry> toSchemaEntries(DbTreeItem::Type type, const QStringList& names);
+        void loadTableColumns(DbTreeItem* tableItem);
+        void expandDbItem(QStandardItem* dbItem);
+        void waitForSchemaLoading(Db* db);
         void restoreExpandedState(const QHash<QString, bool>& expandedState, QStandardItem* parentItem);
         DbTreeItem* findFirstItemOfType(DbTreeItem::Type type, QStandardItem* parentItem);
         QString getToolTip(DbTreeItem *item) const;
@@ -107,6 +169,23 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         bool ignoreDbLoadedSignal = false;
         QString currentFilter;
 
+        /**
+         * @brief Number of the latest schema refresh requested per database.
+         *
+         * Asynchronously loaded snapshot is applied only if no other refresh was requested after it was started.
+         */
+        QHash<Db*, quint64> schemaLoadGeneration;
+        quint64 schemaLoadCounter = 0;
+        QHash<Db*, QList<QFuture<SchemaSnapshotPtr>>> schemaLoadFutures;
+
+        /**
+         * @brief Threads loading schema snapshots.
+         *
+         * Private pool is used, so waiting for the loading (when database is disconnected or removed)
+         * doesn't depend on unrelated tasks queued in the global pool.
+         */
+        QThreadPool schemaLoadPool;
+
     private slots:
         void expanded(const QModelIndex &index);
         void collapsed(const QModelIndex &index);
@@ -114,6 +193,7 @@ class GUI_API_EXPORT DbTreeModel : public QStandardItemModel
         void dbUpdated(const QString &oldName, Db* db);
         void dbRemoved(Db* db);
         void dbConnected(Db* db, bool expandItem = true);
+        void dbAboutToBeDisconnected(Db* db, bool& deny);
         void dbDisconnected(Db* db);
         void dbUnloaded(Db* db);
         void dbLoaded(Db* db);
@@ -205,6 +205,7 @@ void ConfigDialog::init()
     QList<CfgEntry*> entries;
     entries << CFG_UI.General.SortObjects
             << CFG_UI.General.SortColumns
+            << CFG_UI.General.LoadColumnsOnExpand
             << CFG_UI.General.ShowDbTreeLabels
             << CFG_UI.General.ShowRegularTableLabels
             << CFG_UI.General.ShowSystemObjects
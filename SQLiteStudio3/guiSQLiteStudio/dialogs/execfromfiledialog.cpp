@@ -22,6 +22,11 @@ bool ExecFromFileDialog::ignoreErrors() const
     return ui->skipErrorsCheck->isChecked();
 }
 
+int ExecFromFileDialog::commitInterval() const
+{
+    return ui->commitIntervalSpin->value();
+}
+
 QString ExecFromFileDialog::filePath() const
 {
     return ui->fileEdit->text();
@@ -16,6 +16,7 @@ class ExecFromFileDialog : public QDialog
         ~ExecFromFileDialog();
 
         bool ignoreErrors() const;
+        int commitInterval() const;
         QString filePath() const;
         QString codec() const;
 
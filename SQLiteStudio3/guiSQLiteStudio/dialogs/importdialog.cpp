@@ -23,6 +23,7 @@ static const QString IMPORT_DIALOG_CFG_GROUP = "ImportDialog";
 static const QString IMPORT_DIALOG_CFG_CODEC = "codec";
 static const QString IMPORT_DIALOG_CFG_FILE = "inputFileName";
 static const QString IMPORT_DIALOG_CFG_IGNORE_ERR = "ignoreErrors";
+static const QString IMPORT_DIALOG_CFG_FAST_MODE = "fastMode";
 static const QString IMPORT_DIALOG_CFG_FORMAT = "format";
 
 ImportDialog::ImportDialog(QWidget *parent) :
@@ -67,6 +68,7 @@ void ImportDialog::storeStdConfig(ImportManager::StandardImportConfig &stdConfig
     CFG->set(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_CODEC, stdConfig.codec);
     CFG->set(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_FILE, stdConfig.inputFileName);
     CFG->set(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_IGNORE_ERR, stdConfig.ignoreErrors);
+    CFG->set(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_FAST_MODE, stdConfig.fastMode);
     CFG->set(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_FORMAT, currentPlugin->getDataSourceTypeName());
     CFG->commit();
 }
@@ -80,6 +82,7 @@ void ImportDialog::readStdConfig()
 
     ui->inputFileEdit->setText(CFG->get(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_FILE, QString()).toString());
     ui->ignoreErrorsCheck->setChecked(CFG->get(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_IGNORE_ERR, false).toBool());
+    ui->fastModeCheck->setChecked(CFG->get(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_FAST_MODE, false).toBool());
 
     // Encoding
     QString codec = CFG->get(IMPORT_DIALOG_CFG_GROUP, IMPORT_DIALOG_CFG_CODEC).toString();
@@ -397,6 +400,7 @@ void ImportDialog::accept()
         stdConfig.codec = ui->codecCombo->currentText();
 
     stdConfig.ignoreErrors = ui->ignoreErrorsCheck->isChecked();
+    stdConfig.fastMode = ui->fastModeCheck->isChecked();
 
     storeStdConfig(stdConfig);
     configMapper->saveFromWidget(pluginOptionsWidget);
@@ -8,15 +8,18 @@
 #include "plugins/populateplugin.h"
 #include "populateconfigdialog.h"
 #include "uiutils.h"
+#include "uiconfig.h"
 #include "services/populatemanager.h"
 #include "common/widgetcover.h"
 #include "common/compatibility.h"
+#include "services/notifymanager.h"
 #include <QPushButton>
 #include <QGridLayout>
 #include <QCheckBox>
 #include <QToolButton>
 #include <QDebug>
 #include <QSignalMapper>
+#include <QRandomGenerator>
 
 PopulateDialog::PopulateDialog(QWidget *parent) :
     QDialog(parent),
@@ -81,6 +84,8 @@ void PopulateDialog::init()
 
     connect(ui->databaseCombo, SIGNAL(currentTextChanged(QString)), this, SLOT(refreshTables()));
     connect(ui->tableCombo, SIGNAL(currentTextChanged(QString)), this, SLOT(refreshColumns()));
+    connect(ui->lastSeedButton, SIGNAL(clicked()), this, SLOT(useLastSeed()));
+    ui->lastSeedButton->setEnabled(CFG_UI.General.PopulateLastSeed.get() > 0);
     connect(POPULATE_MANAGER, SIGNAL(populatingFinished()), widgetCover, SLOT(hide()));
     connect(POPULATE_MANAGER, SIGNAL(finishedStep(int)), widgetCover, SLOT(setProgress(int)));
     connect(POPULATE_MANAGER, SIGNAL(populatingSuccessful()), this, SLOT(finished()));
@@ -340,6 +345,11 @@ void PopulateDialog::updateState()
     ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(columnsOk && tableOk && colCountOk);
 }
 
+void PopulateDialog::useLastSeed()
+{
+    ui->seedSpin->setValue(CFG_UI.General.PopulateLastSeed.get());
+}
+
 void PopulateDialog::finished()
 {
     QDialog::accept();
@@ -369,11 +379,20 @@ void PopulateDialog::accept()
     QString table = ui->tableCombo->currentText();
     int rows = ui->rowsSpin->value();
 
+    // Random seed is picked here, so it can be remembered and reused to generate the same data again
+    int seed = ui->seedSpin->value();
+    if (seed == 0)
+    {
+        seed = QRandomGenerator::global()->bounded(1, ui->seedSpin->maximum());
+        notifyInfo(tr("Populating table '%1' with random seed %2.").arg(table).arg(seed));
+    }
+    CFG_UI.General.PopulateLastSeed.set(seed);
+
     started = true;
     widgetCover->displayProgress(rows, "%v / %m");
     widgetCover->show();
     CFG->addPopulateHistory(db->getName(), table, rows, configForHistory);
-    POPULATE_MANAGER->populate(db, table, engines, rows);
+    POPULATE_MANAGER->populate(db, table, engines, rows, static_cast<quint32>(seed));
 }
 
 void PopulateDialog::reject()
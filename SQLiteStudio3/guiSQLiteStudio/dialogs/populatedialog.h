@@ -72,6 +72,7 @@ class GUI_API_EXPORT PopulateDialog : public QDialog
         void configurePlugin(int index);
         void updateColumnState(int index, bool updateGlobalState = true);
         void updateState();
+        void useLastSeed();
         void finished();
 
     public:
@@ -12,6 +12,7 @@
 #include "parser/lexer.h"
 #include "parser/parser.h"
 #include "parser/parsererror.h"
+#include "parser/incrementalparser.h"
 #include "common/unused.h"
 #include "services/notifymanager.h"
 #include "dialogs/searchtextdialog.h"
@@ -117,7 +118,7 @@ void SqlEditor::init()
 
     connect(this, SIGNAL(textChanged()), this, SLOT(scheduleQueryParser()));
 
-    queryParser = new Parser();
+    queryParser = new IncrementalParser();
 
     connect(this, &QWidget::customContextMenuRequested, this, &SqlEditor::customContextMenuRequested);
     connect(CFG_UI.Fonts.SqlEditor, SIGNAL(changed(QVariant)), this, SLOT(changeFont(QVariant)));
@@ -495,6 +496,17 @@ void SqlEditor::complete()
         sql = virtualSqlExpression.arg(sql);
         curPos += virtualSqlOffset;
     }
+    else
+    {
+        // Only the statement at cursor matters for completion, no need to parse all statements before it.
+        queryParser->parse(sql);
+        int stmtIdx = queryParser->getStatementIndex(curPos);
+        if (stmtIdx > -1)
+        {
+            curPos -= queryParser->getStatements()[stmtIdx].start;
+            sql = queryParser->getStatementSql(stmtIdx);
+        }
+    }
 
     CompletionHelper completionHelper(sql, curPos, db);
     completionHelper.setCreateTriggerTable(createTriggerTable);
@@ -912,12 +924,15 @@ void SqlEditor::checkForSyntaxErrors()
 
     // Marking invalid tokens, like in "SELECT * from test] t" - the "]" token is invalid.
     // Such tokens don't cause parser to fail.
-    for (const SqliteQueryPtr& query : queryParser->getQueries())
+    for (const IncrementalParser::Statement& stmt : queryParser->getStatements())
     {
-        for (TokenPtr& token : query->tokens)
+        for (const SqliteQueryPtr& query : stmt.results->queries)
         {
-            if (token->type == Token::INVALID)
-                markErrorAt(token->start, token->end, true);
+            for (TokenPtr& token : query->tokens)
+            {
+                if (token->type == Token::INVALID)
+                    markErrorAt(stmt.start + token->start, stmt.start + token->end, true);
+            }
         }
     }
 
@@ -928,8 +943,8 @@ void SqlEditor::checkForSyntaxErrors()
     }
 
     // Setting new markers when errors were detected
-    for (ParserError* error : queryParser->getErrors())
-        markErrorAt(sqlIndex(error->getFrom()), sqlIndex(error->getTo()));
+    for (ParserError& error : queryParser->getErrors())
+        markErrorAt(sqlIndex(error.getFrom()), sqlIndex(error.getTo()));
 
     emit errorsChecked(true);
 }
@@ -943,27 +958,30 @@ void SqlEditor::checkForValidObjects()
     QMutexLocker lock(&objectsInNamedDbMutex);
     QList<SqliteStatement::FullObject> fullObjects;
     QString dbName;
-    for (const SqliteQueryPtr& query : queryParser->getQueries())
+    for (const IncrementalParser::Statement& stmt : queryParser->getStatements())
     {
-        fullObjects = query->getContextFullObjects();
-        for (SqliteStatement::FullObject& fullObj : fullObjects)
+        for (const SqliteQueryPtr& query : stmt.results->queries)
         {
-            dbName = fullObj.database ? stripObjName(fullObj.database->value) : "main";
-            if (!objectsInNamedDb.contains(dbName))
-                continue;
-
-            if (fullObj.type == SqliteStatement::FullObject::DATABASE)
+            fullObjects = query->getContextFullObjects();
+            for (SqliteStatement::FullObject& fullObj : fullObjects)
             {
-                // Valid db name
-                addDbObject(sqlIndex(fullObj.database->start), sqlIndex(fullObj.database->end), QString());
-                continue;
+                dbName = fullObj.database ? stripObjName(fullObj.database->value) : "main";
+                if (!objectsInNamedDb.contains(dbName))
+                    continue;
+
+                if (fullObj.type == SqliteStatement::FullObject::DATABASE)
+                {
+                    // Valid db name
+                    addDbObject(sqlIndex(stmt.start + fullObj.database->start), sqlIndex(stmt.start + fullObj.database->end), QString());
+                    continue;
+                }
+
+                if (!objectsInNamedDb[dbName].contains(stripObjName(fullObj.object->value)))
+                    continue;
+
+                // Valid object name
+                addDbObject(sqlIndex(stmt.start + fullObj.object->start), sqlIndex(stmt.start + fullObj.object->end), dbName);
             }
-
-            if (!objectsInNamedDb[dbName].contains(stripObjName(fullObj.object->value)))
-                continue;
-
-            // Valid object name
-            addDbObject(sqlIndex(fullObj.object->start), sqlIndex(fullObj.object->end), dbName);
         }
     }
 }
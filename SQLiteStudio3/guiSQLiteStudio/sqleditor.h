@@ -12,7 +12,7 @@
 #include <QFuture>
 
 class CompleterWindow;
-class Parser;
+class IncrementalParser;
 class SqlEditor;
 class SearchTextDialog;
 class SearchTextLocator;
@@ -224,7 +224,7 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         bool autoCompletion = true;
         bool deletionKeyPressed = false;
         LazyTrigger* queryParserTrigger = nullptr;
-        Parser* queryParser = nullptr;
+        IncrementalParser* queryParser = nullptr;
         QHash<QString,QStringList> objectsInNamedDb;
         QMutex objectsInNamedDbMutex;
         bool objectLinksEnabled = false;
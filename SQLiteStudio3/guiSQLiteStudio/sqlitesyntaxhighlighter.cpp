@@ -89,9 +89,8 @@ void SqliteSyntaxHighlighter::highlightBlock(const QString &text)
         idxModifier += statePrefix.size();
     }
 
-    Lexer lexer;
-    lexer.setTolerantMode(true);
-    lexer.prepare(statePrefix+text);
+    QString sql = statePrefix + text;
+    RawTokenList tokens = Lexer::tokenizeRaw(sql, true);
 
     // Previous error state.
     // Empty lines have no userData, so we will look for any previous paragraph that is
@@ -106,44 +105,44 @@ void SqliteSyntaxHighlighter::highlightBlock(const QString &text)
 
     TextBlockData* data = new TextBlockData();
     int errorStart = -1;
-    TokenPtr token = lexer.getToken();
-    TokenPtr aheadToken;
-    while (token)
+    for (int i = 0, total = tokens.size(); i < total; i++)
     {
-        aheadToken = lexer.getToken();
+        RawToken& token = tokens[i];
+        const RawToken* aheadToken = (i + 1 < total) ? &tokens[i + 1] : nullptr;
 
-        if (handleToken(token, aheadToken, idxModifier, errorStart, data, prevData))
-            errorStart = token->start + currentBlock().position();
+        if (handleToken(sql, token, aheadToken, idxModifier, errorStart, data, prevData))
+            errorStart = token.start + currentBlock().position();
 
         if (data->getEndsWithQuerySeparator())
             errorStart = -1;
 
-        handleParenthesis(token, data);
-        token = aheadToken;
+        handleParenthesis(sql, token, data);
     }
 
     setCurrentBlockUserData(data);
 }
 
-bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, qint32 idxModifier, int errorStart, TextBlockData* currBlockData,
-                                          TextBlockData* previousBlockData)
+bool SqliteSyntaxHighlighter::handleToken(const QString& sql, RawToken& token, const RawToken* aheadToken, qint32 idxModifier, int errorStart,
+                                          TextBlockData* currBlockData, TextBlockData* previousBlockData)
 {
-    qint64 start = token->start - idxModifier;
-    qint64 lgt = token->end - token->start + 1;
+    qint64 start = token.start - idxModifier;
+    qint64 lgt = token.length;
     if (start < 0)
     {
         lgt += start; // cut length by num of chars before 0 (after idxModifier applied)
         start = 0;
     }
 
-    if (createTriggerContext && token->type == Token::OTHER && (token->value.toLower() == "old" || token->value.toLower() == "new"))
-        token->type = Token::KEYWORD;
+    QStringRef value = sql.midRef(token.start, token.length);
+    if (createTriggerContext && token.type == Token::OTHER &&
+            (value.compare(QLatin1String("old"), Qt::CaseInsensitive) == 0 || value.compare(QLatin1String("new"), Qt::CaseInsensitive) == 0))
+        token.type = Token::KEYWORD;
 
-    if (aheadToken && aheadToken->type == Token::PAR_LEFT && token->type == Token::KEYWORD && isSoftKeyword(token->value))
-        token->type = Token::OTHER;
+    if (aheadToken && aheadToken->type == Token::PAR_LEFT && token.type == Token::KEYWORD && isSoftKeyword(value.toString()))
+        token.type = Token::OTHER;
 
     bool limitedDamage = false;
-    bool querySeparator = (token->type == Token::Type::OPERATOR && token->value == ";");
+    bool querySeparator = (token.type == Token::Type::OPERATOR && value == QLatin1String(";"));
     bool error = isError(start, lgt, &limitedDamage);
     bool valid = isValid(start, lgt);
     bool wasError = (
@@ -152,7 +151,7 @@ bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, q
                         !currBlockData->getEndsWithQuerySeparator() // if it was set for previous token in the same block
                     ) ||
                     (
-                        token->start == 0 &&
+                        token.start == 0 &&
                         previousBlockData &&
                         previousBlockData->getEndsWithError() &&
                         !previousBlockData->getEndsWithQuerySeparator()
@@ -165,19 +164,18 @@ bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, q
     applyValidObjectFormat(format, valid, error, wasError);
 
     // Get format for token type (if any)
-    if (tokenTypeMapping.contains(token->type))
-        format = formats->value(tokenTypeMapping[token->type]);
+    if (tokenTypeMapping.contains(token.type))
+        format = formats->value(tokenTypeMapping[token.type]);
 
     // Merge with error format (if this is an error).
-    applyErrorFormat(format, error, wasError, token->type);
+    applyErrorFormat(format, error, wasError, token.type);
 
     // Apply format
     QSyntaxHighlighter::setFormat(start, lgt, format);
 
     // Save block state
-    TolerantTokenPtr tolerantToken = token.dynamicCast<TolerantToken>();
-    if (tolerantToken->invalid)
-        setStateForUnfinishedToken(tolerantToken);
+    if (token.invalid)
+        setStateForUnfinishedToken(token.type, value.at(0));
     else
         setCurrentBlockState(regulartTextBlockState);
 
@@ -206,10 +204,10 @@ void SqliteSyntaxHighlighter::applyValidObjectFormat(QTextCharFormat& format, bo
         format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
 }
 
-void SqliteSyntaxHighlighter::handleParenthesis(TokenPtr token, TextBlockData* data)
+void SqliteSyntaxHighlighter::handleParenthesis(const QString& sql, const RawToken& token, TextBlockData* data)
 {
-    if (token->type == Token::PAR_LEFT || token->type == Token::PAR_RIGHT)
-        data->insertParenthesis(currentBlock().position() + token->start, token->value[0].toLatin1());
+    if (token.type == Token::PAR_LEFT || token.type == Token::PAR_RIGHT)
+        data->insertParenthesis(currentBlock().position() + token.start, sql[token.start].toLatin1());
 }
 bool SqliteSyntaxHighlighter::getCreateTriggerContext() const
 {
@@ -258,13 +256,13 @@ bool SqliteSyntaxHighlighter::isValid(int start, int lgt)
     return false;
 }
 
-void SqliteSyntaxHighlighter::setStateForUnfinishedToken(TolerantTokenPtr tolerantToken)
+void SqliteSyntaxHighlighter::setStateForUnfinishedToken(Token::Type tokenType, const QChar& firstChar)
 {
-    switch (tolerantToken->type)
+    switch (tokenType)
     {
         case Token::OTHER:
         {
-            switch (tolerantToken->value.at(0).toLatin1())
+            switch (firstChar.toLatin1())
             {
                 case '[':
                     setCurrentBlockState(static_cast<int>(TextBlockState::ID_1));
@@ -118,11 +118,14 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
 
         /**
          * @brief handleToken Highlights token.
+         * @param sql Tokenized text (contents of the block with the prefix for previous block state).
          * @param token Token to handle.
+         * @param aheadToken Next token in the block, or null if this is the last one.
          * @param idxModifier Modifier for text highlighting in case of previous state defined by multi-character token. See getPreviousStatePrefix() for details.
          * @return true if the token is being marked as invalid (syntax error).
          */
-        bool handleToken(TokenPtr token, TokenPtr aheadToken, qint32 idxModifier, int errorStart, TextBlockData* currBlockData, TextBlockData* previousBlockData);
+        bool handleToken(const QString& sql, RawToken& token, const RawToken* aheadToken, qint32 idxModifier, int errorStart, TextBlockData* currBlockData,
+                         TextBlockData* previousBlockData);
 
         bool isError(int start, int lgt, bool* limitedDamage);
         bool isValid(int start, int lgt);
@@ -133,7 +136,7 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
          * Unchecked text is all text after first error, becuase it could not be parser, therefore could not be checked.
          */
         void markUncheckedErrors(int errorStart, int length);
-        void setStateForUnfinishedToken(TolerantTokenPtr tolerantToken);
+        void setStateForUnfinishedToken(Token::Type tokenType, const QChar& firstChar);
 
         /**
          * @brief applyErrorFormat Applies error format properties to given format.
@@ -152,7 +155,7 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
          */
         void applyValidObjectFormat(QTextCharFormat& format, bool isValid, bool isError, bool wasError);
 
-        void handleParenthesis(TokenPtr token, TextBlockData* data);
+        void handleParenthesis(const QString& sql, const RawToken& token, TextBlockData* data);
 
         static const int regulartTextBlockState = static_cast<int>(TextBlockState::REGULAR);
 
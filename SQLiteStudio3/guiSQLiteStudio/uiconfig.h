@@ -74,6 +74,7 @@ CFG_UI_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ExpandViews,                 true)
         CFG_ENTRY(bool,                  SortObjects,                 true)
         CFG_ENTRY(bool,                  SortColumns,                 false)
+        CFG_ENTRY(bool,                  LoadColumnsOnExpand,         false)
         CFG_ENTRY(bool,                  ExecuteCurrentQueryOnly,     true)
         CFG_ENTRY(bool,                  ShowSystemObjects,           false)
         CFG_ENTRY(bool,                  ShowDbTreeLabels,            true) // any labels at all
@@ -107,6 +108,7 @@ CFG_UI_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ShowDataViewTooltips,        true)
         CFG_ENTRY(bool,                  KeepNullWhenEmptyValue,      true)
         CFG_ENTRY(bool,                  UseDefaultValueForNull,      false)
+        CFG_ENTRY(int,                   PopulateLastSeed,            0)
     )
 )
 
@@ -368,6 +368,19 @@ void TableWindow::executeStructureChanges()
     structureExecutor->setQueries(sqls);
     structureExecutor->setDisableForeignKeys(true);
     structureExecutor->setDisableObjectDropsDetection(true);
+
+    // Table data is copied in chunks, so the progress is visible and copying huge table can be interrupted
+    QHash<int,ChainExecutor::ChunkedQuery> chunkedQueries = existingTable && tableModifier ? tableModifier->getChunkedQueries()
+                                                                                          : QHash<int,ChainExecutor::ChunkedQuery>();
+    structureExecutor->setChunkedQueries(chunkedQueries);
+    if (chunkedQueries.isEmpty())
+        widgetCover->noDisplayProgress();
+    else
+    {
+        widgetCover->displayProgress(100);
+        widgetCover->setProgress(0);
+    }
+
     widgetCover->show();
     structureExecutor->exec();
 }
@@ -583,6 +596,7 @@ void TableWindow::setupCoverWidget()
     widgetCover->initWithInterruptContainer();
     widgetCover->hide();
     connect(widgetCover, SIGNAL(cancelClicked()), structureExecutor, SLOT(interrupt()));
+    connect(structureExecutor, SIGNAL(progress(int)), widgetCover, SLOT(setProgress(int)));
 }
 
 void TableWindow::parseDdl()
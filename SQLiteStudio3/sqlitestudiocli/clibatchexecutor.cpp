@@ -0,0 +1,330 @@
+#include "clibatchexecutor.h"
+#include "cli_config.h"
+#include "qio.h"
+#include "csvserializer.h"
+#include "common/utils.h"
+#include "db/sqlquery.h"
+#include "db/sqlresultsrow.h"
+#include "db/sqlscriptexecutor.h"
+#include <QFile>
+#include <QVector>
+#include <QtMath>
+#include <cstdio>
+
+CliBatchExecutor::CliBatchExecutor(Db* db) :
+    db(db)
+{
+}
+
+void CliBatchExecutor::setFormat(Format value)
+{
+    format = value;
+}
+
+void CliBatchExecutor::setHeader(bool value)
+{
+    header = value;
+}
+
+void CliBatchExecutor::setIgnoreErrors(bool value)
+{
+    ignoreErrors = value;
+}
+
+void CliBatchExecutor::setCommitInterval(int value)
+{
+    commitInterval = value;
+}
+
+bool CliBatchExecutor::execSql(const QString& sql)
+{
+    SqlScriptExecutor executor(db);
+    setupExecutor(executor);
+    return reportErrors(executor, executor.exec(sql));
+}
+
+bool CliBatchExecutor::execFile(const QString& path)
+{
+    bool fromStdin = (path == "-");
+    QFile file(fromStdin ? QString() : path);
+    bool opened = fromStdin ? file.open(stdin, QIODevice::ReadOnly) : file.open(QIODevice::ReadOnly);
+    if (!opened)
+    {
+        qErr << QObject::tr("Could not open file '%1' for reading: %2").arg(path, file.errorString()) << "\n";
+        qErr.flush();
+        return false;
+    }
+
+    SqlScriptExecutor executor(db);
+    setupExecutor(executor);
+    bool result = executor.exec(&file);
+    file.close();
+    return reportErrors(executor, result);
+}
+
+bool CliBatchExecutor::toFormat(const QString& name, Format& format)
+{
+    int idx = getFormatNames().indexOf(name.toLower());
+    if (idx < 0)
+        return false;
+
+    format = static_cast<Format>(idx);
+    return true;
+}
+
+QStringList CliBatchExecutor::getFormatNames()
+{
+    // In order of the Format enum
+    static const QStringList names = {"csv", "tsv", "json", "fixed"};
+    return names;
+}
+
+void CliBatchExecutor::setupExecutor(SqlScriptExecutor& executor)
+{
+    executor.setTransactional(commitInterval > 0);
+    executor.setCommitInterval(commitInterval);
+    executor.setIgnoreErrors(ignoreErrors);
+    executor.setResultsHandler([this](SqlQueryPtr results)
+    {
+        printResults(results);
+    });
+}
+
+bool CliBatchExecutor::reportErrors(const SqlScriptExecutor& executor, bool result)
+{
+    qOut.flush();
+
+    for (const SqlScriptExecutor::Error& error : executor.getErrors())
+        qErr << QObject::tr("Query execution error: %1").arg(error.second) << "\n" << error.first.trimmed() << "\n";
+
+    if (!executor.getErrorText().isEmpty())
+        qErr << executor.getErrorText() << "\n";
+
+    qErr.flush();
+
+    // With errors ignored, the executor succeeds even if some statements failed
+    return result && executor.getErrors().isEmpty();
+}
+
+void CliBatchExecutor::printResults(SqlQueryPtr results)
+{
+    if (results->columnCount() == 0)
+        return;
+
+    switch (format)
+    {
+        case Format::CSV:
+            printDsv(results, CsvFormat(",", "\n"));
+            break;
+        case Format::TSV:
+            printDsv(results, CsvFormat("\t", "\n"));
+            break;
+        case Format::JSON:
+            printJson(results);
+            break;
+        case Format::FIXED:
+            printFixed(results);
+            break;
+    }
+}
+
+void CliBatchExecutor::printDsv(SqlQueryPtr results, const CsvFormat& format)
+{
+    if (header)
+        qOut << CsvSerializer::serialize(results->getColumnNames(), format) << "\n";
+
+    int colCount = results->columnCount();
+    QStringList values;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        values.clear();
+        for (int i = 0; i < colCount; i++)
+            values << getValueString(row->value(i), QString());
+
+        qOut << CsvSerializer::serialize(values, format) << "\n";
+    }
+}
+
+void CliBatchExecutor::printJson(SqlQueryPtr results)
+{
+    // One object per line. Keys are escaped only once, for all rows.
+    QStringList keys;
+    QString key;
+    for (const QString& column : results->getColumnNames())
+    {
+        key.clear();
+        appendJsonString(key, column);
+        keys << (key + ":");
+    }
+
+    int colCount = keys.size();
+    QString line;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        line.clear();
+        line += '{';
+        for (int i = 0; i < colCount; i++)
+        {
+            if (i > 0)
+                line += ',';
+
+            line += keys[i];
+            appendJsonValue(line, row->value(i));
+        }
+        line += "}\n";
+        qOut << line;
+    }
+}
+
+void CliBatchExecutor::printFixed(SqlQueryPtr results)
+{
+    QString nullValue = CFG_CLI.Console.NullValue.get();
+    QStringList columns = results->getColumnNames();
+    int colCount = columns.size();
+
+    // Widths are calculated from the first rows only, so the rest can be printed as it's read
+    QVector<int> widths(colCount, 1);
+    if (header)
+    {
+        for (int i = 0; i < colCount; i++)
+            widths[i] = qMax(widths[i], columns[i].length());
+    }
+
+    QList<QStringList> sample;
+    QStringList values;
+    SqlResultsRowPtr row;
+    while (sample.size() < FIXED_WIDTH_SAMPLE_SIZE && results->hasNext())
+    {
+        row = results->next();
+        values.clear();
+        for (int i = 0; i < colCount; i++)
+        {
+            values << getValueString(row->value(i), nullValue);
+            widths[i] = qMax(widths[i], values.last().length());
+        }
+        sample << values;
+    }
+
+    QStringList line;
+    if (header)
+    {
+        for (int i = 0; i < colCount; i++)
+            line << pad(columns[i], widths[i], ' ');
+
+        qOut << line.join("|") << "\n";
+
+        line.clear();
+        for (int i = 0; i < colCount; i++)
+            line << QString("-").repeated(widths[i]);
+
+        qOut << line.join("+") << "\n";
+    }
+
+    for (const QStringList& sampleValues : sample)
+    {
+        line.clear();
+        for (int i = 0; i < colCount; i++)
+            line << pad(sampleValues[i], widths[i], ' ');
+
+        qOut << line.join("|") << "\n";
+    }
+
+    while (results->hasNext())
+    {
+        row = results->next();
+        line.clear();
+        for (int i = 0; i < colCount; i++)
+            line << pad(getValueString(row->value(i), nullValue), widths[i], ' ');
+
+        qOut << line.join("|") << "\n";
+    }
+}
+
+QString CliBatchExecutor::getValueString(const QVariant& value, const QString& nullValue) const
+{
+    if (value.isValid() && !value.isNull())
+        return value.toString();
+
+    return nullValue;
+}
+
+void CliBatchExecutor::appendJsonString(QString& output, const QString& value)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    output += '"';
+    for (const QChar& c : value)
+    {
+        switch (c.unicode())
+        {
+            case '"':
+                output += QLatin1String("\\\"");
+                break;
+            case '\\':
+                output += QLatin1String("\\\\");
+                break;
+            case '\n':
+                output += QLatin1String("\\n");
+                break;
+            case '\r':
+                output += QLatin1String("\\r");
+                break;
+            case '\t':
+                output += QLatin1String("\\t");
+                break;
+            default:
+            {
+                if (c.unicode() < 0x20)
+                {
+                    output += QLatin1String("\\u00");
+                    output += QLatin1Char(hexDigits[c.unicode() >> 4]);
+                    output += QLatin1Char(hexDigits[c.unicode() & 0xf]);
+                }
+                else
+                    output += c;
+
+                break;
+            }
+        }
+    }
+    output += '"';
+}
+
+void CliBatchExecutor::appendJsonValue(QString& output, const QVariant& value)
+{
+    if (!value.isValid() || value.isNull())
+    {
+        output += QLatin1String("null");
+        return;
+    }
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        case QVariant::LongLong:
+        case QVariant::UInt:
+        case QVariant::ULongLong:
+            output += value.toString();
+            break;
+        case QVariant::Double:
+        {
+            double d = value.toDouble();
+            if (qIsFinite(d))
+                output += value.toString();
+            else
+                output += QLatin1String("null");
+
+            break;
+        }
+        case QVariant::ByteArray:
+            appendJsonString(output, QString::fromLatin1(value.toByteArray().toBase64()));
+            break;
+        default:
+            appendJsonString(output, value.toString());
+            break;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef CLIBATCHEXECUTOR_H
+#define CLIBATCHEXECUTOR_H
+
+#include "db/db.h"
+#include "csvformat.h"
+#include <QStringList>
+
+class SqlScriptExecutor;
+
+/**
+ * @brief Executes SQL non-interactively and prints results to the standard output.
+ *
+ * It's used when SQL is passed in command line arguments (or in a file, or through the standard input),
+ * instead of typing it in the interactive prompt. Rows are printed as they are read from the database,
+ * so even huge results are never kept in memory.
+ *
+ * Transactions are left to the executed SQL, just like in the interactive mode, unless the commit interval
+ * is defined (see setCommitInterval()).
+ */
+class CliBatchExecutor
+{
+    public:
+        enum class Format
+        {
+            CSV,
+            TSV,
+            JSON,
+            FIXED
+        };
+
+        /**
+         * @brief Number of first rows used to calculate column widths in FIXED format.
+         *
+         * Values of later rows that are longer than that are not truncated, they just break the alignment.
+         */
+        static const int FIXED_WIDTH_SAMPLE_SIZE = 100;
+
+        explicit CliBatchExecutor(Db* db);
+
+        void setFormat(Format value);
+        void setHeader(bool value);
+        void setIgnoreErrors(bool value);
+
+        /**
+         * @brief Defines after how many statements the transaction is committed.
+         * @param value Number of statements, or 0 to leave transactions to the executed SQL (default).
+         *
+         * When it's set, statements are executed in transactions started by the executor
+         * and transaction statements of the executed SQL are skipped.
+         */
+        void setCommitInterval(int value);
+
+        /**
+         * @brief Executes SQL statements.
+         * @param sql Statements to execute.
+         * @return true if all statements were executed successfully.
+         */
+        bool execSql(const QString& sql);
+
+        /**
+         * @brief Executes SQL script from a file.
+         * @param path Path to the file, or "-" for the standard input.
+         * @return true if all statements were executed successfully.
+         */
+        bool execFile(const QString& path);
+
+        static bool toFormat(const QString& name, Format& format);
+        static QStringList getFormatNames();
+
+    private:
+        void setupExecutor(SqlScriptExecutor& executor);
+        bool reportErrors(const SqlScriptExecutor& executor, bool result);
+        void printResults(SqlQueryPtr results);
+        void printDsv(SqlQueryPtr results, const CsvFormat& format);
+        void printJson(SqlQueryPtr results);
+        void printFixed(SqlQueryPtr results);
+        QString getValueString(const QVariant& value, const QString& nullValue) const;
+        static void appendJsonString(QString& output, const QString& value);
+        static void appendJsonValue(QString& output, const QVariant& value);
+
+        Db* db = nullptr;
+        Format format = Format::CSV;
+        bool header = true;
+        bool ignoreErrors = false;
+        int commitInterval = 0;
+};
+
+#endif // CLIBATCHEXECUTOR_H
@@ -8,6 +8,7 @@
 #include "common/unused.h"
 #include "cli_config.h"
 #include "cliutils.h"
+#include "clibatchexecutor.h"
 #include "common/compatibility.h"
 #include <QList>
 #include <QDebug>
@@ -178,8 +179,11 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
         return;
     }
 
-    // Preload data (we will calculate column widths basing on real values)
-    QList<SqlResultsRowPtr> allRows = results->getAll();
+    // Read first rows (we will calculate column widths basing on real values).
+    // Remaining rows are printed as they are read, with the same widths.
+    QList<SqlResultsRowPtr> sampleRows;
+    while (sampleRows.size() < CliBatchExecutor::FIXED_WIDTH_SAMPLE_SIZE && results->hasNext())
+        sampleRows << results->next();
 
     // Get widths of each column in every data row, remember the longest ones
     QList<SortedColumnWidth*> columnWidths;
@@ -193,7 +197,7 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
     }
 
     int dataLength;
-    for (const SqlResultsRowPtr& row : allRows)
+    for (const SqlResultsRowPtr& row : sampleRows)
     {
         for (int i = 0; i < resultColumnsCount; i++)
         {
@@ -229,9 +233,12 @@ void CliCommandSql::printResultsColumns(QueryExecutor* executor, SqlQueryPtr res
 
     printColumnHeader(finalWidths, headerNames);
 
-    for (SqlResultsRowPtr row : allRows)
+    for (SqlResultsRowPtr row : sampleRows)
         printColumnDataRow(finalWidths, row, resultColumnsCount);
 
+    while (results->hasNext())
+        printColumnDataRow(finalWidths, results->next(), resultColumnsCount);
+
     qOut.flush();
 }
 
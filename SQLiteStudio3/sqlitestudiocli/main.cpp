@@ -9,12 +9,21 @@
 #include "completionhelper.h"
 #include "services/updatemanager.h"
 #include "services/pluginmanager.h"
+#include "services/dbmanager.h"
+#include "clibatchexecutor.h"
 #include <QCoreApplication>
 #include <QtGlobal>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <cstdlib>
 
 bool listPlugins = false;
+QString batchSql;
+QString batchFile;
+CliBatchExecutor::Format batchFormat = CliBatchExecutor::Format::CSV;
+bool batchHeader = true;
+bool batchIgnoreErrors = false;
+int batchCommitInterval = 0;
 
 QString cliHandleCmdLineArgs()
 {
@@ -26,9 +35,31 @@ QString cliHandleCmdLineArgs()
     QCommandLineOption debugOption({"d", "debug"}, QObject::tr("Enables debug messages on standard error output."));
     QCommandLineOption lemonDebugOption("debug-lemon", QObject::tr("Enables Lemon parser debug messages for SQL code assistant."));
     QCommandLineOption listPluginsOption("list-plugins", QObject::tr("Lists plugins installed in the SQLiteStudio and quits."));
+    QCommandLineOption commandOption({"c", "command"}, QObject::tr("Executes SQL statements on the database, prints results and quits."),
+                                     QObject::tr("SQL"));
+    QCommandLineOption fileOption({"f", "file"}, QObject::tr("Executes SQL script from the file on the database, prints results and quits. "
+                                                             "Use - to read the script from the standard input."), QObject::tr("script"));
+    QCommandLineOption formatOption({"o", "output-format"}, QObject::tr("Format of results printed by %1 and %2 options: %3. "
+                                                                        "Blobs in json format are encoded in base64. Default is %4.")
+                                    .arg("--command", "--file", CliBatchExecutor::getFormatNames().join(", "), "csv"),
+                                    QObject::tr("format"), "csv");
+    QCommandLineOption noHeaderOption("no-header", QObject::tr("Skips column names when printing results of %1 and %2 options.")
+                                      .arg("--command", "--file"));
+    QCommandLineOption ignoreErrorsOption("ignore-errors", QObject::tr("Continues executing statements of %1 and %2 options after an error.")
+                                          .arg("--command", "--file"));
+    QCommandLineOption commitIntervalOption("commit-interval", QObject::tr("Executes statements of %1 and %2 options in transactions "
+                                                                           "committed after every given number of statements. "
+                                                                           "Transaction statements of the executed SQL are skipped then.")
+                                            .arg("--command", "--file"), QObject::tr("statements"));
     parser.addOption(debugOption);
     parser.addOption(lemonDebugOption);
     parser.addOption(listPluginsOption);
+    parser.addOption(commandOption);
+    parser.addOption(fileOption);
+    parser.addOption(formatOption);
+    parser.addOption(noHeaderOption);
+    parser.addOption(ignoreErrorsOption);
+    parser.addOption(commitIntervalOption);
 
     parser.addPositionalArgument(QObject::tr("file"), QObject::tr("Database file to open"));
 
@@ -40,6 +71,34 @@ QString cliHandleCmdLineArgs()
     if (parser.isSet(listPluginsOption))
         listPlugins = true;
 
+    if (parser.isSet(commandOption))
+        batchSql = parser.value(commandOption);
+
+    if (parser.isSet(fileOption))
+        batchFile = parser.value(fileOption);
+
+    if (!CliBatchExecutor::toFormat(parser.value(formatOption), batchFormat))
+    {
+        qErr << QObject::tr("Unknown output format: %1").arg(parser.value(formatOption)) << "\n";
+        qErr.flush();
+        exit(1);
+    }
+
+    batchHeader = !parser.isSet(noHeaderOption);
+    batchIgnoreErrors = parser.isSet(ignoreErrorsOption);
+
+    if (parser.isSet(commitIntervalOption))
+    {
+        bool ok;
+        batchCommitInterval = parser.value(commitIntervalOption).toInt(&ok);
+        if (!ok || batchCommitInterval < 1)
+        {
+            qErr << QObject::tr("Invalid commit interval: %1").arg(parser.value(commitIntervalOption)) << "\n";
+            qErr.flush();
+            exit(1);
+        }
+    }
+
     CompletionHelper::enableLemonDebug = parser.isSet(lemonDebugOption);
 
     QStringList args = parser.positionalArguments();
@@ -49,6 +108,43 @@ QString cliHandleCmdLineArgs()
     return QString();
 }
 
+int cliExecBatch(const QString& dbPath)
+{
+    if (dbPath.isEmpty())
+    {
+        qErr << QObject::tr("Database file must be given to execute SQL from command line options.") << "\n";
+        qErr.flush();
+        return 1;
+    }
+
+    Db* db = DBLIST->getByPath(dbPath);
+    if (!db)
+        db = DBLIST->getByName(DBLIST->quickAddDb(dbPath, QHash<QString,QVariant>()));
+
+    if (!db || (!db->isOpen() && !db->open()))
+    {
+        qErr << QObject::tr("Could not open database %1.").arg(dbPath) << "\n";
+        qErr.flush();
+        return 1;
+    }
+
+    CliBatchExecutor executor(db);
+    executor.setFormat(batchFormat);
+    executor.setHeader(batchHeader);
+    executor.setIgnoreErrors(batchIgnoreErrors);
+    executor.setCommitInterval(batchCommitInterval);
+
+    bool ok = true;
+    if (!batchSql.isNull())
+        ok = executor.execSql(batchSql);
+
+    if ((ok || batchIgnoreErrors) && !batchFile.isNull())
+        ok = executor.execFile(batchFile) && ok;
+
+    qOut.flush();
+    return ok ? 0 : 1;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
@@ -75,6 +171,9 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (!batchSql.isNull() || !batchFile.isNull())
+        return cliExecBatch(dbToOpen);
+
     CliCommandExecutor executor;
 
     QObject::connect(CLI::getInstance(), &CLI::execCommand, &executor, &CliCommandExecutor::execCommand);
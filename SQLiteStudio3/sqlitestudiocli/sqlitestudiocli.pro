@@ -47,6 +47,7 @@ SOURCES += main.cpp \
     cli_config.cpp \
     commands/clicommandhelp.cpp \
     cliutils.cpp \
+    clibatchexecutor.cpp \
     commands/clicommandtables.cpp \
     climsghandler.cpp \
     commands/clicommandmode.cpp \
@@ -87,6 +88,7 @@ HEADERS += \
     clicommandexecutor.h \
     commands/clicommandhelp.h \
     cliutils.h \
+    clibatchexecutor.h \
     commands/clicommandtables.h \
     climsghandler.h \
     commands/clicommandmode.h \